@@ -996,44 +996,49 @@ bool ClassDB::set_property(Object *p_object, const StringName &p_property, const
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
 		if (psg) {
 
-			if (!psg->setter) {
-				if (r_valid)
-					*r_valid = false;
-				return true; //return true but do nothing
-			}
+			return set_property_setget(p_object, psg, p_value, r_valid);
+		}
 
-			Variant::CallError ce;
+		check = check->inherits_ptr;
+	}
 
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[2] = { &index, &p_value };
-				//p_object->call(psg->setter,arg,2,ce);
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 2, ce);
-				} else {
-					p_object->call(psg->setter, arg, 2, ce);
-				}
+	return false;
+}
 
-			} else {
-				const Variant *arg[1] = { &p_value };
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 1, ce);
-				} else {
-					p_object->call(psg->setter, arg, 1, ce);
-				}
-			}
+bool ClassDB::set_property_setget(Object *p_object, const PropertySetGet *p_setget, const Variant &p_value, bool *r_valid) {
+
+	if (!p_setget->setter) {
+		if (r_valid)
+			*r_valid = false;
+		return true; //return true but do nothing
+	}
 
-			if (r_valid)
-				*r_valid = ce.error == Variant::CallError::CALL_OK;
+	Variant::CallError ce;
 
-			return true;
+	if (p_setget->index >= 0) {
+		Variant index = p_setget->index;
+		const Variant *arg[2] = { &index, &p_value };
+		if (p_setget->_setptr) {
+			p_setget->_setptr->call(p_object, arg, 2, ce);
+		} else {
+			p_object->call(p_setget->setter, arg, 2, ce);
 		}
 
-		check = check->inherits_ptr;
+	} else {
+		const Variant *arg[1] = { &p_value };
+		if (p_setget->_setptr) {
+			p_setget->_setptr->call(p_object, arg, 1, ce);
+		} else {
+			p_object->call(p_setget->setter, arg, 1, ce);
+		}
 	}
 
-	return false;
+	if (r_valid)
+		*r_valid = ce.error == Variant::CallError::CALL_OK;
+
+	return true;
 }
+
 bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 
 	ClassInfo *type = classes.getptr(p_object->get_class_name());
@@ -1137,6 +1142,23 @@ StringName ClassDB::get_property_setter(StringName p_class, const StringName p_p
 	return StringName();
 }
 
+const ClassDB::PropertySetGet *ClassDB::get_property_setget(StringName p_class, const StringName &p_property) {
+
+	ClassInfo *type = classes.getptr(p_class);
+	ClassInfo *check = type;
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+
+			return psg;
+		}
+
+		check = check->inherits_ptr;
+	}
+
+	return NULL;
+}
+
 StringName ClassDB::get_property_getter(StringName p_class, const StringName p_property) {
 
 	ClassInfo *type = classes.getptr(p_class);
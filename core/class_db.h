@@ -336,6 +336,8 @@ public:
 	static Variant::Type get_property_type(const StringName &p_class, const StringName &p_property, bool *r_is_valid = NULL);
 	static StringName get_property_setter(StringName p_class, const StringName p_property);
 	static StringName get_property_getter(StringName p_class, const StringName p_property);
+	static const PropertySetGet *get_property_setget(StringName p_class, const StringName &p_property);
+	static bool set_property_setget(Object *p_object, const PropertySetGet *p_setget, const Variant &p_value, bool *r_valid = NULL);
 
 	static bool has_method(StringName p_class, StringName p_method, bool p_no_inheritance = false);
 	static void set_method_flags(StringName p_class, StringName p_method, int p_flags);
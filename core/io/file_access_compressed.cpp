@@ -30,7 +30,209 @@
 
 #include "file_access_compressed.h"
 
+#include "core/os/os.h"
 #include "core/print_string.h"
+#include "core/project_settings.h"
+#include "core/safe_refcount.h"
+
+int FileAccessCompressed::readahead_blocks = 0;
+
+Mutex *FileAccessCompressed::task_mutex = NULL;
+Semaphore *FileAccessCompressed::task_sem = NULL;
+List<FileAccessCompressed::DecompressTask *> FileAccessCompressed::task_queue;
+Vector<Thread *> FileAccessCompressed::workers;
+bool FileAccessCompressed::workers_exit = false;
+
+void FileAccessCompressed::_decompress_thread(void *p_user) {
+
+	while (true) {
+
+		task_sem->wait();
+
+		task_mutex->lock();
+		if (workers_exit) {
+			task_mutex->unlock();
+			break;
+		}
+		if (task_queue.empty()) {
+			// The task was cancelled before a worker picked it up.
+			task_mutex->unlock();
+			continue;
+		}
+		DecompressTask *task = task_queue.front()->get();
+		task_queue.pop_front();
+		task_mutex->unlock();
+
+		Compression::decompress(task->dst, task->dst_size, task->src, task->src_size, task->mode);
+
+		// Signal under the lock, so the owner can't free the semaphore while it's being posted.
+		task_mutex->lock();
+		task->done = true;
+		task->done_sem->post();
+		task_mutex->unlock();
+	}
+}
+
+void FileAccessCompressed::setup() {
+
+#ifndef NO_THREADS
+	task_mutex = Mutex::create();
+	task_sem = Semaphore::create();
+#endif
+}
+
+void FileAccessCompressed::cleanup() {
+
+	if (!task_mutex)
+		return;
+
+	task_mutex->lock();
+	workers_exit = true;
+	task_mutex->unlock();
+
+	for (int i = 0; i < workers.size(); i++) {
+		task_sem->post();
+	}
+	for (int i = 0; i < workers.size(); i++) {
+		Thread::wait_to_finish(workers[i]);
+		memdelete(workers[i]);
+	}
+	workers.clear();
+
+	memdelete(task_sem);
+	task_sem = NULL;
+	memdelete(task_mutex);
+	task_mutex = NULL;
+}
+
+const uint8_t *FileAccessCompressed::_read_block_data(int p_block) const {
+
+	// Sources that can hand out views (like mapped packs) are decompressed in place.
+	const uint8_t *view = f->get_buffer_view(read_blocks[p_block].csize);
+	if (view)
+		return view;
+
+	f->get_buffer(comp_buffer.ptrw(), read_blocks[p_block].csize);
+	return comp_buffer.ptr();
+}
+
+void FileAccessCompressed::_wait_task(DecompressTask &p_task) const {
+
+	while (!p_task.done) {
+		readahead_sem->wait();
+	}
+	atomic_memory_barrier();
+}
+
+void FileAccessCompressed::_cancel_readahead() const {
+
+	if (!readahead_count)
+		return;
+
+	task_mutex->lock();
+	for (int i = 0; i < readahead_count; i++) {
+		if (readahead[i].block != -1 && !readahead[i].done && task_queue.erase(&readahead[i])) {
+			readahead[i].done = true;
+		}
+	}
+	task_mutex->unlock();
+
+	for (int i = 0; i < readahead_count; i++) {
+		if (readahead[i].block != -1) {
+			_wait_task(readahead[i]);
+			readahead[i].block = -1;
+		}
+	}
+}
+
+void FileAccessCompressed::_queue_readahead(int p_from) const {
+
+	if (!readahead_count)
+		return;
+
+	int to = MIN(p_from + readahead_count, read_block_count);
+
+	for (int b = p_from; b < to; b++) {
+
+		DecompressTask *task = NULL;
+		bool queued = false;
+		for (int i = 0; i < readahead_count; i++) {
+			int tb = readahead[i].block;
+			if (tb == b) {
+				queued = true;
+				break;
+			}
+			if (!task && (tb == -1 || tb < p_from || tb >= to)) {
+				task = &readahead[i];
+			}
+		}
+
+		if (queued)
+			continue;
+		if (!task)
+			break;
+
+		if (task->block != -1) {
+			_wait_task(*task); // left behind by a forward seek
+		}
+
+		task->block = b;
+		task->mode = cmode;
+		task->src_size = read_blocks[b].csize;
+		task->dst_size = read_blocks.size() == 1 ? read_total : block_size;
+		task->data.resize(block_size);
+		task->dst = task->data.ptrw();
+
+		f->seek(read_blocks[b].offset);
+		task->src = f->get_buffer_view(task->src_size);
+		if (!task->src) {
+			task->comp.resize(task->src_size);
+			f->get_buffer(task->comp.ptrw(), task->src_size);
+			task->src = task->comp.ptr();
+		}
+
+		task->done = false;
+
+		task_mutex->lock();
+		task_queue.push_back(task);
+		task_mutex->unlock();
+		task_sem->post();
+	}
+}
+
+void FileAccessCompressed::_load_block(int p_block) const {
+
+	DecompressTask *task = NULL;
+	for (int i = 0; i < readahead_count; i++) {
+		if (readahead[i].block == p_block) {
+			task = &readahead[i];
+			break;
+		}
+	}
+
+	if (task) {
+
+		_wait_task(*task);
+		// Swap rather than copy, so both vectors keep a single reference and stay writable.
+		Vector<uint8_t> old = buffer;
+		buffer = task->data;
+		task->data = old;
+		task->block = -1;
+
+	} else {
+
+		_cancel_readahead();
+		f->seek(read_blocks[p_block].offset);
+		const uint8_t *comp_data = _read_block_data(p_block);
+		Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_data, read_blocks[p_block].csize, cmode);
+	}
+
+	read_ptr = buffer.ptr();
+	read_block = p_block;
+	read_block_size = p_block == read_block_count - 1 ? read_total % block_size : block_size;
+
+	_queue_readahead(p_block + 1);
+}
 
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, int p_block_size) {
 
@@ -43,6 +245,9 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 	}
 
 	cmode = p_mode;
+	if (p_block_size <= 0) {
+		p_block_size = ProjectSettings::get_singleton() ? int(GLOBAL_GET("compression/formats/block_size")) : 4096;
+	}
 	block_size = p_block_size;
 }
 
@@ -79,15 +284,36 @@ Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
-	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
 
-	Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
+	if (bc > 1 && task_mutex) {
+
+		task_mutex->lock();
+		if (workers.empty() && !workers_exit && ProjectSettings::get_singleton()) {
+			readahead_blocks = GLOBAL_GET("compression/formats/readahead_blocks");
+			if (readahead_blocks > 0) {
+				int worker_count = CLAMP(OS::get_singleton()->get_processor_count() - 1, 1, 8);
+				for (int i = 0; i < worker_count; i++) {
+					workers.push_back(Thread::create(_decompress_thread, NULL));
+				}
+			}
+		}
+		task_mutex->unlock();
+	}
+
+	if (readahead_blocks > 0 && bc > 1 && task_mutex) {
+
+		readahead_count = MIN(readahead_blocks, bc - 1);
+		readahead = memnew_arr(DecompressTask, readahead_count);
+		readahead_sem = Semaphore::create();
+		for (int i = 0; i < readahead_count; i++) {
+			readahead[i].done_sem = readahead_sem;
+		}
+	}
+
+	_load_block(0);
 	read_pos = 0;
 
 	return OK;
@@ -179,6 +405,19 @@ void FileAccessCompressed::close() {
 
 	} else {
 
+		if (readahead_count) {
+			_cancel_readahead();
+			// Workers post while holding the lock, make sure the last one is done with the semaphore.
+			task_mutex->lock();
+			task_mutex->unlock();
+
+			memdelete_arr(readahead);
+			readahead = NULL;
+			readahead_count = 0;
+			memdelete(readahead_sem);
+			readahead_sem = NULL;
+		}
+
 		comp_buffer.clear();
 		buffer.clear();
 		read_blocks.clear();
@@ -212,11 +451,7 @@ void FileAccessCompressed::seek(size_t p_position) {
 			int block_idx = p_position / block_size;
 			if (block_idx != read_block) {
 
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_load_block(block_idx);
 			}
 
 			read_pos = p_position % block_size;
@@ -284,10 +519,7 @@ uint8_t FileAccessCompressed::get_8() const {
 		read_block++;
 
 		if (read_block < read_block_count) {
-			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+			_load_block(read_block);
 			read_pos = 0;
 
 		} else {
@@ -316,10 +548,7 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const {
 			read_block++;
 
 			if (read_block < read_block_count) {
-				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_load_block(read_block);
 				read_pos = 0;
 
 			} else {
@@ -389,7 +618,10 @@ FileAccessCompressed::FileAccessCompressed() :
 		read_pos(0),
 		read_total(0),
 		magic("GCMP"),
-		f(NULL) {
+		f(NULL),
+		readahead(NULL),
+		readahead_count(0),
+		readahead_sem(NULL) {
 }
 
 FileAccessCompressed::~FileAccessCompressed() {
@@ -32,7 +32,11 @@
 #define FILE_ACCESS_COMPRESSED_H
 
 #include "core/io/compression.h"
+#include "core/list.h"
 #include "core/os/file_access.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 
 class FileAccessCompressed : public FileAccess {
 
@@ -52,7 +56,7 @@ class FileAccessCompressed : public FileAccess {
 	};
 
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr;
+	mutable const uint8_t *read_ptr;
 	mutable int read_block;
 	int read_block_count;
 	mutable int read_block_size;
@@ -64,8 +68,56 @@ class FileAccessCompressed : public FileAccess {
 	mutable Vector<uint8_t> buffer;
 	FileAccess *f;
 
+	// While reading, the blocks after the current one are decompressed ahead
+	// of time by a shared pool of worker threads.
+	struct DecompressTask {
+		int block; // -1 when unused
+		const uint8_t *src;
+		int src_size;
+		uint8_t *dst;
+		int dst_size;
+		Compression::Mode mode;
+		Vector<uint8_t> comp; // owns the compressed data when the source can't provide a view
+		Vector<uint8_t> data;
+		Semaphore *done_sem;
+		volatile bool done;
+
+		DecompressTask() :
+				block(-1),
+				src(NULL),
+				src_size(0),
+				dst(NULL),
+				dst_size(0),
+				mode(Compression::MODE_ZSTD),
+				done_sem(NULL),
+				done(true) {}
+	};
+
+	mutable DecompressTask *readahead;
+	int readahead_count;
+	Semaphore *readahead_sem;
+
+	static Mutex *task_mutex;
+	static Semaphore *task_sem;
+	static List<DecompressTask *> task_queue;
+	static Vector<Thread *> workers;
+	static bool workers_exit;
+
+	static void _decompress_thread(void *p_user);
+
+	const uint8_t *_read_block_data(int p_block) const;
+	void _load_block(int p_block) const;
+	void _queue_readahead(int p_from) const;
+	void _wait_task(DecompressTask &p_task) const;
+	void _cancel_readahead() const;
+
+	static int readahead_blocks;
+
 public:
-	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, int p_block_size = 4096);
+	static void setup();
+	static void cleanup();
+
+	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, int p_block_size = 0); ///< a block size of 0 uses the project default
 
 	Error open_after_magic(FileAccess *p_base);
 
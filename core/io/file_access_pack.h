@@ -127,9 +127,20 @@ public:
 
 class PackedSourcePCK : public PackSource {
 
+	struct MappedPack {
+		const uint8_t *data;
+		uint64_t size;
+	};
+
+	// Packs on the native filesystem are memory mapped when the OS supports it,
+	// so their files are read straight from the mapping instead of through syscalls.
+	Map<String, MappedPack> mapped_packs;
+
 public:
 	virtual bool try_open_pack(const String &p_path);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -140,6 +151,7 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *data; // start of the file in a mapped pack, NULL when reading through f
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 
@@ -157,6 +169,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_buffer_view(int p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -169,7 +182,7 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_data = NULL);
 	~FileAccessPack();
 };
 
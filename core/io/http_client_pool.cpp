@@ -0,0 +1,610 @@
+/*************************************************************************/
+/*  http_client_pool.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "http_client_pool.h"
+
+#include "core/os/os.h"
+
+Error HTTPClientPool::_parse_url(const String &p_url, String &r_host, int &r_port, bool &r_ssl, String &r_path) {
+
+	String url = p_url;
+	r_ssl = false;
+	r_port = 80;
+
+	String url_lower = url.to_lower();
+	if (url_lower.begins_with("http://")) {
+		url = url.substr(7, url.length() - 7);
+	} else if (url_lower.begins_with("https://")) {
+		url = url.substr(8, url.length() - 8);
+		r_ssl = true;
+		r_port = 443;
+	} else {
+		ERR_EXPLAIN("Malformed URL");
+		ERR_FAIL_V(ERR_INVALID_PARAMETER);
+	}
+
+	if (url.length() < 1) {
+		ERR_EXPLAIN("URL too short");
+		ERR_FAIL_V(ERR_INVALID_PARAMETER);
+	}
+
+	int slash_pos = url.find("/");
+	if (slash_pos != -1) {
+		r_path = url.substr(slash_pos, url.length());
+		url = url.substr(0, slash_pos);
+	} else {
+		r_path = "/";
+	}
+
+	int colon_pos = url.find(":");
+	if (colon_pos != -1) {
+		r_port = url.substr(colon_pos + 1, url.length()).to_int();
+		url = url.substr(0, colon_pos);
+		ERR_FAIL_COND_V(r_port < 1 || r_port > 65535, ERR_INVALID_PARAMETER);
+	}
+
+	r_host = url;
+	return OK;
+}
+
+bool HTTPClientPool::_is_idempotent(HTTPClient::Method p_method) {
+
+	return p_method != HTTPClient::METHOD_POST && p_method != HTTPClient::METHOD_PATCH && p_method != HTTPClient::METHOD_CONNECT;
+}
+
+HTTPClientPool::Connection *HTTPClientPool::_get_connection(const Request *p_request, bool &r_limited) {
+
+	int count = 0;
+	for (List<Connection *>::Element *E = connections.front(); E; E = E->next()) {
+
+		Connection *c = E->get();
+		if (c->host_key != p_request->host_key)
+			continue;
+
+		if (!c->request && c->client->get_status() == HTTPClient::STATUS_CONNECTED) {
+			c->reused = true;
+			return c;
+		}
+		count++;
+	}
+
+	r_limited = count >= max_connections_per_host;
+	if (r_limited)
+		return NULL;
+
+	Connection *c = memnew(Connection);
+	c->client.instance();
+	c->client->set_blocking_mode(false);
+	c->client->connect_to_host(p_request->host, p_request->port, p_request->ssl, p_request->verify_host);
+	c->host_key = p_request->host_key;
+	c->request = NULL;
+	c->reused = false;
+	c->idle_since = 0;
+	connections.push_back(c);
+	return c;
+}
+
+void HTTPClientPool::_finish(Connection *p_connection, int p_result) {
+
+	Request *r = p_connection->request;
+
+	Event ev;
+	ev.id = r->id;
+	ev.chunk = false;
+	ev.result = p_result;
+	ev.response_code = p_connection->response_code;
+	ev.headers = p_connection->response_headers;
+	ev.data = p_connection->response_body;
+	events.push_back(ev);
+
+	memdelete(r);
+	p_connection->request = NULL;
+	p_connection->response_headers = PoolStringArray();
+	p_connection->response_body = PoolByteArray();
+	p_connection->idle_since = OS::get_singleton()->get_ticks_msec();
+
+	if (p_result != RESULT_SUCCESS || !p_connection->keep_alive) {
+		p_connection->client->close(); // Not reusable, dropped by the next _process().
+	}
+}
+
+bool HTTPClientPool::_retry(Connection *p_connection) {
+
+	// A kept-alive connection may have been closed by the server while idle.
+	// Safe requests are sent again once, over a new connection.
+	Request *r = p_connection->request;
+	if (!p_connection->reused || r->retried || !_is_idempotent(r->method))
+		return false;
+
+	r->retried = true;
+	p_connection->reused = false;
+	p_connection->sent = false;
+	p_connection->got_response = false;
+	p_connection->client->close();
+	p_connection->client->connect_to_host(r->host, r->port, r->ssl, r->verify_host);
+	return true;
+}
+
+bool HTTPClientPool::_update_connection(Connection *p_connection) {
+
+	Connection *c = p_connection;
+	Request *r = c->request;
+
+	if (timeout > 0 && OS::get_singleton()->get_ticks_msec() - r->start_time > (uint64_t)timeout) {
+		_finish(c, RESULT_TIMEOUT);
+		c->client->close();
+		return true;
+	}
+
+	c->client->poll();
+	HTTPClient::Status status = c->client->get_status();
+
+	if (!c->sent) {
+
+		switch (status) {
+			case HTTPClient::STATUS_RESOLVING:
+			case HTTPClient::STATUS_CONNECTING: {
+				return false;
+			}
+			case HTTPClient::STATUS_CANT_RESOLVE: {
+				_finish(c, RESULT_CANT_RESOLVE);
+				return true;
+			}
+			case HTTPClient::STATUS_SSL_HANDSHAKE_ERROR: {
+				_finish(c, RESULT_SSL_HANDSHAKE_ERROR);
+				return true;
+			}
+			case HTTPClient::STATUS_CONNECTED: {
+				Error err = c->client->request_raw(r->method, r->path, r->headers, r->body);
+				if (err != OK) {
+					if (!_retry(c))
+						_finish(c, RESULT_REQUEST_FAILED);
+					return true;
+				}
+				c->sent = true;
+				c->got_response = false;
+				c->response_code = 0;
+				c->body_length = -1;
+				c->downloaded = 0;
+				c->keep_alive = true;
+				return true;
+			}
+			default: {
+				if (!_retry(c))
+					_finish(c, status == HTTPClient::STATUS_CONNECTION_ERROR ? RESULT_CONNECTION_ERROR : RESULT_CANT_CONNECT);
+				return true;
+			}
+		}
+	}
+
+	if (status == HTTPClient::STATUS_REQUESTING)
+		return false;
+
+	if (!c->got_response) {
+
+		if (!c->client->has_response()) {
+			if (!_retry(c))
+				_finish(c, status == HTTPClient::STATUS_CONNECTION_ERROR ? RESULT_CONNECTION_ERROR : RESULT_NO_RESPONSE);
+			return true;
+		}
+
+		c->got_response = true;
+		c->response_code = c->client->get_response_code();
+		c->body_length = c->client->get_response_body_length();
+
+		List<String> headers;
+		c->client->get_response_headers(&headers);
+		c->response_headers.resize(0);
+		for (List<String>::Element *E = headers.front(); E; E = E->next()) {
+			c->response_headers.push_back(E->get());
+			if (E->get().to_lower().begins_with("connection: close"))
+				c->keep_alive = false;
+		}
+
+		if (body_size_limit >= 0 && c->body_length > body_size_limit) {
+			_finish(c, RESULT_BODY_SIZE_LIMIT_EXCEEDED);
+			return true;
+		}
+	}
+
+	bool busy = false;
+
+	while (c->client->get_status() == HTTPClient::STATUS_BODY) {
+
+		PoolByteArray chunk = c->client->read_response_body_chunk();
+		if (chunk.size() == 0)
+			break;
+
+		busy = true;
+		c->downloaded += chunk.size();
+
+		if (body_size_limit >= 0 && c->downloaded > body_size_limit) {
+			_finish(c, RESULT_BODY_SIZE_LIMIT_EXCEEDED);
+			return true;
+		}
+
+		if (r->stream) {
+			Event ev;
+			ev.id = r->id;
+			ev.chunk = true;
+			ev.result = RESULT_SUCCESS;
+			ev.response_code = c->response_code;
+			ev.data = chunk;
+			events.push_back(ev);
+		} else {
+			c->response_body.append_array(chunk);
+		}
+	}
+
+	status = c->client->get_status();
+
+	if (status == HTTPClient::STATUS_BODY)
+		return busy;
+
+	if (status == HTTPClient::STATUS_CONNECTED) {
+		_finish(c, RESULT_SUCCESS);
+	} else if (status == HTTPClient::STATUS_DISCONNECTED && (c->body_length < 0 || c->downloaded >= c->body_length)) {
+		// Body delimited by the server closing the connection.
+		c->keep_alive = false;
+		_finish(c, RESULT_SUCCESS);
+	} else {
+		_finish(c, RESULT_CONNECTION_ERROR);
+	}
+	return true;
+}
+
+bool HTTPClientPool::_process() {
+
+	MutexLock lock(mutex);
+
+	bool busy = false;
+
+	for (List<Request *>::Element *E = queue.front(); E;) {
+
+		List<Request *>::Element *N = E->next();
+		Request *r = E->get();
+
+		if (timeout > 0 && OS::get_singleton()->get_ticks_msec() - r->start_time > (uint64_t)timeout) {
+			Event ev;
+			ev.id = r->id;
+			ev.chunk = false;
+			ev.result = RESULT_TIMEOUT;
+			ev.response_code = 0;
+			events.push_back(ev);
+			memdelete(r);
+			queue.erase(E);
+			busy = true;
+		} else {
+			bool limited = false;
+			Connection *c = _get_connection(r, limited);
+			if (c) {
+				c->request = r;
+				c->sent = false;
+				c->got_response = false;
+				queue.erase(E);
+				busy = true;
+			}
+		}
+		E = N;
+	}
+
+	uint64_t now = OS::get_singleton()->get_ticks_msec();
+
+	for (List<Connection *>::Element *E = connections.front(); E;) {
+
+		List<Connection *>::Element *N = E->next();
+		Connection *c = E->get();
+
+		if (c->request) {
+			busy = _update_connection(c) || busy;
+		} else if (c->client->get_status() != HTTPClient::STATUS_CONNECTED || now - c->idle_since > (uint64_t)keep_alive_timeout) {
+			c->client->close();
+			memdelete(c);
+			connections.erase(E);
+		}
+		E = N;
+	}
+
+	return busy;
+}
+
+void HTTPClientPool::_thread_func(void *p_userdata) {
+
+	HTTPClientPool *pool = (HTTPClientPool *)p_userdata;
+
+	while (!pool->thread_quit) {
+		if (!pool->_process())
+			OS::get_singleton()->delay_usec(1000); // Only waiting on the network.
+	}
+}
+
+void HTTPClientPool::_start_thread() {
+
+	thread_quit = false;
+	thread = Thread::create(_thread_func, this);
+}
+
+void HTTPClientPool::_stop_thread() {
+
+	if (!thread)
+		return;
+
+	thread_quit = true;
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	thread = NULL;
+}
+
+int HTTPClientPool::request(const String &p_url, const Vector<String> &p_headers, HTTPClient::Method p_method, const PoolVector<uint8_t> &p_body, bool p_stream) {
+
+	String host;
+	String path;
+	int port;
+	bool ssl;
+	Error err = _parse_url(p_url, host, port, ssl, path);
+	ERR_FAIL_COND_V(err != OK, -1);
+
+	Request *r = memnew(Request);
+	r->host = host;
+	r->port = port;
+	r->ssl = ssl;
+	r->verify_host = true;
+	r->host_key = (ssl ? "https://" : "http://") + host + ":" + itos(port);
+	r->path = path;
+	r->method = p_method;
+	r->headers = p_headers;
+	r->body = p_body;
+	r->stream = p_stream;
+	r->retried = false;
+	r->start_time = OS::get_singleton()->get_ticks_msec();
+
+	MutexLock lock(mutex);
+	r->id = ++last_id;
+	queue.push_back(r);
+	return r->id;
+}
+
+void HTTPClientPool::cancel_request(int p_id) {
+
+	MutexLock lock(mutex);
+
+	for (List<Request *>::Element *E = queue.front(); E; E = E->next()) {
+		if (E->get()->id == p_id) {
+			memdelete(E->get());
+			queue.erase(E);
+			break;
+		}
+	}
+
+	for (List<Connection *>::Element *E = connections.front(); E; E = E->next()) {
+		Connection *c = E->get();
+		if (c->request && c->request->id == p_id) {
+			// The response is partially read, the connection can't be reused.
+			memdelete(c->request);
+			c->request = NULL;
+			c->client->close();
+			break;
+		}
+	}
+
+	for (List<Event>::Element *E = events.front(); E;) {
+		List<Event>::Element *N = E->next();
+		if (E->get().id == p_id)
+			events.erase(E);
+		E = N;
+	}
+}
+
+void HTTPClientPool::poll() {
+
+	if (!use_threads)
+		_process();
+
+	List<Event> ready;
+	{
+		MutexLock lock(mutex);
+		ready = events;
+		events.clear();
+	}
+
+	for (List<Event>::Element *E = ready.front(); E; E = E->next()) {
+		const Event &ev = E->get();
+		if (ev.chunk) {
+			emit_signal("body_chunk_received", ev.id, ev.data);
+		} else {
+			emit_signal("request_completed", ev.id, ev.result, ev.response_code, ev.headers, ev.data);
+		}
+	}
+}
+
+void HTTPClientPool::close_connections() {
+
+	MutexLock lock(mutex);
+
+	for (List<Connection *>::Element *E = connections.front(); E;) {
+		List<Connection *>::Element *N = E->next();
+		Connection *c = E->get();
+		if (!c->request) {
+			c->client->close();
+			memdelete(c);
+			connections.erase(E);
+		}
+		E = N;
+	}
+}
+
+int HTTPClientPool::get_pending_request_count() const {
+
+	MutexLock lock(mutex);
+
+	int count = queue.size();
+	for (const List<Connection *>::Element *E = connections.front(); E; E = E->next()) {
+		if (E->get()->request)
+			count++;
+	}
+	return count;
+}
+
+int HTTPClientPool::get_connection_count() const {
+
+	MutexLock lock(mutex);
+	return connections.size();
+}
+
+void HTTPClientPool::set_use_threads(bool p_use) {
+
+	if (p_use == use_threads)
+		return;
+
+	_stop_thread();
+	use_threads = p_use;
+	if (use_threads)
+		_start_thread();
+}
+
+bool HTTPClientPool::is_using_threads() const {
+
+	return use_threads;
+}
+
+void HTTPClientPool::set_max_connections_per_host(int p_max) {
+
+	ERR_FAIL_COND(p_max < 1);
+	max_connections_per_host = p_max;
+}
+
+int HTTPClientPool::get_max_connections_per_host() const {
+
+	return max_connections_per_host;
+}
+
+void HTTPClientPool::set_keep_alive_timeout(int p_msec) {
+
+	keep_alive_timeout = p_msec;
+}
+
+int HTTPClientPool::get_keep_alive_timeout() const {
+
+	return keep_alive_timeout;
+}
+
+void HTTPClientPool::set_timeout(int p_msec) {
+
+	timeout = p_msec;
+}
+
+int HTTPClientPool::get_timeout() const {
+
+	return timeout;
+}
+
+void HTTPClientPool::set_body_size_limit(int p_bytes) {
+
+	body_size_limit = p_bytes;
+}
+
+int HTTPClientPool::get_body_size_limit() const {
+
+	return body_size_limit;
+}
+
+void HTTPClientPool::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("request", "url", "custom_headers", "method", "body", "stream"), &HTTPClientPool::request, DEFVAL(PoolStringArray()), DEFVAL(HTTPClient::METHOD_GET), DEFVAL(PoolByteArray()), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("cancel_request", "id"), &HTTPClientPool::cancel_request);
+	ClassDB::bind_method(D_METHOD("poll"), &HTTPClientPool::poll);
+	ClassDB::bind_method(D_METHOD("close_connections"), &HTTPClientPool::close_connections);
+	ClassDB::bind_method(D_METHOD("get_pending_request_count"), &HTTPClientPool::get_pending_request_count);
+	ClassDB::bind_method(D_METHOD("get_connection_count"), &HTTPClientPool::get_connection_count);
+
+	ClassDB::bind_method(D_METHOD("set_use_threads", "enable"), &HTTPClientPool::set_use_threads);
+	ClassDB::bind_method(D_METHOD("is_using_threads"), &HTTPClientPool::is_using_threads);
+	ClassDB::bind_method(D_METHOD("set_max_connections_per_host", "max"), &HTTPClientPool::set_max_connections_per_host);
+	ClassDB::bind_method(D_METHOD("get_max_connections_per_host"), &HTTPClientPool::get_max_connections_per_host);
+	ClassDB::bind_method(D_METHOD("set_keep_alive_timeout", "msec"), &HTTPClientPool::set_keep_alive_timeout);
+	ClassDB::bind_method(D_METHOD("get_keep_alive_timeout"), &HTTPClientPool::get_keep_alive_timeout);
+	ClassDB::bind_method(D_METHOD("set_timeout", "msec"), &HTTPClientPool::set_timeout);
+	ClassDB::bind_method(D_METHOD("get_timeout"), &HTTPClientPool::get_timeout);
+	ClassDB::bind_method(D_METHOD("set_body_size_limit", "bytes"), &HTTPClientPool::set_body_size_limit);
+	ClassDB::bind_method(D_METHOD("get_body_size_limit"), &HTTPClientPool::get_body_size_limit);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_threads"), "set_use_threads", "is_using_threads");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_connections_per_host", PROPERTY_HINT_RANGE, "1,64,1"), "set_max_connections_per_host", "get_max_connections_per_host");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "keep_alive_timeout"), "set_keep_alive_timeout", "get_keep_alive_timeout");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "timeout"), "set_timeout", "get_timeout");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "body_size_limit", PROPERTY_HINT_RANGE, "-1,2000000000"), "set_body_size_limit", "get_body_size_limit");
+
+	ADD_SIGNAL(MethodInfo("request_completed", PropertyInfo(Variant::INT, "id"), PropertyInfo(Variant::INT, "result"), PropertyInfo(Variant::INT, "response_code"), PropertyInfo(Variant::POOL_STRING_ARRAY, "headers"), PropertyInfo(Variant::POOL_BYTE_ARRAY, "body")));
+	ADD_SIGNAL(MethodInfo("body_chunk_received", PropertyInfo(Variant::INT, "id"), PropertyInfo(Variant::POOL_BYTE_ARRAY, "chunk")));
+
+	BIND_ENUM_CONSTANT(RESULT_SUCCESS);
+	BIND_ENUM_CONSTANT(RESULT_CANT_CONNECT);
+	BIND_ENUM_CONSTANT(RESULT_CANT_RESOLVE);
+	BIND_ENUM_CONSTANT(RESULT_CONNECTION_ERROR);
+	BIND_ENUM_CONSTANT(RESULT_SSL_HANDSHAKE_ERROR);
+	BIND_ENUM_CONSTANT(RESULT_NO_RESPONSE);
+	BIND_ENUM_CONSTANT(RESULT_BODY_SIZE_LIMIT_EXCEEDED);
+	BIND_ENUM_CONSTANT(RESULT_REQUEST_FAILED);
+	BIND_ENUM_CONSTANT(RESULT_TIMEOUT);
+}
+
+HTTPClientPool::HTTPClientPool() {
+
+	mutex = Mutex::create();
+	thread = NULL;
+	thread_quit = false;
+	use_threads = false;
+	last_id = 0;
+	max_connections_per_host = 4;
+	keep_alive_timeout = 30000;
+	timeout = 0;
+	body_size_limit = -1;
+}
+
+HTTPClientPool::~HTTPClientPool() {
+
+	_stop_thread();
+
+	while (queue.size()) {
+		memdelete(queue.front()->get());
+		queue.pop_front();
+	}
+
+	while (connections.size()) {
+		Connection *c = connections.front()->get();
+		if (c->request)
+			memdelete(c->request);
+		c->client->close();
+		memdelete(c);
+		connections.pop_front();
+	}
+
+	memdelete(mutex);
+}
@@ -0,0 +1,164 @@
+/*************************************************************************/
+/*  http_client_pool.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef HTTP_CLIENT_POOL_H
+#define HTTP_CLIENT_POOL_H
+
+#include "core/io/http_client.h"
+#include "core/list.h"
+#include "core/map.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/reference.h"
+
+// Runs many HTTP requests concurrently over keep-alive connections, reused per host.
+// Requests are driven either by poll() or by a single I/O thread; results are always
+// delivered as signals from poll().
+class HTTPClientPool : public Reference {
+
+	GDCLASS(HTTPClientPool, Reference);
+
+public:
+	enum Result {
+		RESULT_SUCCESS,
+		RESULT_CANT_CONNECT,
+		RESULT_CANT_RESOLVE,
+		RESULT_CONNECTION_ERROR,
+		RESULT_SSL_HANDSHAKE_ERROR,
+		RESULT_NO_RESPONSE,
+		RESULT_BODY_SIZE_LIMIT_EXCEEDED,
+		RESULT_REQUEST_FAILED,
+		RESULT_TIMEOUT,
+	};
+
+private:
+	struct Request {
+		int id;
+		String host_key;
+		String host;
+		int port;
+		bool ssl;
+		bool verify_host;
+		String path;
+		HTTPClient::Method method;
+		Vector<String> headers;
+		PoolVector<uint8_t> body;
+		bool stream;
+		bool retried;
+		uint64_t start_time;
+	};
+
+	struct Connection {
+		Ref<HTTPClient> client;
+		String host_key;
+		Request *request; // NULL while idle.
+		bool reused;
+		bool sent;
+		bool got_response;
+		int response_code;
+		PoolStringArray response_headers;
+		PoolByteArray response_body;
+		int body_length;
+		int downloaded;
+		bool keep_alive;
+		uint64_t idle_since;
+	};
+
+	struct Event {
+		int id;
+		bool chunk;
+		int result;
+		int response_code;
+		PoolStringArray headers;
+		PoolByteArray data;
+	};
+
+	Mutex *mutex;
+	Thread *thread;
+	volatile bool thread_quit;
+	bool use_threads;
+
+	List<Request *> queue;
+	List<Connection *> connections;
+	List<Event> events;
+	int last_id;
+
+	int max_connections_per_host;
+	int keep_alive_timeout;
+	int timeout;
+	int body_size_limit;
+
+	static Error _parse_url(const String &p_url, String &r_host, int &r_port, bool &r_ssl, String &r_path);
+	static bool _is_idempotent(HTTPClient::Method p_method);
+
+	Connection *_get_connection(const Request *p_request, bool &r_limited);
+	void _finish(Connection *p_connection, int p_result);
+	bool _retry(Connection *p_connection);
+	bool _update_connection(Connection *p_connection);
+	bool _process();
+
+	void _start_thread();
+	void _stop_thread();
+	static void _thread_func(void *p_userdata);
+
+protected:
+	static void _bind_methods();
+
+public:
+	int request(const String &p_url, const Vector<String> &p_headers = Vector<String>(), HTTPClient::Method p_method = HTTPClient::METHOD_GET, const PoolVector<uint8_t> &p_body = PoolVector<uint8_t>(), bool p_stream = false);
+	void cancel_request(int p_id);
+	void poll();
+	void close_connections();
+
+	int get_pending_request_count() const;
+	int get_connection_count() const;
+
+	void set_use_threads(bool p_use);
+	bool is_using_threads() const;
+
+	void set_max_connections_per_host(int p_max);
+	int get_max_connections_per_host() const;
+
+	void set_keep_alive_timeout(int p_msec);
+	int get_keep_alive_timeout() const;
+
+	void set_timeout(int p_msec);
+	int get_timeout() const;
+
+	void set_body_size_limit(int p_bytes);
+	int get_body_size_limit() const;
+
+	HTTPClientPool();
+	~HTTPClientPool();
+};
+
+VARIANT_ENUM_CAST(HTTPClientPool::Result);
+
+#endif // HTTP_CLIENT_POOL_H
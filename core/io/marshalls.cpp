@@ -81,9 +81,7 @@ static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r
 	ERR_FAIL_ADD_OF(strlen, pad, ERR_FILE_EOF);
 	ERR_FAIL_COND_V(strlen < 0 || strlen + pad > len, ERR_FILE_EOF);
 
-	String str;
-	ERR_FAIL_COND_V(str.parse_utf8((const char *)buf, strlen), ERR_INVALID_DATA);
-	r_string = str;
+	ERR_FAIL_COND_V(r_string.parse_utf8((const char *)buf, strlen), ERR_INVALID_DATA);
 
 	// Add padding
 	strlen += pad;
@@ -98,7 +96,18 @@ static Error _decode_string(const uint8_t *&buf, int &len, int *r_len, String &r
 	return OK;
 }
 
-Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
+// When reusing, takes the value out of r_variant if it already holds the
+// requested type, so the caller can write into its storage without copying it.
+template <class T>
+static _FORCE_INLINE_ void _take_reusable(Variant &r_variant, Variant::Type p_type, T &r_value, bool p_reuse) {
+
+	if (p_reuse && r_variant.get_type() == p_type) {
+		r_value = r_variant;
+		r_variant = Variant();
+	}
+}
+
+static Error _decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects, bool p_reuse) {
 
 	const uint8_t *buf = p_buffer;
 	int len = p_len;
@@ -169,6 +178,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 		case Variant::STRING: {
 
 			String str;
+			_take_reusable(r_variant, Variant::STRING, str, p_reuse);
 			Error err = _decode_string(buf, len, r_len, str);
 			if (err)
 				return err;
@@ -439,7 +449,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 						Variant value;
 						int used;
-						err = decode_variant(value, buf, len, &used, p_allow_objects);
+						err = _decode_variant(value, buf, len, &used, p_allow_objects, false);
 						if (err)
 							return err;
 
@@ -480,10 +490,10 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 
 			for (int i = 0; i < count; i++) {
 
-				Variant key, value;
+				Variant key;
 
 				int used;
-				Error err = decode_variant(key, buf, len, &used, p_allow_objects);
+				Error err = _decode_variant(key, buf, len, &used, p_allow_objects, false);
 				ERR_FAIL_COND_V(err, err);
 
 				buf += used;
@@ -492,7 +502,7 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 					(*r_len) += used;
 				}
 
-				err = decode_variant(value, buf, len, &used, p_allow_objects);
+				err = _decode_variant(d[key], buf, len, &used, p_allow_objects, false);
 				ERR_FAIL_COND_V(err, err);
 
 				buf += used;
@@ -500,8 +510,6 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				if (r_len) {
 					(*r_len) += used;
 				}
-
-				d[key] = value;
 			}
 
 			r_variant = d;
@@ -521,17 +529,20 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 				(*r_len) += 4;
 			}
 
+			// Every element takes at least 4 bytes, don't allocate for more than could fit.
+			ERR_FAIL_COND_V(count > len / 4, ERR_INVALID_DATA);
+
 			Array varr;
+			_take_reusable(r_variant, Variant::ARRAY, varr, p_reuse);
+			varr.resize(count);
 
 			for (int i = 0; i < count; i++) {
 
 				int used = 0;
-				Variant v;
-				Error err = decode_variant(v, buf, len, &used, p_allow_objects);
+				Error err = _decode_variant(varr[i], buf, len, &used, p_allow_objects, p_reuse);
 				ERR_FAIL_COND_V(err, err);
 				buf += used;
 				len -= used;
-				varr.push_back(v);
 				if (r_len) {
 					(*r_len) += used;
 				}
@@ -551,9 +562,10 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			ERR_FAIL_COND_V(count < 0 || count > len, ERR_INVALID_DATA);
 
 			PoolVector<uint8_t> data;
+			_take_reusable(r_variant, Variant::POOL_BYTE_ARRAY, data, p_reuse);
+			data.resize(count);
 
 			if (count) {
-				data.resize(count);
 				PoolVector<uint8_t>::Write w = data.write();
 				for (int32_t i = 0; i < count; i++) {
 
@@ -582,10 +594,11 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			ERR_FAIL_COND_V(count < 0 || count * 4 > len, ERR_INVALID_DATA);
 
 			PoolVector<int> data;
+			_take_reusable(r_variant, Variant::POOL_INT_ARRAY, data, p_reuse);
+			data.resize(count);
 
 			if (count) {
 				//const int*rbuf=(const int*)buf;
-				data.resize(count);
 				PoolVector<int>::Write w = data.write();
 				for (int32_t i = 0; i < count; i++) {
 
@@ -610,10 +623,11 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			ERR_FAIL_COND_V(count < 0 || count * 4 > len, ERR_INVALID_DATA);
 
 			PoolVector<float> data;
+			_take_reusable(r_variant, Variant::POOL_REAL_ARRAY, data, p_reuse);
+			data.resize(count);
 
 			if (count) {
 				//const float*rbuf=(const float*)buf;
-				data.resize(count);
 				PoolVector<float>::Write w = data.write();
 				for (int32_t i = 0; i < count; i++) {
 
@@ -665,13 +679,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			ERR_FAIL_MUL_OF(count, 4 * 2, ERR_INVALID_DATA);
 			ERR_FAIL_COND_V(count < 0 || count * 4 * 2 > len, ERR_INVALID_DATA);
 			PoolVector<Vector2> varray;
+			_take_reusable(r_variant, Variant::POOL_VECTOR2_ARRAY, varray, p_reuse);
+			varray.resize(count);
 
 			if (r_len) {
 				(*r_len) += 4;
 			}
 
 			if (count) {
-				varray.resize(count);
 				PoolVector<Vector2>::Write w = varray.write();
 
 				for (int32_t i = 0; i < count; i++) {
@@ -702,13 +717,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			ERR_FAIL_COND_V(count < 0 || count * 4 * 3 > len, ERR_INVALID_DATA);
 
 			PoolVector<Vector3> varray;
+			_take_reusable(r_variant, Variant::POOL_VECTOR3_ARRAY, varray, p_reuse);
+			varray.resize(count);
 
 			if (r_len) {
 				(*r_len) += 4;
 			}
 
 			if (count) {
-				varray.resize(count);
 				PoolVector<Vector3>::Write w = varray.write();
 
 				for (int32_t i = 0; i < count; i++) {
@@ -740,13 +756,14 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 			ERR_FAIL_COND_V(count < 0 || count * 4 * 4 > len, ERR_INVALID_DATA);
 
 			PoolVector<Color> carray;
+			_take_reusable(r_variant, Variant::POOL_COLOR_ARRAY, carray, p_reuse);
+			carray.resize(count);
 
 			if (r_len) {
 				(*r_len) += 4;
 			}
 
 			if (count) {
-				carray.resize(count);
 				PoolVector<Color>::Write w = carray.write();
 
 				for (int32_t i = 0; i < count; i++) {
@@ -774,31 +791,109 @@ Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int
 	return OK;
 }
 
-static void _encode_string(const String &p_string, uint8_t *&buf, int &r_len) {
+Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
 
-	CharString utf8 = p_string.utf8();
+	return _decode_variant(r_variant, p_buffer, p_len, r_len, p_allow_objects, false);
+}
+
+Error decode_variant_reuse(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len, bool p_allow_objects) {
+
+	return _decode_variant(r_variant, p_buffer, p_len, r_len, p_allow_objects, true);
+}
+
+Error decode_variant_bytes(const uint8_t *p_buffer, int p_len, const uint8_t *&r_data, int &r_size, int *r_len) {
+
+	ERR_FAIL_COND_V(p_len < 8, ERR_INVALID_DATA);
+	ERR_FAIL_COND_V((decode_uint32(p_buffer) & ENCODE_MASK) != Variant::POOL_BYTE_ARRAY, ERR_INVALID_DATA);
+
+	int32_t count = decode_uint32(p_buffer + 4);
+	ERR_FAIL_COND_V(count < 0 || count > p_len - 8, ERR_INVALID_DATA);
+
+	r_data = p_buffer + 8;
+	r_size = count;
+	if (r_len) {
+		*r_len = 8 + count;
+		if (count % 4)
+			(*r_len) += 4 - count % 4;
+	}
+
+	return OK;
+}
+
+// Destination for the encoder. Writes either go to a fixed buffer (or nowhere,
+// when only measuring), or to a Vector that grows as needed, so a single pass
+// is enough to encode into it.
+struct VariantEncodeTarget {
 
-	if (buf) {
-		encode_uint32(utf8.length(), buf);
-		buf += 4;
-		copymem(buf, utf8.get_data(), utf8.length());
-		buf += utf8.length();
+	uint8_t *buf;
+	Vector<uint8_t> *growable;
+	int pos;
+
+	// Returns where the next p_bytes should be written, or NULL when measuring.
+	_FORCE_INLINE_ uint8_t *reserve(int p_bytes) {
+
+		uint8_t *ret;
+		if (growable) {
+			if (pos + p_bytes > growable->size()) {
+				growable->resize(pos + p_bytes);
+			}
+			ret = growable->ptrw() + pos;
+		} else {
+			ret = buf ? buf + pos : NULL;
+		}
+		pos += p_bytes;
+		return ret;
+	}
+
+	_FORCE_INLINE_ void put_32(uint32_t p_value) {
+
+		uint8_t *b = reserve(4);
+		if (b)
+			encode_uint32(p_value, b);
 	}
 
-	r_len += 4 + utf8.length();
-	while (r_len % 4) {
-		r_len++; //pad
-		if (buf) {
-			*(buf++) = 0;
+	_FORCE_INLINE_ void put_floats(const real_t *p_values, int p_count) {
+
+		uint8_t *b = reserve(4 * p_count);
+		if (b) {
+			for (int i = 0; i < p_count; i++) {
+				encode_float(p_values[i], &b[i * 4]);
+			}
 		}
 	}
-}
 
-Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects) {
+	// Writes p_len bytes and zero-pads them to a multiple of 4.
+	_FORCE_INLINE_ void put_padded(const uint8_t *p_data, int p_len) {
 
-	uint8_t *buf = r_buffer;
+		int pad = p_len % 4 ? 4 - p_len % 4 : 0;
+		uint8_t *b = reserve(p_len + pad);
+		if (b) {
+			copymem(b, p_data, p_len);
+			for (int i = 0; i < pad; i++) {
+				b[p_len + i] = 0;
+			}
+		}
+	}
+
+	VariantEncodeTarget(uint8_t *p_buf) :
+			buf(p_buf),
+			growable(NULL),
+			pos(0) {}
 
-	r_len = 0;
+	VariantEncodeTarget(Vector<uint8_t> *p_growable, int p_pos) :
+			buf(NULL),
+			growable(p_growable),
+			pos(p_pos) {}
+};
+
+static void _encode_string(const String &p_string, VariantEncodeTarget &w) {
+
+	CharString utf8 = p_string.utf8();
+	w.put_32(utf8.length());
+	w.put_padded((const uint8_t *)utf8.get_data(), utf8.length());
+}
+
+static Error _encode_variant(const Variant &p_variant, VariantEncodeTarget &w, bool p_full_objects) {
 
 	uint32_t flags = 0;
 
@@ -826,11 +921,7 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		default: {} // nothing to do at this stage
 	}
 
-	if (buf) {
-		encode_uint32(p_variant.get_type() | flags, buf);
-		buf += 4;
-	}
-	r_len += 4;
+	w.put_32(p_variant.get_type() | flags);
 
 	switch (p_variant.get_type()) {
 
@@ -840,240 +931,127 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 		} break;
 		case Variant::BOOL: {
 
-			if (buf) {
-				encode_uint32(p_variant.operator bool(), buf);
-			}
-
-			r_len += 4;
+			w.put_32(p_variant.operator bool());
 
 		} break;
 		case Variant::INT: {
 
 			if (flags & ENCODE_FLAG_64) {
 				//64 bits
+				uint8_t *buf = w.reserve(8);
 				if (buf) {
 					encode_uint64(p_variant.operator int64_t(), buf);
 				}
-
-				r_len += 8;
 			} else {
-				if (buf) {
-					encode_uint32(p_variant.operator int32_t(), buf);
-				}
-
-				r_len += 4;
+				w.put_32(p_variant.operator int32_t());
 			}
 		} break;
 		case Variant::REAL: {
 
 			if (flags & ENCODE_FLAG_64) {
+				uint8_t *buf = w.reserve(8);
 				if (buf) {
 					encode_double(p_variant.operator double(), buf);
 				}
-
-				r_len += 8;
-
 			} else {
-
+				uint8_t *buf = w.reserve(4);
 				if (buf) {
 					encode_float(p_variant.operator float(), buf);
 				}
-
-				r_len += 4;
 			}
 
 		} break;
 		case Variant::NODE_PATH: {
 
 			NodePath np = p_variant;
-			if (buf) {
-				encode_uint32(uint32_t(np.get_name_count()) | 0x80000000, buf); //for compatibility with the old format
-				encode_uint32(np.get_subname_count(), buf + 4);
-				uint32_t np_flags = 0;
-				if (np.is_absolute())
-					np_flags |= 1;
-
-				encode_uint32(np_flags, buf + 8);
-
-				buf += 12;
-			}
-
-			r_len += 12;
+			w.put_32(uint32_t(np.get_name_count()) | 0x80000000); //for compatibility with the old format
+			w.put_32(np.get_subname_count());
+			w.put_32(np.is_absolute() ? 1 : 0);
 
 			int total = np.get_name_count() + np.get_subname_count();
 
 			for (int i = 0; i < total; i++) {
 
-				String str;
-
 				if (i < np.get_name_count())
-					str = np.get_name(i);
+					_encode_string(np.get_name(i), w);
 				else
-					str = np.get_subname(i - np.get_name_count());
-
-				CharString utf8 = str.utf8();
-
-				int pad = 0;
-
-				if (utf8.length() % 4)
-					pad = 4 - utf8.length() % 4;
-
-				if (buf) {
-					encode_uint32(utf8.length(), buf);
-					buf += 4;
-					copymem(buf, utf8.get_data(), utf8.length());
-					buf += pad + utf8.length();
-				}
-
-				r_len += 4 + utf8.length() + pad;
+					_encode_string(np.get_subname(i - np.get_name_count()), w);
 			}
 
 		} break;
 		case Variant::STRING: {
 
-			_encode_string(p_variant, buf, r_len);
+			_encode_string(p_variant, w);
 
 		} break;
 
 		// math types
 		case Variant::VECTOR2: {
 
-			if (buf) {
-				Vector2 v2 = p_variant;
-				encode_float(v2.x, &buf[0]);
-				encode_float(v2.y, &buf[4]);
-			}
-
-			r_len += 2 * 4;
+			Vector2 v2 = p_variant;
+			w.put_floats(&v2.x, 2);
 
 		} break; // 5
 		case Variant::RECT2: {
 
-			if (buf) {
-				Rect2 r2 = p_variant;
-				encode_float(r2.position.x, &buf[0]);
-				encode_float(r2.position.y, &buf[4]);
-				encode_float(r2.size.x, &buf[8]);
-				encode_float(r2.size.y, &buf[12]);
-			}
-			r_len += 4 * 4;
+			Rect2 r2 = p_variant;
+			real_t vals[4] = { r2.position.x, r2.position.y, r2.size.x, r2.size.y };
+			w.put_floats(vals, 4);
 
 		} break;
 		case Variant::VECTOR3: {
 
-			if (buf) {
-				Vector3 v3 = p_variant;
-				encode_float(v3.x, &buf[0]);
-				encode_float(v3.y, &buf[4]);
-				encode_float(v3.z, &buf[8]);
-			}
-
-			r_len += 3 * 4;
+			Vector3 v3 = p_variant;
+			w.put_floats(&v3.x, 3);
 
 		} break;
 		case Variant::TRANSFORM2D: {
 
-			if (buf) {
-				Transform2D val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 2; j++) {
-
-						copymem(&buf[(i * 2 + j) * 4], &val.elements[i][j], sizeof(float));
-					}
-				}
-			}
-
-			r_len += 6 * 4;
+			Transform2D val = p_variant;
+			w.put_floats(&val.elements[0][0], 6);
 
 		} break;
 		case Variant::PLANE: {
 
-			if (buf) {
-				Plane p = p_variant;
-				encode_float(p.normal.x, &buf[0]);
-				encode_float(p.normal.y, &buf[4]);
-				encode_float(p.normal.z, &buf[8]);
-				encode_float(p.d, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Plane p = p_variant;
+			real_t vals[4] = { p.normal.x, p.normal.y, p.normal.z, p.d };
+			w.put_floats(vals, 4);
 
 		} break;
 		case Variant::QUAT: {
 
-			if (buf) {
-				Quat q = p_variant;
-				encode_float(q.x, &buf[0]);
-				encode_float(q.y, &buf[4]);
-				encode_float(q.z, &buf[8]);
-				encode_float(q.w, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Quat q = p_variant;
+			real_t vals[4] = { q.x, q.y, q.z, q.w };
+			w.put_floats(vals, 4);
 
 		} break;
 		case Variant::AABB: {
 
-			if (buf) {
-				AABB aabb = p_variant;
-				encode_float(aabb.position.x, &buf[0]);
-				encode_float(aabb.position.y, &buf[4]);
-				encode_float(aabb.position.z, &buf[8]);
-				encode_float(aabb.size.x, &buf[12]);
-				encode_float(aabb.size.y, &buf[16]);
-				encode_float(aabb.size.z, &buf[20]);
-			}
-
-			r_len += 6 * 4;
+			AABB aabb = p_variant;
+			real_t vals[6] = { aabb.position.x, aabb.position.y, aabb.position.z, aabb.size.x, aabb.size.y, aabb.size.z };
+			w.put_floats(vals, 6);
 
 		} break;
 		case Variant::BASIS: {
 
-			if (buf) {
-				Basis val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 3; j++) {
-
-						copymem(&buf[(i * 3 + j) * 4], &val.elements[i][j], sizeof(float));
-					}
-				}
-			}
-
-			r_len += 9 * 4;
+			Basis val = p_variant;
+			w.put_floats(&val.elements[0][0], 9);
 
 		} break;
 		case Variant::TRANSFORM: {
 
-			if (buf) {
-				Transform val = p_variant;
-				for (int i = 0; i < 3; i++) {
-					for (int j = 0; j < 3; j++) {
-
-						copymem(&buf[(i * 3 + j) * 4], &val.basis.elements[i][j], sizeof(float));
-					}
-				}
-
-				encode_float(val.origin.x, &buf[36]);
-				encode_float(val.origin.y, &buf[40]);
-				encode_float(val.origin.z, &buf[44]);
-			}
-
-			r_len += 12 * 4;
+			Transform val = p_variant;
+			w.put_floats(&val.basis.elements[0][0], 9);
+			w.put_floats(&val.origin.x, 3);
 
 		} break;
 
 		// misc types
 		case Variant::COLOR: {
 
-			if (buf) {
-				Color c = p_variant;
-				encode_float(c.r, &buf[0]);
-				encode_float(c.g, &buf[4]);
-				encode_float(c.b, &buf[8]);
-				encode_float(c.a, &buf[12]);
-			}
-
-			r_len += 4 * 4;
+			Color c = p_variant;
+			real_t vals[4] = { c.r, c.g, c.b, c.a };
+			w.put_floats(vals, 4);
 
 		} break;
 		/*case Variant::RESOURCE: {
@@ -1090,14 +1068,10 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 				Object *obj = p_variant;
 				if (!obj) {
-					if (buf) {
-						encode_uint32(0, buf);
-						buf += 4;
-					}
-					r_len += 4;
+					w.put_32(0);
 
 				} else {
-					_encode_string(obj->get_class(), buf, r_len);
+					_encode_string(obj->get_class(), w);
 
 					List<PropertyInfo> props;
 					obj->get_property_list(&props);
@@ -1110,31 +1084,22 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 						pc++;
 					}
 
-					if (buf) {
-						encode_uint32(pc, buf);
-						buf += 4;
-					}
-
-					r_len += 4;
+					w.put_32(pc);
 
 					for (List<PropertyInfo>::Element *E = props.front(); E; E = E->next()) {
 
 						if (!(E->get().usage & PROPERTY_USAGE_STORAGE))
 							continue;
 
-						_encode_string(E->get().name, buf, r_len);
+						_encode_string(E->get().name, w);
 
-						int len;
-						Error err = encode_variant(obj->get(E->get().name), buf, len, p_full_objects);
+						Error err = _encode_variant(obj->get(E->get().name), w, p_full_objects);
 						if (err)
 							return err;
-						ERR_FAIL_COND_V(len % 4, ERR_BUG);
-						r_len += len;
-						if (buf)
-							buf += len;
 					}
 				}
 			} else {
+				uint8_t *buf = w.reserve(8);
 				if (buf) {
 
 					Object *obj = p_variant;
@@ -1145,8 +1110,6 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 					encode_uint64(id, buf);
 				}
-
-				r_len += 8;
 			}
 
 		} break;
@@ -1154,43 +1117,17 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			Dictionary d = p_variant;
 
-			if (buf) {
-				encode_uint32(uint32_t(d.size()), buf);
-				buf += 4;
-			}
-			r_len += 4;
-
-			List<Variant> keys;
-			d.get_key_list(&keys);
-
-			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+			w.put_32(uint32_t(d.size()));
 
-				/*
-				CharString utf8 = E->->utf8();
-
-				if (buf) {
-					encode_uint32(utf8.length()+1,buf);
-					buf+=4;
-					copymem(buf,utf8.get_data(),utf8.length()+1);
-				}
+			const Variant *K = NULL;
+			while ((K = d.next(K))) {
 
-				r_len+=4+utf8.length()+1;
-				while (r_len%4)
-					r_len++; //pad
-				*/
-				int len;
-				encode_variant(E->get(), buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
-				Variant *v = d.getptr(E->get());
+				Error err = _encode_variant(*K, w, p_full_objects);
+				ERR_FAIL_COND_V(err, err);
+				const Variant *v = d.getptr(*K);
 				ERR_FAIL_COND_V(!v, ERR_BUG);
-				encode_variant(*v, buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				err = _encode_variant(*v, w, p_full_objects);
+				ERR_FAIL_COND_V(err, err);
 			}
 
 		} break;
@@ -1198,21 +1135,12 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			Array v = p_variant;
 
-			if (buf) {
-				encode_uint32(uint32_t(v.size()), buf);
-				buf += 4;
-			}
-
-			r_len += 4;
+			w.put_32(uint32_t(v.size()));
 
 			for (int i = 0; i < v.size(); i++) {
 
-				int len;
-				encode_variant(v.get(i), buf, len, p_full_objects);
-				ERR_FAIL_COND_V(len % 4, ERR_BUG);
-				r_len += len;
-				if (buf)
-					buf += len;
+				Error err = _encode_variant(v.get(i), w, p_full_objects);
+				ERR_FAIL_COND_V(err, err);
 			}
 
 		} break;
@@ -1221,52 +1149,34 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 
 			PoolVector<uint8_t> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(uint8_t);
 
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
-				PoolVector<uint8_t>::Read r = data.read();
-				copymem(buf, &r[0], datalen * datasize);
-			}
-
-			r_len += 4 + datalen * datasize;
-			while (r_len % 4)
-				r_len++;
+			w.put_32(datalen);
+			PoolVector<uint8_t>::Read r = data.read();
+			w.put_padded(r.ptr(), datalen);
 
 		} break;
 		case Variant::POOL_INT_ARRAY: {
 
 			PoolVector<int> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(int32_t);
 
+			w.put_32(datalen);
+			uint8_t *buf = w.reserve(datalen * 4);
 			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
 				PoolVector<int>::Read r = data.read();
 				for (int i = 0; i < datalen; i++)
-					encode_uint32(r[i], &buf[i * datasize]);
+					encode_uint32(r[i], &buf[i * 4]);
 			}
 
-			r_len += 4 + datalen * datasize;
-
 		} break;
 		case Variant::POOL_REAL_ARRAY: {
 
 			PoolVector<real_t> data = p_variant;
 			int datalen = data.size();
-			int datasize = sizeof(real_t);
 
-			if (buf) {
-				encode_uint32(datalen, buf);
-				buf += 4;
-				PoolVector<real_t>::Read r = data.read();
-				for (int i = 0; i < datalen; i++)
-					encode_float(r[i], &buf[i * datasize]);
-			}
-
-			r_len += 4 + datalen * datasize;
+			w.put_32(datalen);
+			PoolVector<real_t>::Read r = data.read();
+			w.put_floats(r.ptr(), datalen);
 
 		} break;
 		case Variant::POOL_STRING_ARRAY: {
@@ -1274,30 +1184,14 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<String> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
+			w.put_32(len);
 
+			PoolVector<String>::Read r = data.read();
 			for (int i = 0; i < len; i++) {
 
-				CharString utf8 = data.get(i).utf8();
-
-				if (buf) {
-					encode_uint32(utf8.length() + 1, buf);
-					buf += 4;
-					copymem(buf, utf8.get_data(), utf8.length() + 1);
-					buf += utf8.length() + 1;
-				}
-
-				r_len += 4 + utf8.length() + 1;
-				while (r_len % 4) {
-					r_len++; //pad
-					if (buf)
-						*(buf++) = 0;
-				}
+				CharString utf8 = r[i].utf8();
+				w.put_32(utf8.length() + 1);
+				w.put_padded((const uint8_t *)utf8.get_data(), utf8.length() + 1);
 			}
 
 		} break;
@@ -1306,26 +1200,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<Vector2> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
-
-				for (int i = 0; i < len; i++) {
-
-					Vector2 v = data.get(i);
-
-					encode_float(v.x, &buf[0]);
-					encode_float(v.y, &buf[4]);
-					buf += 4 * 2;
-				}
-			}
-
-			r_len += 4 * 2 * len;
+			w.put_32(len);
+			PoolVector<Vector2>::Read r = data.read();
+			w.put_floats(len ? &r[0].x : NULL, len * 2);
 
 		} break;
 		case Variant::POOL_VECTOR3_ARRAY: {
@@ -1333,27 +1210,9 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<Vector3> data = p_variant;
 			int len = data.size();
 
-			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
-
-				for (int i = 0; i < len; i++) {
-
-					Vector3 v = data.get(i);
-
-					encode_float(v.x, &buf[0]);
-					encode_float(v.y, &buf[4]);
-					encode_float(v.z, &buf[8]);
-					buf += 4 * 3;
-				}
-			}
-
-			r_len += 4 * 3 * len;
+			w.put_32(len);
+			PoolVector<Vector3>::Read r = data.read();
+			w.put_floats(len ? &r[0].x : NULL, len * 3);
 
 		} break;
 		case Variant::POOL_COLOR_ARRAY: {
@@ -1361,32 +1220,43 @@ Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bo
 			PoolVector<Color> data = p_variant;
 			int len = data.size();
 
+			w.put_32(len);
+			uint8_t *buf = w.reserve(len * 4 * 4);
 			if (buf) {
-				encode_uint32(len, buf);
-				buf += 4;
-			}
-
-			r_len += 4;
-
-			if (buf) {
-
+				PoolVector<Color>::Read r = data.read();
 				for (int i = 0; i < len; i++) {
 
-					Color c = data.get(i);
-
-					encode_float(c.r, &buf[0]);
-					encode_float(c.g, &buf[4]);
-					encode_float(c.b, &buf[8]);
-					encode_float(c.a, &buf[12]);
+					encode_float(r[i].r, &buf[0]);
+					encode_float(r[i].g, &buf[4]);
+					encode_float(r[i].b, &buf[8]);
+					encode_float(r[i].a, &buf[12]);
 					buf += 4 * 4;
 				}
 			}
 
-			r_len += 4 * 4 * len;
-
 		} break;
 		default: { ERR_FAIL_V(ERR_BUG); }
 	}
 
 	return OK;
 }
+
+Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects) {
+
+	VariantEncodeTarget w(r_buffer);
+	Error err = _encode_variant(p_variant, w, p_full_objects);
+	r_len = w.pos;
+	return err;
+}
+
+Error encode_variant_into(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_pos, bool p_full_objects) {
+
+	ERR_FAIL_COND_V(r_pos < 0 || r_pos > r_buffer.size(), ERR_INVALID_PARAMETER);
+
+	VariantEncodeTarget w(&r_buffer, r_pos);
+	Error err = _encode_variant(p_variant, w, p_full_objects);
+	if (err == OK) {
+		r_pos = w.pos;
+	}
+	return err;
+}
@@ -202,4 +202,12 @@ public:
 Error decode_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = false);
 Error encode_variant(const Variant &p_variant, uint8_t *r_buffer, int &r_len, bool p_full_objects = false);
 
+// Like decode_variant(), but writes into the strings, arrays and pool arrays r_variant already holds when the types match,
+// instead of allocating new ones. Arrays are reused in place, so anyone else sharing them sees the new contents.
+Error decode_variant_reuse(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL, bool p_allow_objects = false);
+// Decodes an encoded PoolByteArray without copying it, r_data points into p_buffer.
+Error decode_variant_bytes(const uint8_t *p_buffer, int p_len, const uint8_t *&r_data, int &r_size, int *r_len = NULL);
+// Encodes in a single pass at r_pos, growing r_buffer when needed (it never shrinks), and advances r_pos past the written data.
+Error encode_variant_into(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_pos, bool p_full_objects = false);
+
 #endif
@@ -31,6 +31,7 @@
 #include "multiplayer_api.h"
 
 #include "core/io/marshalls.h"
+#include "core/sort_array.h"
 #include "scene/main/node.h"
 
 _FORCE_INLINE_ bool _should_call_local(MultiplayerAPI::RPCMode mode, bool is_master, bool &r_skip_rpc) {
@@ -88,6 +89,81 @@ _FORCE_INLINE_ bool _can_call_mode(MultiplayerAPI::RPCMode mode, int p_node_mast
 	return false;
 }
 
+_FORCE_INLINE_ bool _can_use_rset_baseline(const Variant &p_value) {
+
+	// Only values compared by contents, arrays and dictionaries may be changed in place.
+	switch (p_value.get_type()) {
+		case Variant::OBJECT:
+		case Variant::ARRAY:
+		case Variant::DICTIONARY: {
+			return false;
+		} break;
+		default: {
+			return true;
+		}
+	}
+}
+
+_FORCE_INLINE_ bool _is_target_peer(int p_peer, int p_target) {
+
+	if (p_target < 0)
+		return p_peer != -p_target;
+	return p_target == 0 || p_peer == p_target;
+}
+
+static int _get_id_compression(uint32_t p_id) {
+
+	if (p_id <= 0xFF)
+		return MultiplayerAPI::ID_COMPRESSION_8;
+	if (p_id <= 0xFFFF)
+		return MultiplayerAPI::ID_COMPRESSION_16;
+	return MultiplayerAPI::ID_COMPRESSION_32;
+}
+
+static int _encode_id(uint32_t p_id, int p_compression, uint8_t *p_buf) {
+
+	switch (p_compression) {
+		case MultiplayerAPI::ID_COMPRESSION_8: {
+			*p_buf = p_id;
+			return 1;
+		} break;
+		case MultiplayerAPI::ID_COMPRESSION_16: {
+			return encode_uint16(p_id, p_buf);
+		} break;
+		default: {
+			return encode_uint32(p_id, p_buf);
+		}
+	}
+}
+
+static bool _decode_id(const uint8_t *p_packet, int p_packet_len, int p_compression, int &r_offset, uint32_t &r_id) {
+
+	static const int sizes[3] = { 1, 2, 4 };
+	int size = sizes[p_compression];
+	if (r_offset + size > p_packet_len)
+		return false;
+
+	if (p_compression == MultiplayerAPI::ID_COMPRESSION_8) {
+		r_id = p_packet[r_offset];
+	} else if (p_compression == MultiplayerAPI::ID_COMPRESSION_16) {
+		r_id = decode_uint16(&p_packet[r_offset]);
+	} else {
+		r_id = decode_uint32(&p_packet[r_offset]);
+	}
+	r_offset += size;
+	return true;
+}
+
+// Returns the offset of the terminating zero, or -1 if there is none.
+static int _find_cstring_end(const uint8_t *p_packet, int p_packet_len, int p_offset) {
+
+	for (int i = p_offset; i < p_packet_len; i++) {
+		if (p_packet[i] == 0)
+			return i;
+	}
+	return -1;
+}
+
 void MultiplayerAPI::poll() {
 
 	if (!network_peer.is_valid() || network_peer->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_DISCONNECTED)
@@ -117,14 +193,25 @@ void MultiplayerAPI::poll() {
 			break; // It's also possible that a packet or RPC caused a disconnection, so also check here.
 		}
 	}
+
+	if (network_peer.is_valid() && !replication_queues.empty()) {
+		_process_replication();
+	}
 }
 
 void MultiplayerAPI::clear() {
 	connected_peers.clear();
 	path_get_cache.clear();
 	path_send_cache.clear();
+	name_get_cache.clear();
+	name_send_cache.clear();
 	packet_cache.clear();
+	arg_cache.clear();
 	last_send_cache_id = 1;
+	last_name_cache_id = 0;
+	interest_peers.clear();
+	interest_grid.clear();
+	replication_queues.clear();
 }
 
 void MultiplayerAPI::set_root_node(Node *p_node) {
@@ -169,7 +256,7 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 	ERR_EXPLAIN("Invalid packet received. Size too small.");
 	ERR_FAIL_COND(p_packet_len < 1);
 
-	uint8_t packet_type = p_packet[0];
+	uint8_t packet_type = p_packet[0] & HEADER_COMMAND_MASK;
 
 	switch (packet_type) {
 
@@ -183,37 +270,41 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 			_process_confirm_path(p_from, p_packet, p_packet_len);
 		} break;
 
+		case NETWORK_COMMAND_SIMPLIFY_NAME: {
+
+			_process_simplify_name(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_CONFIRM_NAME: {
+
+			_process_confirm_name(p_from, p_packet, p_packet_len);
+		} break;
+
 		case NETWORK_COMMAND_REMOTE_CALL:
 		case NETWORK_COMMAND_REMOTE_SET: {
 
 			ERR_EXPLAIN("Invalid packet received. Size too small.");
-			ERR_FAIL_COND(p_packet_len < 6);
+			ERR_FAIL_COND(p_packet_len < 3);
 
-			Node *node = _process_get_node(p_from, p_packet, p_packet_len);
+			int ofs = 1;
+			PathGetCache::NodeInfo *node_info = NULL;
+			Node *node = _process_get_node(p_from, p_packet, p_packet_len, ofs, &node_info);
 
 			ERR_EXPLAIN("Invalid packet received. Requested node was not found.");
 			ERR_FAIL_COND(node == NULL);
 
-			// Detect cstring end.
-			int len_end = 5;
-			for (; len_end < p_packet_len; len_end++) {
-				if (p_packet[len_end] == 0) {
-					break;
-				}
-			}
-
-			ERR_EXPLAIN("Invalid packet received. Size too small.");
-			ERR_FAIL_COND(len_end >= p_packet_len);
+			StringName name = _process_get_name(p_from, p_packet, p_packet_len, ofs);
 
-			StringName name = String::utf8((const char *)&p_packet[5]);
+			ERR_EXPLAIN("Invalid packet received. Requested method or property name was not found.");
+			ERR_FAIL_COND(name == StringName());
 
 			if (packet_type == NETWORK_COMMAND_REMOTE_CALL) {
 
-				_process_rpc(node, name, p_from, p_packet, p_packet_len, len_end + 1);
+				_process_rpc(node, name, p_from, p_packet, p_packet_len, ofs);
 
 			} else {
 
-				_process_rset(node, name, p_from, p_packet, p_packet_len, len_end + 1);
+				_process_rset(node, name, p_from, p_packet, p_packet_len, ofs, node_info, p_packet[0] & HEADER_RSET_BASELINE);
 			}
 
 		} break;
@@ -225,21 +316,22 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 	}
 }
 
-Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len) {
+Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len, int &r_offset, PathGetCache::NodeInfo **r_node_info) {
 
-	uint32_t target = decode_uint32(&p_packet[1]);
+	int compression = (p_packet[0] >> HEADER_NODE_ID_SHIFT) & HEADER_ID_COMPRESSION_MASK;
 	Node *node = NULL;
 
-	if (target & 0x80000000) {
+	if (compression == ID_COMPRESSION_INLINE) {
 		// Use full path (not cached yet).
 
-		int ofs = target & 0x7FFFFFFF;
+		int end = _find_cstring_end(p_packet, p_packet_len, r_offset);
 
 		ERR_EXPLAIN("Invalid packet received. Size smaller than declared.");
-		ERR_FAIL_COND_V(ofs >= p_packet_len, NULL);
+		ERR_FAIL_COND_V(end < 0, NULL);
 
 		String paths;
-		paths.parse_utf8((const char *)&p_packet[ofs], p_packet_len - ofs);
+		paths.parse_utf8((const char *)&p_packet[r_offset], end - r_offset);
+		r_offset = end + 1;
 
 		NodePath np = paths;
 
@@ -249,7 +341,9 @@ Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int
 			ERR_PRINTS("Failed to get path from RPC: " + String(np));
 	} else {
 		// Use cached path.
-		int id = target;
+		uint32_t id;
+		ERR_EXPLAIN("Invalid packet received. Size too small.");
+		ERR_FAIL_COND_V(!_decode_id(p_packet, p_packet_len, compression, r_offset, id), NULL);
 
 		Map<int, PathGetCache>::Element *E = path_get_cache.find(p_from);
 		ERR_EXPLAIN("Invalid packet received. Requests invalid peer cache.");
@@ -265,10 +359,44 @@ Node *MultiplayerAPI::_process_get_node(int p_from, const uint8_t *p_packet, int
 		node = root_node->get_node(ni->path);
 		if (!node)
 			ERR_PRINTS("Failed to get cached path from RPC: " + String(ni->path));
+		*r_node_info = ni;
 	}
 	return node;
 }
 
+StringName MultiplayerAPI::_process_get_name(int p_from, const uint8_t *p_packet, int p_packet_len, int &r_offset) {
+
+	int compression = (p_packet[0] >> HEADER_NAME_ID_SHIFT) & HEADER_ID_COMPRESSION_MASK;
+
+	if (compression == ID_COMPRESSION_INLINE) {
+		// Use full name (not cached yet).
+
+		int end = _find_cstring_end(p_packet, p_packet_len, r_offset);
+
+		ERR_EXPLAIN("Invalid packet received. Size smaller than declared.");
+		ERR_FAIL_COND_V(end < 0, StringName());
+
+		StringName name = String::utf8((const char *)&p_packet[r_offset], end - r_offset);
+		r_offset = end + 1;
+		return name;
+	}
+
+	// Use cached name.
+	uint32_t id;
+	ERR_EXPLAIN("Invalid packet received. Size too small.");
+	ERR_FAIL_COND_V(!_decode_id(p_packet, p_packet_len, compression, r_offset, id), StringName());
+
+	Map<int, NameGetCache>::Element *E = name_get_cache.find(p_from);
+	ERR_EXPLAIN("Invalid packet received. Requests invalid peer cache.");
+	ERR_FAIL_COND_V(!E, StringName());
+
+	Map<int, StringName>::Element *F = E->get().names.find(id);
+	ERR_EXPLAIN("Invalid packet received. Unabled to find requested cached name.");
+	ERR_FAIL_COND_V(!F, StringName());
+
+	return F->get();
+}
+
 void MultiplayerAPI::_process_rpc(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset) {
 
 	ERR_EXPLAIN("Invalid packet received. Size too small.");
@@ -301,7 +429,7 @@ void MultiplayerAPI::_process_rpc(Node *p_node, const StringName &p_name, int p_
 		ERR_FAIL_COND(p_offset >= p_packet_len);
 
 		int vlen;
-		Error err = decode_variant(args.write[i], &p_packet[p_offset], p_packet_len - p_offset, &vlen, allow_object_decoding || network_peer->is_object_decoding_allowed());
+		Error err = decode_and_decompress_variant(args.write[i], &p_packet[p_offset], p_packet_len - p_offset, &vlen);
 		ERR_EXPLAIN("Invalid packet received. Unable to decode RPC argument.");
 		ERR_FAIL_COND(err != OK);
 
@@ -319,10 +447,13 @@ void MultiplayerAPI::_process_rpc(Node *p_node, const StringName &p_name, int p_
 	}
 }
 
-void MultiplayerAPI::_process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset) {
+void MultiplayerAPI::_process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset, PathGetCache::NodeInfo *p_node_info, bool p_baseline) {
 
 	ERR_EXPLAIN("Invalid packet received. Size too small.");
-	ERR_FAIL_COND(p_offset >= p_packet_len);
+	ERR_FAIL_COND(p_offset > p_packet_len || (p_offset == p_packet_len && !p_baseline));
+
+	ERR_EXPLAIN("Invalid packet received. RSET baseline on a node which is not cached.");
+	ERR_FAIL_COND(p_baseline && !p_node_info);
 
 	// Check that remote can call the RSET on this node.
 	RPCMode rset_mode = RPC_MODE_DISABLED;
@@ -338,10 +469,22 @@ void MultiplayerAPI::_process_rset(Node *p_node, const StringName &p_name, int p
 	ERR_FAIL_COND(!_can_call_mode(rset_mode, p_from, node_master_id));
 
 	Variant value;
-	Error err = decode_variant(value, &p_packet[p_offset], p_packet_len - p_offset, NULL, allow_object_decoding || network_peer->is_object_decoding_allowed());
+	if (p_baseline && p_offset == p_packet_len) {
+		// Same value as the last one set reliably.
+		Map<StringName, Variant>::Element *F = p_node_info->rset_baselines.find(p_name);
+		ERR_EXPLAIN("Invalid packet received. RSET baseline for '" + String(p_name) + "' was never received.");
+		ERR_FAIL_COND(!F);
+		value = F->get();
+	} else {
+		Error err = decode_and_decompress_variant(value, &p_packet[p_offset], p_packet_len - p_offset);
 
-	ERR_EXPLAIN("Invalid packet received. Unable to decode RSET value.");
-	ERR_FAIL_COND(err != OK);
+		ERR_EXPLAIN("Invalid packet received. Unable to decode RSET value.");
+		ERR_FAIL_COND(err != OK);
+
+		if (p_baseline) {
+			p_node_info->rset_baselines[p_name] = value;
+		}
+	}
 
 	bool valid;
 
@@ -408,6 +551,54 @@ void MultiplayerAPI::_process_confirm_path(int p_from, const uint8_t *p_packet,
 	E->get() = true;
 }
 
+void MultiplayerAPI::_process_simplify_name(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_EXPLAIN("Invalid packet received. Size too small.");
+	ERR_FAIL_COND(p_packet_len < 5);
+	int id = decode_uint32(&p_packet[1]);
+
+	String names;
+	names.parse_utf8((const char *)&p_packet[5], p_packet_len - 5);
+
+	if (!name_get_cache.has(p_from)) {
+		name_get_cache[p_from] = NameGetCache();
+	}
+
+	name_get_cache[p_from].names[id] = names;
+
+	// Encode name to send ack.
+	CharString pname = names.utf8();
+	int len = encode_cstring(pname.get_data(), NULL);
+
+	Vector<uint8_t> packet;
+
+	packet.resize(1 + len);
+	packet.write[0] = NETWORK_COMMAND_CONFIRM_NAME;
+	encode_cstring(pname.get_data(), &packet.write[1]);
+
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+	network_peer->set_target_peer(p_from);
+	network_peer->put_packet(packet.ptr(), packet.size());
+}
+
+void MultiplayerAPI::_process_confirm_name(int p_from, const uint8_t *p_packet, int p_packet_len) {
+
+	ERR_EXPLAIN("Invalid packet received. Size too small.");
+	ERR_FAIL_COND(p_packet_len < 2);
+
+	String names;
+	names.parse_utf8((const char *)&p_packet[1], p_packet_len - 1);
+
+	NameSentCache *nsc = name_send_cache.getptr(names);
+	ERR_EXPLAIN("Invalid packet received. Tries to confirm a name which was not found in cache.");
+	ERR_FAIL_COND(!nsc);
+
+	Map<int, bool>::Element *E = nsc->confirmed_peers.find(p_from);
+	ERR_EXPLAIN("Invalid packet received. Source peer was not found in cache for the given name.");
+	ERR_FAIL_COND(!E);
+	E->get() = true;
+}
+
 bool MultiplayerAPI::_send_confirm_path(NodePath p_path, PathSentCache *psc, int p_target) {
 	bool has_all_peers = true;
 	List<int> peers_to_add; // If one is missing, take note to add it.
@@ -458,6 +649,106 @@ bool MultiplayerAPI::_send_confirm_path(NodePath p_path, PathSentCache *psc, int
 	return has_all_peers;
 }
 
+bool MultiplayerAPI::_send_confirm_name(const StringName &p_name, NameSentCache *nsc, int p_target) {
+	bool has_all_peers = true;
+	List<int> peers_to_add; // If one is missing, take note to add it.
+
+	for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
+
+		if (!_is_target_peer(E->get(), p_target))
+			continue; // Continue, not for this peer.
+
+		Map<int, bool>::Element *F = nsc->confirmed_peers.find(E->get());
+
+		if (!F || !F->get()) {
+			// Name was not cached, or was cached but is unconfirmed.
+			if (!F) {
+				// Not cached at all, take note.
+				peers_to_add.push_back(E->get());
+			}
+
+			has_all_peers = false;
+		}
+	}
+
+	if (peers_to_add.empty())
+		return has_all_peers;
+
+	// Those that need to be added, send a message for this.
+
+	CharString pname = String(p_name).utf8();
+	int len = encode_cstring(pname.get_data(), NULL);
+
+	Vector<uint8_t> packet;
+
+	packet.resize(1 + 4 + len);
+	packet.write[0] = NETWORK_COMMAND_SIMPLIFY_NAME;
+	encode_uint32(nsc->id, &packet.write[1]);
+	encode_cstring(pname.get_data(), &packet.write[5]);
+
+	for (List<int>::Element *E = peers_to_add.front(); E; E = E->next()) {
+
+		network_peer->set_target_peer(E->get());
+		network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
+		network_peer->put_packet(packet.ptr(), packet.size());
+
+		nsc->confirmed_peers.insert(E->get(), false); // Insert into confirmed, but as false since it was not confirmed.
+	}
+
+	return has_all_peers;
+}
+
+#define MAKE_ROOM(m_amount) \
+	if (packet_cache.size() < m_amount) packet_cache.resize(m_amount);
+
+int MultiplayerAPI::_make_rpc_packet(uint8_t p_command, int p_path_id, const CharString *p_path, int p_name_id, const CharString *p_name, bool p_baseline, int p_args_len) {
+
+	// Worst case for the header, the strings are added below.
+	MAKE_ROOM(1 + 4 + 4);
+
+	uint8_t header = p_command;
+	if (p_baseline) {
+		header |= HEADER_RSET_BASELINE;
+	}
+	int ofs = 1;
+
+	// Encode node, ID if the peer has it, path otherwise.
+	if (p_path) {
+		header |= ID_COMPRESSION_INLINE << HEADER_NODE_ID_SHIFT;
+		int len = encode_cstring(p_path->get_data(), NULL);
+		MAKE_ROOM(ofs + len + 4);
+		encode_cstring(p_path->get_data(), &(packet_cache.write[ofs]));
+		ofs += len;
+	} else {
+		int compression = _get_id_compression(p_path_id);
+		header |= compression << HEADER_NODE_ID_SHIFT;
+		ofs += _encode_id(p_path_id, compression, &(packet_cache.write[ofs]));
+	}
+
+	// Encode method or property, same as above.
+	if (p_name) {
+		header |= ID_COMPRESSION_INLINE << HEADER_NAME_ID_SHIFT;
+		int len = encode_cstring(p_name->get_data(), NULL);
+		MAKE_ROOM(ofs + len);
+		encode_cstring(p_name->get_data(), &(packet_cache.write[ofs]));
+		ofs += len;
+	} else {
+		int compression = _get_id_compression(p_name_id);
+		header |= compression << HEADER_NAME_ID_SHIFT;
+		ofs += _encode_id(p_name_id, compression, &(packet_cache.write[ofs]));
+	}
+
+	packet_cache.write[0] = header;
+
+	// Arguments were encoded once by the caller.
+	MAKE_ROOM(ofs + p_args_len);
+	if (p_args_len) {
+		memcpy(&(packet_cache.write[ofs]), arg_cache.ptr(), p_args_len);
+	}
+
+	return ofs + p_args_len;
+}
+
 void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount) {
 
 	if (network_peer.is_null()) {
@@ -490,6 +781,23 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 		ERR_FAIL();
 	}
 
+	if (interest_enabled && p_to <= 0) {
+		const InterestNode *interest = interest_nodes.getptr(p_from->get_instance_id());
+		Vector<int> peers;
+		bool schedule = p_set && p_unreliable && interest_update_budget > 0;
+		if (interest && (!_get_interested_peers(*interest, p_to, peers) || schedule)) {
+			// Not relevant to everyone or waiting for its turn, send to the peers it is relevant to one by one.
+			for (int i = 0; i < peers.size(); i++) {
+				if (schedule) {
+					_schedule_rset(peers[i], p_from, p_name, *p_arg[0]);
+				} else {
+					_send_rpc(p_from, peers[i], p_unreliable, p_set, p_name, p_arg, p_argcount);
+				}
+			}
+			return;
+		}
+	}
+
 	NodePath from_path = (root_node->get_path()).rel_path_to(p_from->get_path());
 	ERR_EXPLAIN("Unable to send RPC. Relative path is empty. THIS IS LIKELY A BUG IN THE ENGINE!");
 	ERR_FAIL_COND(from_path.is_empty());
@@ -503,95 +811,114 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 		psc->id = last_send_cache_id++;
 	}
 
-	// Create base packet, lots of hardcode because it must be tight.
-
-	int ofs = 0;
+	// See if the name is cached.
+	NameSentCache *nsc = name_send_cache.getptr(p_name);
+	if (!nsc) {
+		// Name is not cached, create.
+		name_send_cache[p_name] = NameSentCache();
+		nsc = name_send_cache.getptr(p_name);
+		nsc->id = last_name_cache_id++;
+	}
 
-#define MAKE_ROOM(m_amount) \
-	if (packet_cache.size() < m_amount) packet_cache.resize(m_amount);
+	// Encode arguments once, the header depends on what each peer has cached.
 
-	// Encode type.
-	MAKE_ROOM(1);
-	packet_cache.write[0] = p_set ? NETWORK_COMMAND_REMOTE_SET : NETWORK_COMMAND_REMOTE_CALL;
-	ofs += 1;
+	int args_len = 0;
+	RsetBaseline *baseline = NULL;
+	bool unchanged = false;
 
-	// Encode ID.
-	MAKE_ROOM(ofs + 4);
-	encode_uint32(psc->id, &(packet_cache.write[ofs]));
-	ofs += 4;
+	if (p_set) {
+		// Reliable sets are kept on both sides, so sending the same value again costs no bytes.
+		if (!p_unreliable && _can_use_rset_baseline(*p_arg[0])) {
+			baseline = psc->rset_baselines.getptr(p_name);
+			if (!baseline) {
+				psc->rset_baselines[p_name] = RsetBaseline();
+				baseline = psc->rset_baselines.getptr(p_name);
+			}
 
-	// Encode function name.
-	CharString name = String(p_name).utf8();
-	int len = encode_cstring(name.get_data(), NULL);
-	MAKE_ROOM(ofs + len);
-	encode_cstring(name.get_data(), &(packet_cache.write[ofs]));
-	ofs += len;
+			if (baseline->value.get_type() == p_arg[0]->get_type() && baseline->value == *p_arg[0]) {
+				unchanged = true;
+				for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
+					if (_is_target_peer(E->get(), p_to) && !baseline->peers.has(E->get())) {
+						unchanged = false;
+						break;
+					}
+				}
+			} else {
+				// Peers holding the old value will get the new one in full.
+				baseline->value = *p_arg[0];
+				baseline->peers.clear();
+			}
+		}
 
-	if (p_set) {
-		// Set argument.
-		Error err = encode_variant(*p_arg[0], NULL, len, allow_object_decoding || network_peer->is_object_decoding_allowed());
-		ERR_EXPLAIN("Unable to encode RSET value. THIS IS LIKELY A BUG IN THE ENGINE!");
-		ERR_FAIL_COND(err != OK);
-		MAKE_ROOM(ofs + len);
-		encode_variant(*p_arg[0], &(packet_cache.write[ofs]), len, allow_object_decoding || network_peer->is_object_decoding_allowed());
-		ofs += len;
+		if (!unchanged) {
+			// Set argument.
+			Error err = encode_and_compress_variant(*p_arg[0], arg_cache, args_len);
+			ERR_EXPLAIN("Unable to encode RSET value. THIS IS LIKELY A BUG IN THE ENGINE!");
+			ERR_FAIL_COND(err != OK);
+		}
 
 	} else {
 		// Call arguments.
-		MAKE_ROOM(ofs + 1);
-		packet_cache.write[ofs] = p_argcount;
-		ofs += 1;
+		if (arg_cache.size() < 1)
+			arg_cache.resize(1);
+		arg_cache.write[0] = p_argcount;
+		args_len += 1;
 		for (int i = 0; i < p_argcount; i++) {
-			Error err = encode_variant(*p_arg[i], NULL, len, allow_object_decoding || network_peer->is_object_decoding_allowed());
+			Error err = encode_and_compress_variant(*p_arg[i], arg_cache, args_len);
 			ERR_EXPLAIN("Unable to encode RPC argument. THIS IS LIKELY A BUG IN THE ENGINE!");
 			ERR_FAIL_COND(err != OK);
-			MAKE_ROOM(ofs + len);
-			encode_variant(*p_arg[i], &(packet_cache.write[ofs]), len, allow_object_decoding || network_peer->is_object_decoding_allowed());
-			ofs += len;
 		}
 	}
 
-	// See if all peers have cached path (is so, call can be fast).
-	bool has_all_peers = _send_confirm_path(from_path, psc, p_to);
+	// See if all peers have cached path and name (is so, call can be fast).
+	bool has_all_paths = _send_confirm_path(from_path, psc, p_to);
+	bool has_all_names = _send_confirm_name(p_name, nsc, p_to);
 
 	// Take chance and set transfer mode, since all send methods will use it.
 	network_peer->set_transfer_mode(p_unreliable ? NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE : NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE);
 
-	if (has_all_peers) {
+	uint8_t command = p_set ? NETWORK_COMMAND_REMOTE_SET : NETWORK_COMMAND_REMOTE_CALL;
+
+	if (has_all_paths && has_all_names) {
 
-		// They all have verified paths, so send fast.
+		// They all have verified paths and names, so send fast.
+		int len = _make_rpc_packet(command, psc->id, NULL, nsc->id, NULL, baseline != NULL, args_len);
 		network_peer->set_target_peer(p_to); // To all of you.
-		network_peer->put_packet(packet_cache.ptr(), ofs); // A message with love.
+		network_peer->put_packet(packet_cache.ptr(), len); // A message with love.
+
+		if (baseline && !unchanged) {
+			for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
+				if (_is_target_peer(E->get(), p_to))
+					baseline->peers.insert(E->get());
+			}
+		}
 	} else {
-		// Not all verified path, so send one by one.
+		// Not all verified path or name, so send one by one.
 
-		// Append path at the end, since we will need it for some packets.
 		CharString pname = String(from_path).utf8();
-		int path_len = encode_cstring(pname.get_data(), NULL);
-		MAKE_ROOM(ofs + path_len);
-		encode_cstring(pname.get_data(), &(packet_cache.write[ofs]));
+		CharString mname = String(p_name).utf8();
 
 		for (Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
 
-			if (p_to < 0 && E->get() == -p_to)
-				continue; // Continue, excluded.
-
-			if (p_to > 0 && E->get() != p_to)
+			if (!_is_target_peer(E->get(), p_to))
 				continue; // Continue, not for this peer.
 
 			Map<int, bool>::Element *F = psc->confirmed_peers.find(E->get());
 			ERR_CONTINUE(!F); // Should never happen.
+			Map<int, bool>::Element *G = nsc->confirmed_peers.find(E->get());
+			ERR_CONTINUE(!G); // Should never happen.
+
+			// The peer keeps baselines per cached path, so only send them to peers that confirmed it.
+			bool use_baseline = baseline && F->get();
 
 			network_peer->set_target_peer(E->get()); // To this one specifically.
 
-			if (F->get()) {
-				// This one confirmed path, so use id.
-				encode_uint32(psc->id, &(packet_cache.write[1]));
-				network_peer->put_packet(packet_cache.ptr(), ofs);
-			} else {
-				// This one did not confirm path yet, so use entire path (sorry!).
-				encode_uint32(0x80000000 | ofs, &(packet_cache.write[1])); // Offset to path and flag.
-				network_peer->put_packet(packet_cache.ptr(), ofs + path_len);
+			// Use IDs for what this peer confirmed, and the entire strings for the rest (sorry!).
+			int len = _make_rpc_packet(command, psc->id, F->get() ? NULL : &pname, nsc->id, G->get() ? NULL : &mname, use_baseline, args_len);
+			network_peer->put_packet(packet_cache.ptr(), len);
+
+			if (use_baseline && !unchanged) {
+				baseline->peers.insert(E->get());
 			}
 		}
 	}
@@ -600,12 +927,33 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 void MultiplayerAPI::_add_peer(int p_id) {
 	connected_peers.insert(p_id);
 	path_get_cache.insert(p_id, PathGetCache());
+	name_get_cache.insert(p_id, NameGetCache());
 	emit_signal("network_peer_connected", p_id);
 }
 
 void MultiplayerAPI::_del_peer(int p_id) {
 	connected_peers.erase(p_id);
 	path_get_cache.erase(p_id); // I no longer need your cache, sorry.
+	name_get_cache.erase(p_id);
+	_remove_interest_peer(p_id);
+	replication_queues.erase(p_id);
+
+	// A new peer could get the same ID, it must not be sent IDs or baselines it doesn't have.
+	const NodePath *K = NULL;
+	while ((K = path_send_cache.next(K))) {
+		PathSentCache &psc = path_send_cache[*K];
+		psc.confirmed_peers.erase(p_id);
+
+		const StringName *L = NULL;
+		while ((L = psc.rset_baselines.next(L))) {
+			psc.rset_baselines[*L].peers.erase(p_id);
+		}
+	}
+	const StringName *N = NULL;
+	while ((N = name_send_cache.next(N))) {
+		name_send_cache[*N].confirmed_peers.erase(p_id);
+	}
+
 	emit_signal("network_peer_disconnected", p_id);
 }
 
@@ -831,6 +1179,417 @@ bool MultiplayerAPI::is_object_decoding_allowed() const {
 	return allow_object_decoding;
 }
 
+bool MultiplayerAPI::_is_object_decoding_enabled() const {
+
+	return allow_object_decoding || (network_peer.is_valid() && network_peer->is_object_decoding_allowed());
+}
+
+MultiplayerAPI::InterestCell MultiplayerAPI::_get_interest_cell(const Vector3 &p_origin) const {
+
+	InterestCell cell;
+	cell.x = Math::floor(p_origin.x / interest_radius);
+	cell.y = Math::floor(p_origin.y / interest_radius);
+	cell.z = Math::floor(p_origin.z / interest_radius);
+	return cell;
+}
+
+void MultiplayerAPI::_remove_interest_peer(int p_peer) {
+
+	InterestPeer *ip = interest_peers.getptr(p_peer);
+	if (!ip)
+		return;
+
+	Vector<int> *cell_peers = interest_grid.getptr(ip->cell);
+	if (cell_peers) {
+		cell_peers->erase(p_peer);
+		if (cell_peers->empty()) {
+			interest_grid.erase(ip->cell);
+		}
+	}
+	interest_peers.erase(p_peer);
+}
+
+bool MultiplayerAPI::_get_interested_peers(const InterestNode &p_node, int p_target, Vector<int> &r_peers) const {
+
+	bool all = true;
+
+	// Peers without an origin are interested in everything.
+	for (const Set<int>::Element *E = connected_peers.front(); E; E = E->next()) {
+		if (_is_target_peer(E->get(), p_target) && !interest_peers.has(E->get())) {
+			r_peers.push_back(E->get());
+		}
+	}
+
+	// The cells are as big as the radius, so at most three per axis need to be checked.
+	InterestCell from = _get_interest_cell(p_node.origin - Vector3(interest_radius, interest_radius, interest_radius));
+	InterestCell to = _get_interest_cell(p_node.origin + Vector3(interest_radius, interest_radius, interest_radius));
+	real_t radius_squared = interest_radius * interest_radius;
+	int located = 0;
+
+	InterestCell cell;
+	for (cell.x = from.x; cell.x <= to.x; cell.x++) {
+		for (cell.y = from.y; cell.y <= to.y; cell.y++) {
+			for (cell.z = from.z; cell.z <= to.z; cell.z++) {
+
+				const Vector<int> *cell_peers = interest_grid.getptr(cell);
+				if (!cell_peers)
+					continue;
+
+				for (int i = 0; i < cell_peers->size(); i++) {
+					int peer = (*cell_peers)[i];
+					if (!_is_target_peer(peer, p_target) || !connected_peers.has(peer))
+						continue;
+					if (interest_peers.get(peer).origin.distance_squared_to(p_node.origin) > radius_squared) {
+						all = false;
+						continue;
+					}
+					r_peers.push_back(peer);
+					located++;
+				}
+			}
+		}
+	}
+
+	// Located peers in cells that were not visited are out of range too.
+	if (all) {
+		int targets = 0;
+		const int *K = NULL;
+		while ((K = interest_peers.next(K))) {
+			if (_is_target_peer(*K, p_target) && connected_peers.has(*K))
+				targets++;
+		}
+		all = located == targets;
+	}
+
+	return all;
+}
+
+real_t MultiplayerAPI::_get_interest_factor(const InterestNode &p_node, int p_peer) const {
+
+	const InterestPeer *ip = interest_peers.getptr(p_peer);
+	if (!ip)
+		return p_node.priority;
+
+	// Closer nodes gain priority faster, but even the farthest one gets its turn.
+	real_t distance = ip->origin.distance_to(p_node.origin) / interest_radius;
+	return p_node.priority * MAX(1.0 - distance, 0.1);
+}
+
+void MultiplayerAPI::_schedule_rset(int p_peer, Node *p_node, const StringName &p_property, const Variant &p_value) {
+
+	ReplicationKey key;
+	key.node = p_node->get_instance_id();
+	key.property = p_property;
+
+	ReplicationQueue &queue = replication_queues[p_peer];
+	PendingReplication *pending = queue.getptr(key);
+	if (pending) {
+		// Keep the accumulated priority, only the latest value matters.
+		pending->value = p_value;
+	} else {
+		PendingReplication pr;
+		pr.value = p_value;
+		pr.priority = 0;
+		queue.set(key, pr);
+	}
+}
+
+void MultiplayerAPI::_process_replication() {
+
+	Vector<ReplicationSort> order;
+	Vector<ReplicationKey> sent;
+
+	for (Map<int, ReplicationQueue>::Element *E = replication_queues.front(); E;) {
+
+		Map<int, ReplicationQueue>::Element *N = E->next();
+		int peer = E->key();
+		ReplicationQueue &queue = E->get();
+
+		if (!connected_peers.has(peer)) {
+			replication_queues.erase(E);
+			E = N;
+			continue;
+		}
+
+		// Everything waiting gains priority, the highest ones are sent within the budget.
+		order.clear();
+		sent.clear();
+		const ReplicationKey *K = NULL;
+		while ((K = queue.next(K))) {
+			PendingReplication &pr = queue[*K];
+			const InterestNode *interest = interest_nodes.getptr(K->node);
+			pr.priority += interest ? _get_interest_factor(*interest, peer) : 1.0;
+
+			ReplicationSort s;
+			s.key = K;
+			s.priority = pr.priority;
+			order.push_back(s);
+		}
+		order.sort();
+
+		for (int i = 0; i < order.size() && i < interest_update_budget; i++) {
+
+			const ReplicationKey &key = *order[i].key;
+			Node *node = Object::cast_to<Node>(ObjectDB::get_instance(key.node));
+			if (node && node->is_inside_tree()) {
+				const Variant *value = &queue[key].value;
+				_send_rpc(node, peer, true, true, key.property, &value, 1);
+			}
+			sent.push_back(key);
+
+			if (!network_peer.is_valid())
+				return; // Sending failed badly and disconnected.
+		}
+
+		for (int i = 0; i < sent.size(); i++) {
+			queue.erase(sent[i]);
+		}
+
+		if (queue.empty()) {
+			replication_queues.erase(E);
+		}
+		E = N;
+	}
+}
+
+void MultiplayerAPI::set_interest_enabled(bool p_enabled) {
+
+	interest_enabled = p_enabled;
+	if (!interest_enabled) {
+		replication_queues.clear();
+	}
+}
+
+bool MultiplayerAPI::is_interest_enabled() const {
+
+	return interest_enabled;
+}
+
+void MultiplayerAPI::set_interest_radius(real_t p_radius) {
+
+	ERR_FAIL_COND(p_radius <= 0);
+	interest_radius = p_radius;
+
+	// Cells are sized by the radius, bucket all peers again.
+	interest_grid.clear();
+	const int *K = NULL;
+	while ((K = interest_peers.next(K))) {
+		InterestPeer &ip = interest_peers[*K];
+		ip.cell = _get_interest_cell(ip.origin);
+		interest_grid[ip.cell].push_back(*K);
+	}
+}
+
+real_t MultiplayerAPI::get_interest_radius() const {
+
+	return interest_radius;
+}
+
+void MultiplayerAPI::set_interest_update_budget(int p_budget) {
+
+	ERR_FAIL_COND(p_budget < 0);
+	interest_update_budget = p_budget;
+}
+
+int MultiplayerAPI::get_interest_update_budget() const {
+
+	return interest_update_budget;
+}
+
+void MultiplayerAPI::set_peer_interest_origin(int p_peer, const Vector3 &p_origin) {
+
+	InterestCell cell = _get_interest_cell(p_origin);
+	InterestPeer *ip = interest_peers.getptr(p_peer);
+
+	if (ip && ip->cell == cell) {
+		ip->origin = p_origin;
+		return;
+	}
+
+	_remove_interest_peer(p_peer);
+
+	InterestPeer new_ip;
+	new_ip.origin = p_origin;
+	new_ip.cell = cell;
+	interest_peers.set(p_peer, new_ip);
+	interest_grid[cell].push_back(p_peer);
+}
+
+void MultiplayerAPI::clear_peer_interest_origin(int p_peer) {
+
+	_remove_interest_peer(p_peer);
+}
+
+void MultiplayerAPI::set_node_interest(Node *p_node, const Vector3 &p_origin, real_t p_priority) {
+
+	ERR_FAIL_NULL(p_node);
+	ERR_FAIL_COND(!p_node->is_inside_tree());
+	ERR_FAIL_COND(p_priority <= 0);
+
+	ObjectID id = p_node->get_instance_id();
+	if (!interest_nodes.has(id)) {
+		// Forget the node when it leaves the tree, freed nodes would stay in the map otherwise.
+		p_node->connect("tree_exiting", this, "_interest_node_exiting", varray(id), CONNECT_ONESHOT);
+	}
+
+	InterestNode in;
+	in.origin = p_origin;
+	in.priority = p_priority;
+	interest_nodes.set(id, in);
+}
+
+void MultiplayerAPI::clear_node_interest(Node *p_node) {
+
+	ERR_FAIL_NULL(p_node);
+
+	ObjectID id = p_node->get_instance_id();
+	if (interest_nodes.erase(id)) {
+		p_node->disconnect("tree_exiting", this, "_interest_node_exiting");
+	}
+}
+
+void MultiplayerAPI::_interest_node_exiting(ObjectID p_node) {
+
+	interest_nodes.erase(p_node);
+}
+
+Vector<int> MultiplayerAPI::get_interested_peers(Node *p_node) const {
+
+	Vector<int> ret;
+	ERR_FAIL_NULL_V(p_node, ret);
+
+	const InterestNode *interest = interest_nodes.getptr(p_node->get_instance_id());
+	if (!interest) {
+		return get_network_connected_peers();
+	}
+
+	_get_interested_peers(*interest, 0, ret);
+	return ret;
+}
+
+int MultiplayerAPI::get_pending_replication_count(int p_peer) const {
+
+	const Map<int, ReplicationQueue>::Element *E = replication_queues.find(p_peer);
+	return E ? E->get().size() : 0;
+}
+
+Error MultiplayerAPI::encode_and_compress_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_pos) {
+
+	uint8_t header = p_variant.get_type();
+	int len = 1;
+	uint8_t data[8];
+
+	switch (p_variant.get_type()) {
+
+		case Variant::NIL: {
+			// The type is enough.
+		} break;
+		case Variant::BOOL: {
+			if (p_variant.operator bool())
+				header |= 1 << VARIANT_COMPRESSION_SHIFT;
+		} break;
+		case Variant::INT: {
+			// Use the smallest size that holds the value.
+			int64_t val = p_variant;
+			if (val >= -0x80 && val <= 0x7F) {
+				header |= VARIANT_COMPRESSION_INT_8 << VARIANT_COMPRESSION_SHIFT;
+				data[0] = val;
+				len += 1;
+			} else if (val >= -0x8000 && val <= 0x7FFF) {
+				header |= VARIANT_COMPRESSION_INT_16 << VARIANT_COMPRESSION_SHIFT;
+				len += encode_uint16(val, data);
+			} else if (val >= -0x80000000LL && val <= 0x7FFFFFFFLL) {
+				header |= VARIANT_COMPRESSION_INT_32 << VARIANT_COMPRESSION_SHIFT;
+				len += encode_uint32(val, data);
+			} else {
+				header |= VARIANT_COMPRESSION_INT_64 << VARIANT_COMPRESSION_SHIFT;
+				len += encode_uint64(val, data);
+			}
+		} break;
+		case Variant::REAL: {
+			double d = p_variant;
+			float f = d;
+			if (double(f) == d) {
+				header |= VARIANT_COMPRESSION_REAL_32 << VARIANT_COMPRESSION_SHIFT;
+				len += encode_float(f, data);
+			} else {
+				header |= VARIANT_COMPRESSION_REAL_64 << VARIANT_COMPRESSION_SHIFT;
+				len += encode_double(d, data);
+			}
+		} break;
+		default: {
+			// Not compressed, the first byte of the regular encoding is the type, which is all the decoder needs.
+			return encode_variant_into(p_variant, r_buffer, r_pos, _is_object_decoding_enabled());
+		}
+	}
+
+	if (r_buffer.size() < r_pos + len)
+		r_buffer.resize(r_pos + len);
+
+	uint8_t *w = r_buffer.ptrw() + r_pos;
+	w[0] = header;
+	for (int i = 1; i < len; i++) {
+		w[i] = data[i - 1];
+	}
+	r_pos += len;
+
+	return OK;
+}
+
+Error MultiplayerAPI::decode_and_decompress_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len) {
+
+	ERR_FAIL_COND_V(p_len < 1, ERR_INVALID_DATA);
+
+	uint8_t type = p_buffer[0] & VARIANT_COMPRESSION_TYPE_MASK;
+	uint8_t compression = p_buffer[0] >> VARIANT_COMPRESSION_SHIFT;
+	int len = 1;
+
+	switch (type) {
+
+		case Variant::NIL: {
+			r_variant = Variant();
+		} break;
+		case Variant::BOOL: {
+			r_variant = compression != 0;
+		} break;
+		case Variant::INT: {
+			static const int sizes[4] = { 1, 2, 4, 8 };
+			len += sizes[compression];
+			ERR_FAIL_COND_V(p_len < len, ERR_INVALID_DATA);
+
+			if (compression == VARIANT_COMPRESSION_INT_8) {
+				r_variant = int8_t(p_buffer[1]);
+			} else if (compression == VARIANT_COMPRESSION_INT_16) {
+				r_variant = int16_t(decode_uint16(&p_buffer[1]));
+			} else if (compression == VARIANT_COMPRESSION_INT_32) {
+				r_variant = int32_t(decode_uint32(&p_buffer[1]));
+			} else {
+				r_variant = int64_t(decode_uint64(&p_buffer[1]));
+			}
+		} break;
+		case Variant::REAL: {
+			if (compression == VARIANT_COMPRESSION_REAL_32) {
+				len += 4;
+				ERR_FAIL_COND_V(p_len < len, ERR_INVALID_DATA);
+				r_variant = decode_float(&p_buffer[1]);
+			} else {
+				len += 8;
+				ERR_FAIL_COND_V(p_len < len, ERR_INVALID_DATA);
+				r_variant = decode_double(&p_buffer[1]);
+			}
+		} break;
+		default: {
+			ERR_FAIL_COND_V(compression != 0, ERR_INVALID_DATA);
+			return decode_variant(r_variant, p_buffer, p_len, r_len, _is_object_decoding_enabled());
+		}
+	}
+
+	if (r_len)
+		*r_len = len;
+
+	return OK;
+}
+
 void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_root_node", "node"), &MultiplayerAPI::set_root_node);
 	ClassDB::bind_method(D_METHOD("send_bytes", "bytes", "id", "mode"), &MultiplayerAPI::send_bytes, DEFVAL(NetworkedMultiplayerPeer::TARGET_PEER_BROADCAST), DEFVAL(NetworkedMultiplayerPeer::TRANSFER_MODE_RELIABLE));
@@ -841,6 +1600,7 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_rpc_sender_id"), &MultiplayerAPI::get_rpc_sender_id);
 	ClassDB::bind_method(D_METHOD("_add_peer", "id"), &MultiplayerAPI::_add_peer);
 	ClassDB::bind_method(D_METHOD("_del_peer", "id"), &MultiplayerAPI::_del_peer);
+	ClassDB::bind_method(D_METHOD("_interest_node_exiting", "node"), &MultiplayerAPI::_interest_node_exiting);
 	ClassDB::bind_method(D_METHOD("set_network_peer", "peer"), &MultiplayerAPI::set_network_peer);
 	ClassDB::bind_method(D_METHOD("poll"), &MultiplayerAPI::poll);
 	ClassDB::bind_method(D_METHOD("clear"), &MultiplayerAPI::clear);
@@ -853,10 +1613,25 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_refusing_new_network_connections"), &MultiplayerAPI::is_refusing_new_network_connections);
 	ClassDB::bind_method(D_METHOD("set_allow_object_decoding", "enable"), &MultiplayerAPI::set_allow_object_decoding);
 	ClassDB::bind_method(D_METHOD("is_object_decoding_allowed"), &MultiplayerAPI::is_object_decoding_allowed);
+	ClassDB::bind_method(D_METHOD("set_interest_enabled", "enabled"), &MultiplayerAPI::set_interest_enabled);
+	ClassDB::bind_method(D_METHOD("is_interest_enabled"), &MultiplayerAPI::is_interest_enabled);
+	ClassDB::bind_method(D_METHOD("set_interest_radius", "radius"), &MultiplayerAPI::set_interest_radius);
+	ClassDB::bind_method(D_METHOD("get_interest_radius"), &MultiplayerAPI::get_interest_radius);
+	ClassDB::bind_method(D_METHOD("set_interest_update_budget", "budget"), &MultiplayerAPI::set_interest_update_budget);
+	ClassDB::bind_method(D_METHOD("get_interest_update_budget"), &MultiplayerAPI::get_interest_update_budget);
+	ClassDB::bind_method(D_METHOD("set_peer_interest_origin", "id", "origin"), &MultiplayerAPI::set_peer_interest_origin);
+	ClassDB::bind_method(D_METHOD("clear_peer_interest_origin", "id"), &MultiplayerAPI::clear_peer_interest_origin);
+	ClassDB::bind_method(D_METHOD("set_node_interest", "node", "origin", "priority"), &MultiplayerAPI::set_node_interest, DEFVAL(1.0));
+	ClassDB::bind_method(D_METHOD("clear_node_interest", "node"), &MultiplayerAPI::clear_node_interest);
+	ClassDB::bind_method(D_METHOD("get_interested_peers", "node"), &MultiplayerAPI::get_interested_peers);
+	ClassDB::bind_method(D_METHOD("get_pending_replication_count", "id"), &MultiplayerAPI::get_pending_replication_count);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_object_decoding"), "set_allow_object_decoding", "is_object_decoding_allowed");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_network_connections"), "set_refuse_new_network_connections", "is_refusing_new_network_connections");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "network_peer", PROPERTY_HINT_RESOURCE_TYPE, "NetworkedMultiplayerPeer", 0), "set_network_peer", "get_network_peer");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "interest_enabled"), "set_interest_enabled", "is_interest_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "interest_radius"), "set_interest_radius", "get_interest_radius");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "interest_update_budget"), "set_interest_update_budget", "get_interest_update_budget");
 
 	ADD_SIGNAL(MethodInfo("network_peer_connected", PropertyInfo(Variant::INT, "id")));
 	ADD_SIGNAL(MethodInfo("network_peer_disconnected", PropertyInfo(Variant::INT, "id")));
@@ -880,6 +1655,9 @@ MultiplayerAPI::MultiplayerAPI() :
 		allow_object_decoding(false) {
 	rpc_sender_id = 0;
 	root_node = NULL;
+	interest_enabled = false;
+	interest_radius = 100;
+	interest_update_budget = 0;
 	clear();
 }
 
@@ -39,10 +39,23 @@ class MultiplayerAPI : public Reference {
 	GDCLASS(MultiplayerAPI, Reference);
 
 private:
+	//last value sent with reliable rset, and the peers that have it
+	struct RsetBaseline {
+		Variant value;
+		Set<int> peers;
+	};
+
 	//path sent caches
 	struct PathSentCache {
 		Map<int, bool> confirmed_peers;
 		int id;
+		HashMap<StringName, RsetBaseline> rset_baselines;
+	};
+
+	//method and property name sent caches
+	struct NameSentCache {
+		Map<int, bool> confirmed_peers;
+		int id;
 	};
 
 	//path get caches
@@ -50,34 +63,116 @@ private:
 		struct NodeInfo {
 			NodePath path;
 			ObjectID instance;
+			Map<StringName, Variant> rset_baselines;
 		};
 
 		Map<int, NodeInfo> nodes;
 	};
 
+	//method and property name get caches
+	struct NameGetCache {
+		Map<int, StringName> names;
+	};
+
+	//interest management, peers are bucketed in a grid of interest radius sized cells
+	struct InterestCell {
+		int32_t x;
+		int32_t y;
+		int32_t z;
+
+		_FORCE_INLINE_ uint32_t hash() const { return hash_djb2_one_32(z, hash_djb2_one_32(y, hash_djb2_one_32(x))); }
+		_FORCE_INLINE_ bool operator==(const InterestCell &p_cell) const { return x == p_cell.x && y == p_cell.y && z == p_cell.z; }
+	};
+
+	struct InterestCellHasher {
+		static _FORCE_INLINE_ uint32_t hash(const InterestCell &p_cell) { return p_cell.hash(); }
+	};
+
+	struct InterestPeer {
+		Vector3 origin;
+		InterestCell cell;
+	};
+
+	struct InterestNode {
+		Vector3 origin;
+		real_t priority;
+	};
+
+	//unreliable sets waiting for their turn, only the latest value of each property is kept
+	struct ReplicationKey {
+		ObjectID node;
+		StringName property;
+
+		_FORCE_INLINE_ bool operator==(const ReplicationKey &p_key) const { return node == p_key.node && property == p_key.property; }
+	};
+
+	struct ReplicationKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const ReplicationKey &p_key) { return hash_djb2_one_64(p_key.node, p_key.property.hash()); }
+	};
+
+	struct PendingReplication {
+		Variant value;
+		real_t priority;
+	};
+
+	typedef HashMap<ReplicationKey, PendingReplication, ReplicationKeyHasher> ReplicationQueue;
+
+	struct ReplicationSort {
+		const ReplicationKey *key;
+		real_t priority;
+
+		bool operator<(const ReplicationSort &p_other) const { return priority > p_other.priority; }
+	};
+
 	Ref<NetworkedMultiplayerPeer> network_peer;
 	int rpc_sender_id;
 	Set<int> connected_peers;
 	HashMap<NodePath, PathSentCache> path_send_cache;
 	Map<int, PathGetCache> path_get_cache;
+	HashMap<StringName, NameSentCache> name_send_cache;
+	Map<int, NameGetCache> name_get_cache;
 	int last_send_cache_id;
+	int last_name_cache_id;
 	Vector<uint8_t> packet_cache;
+	Vector<uint8_t> arg_cache;
 	Node *root_node;
 	bool allow_object_decoding;
 
+	bool interest_enabled;
+	real_t interest_radius;
+	int interest_update_budget;
+	HashMap<int, InterestPeer> interest_peers;
+	HashMap<InterestCell, Vector<int>, InterestCellHasher> interest_grid;
+	HashMap<ObjectID, InterestNode> interest_nodes;
+	Map<int, ReplicationQueue> replication_queues;
+
+	_FORCE_INLINE_ InterestCell _get_interest_cell(const Vector3 &p_origin) const;
+	void _remove_interest_peer(int p_peer);
+	bool _get_interested_peers(const InterestNode &p_node, int p_target, Vector<int> &r_peers) const;
+	real_t _get_interest_factor(const InterestNode &p_node, int p_peer) const;
+	void _schedule_rset(int p_peer, Node *p_node, const StringName &p_property, const Variant &p_value);
+	void _process_replication();
+	void _interest_node_exiting(ObjectID p_node);
+
 protected:
 	static void _bind_methods();
 
 	void _process_packet(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _process_simplify_path(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _process_confirm_path(int p_from, const uint8_t *p_packet, int p_packet_len);
-	Node *_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_simplify_name(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_confirm_name(int p_from, const uint8_t *p_packet, int p_packet_len);
+	Node *_process_get_node(int p_from, const uint8_t *p_packet, int p_packet_len, int &r_offset, PathGetCache::NodeInfo **r_node_info);
+	StringName _process_get_name(int p_from, const uint8_t *p_packet, int p_packet_len, int &r_offset);
 	void _process_rpc(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
-	void _process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset);
+	void _process_rset(Node *p_node, const StringName &p_name, int p_from, const uint8_t *p_packet, int p_packet_len, int p_offset, PathGetCache::NodeInfo *p_node_info, bool p_baseline);
 	void _process_raw(int p_from, const uint8_t *p_packet, int p_packet_len);
 
 	void _send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p_set, const StringName &p_name, const Variant **p_arg, int p_argcount);
 	bool _send_confirm_path(NodePath p_path, PathSentCache *psc, int p_from);
+	bool _send_confirm_name(const StringName &p_name, NameSentCache *nsc, int p_target);
+	int _make_rpc_packet(uint8_t p_command, int p_path_id, const CharString *p_path, int p_name_id, const CharString *p_name, bool p_baseline, int p_args_len);
+	bool _is_object_decoding_enabled() const;
 
 public:
 	enum NetworkCommands {
@@ -86,6 +181,36 @@ public:
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
 		NETWORK_COMMAND_RAW,
+		NETWORK_COMMAND_SIMPLIFY_NAME,
+		NETWORK_COMMAND_CONFIRM_NAME,
+	};
+
+	// Layout of the first byte of a remote call or set packet.
+	enum PacketHeader {
+		HEADER_COMMAND_MASK = 0x07,
+		HEADER_NODE_ID_SHIFT = 3, // How the node is addressed, see IDCompression.
+		HEADER_NAME_ID_SHIFT = 5, // How the method or property is addressed, see IDCompression.
+		HEADER_ID_COMPRESSION_MASK = 0x03,
+		HEADER_RSET_BASELINE = 0x80, // Remote set kept as baseline, an empty value means the baseline is unchanged.
+	};
+
+	enum IDCompression {
+		ID_COMPRESSION_8,
+		ID_COMPRESSION_16,
+		ID_COMPRESSION_32,
+		ID_COMPRESSION_INLINE, // Not cached yet, sent as a string.
+	};
+
+	// Compressed arguments start with the variant type, the two upper bits say how the value is stored.
+	enum VariantCompression {
+		VARIANT_COMPRESSION_TYPE_MASK = 0x3F,
+		VARIANT_COMPRESSION_SHIFT = 6,
+		VARIANT_COMPRESSION_INT_8 = 0,
+		VARIANT_COMPRESSION_INT_16 = 1,
+		VARIANT_COMPRESSION_INT_32 = 2,
+		VARIANT_COMPRESSION_INT_64 = 3,
+		VARIANT_COMPRESSION_REAL_32 = 0,
+		VARIANT_COMPRESSION_REAL_64 = 1,
 	};
 
 	enum RPCMode {
@@ -130,6 +255,25 @@ public:
 	void set_allow_object_decoding(bool p_enable);
 	bool is_object_decoding_allowed() const;
 
+	void set_interest_enabled(bool p_enabled);
+	bool is_interest_enabled() const;
+	void set_interest_radius(real_t p_radius);
+	real_t get_interest_radius() const;
+	void set_interest_update_budget(int p_budget);
+	int get_interest_update_budget() const;
+
+	void set_peer_interest_origin(int p_peer, const Vector3 &p_origin);
+	void clear_peer_interest_origin(int p_peer);
+	void set_node_interest(Node *p_node, const Vector3 &p_origin, real_t p_priority = 1.0);
+	void clear_node_interest(Node *p_node);
+	Vector<int> get_interested_peers(Node *p_node) const;
+	int get_pending_replication_count(int p_peer) const;
+
+	// Encoding used for remote call arguments and set values. Null, bools, ints and reals take one to nine bytes,
+	// everything else is stored as encode_variant() does, with the type in the first byte.
+	Error encode_and_compress_variant(const Variant &p_variant, Vector<uint8_t> &r_buffer, int &r_pos);
+	Error decode_and_decompress_variant(Variant &r_variant, const uint8_t *p_buffer, int p_len, int *r_len = NULL);
+
 	MultiplayerAPI();
 	~MultiplayerAPI();
 };
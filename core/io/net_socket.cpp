@@ -40,3 +40,14 @@ NetSocket *NetSocket::create() {
 	ERR_PRINT("Unable to create network socket, platform not supported");
 	return NULL;
 }
+
+NetSocketSet *(*NetSocketSet::_create)() = NULL;
+
+NetSocketSet *NetSocketSet::create() {
+
+	if (_create)
+		return _create();
+
+	ERR_PRINT("Unable to create network socket set, platform not supported");
+	return NULL;
+}
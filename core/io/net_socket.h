@@ -76,4 +76,33 @@ public:
 	virtual void set_reuse_address_enabled(bool p_enabled) = 0;
 };
 
+// Watches many sockets at once, so a single call reports which of them are ready.
+class NetSocketSet : public Reference {
+
+protected:
+	static NetSocketSet *(*_create)();
+
+public:
+	static NetSocketSet *create();
+
+	struct Event {
+		int id;
+		bool readable;
+		bool writable;
+		bool error; // Error or hang up, the next read or write tells which.
+	};
+
+	// Sockets are identified by an ID chosen by the caller. Remove a socket before closing it, or at
+	// least before adding another one, as closed sockets can't be told apart from new ones reusing them.
+	virtual Error add(const Ref<NetSocket> &p_socket, NetSocket::PollType p_type, int p_id) = 0;
+	virtual Error modify(int p_id, NetSocket::PollType p_type) = 0;
+	virtual void remove(int p_id) = 0;
+	virtual bool has(int p_id) const = 0;
+	virtual int get_count() const = 0;
+
+	// Waits up to p_timeout milliseconds (-1 to block) for any socket to be ready, and fills r_events with the
+	// ready ones. Returns OK with no events on timeout.
+	virtual Error wait(int p_timeout, Vector<Event> &r_events) = 0;
+};
+
 #endif // NET_SOCKET_H
@@ -92,20 +92,15 @@ Error PacketPeer::get_var(Variant &r_variant, bool p_allow_objects) {
 
 Error PacketPeer::put_var(const Variant &p_packet, bool p_full_objects) {
 
-	int len;
-	Error err = encode_variant(p_packet, NULL, len, p_full_objects || allow_object_decoding); // compute len first
+	int len = 0;
+	Error err = encode_variant_into(p_packet, encode_buffer, len, p_full_objects || allow_object_decoding);
 	if (err)
 		return err;
 
 	if (len == 0)
 		return OK;
 
-	uint8_t *buf = (uint8_t *)alloca(len);
-	ERR_FAIL_COND_V(!buf, ERR_OUT_OF_MEMORY);
-	err = encode_variant(p_packet, buf, len, p_full_objects || allow_object_decoding);
-	ERR_FAIL_COND_V(err, err);
-
-	return put_packet(buf, len);
+	return put_packet(encode_buffer.ptr(), len);
 }
 
 Variant PacketPeer::_bnd_get_var(bool p_allow_objects) {
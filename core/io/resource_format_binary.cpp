@@ -34,6 +34,7 @@
 #include "core/io/file_access_compressed.h"
 #include "core/io/marshalls.h"
 #include "core/os/dir_access.h"
+#include "core/os/os.h"
 #include "core/project_settings.h"
 #include "core/version.h"
 
@@ -86,9 +87,12 @@ enum {
 	OBJECT_EXTERNAL_RESOURCE_INDEX = 3,
 	//version 2: added 64 bits support for float and int
 	//version 3: changed nodepath encoding
-	FORMAT_VERSION = 3,
+	//version 4: numeric arrays are aligned
+	FORMAT_VERSION = 4,
 	FORMAT_VERSION_CAN_RENAME_DEPS = 1,
 	FORMAT_VERSION_NO_NODEPATH_PROPERTY = 3,
+	FORMAT_VERSION_ALIGNED_ARRAYS = 4,
+	MAP_ARRAY_MIN_SIZE = 65536, // Smaller arrays are cheaper to read than to map.
 
 };
 
@@ -101,6 +105,82 @@ void ResourceInteractiveLoaderBinary::_advance_padding(uint32_t p_len) {
 	}
 }
 
+bool ResourceInteractiveLoaderBinary::_map_file() {
+
+	if (!mapped_file_tried) {
+		mapped_file_tried = true;
+
+		// Only files on the native filesystem have an absolute path, packed and compressed files are read.
+		String path = f->get_path_absolute();
+		const uint8_t *data = NULL;
+		uint64_t size = 0;
+		if (path != "" && OS::get_singleton()->map_file(path, data, size) == OK) {
+			mapped_file = memnew(MappedFile);
+			mapped_file->refcount.init();
+			mapped_file->data = data;
+			mapped_file->size = size;
+		}
+	}
+
+	return mapped_file != NULL;
+}
+
+void ResourceInteractiveLoaderBinary::_unreference_mapped_file(void *p_mapped_file) {
+
+	MappedFile *mf = (MappedFile *)p_mapped_file;
+	if (mf->refcount.unref()) {
+		OS::get_singleton()->unmap_file(mf->data, mf->size);
+		memdelete(mf);
+	}
+}
+
+// Reads the payload of a numeric pool array. Since format 4 it starts at an aligned offset,
+// which lets large arrays be mapped from the file instead of read: their pages are then
+// only loaded on first access, and shared by every process using the same file until written.
+template <class T>
+Error ResourceInteractiveLoaderBinary::_parse_array(PoolVector<T> &r_array, uint32_t p_len, bool p_swap32) {
+
+	size_t size = (size_t)p_len * sizeof(T);
+
+	if (ver_format >= FORMAT_VERSION_ALIGNED_ARRAYS) {
+
+		uint32_t pad = f->get_32();
+		ERR_FAIL_COND_V(pad >= ResourceFormatSaverBinaryInstance::ARRAY_ALIGNMENT, ERR_FILE_CORRUPT);
+		for (uint32_t i = 0; i < pad; i++)
+			f->get_8();
+
+		size_t ofs = f->get_position();
+		if (map_arrays && size >= MAP_ARRAY_MIN_SIZE && ofs % ResourceFormatSaverBinaryInstance::ARRAY_ALIGNMENT == 0) {
+			// Not aligned if the file was edited without being saved again, e.g. by rename_dependencies.
+			if (_map_file() && ofs + size <= mapped_file->size) {
+				mapped_file->refcount.ref();
+				if (r_array.adopt_external((const T *)(mapped_file->data + ofs), p_len, _unreference_mapped_file, mapped_file) == OK) {
+					f->seek(ofs + size);
+					return OK;
+				}
+				_unreference_mapped_file(mapped_file);
+			}
+		}
+	}
+
+	r_array.resize(p_len);
+	if (p_len == 0)
+		return OK;
+
+	typename PoolVector<T>::Write w = r_array.write();
+	f->get_buffer((uint8_t *)w.ptr(), size);
+#ifdef BIG_ENDIAN_ENABLED
+	if (p_swap32) {
+		uint32_t *ptr = (uint32_t *)w.ptr();
+		for (size_t i = 0; i < size / 4; i++) {
+
+			ptr[i] = BSWAP32(ptr[i]);
+		}
+	}
+#endif
+	return OK;
+}
+
 StringName ResourceInteractiveLoaderBinary::_get_string() {
 
 	uint32_t id = f->get_32();
@@ -406,11 +486,9 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			uint32_t len = f->get_32();
 
 			PoolVector<uint8_t> array;
-			array.resize(len);
-			PoolVector<uint8_t>::Write w = array.write();
-			f->get_buffer(w.ptr(), len);
+			Error err = _parse_array(array, len, false);
+			ERR_FAIL_COND_V(err != OK, err);
 			_advance_padding(len);
-			w = PoolVector<uint8_t>::Write();
 			r_v = array;
 
 		} break;
@@ -419,20 +497,8 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			uint32_t len = f->get_32();
 
 			PoolVector<int> array;
-			array.resize(len);
-			PoolVector<int>::Write w = array.write();
-			f->get_buffer((uint8_t *)w.ptr(), len * 4);
-#ifdef BIG_ENDIAN_ENABLED
-			{
-				uint32_t *ptr = (uint32_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
-
-					ptr[i] = BSWAP32(ptr[i]);
-				}
-			}
-
-#endif
-			w = PoolVector<int>::Write();
+			Error err = _parse_array(array, len, true);
+			ERR_FAIL_COND_V(err != OK, err);
 			r_v = array;
 		} break;
 		case VARIANT_REAL_ARRAY: {
@@ -440,21 +506,8 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			uint32_t len = f->get_32();
 
 			PoolVector<real_t> array;
-			array.resize(len);
-			PoolVector<real_t>::Write w = array.write();
-			f->get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t));
-#ifdef BIG_ENDIAN_ENABLED
-			{
-				uint32_t *ptr = (uint32_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
-
-					ptr[i] = BSWAP32(ptr[i]);
-				}
-			}
-
-#endif
-
-			w = PoolVector<real_t>::Write();
+			Error err = _parse_array(array, len, true);
+			ERR_FAIL_COND_V(err != OK, err);
 			r_v = array;
 		} break;
 		case VARIANT_STRING_ARRAY: {
@@ -474,26 +527,13 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			uint32_t len = f->get_32();
 
 			PoolVector<Vector2> array;
-			array.resize(len);
-			PoolVector<Vector2>::Write w = array.write();
 			if (sizeof(Vector2) == 8) {
-				f->get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 2);
-#ifdef BIG_ENDIAN_ENABLED
-				{
-					uint32_t *ptr = (uint32_t *)w.ptr();
-					for (int i = 0; i < len * 2; i++) {
-
-						ptr[i] = BSWAP32(ptr[i]);
-					}
-				}
-
-#endif
-
+				Error err = _parse_array(array, len, true);
+				ERR_FAIL_COND_V(err != OK, err);
 			} else {
 				ERR_EXPLAIN("Vector2 size is NOT 8!");
 				ERR_FAIL_V(ERR_UNAVAILABLE);
 			}
-			w = PoolVector<Vector2>::Write();
 			r_v = array;
 
 		} break;
@@ -502,26 +542,13 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			uint32_t len = f->get_32();
 
 			PoolVector<Vector3> array;
-			array.resize(len);
-			PoolVector<Vector3>::Write w = array.write();
 			if (sizeof(Vector3) == 12) {
-				f->get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 3);
-#ifdef BIG_ENDIAN_ENABLED
-				{
-					uint32_t *ptr = (uint32_t *)w.ptr();
-					for (int i = 0; i < len * 3; i++) {
-
-						ptr[i] = BSWAP32(ptr[i]);
-					}
-				}
-
-#endif
-
+				Error err = _parse_array(array, len, true);
+				ERR_FAIL_COND_V(err != OK, err);
 			} else {
 				ERR_EXPLAIN("Vector3 size is NOT 12!");
 				ERR_FAIL_V(ERR_UNAVAILABLE);
 			}
-			w = PoolVector<Vector3>::Write();
 			r_v = array;
 
 		} break;
@@ -530,26 +557,13 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			uint32_t len = f->get_32();
 
 			PoolVector<Color> array;
-			array.resize(len);
-			PoolVector<Color>::Write w = array.write();
 			if (sizeof(Color) == 16) {
-				f->get_buffer((uint8_t *)w.ptr(), len * sizeof(real_t) * 4);
-#ifdef BIG_ENDIAN_ENABLED
-				{
-					uint32_t *ptr = (uint32_t *)w.ptr();
-					for (int i = 0; i < len * 4; i++) {
-
-						ptr[i] = BSWAP32(ptr[i]);
-					}
-				}
-
-#endif
-
+				Error err = _parse_array(array, len, true);
+				ERR_FAIL_COND_V(err != OK, err);
 			} else {
 				ERR_EXPLAIN("Color size is NOT 16!");
 				ERR_FAIL_V(ERR_UNAVAILABLE);
 			}
-			w = PoolVector<Color>::Write();
 			r_v = array;
 		} break;
 #ifndef DISABLE_DEPRECATED
@@ -863,6 +877,12 @@ void ResourceInteractiveLoaderBinary::open(FileAccess *p_f) {
 	uint32_t ver_minor = f->get_32();
 	ver_format = f->get_32();
 
+#ifdef BIG_ENDIAN_ENABLED
+	map_arrays = false;
+#else
+	map_arrays = !big_endian && ResourceFormatLoaderBinary::is_array_mapping_enabled();
+#endif
+
 	print_bl("big endian: " + itos(big_endian));
 #ifdef BIG_ENDIAN_ENABLED
 	print_bl("endian swap: " + itos(!big_endian));
@@ -972,6 +992,9 @@ String ResourceInteractiveLoaderBinary::recognize(FileAccess *p_f) {
 
 ResourceInteractiveLoaderBinary::ResourceInteractiveLoaderBinary() :
 		translation_remapped(false),
+		map_arrays(false),
+		mapped_file(NULL),
+		mapped_file_tried(false),
 		f(NULL),
 		error(OK),
 		stage(0) {
@@ -981,8 +1004,12 @@ ResourceInteractiveLoaderBinary::~ResourceInteractiveLoaderBinary() {
 
 	if (f)
 		memdelete(f);
+	if (mapped_file)
+		_unreference_mapped_file(mapped_file);
 }
 
+bool ResourceFormatLoaderBinary::array_mapping = true;
+
 Ref<ResourceInteractiveLoader> ResourceFormatLoaderBinary::load_interactive(const String &p_path, const String &p_original_path, Error *r_error) {
 
 	if (r_error)
@@ -1285,6 +1312,15 @@ void ResourceFormatSaverBinaryInstance::_pad_buffer(FileAccess *f, int p_bytes)
 	}
 }
 
+void ResourceFormatSaverBinaryInstance::_align_array(FileAccess *f) {
+
+	// Explicit, so arrays can still be read if a tool moves them.
+	uint32_t pad = (ARRAY_ALIGNMENT - (f->get_position() + 4) % ARRAY_ALIGNMENT) % ARRAY_ALIGNMENT;
+	f->store_32(pad);
+	for (uint32_t i = 0; i < pad; i++)
+		f->store_8(0);
+}
+
 void ResourceFormatSaverBinaryInstance::_write_variant(const Variant &p_property, const PropertyInfo &p_hint) {
 
 	write_variant(f, p_property, resource_set, external_resources, string_map, p_hint);
@@ -1549,6 +1585,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			PoolVector<uint8_t> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array(f);
 			PoolVector<uint8_t>::Read r = arr.read();
 			f->store_buffer(r.ptr(), len);
 			_pad_buffer(f, len);
@@ -1560,6 +1597,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			PoolVector<int> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array(f);
 			PoolVector<int>::Read r = arr.read();
 			for (int i = 0; i < len; i++)
 				f->store_32(r[i]);
@@ -1571,6 +1609,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			PoolVector<real_t> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array(f);
 			PoolVector<real_t>::Read r = arr.read();
 			for (int i = 0; i < len; i++) {
 				f->store_real(r[i]);
@@ -1595,6 +1634,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			PoolVector<Vector3> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array(f);
 			PoolVector<Vector3>::Read r = arr.read();
 			for (int i = 0; i < len; i++) {
 				f->store_real(r[i].x);
@@ -1609,6 +1649,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			PoolVector<Vector2> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array(f);
 			PoolVector<Vector2>::Read r = arr.read();
 			for (int i = 0; i < len; i++) {
 				f->store_real(r[i].x);
@@ -1622,6 +1663,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			PoolVector<Color> arr = p_property;
 			int len = arr.size();
 			f->store_32(len);
+			_align_array(f);
 			PoolVector<Color>::Read r = arr.read();
 			for (int i = 0; i < len; i++) {
 				f->store_real(r[i].r);
@@ -43,6 +43,20 @@ class ResourceInteractiveLoaderBinary : public ResourceInteractiveLoader {
 	String type;
 	Ref<Resource> resource;
 	uint32_t ver_format;
+	bool map_arrays;
+
+	// The file mapped with OS::map_file(), referenced by the loader and every array using it.
+	struct MappedFile {
+		SafeRefCount refcount;
+		const uint8_t *data;
+		uint64_t size;
+	};
+
+	MappedFile *mapped_file;
+	bool mapped_file_tried;
+
+	bool _map_file();
+	static void _unreference_mapped_file(void *p_mapped_file);
 
 	FileAccess *f;
 
@@ -80,6 +94,8 @@ class ResourceInteractiveLoaderBinary : public ResourceInteractiveLoader {
 
 	friend class ResourceFormatLoaderBinary;
 
+	template <class T>
+	Error _parse_array(PoolVector<T> &r_array, uint32_t p_len, bool p_swap32);
 	Error parse_variant(Variant &r_v);
 
 public:
@@ -101,7 +117,13 @@ public:
 
 class ResourceFormatLoaderBinary : public ResourceFormatLoader {
 	GDCLASS(ResourceFormatLoaderBinary, ResourceFormatLoader)
+
+	static bool array_mapping;
+
 public:
+	static void set_array_mapping(bool p_enable) { array_mapping = p_enable; }
+	static bool is_array_mapping_enabled() { return array_mapping; }
+
 	virtual Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_original_path = "", Error *r_error = NULL);
 	virtual void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions) const;
 	virtual void get_recognized_extensions(List<String> *p_extensions) const;
@@ -151,12 +173,17 @@ class ResourceFormatSaverBinaryInstance {
 	};
 
 	static void _pad_buffer(FileAccess *f, int p_bytes);
+	static void _align_array(FileAccess *f);
 	void _write_variant(const Variant &p_property, const PropertyInfo &p_hint = PropertyInfo());
 	void _find_resources(const Variant &p_variant, bool p_main = false);
 	static void save_unicode_string(FileAccess *f, const String &p_string, bool p_bit_on_len = false);
 	int get_string_index(const String &p_string);
 
 public:
+	enum {
+		ARRAY_ALIGNMENT = 16 // Of numeric array payloads, relative to the start of the file.
+	};
+
 	Error save(const String &p_path, const RES &p_resource, uint32_t p_flags = 0);
 	static void write_variant(FileAccess *f, const Variant &p_property, Set<RES> &resource_set, Map<RES, int> &external_resources, Map<StringName, int> &string_map, const PropertyInfo &p_hint = PropertyInfo());
 };
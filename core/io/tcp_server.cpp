@@ -36,6 +36,12 @@ void TCP_Server::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_connection_available"), &TCP_Server::is_connection_available);
 	ClassDB::bind_method(D_METHOD("take_connection"), &TCP_Server::take_connection);
 	ClassDB::bind_method(D_METHOD("stop"), &TCP_Server::stop);
+	ClassDB::bind_method(D_METHOD("set_watch_connections", "enable"), &TCP_Server::set_watch_connections);
+	ClassDB::bind_method(D_METHOD("is_watching_connections"), &TCP_Server::is_watching_connections);
+	ClassDB::bind_method(D_METHOD("poll", "timeout"), &TCP_Server::poll, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_ready_connections"), &TCP_Server::get_ready_connections);
+
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "watch_connections"), "set_watch_connections", "is_watching_connections");
 }
 
 Error TCP_Server::listen(uint16_t p_port, const IP_Address &p_bind_address) {
@@ -72,6 +78,10 @@ Error TCP_Server::listen(uint16_t p_port, const IP_Address &p_bind_address) {
 		_sock->close();
 		return FAILED;
 	}
+
+	if (_socket_set.is_valid()) {
+		_socket_set->add(_sock, NetSocket::POLL_TYPE_IN, 0);
+	}
 	return OK;
 }
 
@@ -106,18 +116,109 @@ Ref<StreamPeerTCP> TCP_Server::take_connection() {
 
 	conn = Ref<StreamPeerTCP>(memnew(StreamPeerTCP));
 	conn->accept_socket(ns, ip, port);
+
+	if (_socket_set.is_valid()) {
+		int id = ++last_watch_id;
+		if (_socket_set->add(ns, NetSocket::POLL_TYPE_IN, id) == OK) {
+			WatchedConnection wc;
+			wc.peer = conn;
+			wc.sock = ns;
+			watched[id] = wc;
+		}
+	}
 	return conn;
 }
 
 void TCP_Server::stop() {
 
+	if (_socket_set.is_valid()) {
+		_socket_set->remove(0);
+		for (Map<int, WatchedConnection>::Element *E = watched.front(); E; E = E->next()) {
+			_socket_set->remove(E->key());
+		}
+		watched.clear();
+		ready_connections.clear();
+	}
+
 	if (_sock.is_valid()) {
 		_sock->close();
 	}
 }
 
+void TCP_Server::set_watch_connections(bool p_enable) {
+
+	if (p_enable == watch_connections)
+		return;
+
+	watch_connections = p_enable;
+
+	if (!watch_connections) {
+		watched.clear();
+		ready_connections.clear();
+		_socket_set.unref();
+		return;
+	}
+
+	// Connections taken before are not watched.
+	_socket_set = Ref<NetSocketSet>(NetSocketSet::create());
+	ERR_FAIL_COND(!_socket_set.is_valid());
+
+	if (_sock.is_valid() && _sock->is_open()) {
+		_socket_set->add(_sock, NetSocket::POLL_TYPE_IN, 0);
+	}
+}
+
+bool TCP_Server::is_watching_connections() const {
+
+	return watch_connections;
+}
+
+Error TCP_Server::poll(int p_timeout) {
+
+	ERR_EXPLAIN("Watching connections is not enabled.");
+	ERR_FAIL_COND_V(!_socket_set.is_valid(), ERR_UNCONFIGURED);
+
+	ready_connections.clear();
+
+	// Forget connections closed since the last poll, before their sockets are reused.
+	for (Map<int, WatchedConnection>::Element *E = watched.front(); E;) {
+		Map<int, WatchedConnection>::Element *N = E->next();
+		if (!E->get().sock->is_open()) {
+			_socket_set->remove(E->key());
+			watched.erase(E);
+		}
+		E = N;
+	}
+
+	Vector<NetSocketSet::Event> events;
+	Error err = _socket_set->wait(p_timeout, events);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	for (int i = 0; i < events.size(); i++) {
+
+		if (events[i].id == 0)
+			continue; // New connections are taken with take_connection().
+
+		Map<int, WatchedConnection>::Element *E = watched.find(events[i].id);
+		if (E) {
+			// Data arrived or the connection closed, reading tells which.
+			ready_connections.push_back(E->get().peer);
+		}
+	}
+
+	return OK;
+}
+
+Array TCP_Server::get_ready_connections() const {
+
+	return ready_connections;
+}
+
 TCP_Server::TCP_Server() :
 		_sock(Ref<NetSocket>(NetSocket::create())) {
+
+	watch_connections = false;
+	last_watch_id = 0;
 }
 
 TCP_Server::~TCP_Server() {
@@ -46,6 +46,19 @@ protected:
 	};
 
 	Ref<NetSocket> _sock;
+
+	// Taken connections, watched together with the listening socket when enabled.
+	struct WatchedConnection {
+		Ref<StreamPeerTCP> peer;
+		Ref<NetSocket> sock;
+	};
+
+	bool watch_connections;
+	Ref<NetSocketSet> _socket_set;
+	Map<int, WatchedConnection> watched;
+	int last_watch_id;
+	Array ready_connections;
+
 	static void _bind_methods();
 
 public:
@@ -55,6 +68,11 @@ public:
 
 	void stop(); // Stop listening
 
+	void set_watch_connections(bool p_enable);
+	bool is_watching_connections() const;
+	Error poll(int p_timeout = 0);
+	Array get_ready_connections() const;
+
 	TCP_Server();
 	~TCP_Server();
 };
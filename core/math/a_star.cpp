@@ -31,149 +31,306 @@
 #include "a_star.h"
 
 #include "core/math/geometry.h"
+#include "core/path_request_queue.h"
 #include "core/script_language.h"
 #include "scene/scene_string_names.h"
 
+AStarSearchState *AStarSearchContext::begin_search(int p_point_count) {
+
+	int prev_size = states.size();
+	if (prev_size < p_point_count) {
+		states.resize(p_point_count);
+		for (int i = prev_size; i < p_point_count; i++) {
+			states.write[i].pass = 0;
+		}
+	}
+
+	AStarSearchState *ptr = states.ptrw();
+
+	pass++;
+	if (pass == 0) {
+		// Wrapped around, old passes could match again.
+		for (int i = 0; i < states.size(); i++) {
+			ptr[i].pass = 0;
+		}
+		pass = 1;
+	}
+
+	open_list.clear();
+	return ptr;
+}
+
 int AStar::get_available_point_id() const {
 
-	if (points.empty()) {
+	if (point_ids.get_num_elements() == 0) {
 		return 1;
 	}
 
-	return points.back()->key() + 1;
+	if (max_id_dirty) {
+		// The highest id was removed, find the new one.
+		AStar *self = const_cast<AStar *>(this);
+		self->max_id = -1;
+		for (int i = 0; i < point_data.size(); i++) {
+			self->max_id = MAX(max_id, point_data[i].id);
+		}
+		self->max_id_dirty = false;
+	}
+
+	return max_id + 1;
 }
 
 void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND(_is_computing_script_costs());
+
+	RWLockWrite write_lock(points_lock);
+
 	ERR_FAIL_COND(p_id < 0);
 	ERR_FAIL_COND(p_weight_scale < 1);
 
-	if (!points.has(p_id)) {
-		Point *pt = memnew(Point);
-		pt->id = p_id;
-		pt->pos = p_pos;
-		pt->weight_scale = p_weight_scale;
-		pt->prev_point = NULL;
-		pt->last_pass = 0;
-		points[p_id] = pt;
+	int slot = _get_slot(p_id);
+	if (slot < 0) {
+		if (free_slots.size()) {
+			slot = free_slots[free_slots.size() - 1];
+			free_slots.resize(free_slots.size() - 1);
+		} else {
+			slot = point_data.size();
+			point_data.resize(slot + 1);
+		}
+
+		Point &pt = point_data.write[slot];
+		pt.id = p_id;
+		pt.pos = p_pos;
+		pt.weight_scale = p_weight_scale;
+		pt.enabled = true;
+		point_ids.set(p_id, slot);
+
+		if (!max_id_dirty) {
+			max_id = MAX(max_id, p_id);
+		}
+		adjacency_dirty = true;
 	} else {
-		points[p_id]->pos = p_pos;
-		points[p_id]->weight_scale = p_weight_scale;
+		Point &pt = point_data.write[slot];
+		pt.pos = p_pos;
+		pt.weight_scale = p_weight_scale;
 	}
+
+	_invalidate_flow_fields();
 }
 
 Vector3 AStar::get_point_position(int p_id) const {
 
-	ERR_FAIL_COND_V(!points.has(p_id), Vector3());
+	int slot = _get_slot(p_id);
+	ERR_FAIL_COND_V(slot < 0, Vector3());
 
-	return points[p_id]->pos;
+	return point_data[slot].pos;
 }
 
 void AStar::set_point_position(int p_id, const Vector3 &p_pos) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND(_is_computing_script_costs());
+
+	RWLockWrite write_lock(points_lock);
 
-	points[p_id]->pos = p_pos;
+	int slot = _get_slot(p_id);
+	ERR_FAIL_COND(slot < 0);
+
+	point_data.write[slot].pos = p_pos;
+	_invalidate_flow_fields();
 }
 
 real_t AStar::get_point_weight_scale(int p_id) const {
 
-	ERR_FAIL_COND_V(!points.has(p_id), 0);
+	int slot = _get_slot(p_id);
+	ERR_FAIL_COND_V(slot < 0, 0);
 
-	return points[p_id]->weight_scale;
+	return point_data[slot].weight_scale;
 }
 
 void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND(_is_computing_script_costs());
+
+	RWLockWrite write_lock(points_lock);
+
+	int slot = _get_slot(p_id);
+	ERR_FAIL_COND(slot < 0);
 	ERR_FAIL_COND(p_weight_scale < 1);
 
-	points[p_id]->weight_scale = p_weight_scale;
+	point_data.write[slot].weight_scale = p_weight_scale;
+	_invalidate_flow_fields();
 }
 
 void AStar::remove_point(int p_id) {
 
-	ERR_FAIL_COND(!points.has(p_id));
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND(_is_computing_script_costs());
 
-	Point *p = points[p_id];
+	RWLockWrite write_lock(points_lock);
 
-	Map<int, Point *>::Element *PE = points.front();
-	while (PE) {
-		for (Set<Point *>::Element *E = PE->get()->neighbours.front(); E; E = E->next()) {
-			Segment s(p_id, E->get()->id);
-			segments.erase(s);
-			E->get()->neighbours.erase(p);
-		}
-		PE = PE->next();
+	int slot = _get_slot(p_id);
+	ERR_FAIL_COND(slot < 0);
+
+	Point &p = point_data.write[slot];
+
+	for (int i = 0; i < p.neighbours.size(); i++) {
+		Point &n = point_data.write[p.neighbours[i]];
+		segments.erase(Segment(p_id, n.id));
+		n.neighbours.erase(slot);
+		n.unlinked_neighbours.erase(slot);
 	}
 
-	memdelete(p);
-	points.erase(p_id);
+	for (int i = 0; i < p.unlinked_neighbours.size(); i++) {
+		Point &n = point_data.write[p.unlinked_neighbours[i]];
+		segments.erase(Segment(p_id, n.id));
+		n.neighbours.erase(slot);
+	}
+
+	p.id = -1;
+	p.neighbours.clear();
+	p.unlinked_neighbours.clear();
+	free_slots.push_back(slot);
+	point_ids.remove(p_id);
+
+	if (p_id == max_id) {
+		max_id_dirty = true;
+	}
+	adjacency_dirty = true;
+	_invalidate_flow_fields();
 }
 
 void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 
-	ERR_FAIL_COND(!points.has(p_id));
-	ERR_FAIL_COND(!points.has(p_with_id));
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND(_is_computing_script_costs());
+
+	RWLockWrite write_lock(points_lock);
+
+	int a_slot = _get_slot(p_id);
+	int b_slot = _get_slot(p_with_id);
+	ERR_FAIL_COND(a_slot < 0);
+	ERR_FAIL_COND(b_slot < 0);
 	ERR_FAIL_COND(p_id == p_with_id);
 
-	Point *a = points[p_id];
-	Point *b = points[p_with_id];
-	a->neighbours.insert(b);
+	Point &a = point_data.write[a_slot];
+	Point &b = point_data.write[b_slot];
 
-	if (bidirectional)
-		b->neighbours.insert(a);
+	if (a.neighbours.find(b_slot) == -1) {
+		a.neighbours.push_back(b_slot);
+	}
+	if (bidirectional && b.neighbours.find(a_slot) == -1) {
+		b.neighbours.push_back(a_slot);
+	}
+
+	// Keep track of one-way connections, so both ends can be found when removing a point.
+	a.unlinked_neighbours.erase(b_slot);
+	b.unlinked_neighbours.erase(a_slot);
+	if (b.neighbours.find(a_slot) == -1) {
+		b.unlinked_neighbours.push_back(a_slot);
+	}
 
 	Segment s(p_id, p_with_id);
 	if (s.from == p_id) {
-		s.from_point = a;
-		s.to_point = b;
+		s.from_slot = a_slot;
+		s.to_slot = b_slot;
 	} else {
-		s.from_point = b;
-		s.to_point = a;
+		s.from_slot = b_slot;
+		s.to_slot = a_slot;
 	}
 
 	segments.insert(s);
+	adjacency_dirty = true;
+	_invalidate_flow_fields();
 }
 void AStar::disconnect_points(int p_id, int p_with_id) {
 
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND(_is_computing_script_costs());
+
+	RWLockWrite write_lock(points_lock);
+
 	Segment s(p_id, p_with_id);
 	ERR_FAIL_COND(!segments.has(s));
 
 	segments.erase(s);
 
-	Point *a = points[p_id];
-	Point *b = points[p_with_id];
-	a->neighbours.erase(b);
-	b->neighbours.erase(a);
+	int a_slot = _get_slot(p_id);
+	int b_slot = _get_slot(p_with_id);
+	Point &a = point_data.write[a_slot];
+	Point &b = point_data.write[b_slot];
+	a.neighbours.erase(b_slot);
+	a.unlinked_neighbours.erase(b_slot);
+	b.neighbours.erase(a_slot);
+	b.unlinked_neighbours.erase(a_slot);
+
+	adjacency_dirty = true;
+	_invalidate_flow_fields();
 }
 
 bool AStar::has_point(int p_id) const {
 
-	return points.has(p_id);
+	return _get_slot(p_id) >= 0;
+}
+
+void AStar::set_point_disabled(int p_id, bool p_disabled) {
+
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND(_is_computing_script_costs());
+
+	RWLockWrite write_lock(points_lock);
+
+	int slot = _get_slot(p_id);
+	ERR_FAIL_COND(slot < 0);
+
+	Point &p = point_data.write[slot];
+	if (p.enabled != p_disabled)
+		return;
+
+	p.enabled = !p_disabled;
+	for (int i = 0; i < flow_fields.size(); i++) {
+		flow_fields[i]->toggled_slots.push_back(slot);
+	}
+}
+
+bool AStar::is_point_disabled(int p_id) const {
+
+	int slot = _get_slot(p_id);
+	ERR_FAIL_COND_V(slot < 0, false);
+
+	return !point_data[slot].enabled;
 }
 
 Array AStar::get_points() {
 
 	Array point_list;
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
-		point_list.push_back(E->key());
+	for (int i = 0; i < point_data.size(); i++) {
+		if (point_data[i].id >= 0) {
+			point_list.push_back(point_data[i].id);
+		}
 	}
 
+	point_list.sort();
 	return point_list;
 }
 
 PoolVector<int> AStar::get_point_connections(int p_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_id), PoolVector<int>());
-
-	PoolVector<int> point_list;
+	int slot = _get_slot(p_id);
+	ERR_FAIL_COND_V(slot < 0, PoolVector<int>());
 
-	Point *p = points[p_id];
+	const Point &p = point_data[slot];
 
-	for (Set<Point *>::Element *E = p->neighbours.front(); E; E = E->next()) {
-		point_list.push_back(E->get()->id);
+	PoolVector<int> point_list;
+	point_list.resize(p.neighbours.size());
+	{
+		PoolVector<int>::Write w = point_list.write();
+		for (int i = 0; i < p.neighbours.size(); i++) {
+			w[i] = point_data[p.neighbours[i]].id;
+		}
 	}
 
 	return point_list;
@@ -187,25 +344,38 @@ bool AStar::are_points_connected(int p_id, int p_with_id) const {
 
 void AStar::clear() {
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND(_is_computing_script_costs());
 
-		memdelete(E->get());
-	}
+	RWLockWrite write_lock(points_lock);
+
+	point_data.clear();
+	free_slots.clear();
+	point_ids.clear();
 	segments.clear();
-	points.clear();
+	adjacency_offsets.clear();
+	adjacency.clear();
+	adjacency_dirty = false;
+	max_id = -1;
+	max_id_dirty = false;
+	_invalidate_flow_fields();
 }
 
-int AStar::get_closest_point(const Vector3 &p_point) const {
+int AStar::get_closest_point(const Vector3 &p_point, bool p_include_disabled) const {
 
 	int closest_id = -1;
 	real_t closest_dist = 1e20;
 
-	for (const Map<int, Point *>::Element *E = points.front(); E; E = E->next()) {
+	for (int i = 0; i < point_data.size(); i++) {
 
-		real_t d = p_point.distance_squared_to(E->get()->pos);
-		if (closest_id < 0 || d < closest_dist) {
+		const Point &p = point_data[i];
+		if (p.id < 0 || (!p.enabled && !p_include_disabled))
+			continue;
+
+		real_t d = p_point.distance_squared_to(p.pos);
+		if (closest_id < 0 || d < closest_dist || (d == closest_dist && p.id < closest_id)) {
 			closest_dist = d;
-			closest_id = E->key();
+			closest_id = p.id;
 		}
 	}
 
@@ -221,8 +391,8 @@ Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 	for (const Set<Segment>::Element *E = segments.front(); E; E = E->next()) {
 
 		Vector3 segment[2] = {
-			E->get().from_point->pos,
-			E->get().to_point->pos,
+			point_data[E->get().from_slot].pos,
+			point_data[E->get().to_slot].pos,
 		};
 
 		Vector3 p = Geometry::get_closest_point_to_segment(p_point, segment);
@@ -238,94 +408,207 @@ Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar::_solve(Point *begin_point, Point *end_point) {
+void AStar::_invalidate_flow_fields() {
 
-	pass++;
+	for (int i = 0; i < flow_fields.size(); i++) {
+		flow_fields[i]->rebuild = true;
+	}
+}
 
-	SelfList<Point>::List open_list;
+void AStar::_build_adjacency() {
 
-	bool found_route = false;
+	int count = point_data.size();
+	const Point *pts = point_data.ptr();
 
-	for (Set<Point *>::Element *E = begin_point->neighbours.front(); E; E = E->next()) {
+	int total = 0;
+	for (int i = 0; i < count; i++) {
+		total += pts[i].neighbours.size();
+	}
 
-		Point *n = E->get();
-		n->prev_point = begin_point;
-		n->distance = _compute_cost(begin_point->id, n->id) * n->weight_scale;
-		n->last_pass = pass;
-		open_list.add(&n->list);
+	adjacency_offsets.resize(count + 1);
+	adjacency.resize(total);
+	int *offsets = adjacency_offsets.ptrw();
+	int *adj = adjacency.ptrw();
+
+	int ofs = 0;
+	for (int i = 0; i < count; i++) {
+		offsets[i] = ofs;
+		const int *n = pts[i].neighbours.ptr();
+		for (int j = 0; j < pts[i].neighbours.size(); j++) {
+			adj[ofs++] = n[j];
+		}
 	}
+	offsets[count] = ofs;
 
-	while (true) {
+	adjacency_dirty = false;
+}
 
-		if (open_list.first() == NULL) {
-			// No path found
-			break;
-		}
-		// Check open list
+AStarSearchContext *AStar::_acquire_context() {
+
+	MutexLock lock(context_mutex);
+
+	if (adjacency_dirty) {
+		_build_adjacency();
+	}
 
-		SelfList<Point> *least_cost_point = open_list.first();
-		real_t least_cost = Math_INF;
+	if (free_contexts.empty()) {
+		return memnew(AStarSearchContext);
+	}
 
-		// TODO: Cache previous results
-		for (SelfList<Point> *E = open_list.first(); E; E = E->next()) {
+	AStarSearchContext *context = free_contexts[free_contexts.size() - 1];
+	free_contexts.resize(free_contexts.size() - 1);
+	return context;
+}
 
-			Point *p = E->self();
+void AStar::_release_context(AStarSearchContext *p_context) {
 
-			real_t cost = p->distance;
-			cost += _estimate_cost(p->id, end_point->id);
+	MutexLock lock(context_mutex);
+	free_contexts.push_back(p_context);
+}
 
-			if (cost < least_cost) {
-				least_cost_point = E;
-				least_cost = cost;
-			}
-		}
+ScriptInstance *AStar::_get_cost_script(const StringName &p_method) const {
+
+	ScriptInstance *si = get_script_instance();
+	return si && si->has_method(p_method) ? si : NULL;
+}
+
+void AStar::_begin_script_costs() {
+
+	MutexLock lock(context_mutex);
+	script_cost_threads.push_back(Thread::get_caller_id());
+	atomic_increment(&script_cost_count);
+}
+
+void AStar::_end_script_costs() {
+
+	MutexLock lock(context_mutex);
+	script_cost_threads.erase(Thread::get_caller_id());
+	atomic_decrement(&script_cost_count);
+}
+
+bool AStar::_is_computing_script_costs() const {
+
+	// Other threads computing costs only make the caller wait for the lock.
+	if (atomic_load_acquire(&script_cost_count) == 0)
+		return false;
+
+	MutexLock lock(context_mutex);
+	return script_cost_threads.find(Thread::get_caller_id()) >= 0;
+}
+
+real_t AStar::_get_estimate(ScriptInstance *p_script, int p_from_slot, int p_to_slot) {
+
+	if (p_script)
+		return p_script->call(SceneStringNames::get_singleton()->_estimate_cost, point_data[p_from_slot].id, point_data[p_to_slot].id);
 
-		Point *p = least_cost_point->self();
-		if (p == end_point) {
+	// Still virtual, C++ subclasses may override it.
+	return _estimate_cost(point_data[p_from_slot].id, point_data[p_to_slot].id);
+}
+
+real_t AStar::_get_cost(ScriptInstance *p_script, int p_from_slot, int p_to_slot) {
+
+	if (p_script)
+		return p_script->call(SceneStringNames::get_singleton()->_compute_cost, point_data[p_from_slot].id, point_data[p_to_slot].id);
+
+	return _compute_cost(point_data[p_from_slot].id, point_data[p_to_slot].id);
+}
+
+bool AStar::_solve(AStarSearchContext *p_context, int p_begin_slot, int p_end_slot) {
+
+	if (!point_data[p_end_slot].enabled)
+		return false;
+
+	AStarSearchState *states = p_context->begin_search(point_data.size());
+	p_context->estimate_script = _get_cost_script(SceneStringNames::get_singleton()->_estimate_cost);
+	p_context->compute_script = _get_cost_script(SceneStringNames::get_singleton()->_compute_cost);
+	bool script_costs = p_context->estimate_script || p_context->compute_script;
+	if (script_costs) {
+		_begin_script_costs();
+	}
+	AStarOpenList<AStarSearchState> &open_list = p_context->open_list;
+	uint32_t pass = p_context->pass;
+
+	const Point *pts = point_data.ptr();
+	const int *offsets = adjacency_offsets.ptr();
+	const int *adj = adjacency.ptr();
+
+	AStarSearchState &begin = states[p_begin_slot];
+	begin.g_score = 0;
+	begin.f_score = _get_estimate(p_context->estimate_script, p_begin_slot, p_end_slot);
+	begin.prev_point = -1;
+	begin.pass = pass;
+	begin.closed = false;
+
+	open_list.push(states, p_begin_slot);
+
+	bool found_route = false;
+
+	while (!open_list.empty()) {
+
+		int p = open_list.pop(states);
+		if (p == p_end_slot) {
 			found_route = true;
 			break;
 		}
 
-		for (Set<Point *>::Element *E = p->neighbours.front(); E; E = E->next()) {
+		states[p].closed = true;
 
-			Point *e = E->get();
+		for (int i = offsets[p]; i < offsets[p + 1]; i++) {
 
-			real_t distance = _compute_cost(p->id, e->id) * e->weight_scale + p->distance;
+			int e = adj[i];
+			AStarSearchState &es = states[e];
 
-			if (e->last_pass == pass) {
-				// Already visited, is this cheaper?
+			if (!pts[e].enabled || (es.pass == pass && es.closed))
+				continue;
 
-				if (e->distance > distance) {
-					e->prev_point = p;
-					e->distance = distance;
-				}
-			} else {
+			real_t g_score = states[p].g_score + _get_cost(p_context->compute_script, p, e) * pts[e].weight_scale;
+
+			if (es.pass != pass) {
 				// Add to open neighbours
 
-				e->prev_point = p;
-				e->distance = distance;
-				e->last_pass = pass; // Mark as used
-				open_list.add(&e->list);
+				es.pass = pass; // Mark as used
+				es.closed = false;
+				es.prev_point = p;
+				es.g_score = g_score;
+				es.f_score = g_score + _get_estimate(p_context->estimate_script, e, p_end_slot);
+				open_list.push(states, e);
+			} else if (g_score < es.g_score) {
+				// Already visited, this is cheaper
+
+				es.f_score -= es.g_score - g_score;
+				es.prev_point = p;
+				es.g_score = g_score;
+				open_list.decrease(states, e);
 			}
 		}
-
-		open_list.remove(least_cost_point);
 	}
 
-	// Clear the openf list
-	while (open_list.first()) {
-		open_list.remove(open_list.first());
+	open_list.clear();
+	if (script_costs) {
+		_end_script_costs();
 	}
 
 	return found_route;
 }
 
+int AStar::_get_path_length(const AStarSearchContext *p_context, int p_begin_slot, int p_end_slot) const {
+
+	const AStarSearchState *states = p_context->states.ptr();
+
+	int pc = 1; // Begin point
+	for (int p = p_end_slot; p != p_begin_slot; p = states[p].prev_point) {
+		pc++;
+	}
+
+	return pc;
+}
+
 float AStar::_estimate_cost(int p_from_id, int p_to_id) {
 
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_estimate_cost))
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_estimate_cost, p_from_id, p_to_id);
 
-	return points[p_from_id]->pos.distance_to(points[p_to_id]->pos);
+	return point_data[_get_slot(p_from_id)].pos.distance_to(point_data[_get_slot(p_to_id)].pos);
 }
 
 float AStar::_compute_cost(int p_from_id, int p_to_id) {
@@ -333,111 +616,188 @@ float AStar::_compute_cost(int p_from_id, int p_to_id) {
 	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_compute_cost))
 		return get_script_instance()->call(SceneStringNames::get_singleton()->_compute_cost, p_from_id, p_to_id);
 
-	return points[p_from_id]->pos.distance_to(points[p_to_id]->pos);
+	return point_data[_get_slot(p_from_id)].pos.distance_to(point_data[_get_slot(p_to_id)].pos);
 }
 
 PoolVector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_from_id), PoolVector<Vector3>());
-	ERR_FAIL_COND_V(!points.has(p_to_id), PoolVector<Vector3>());
-
-	pass++;
+	RWLockRead read_lock(points_lock);
 
-	Point *a = points[p_from_id];
-	Point *b = points[p_to_id];
+	int a = _get_slot(p_from_id);
+	int b = _get_slot(p_to_id);
+	ERR_FAIL_COND_V(a < 0, PoolVector<Vector3>());
+	ERR_FAIL_COND_V(b < 0, PoolVector<Vector3>());
 
 	if (a == b) {
 		PoolVector<Vector3> ret;
-		ret.push_back(a->pos);
+		ret.push_back(point_data[a].pos);
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	AStarSearchContext *context = _acquire_context();
 
-	bool found_route = _solve(begin_point, end_point);
-
-	if (!found_route)
+	if (!_solve(context, a, b)) {
+		_release_context(context);
 		return PoolVector<Vector3>();
-
-	// Midpoints
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
 	}
 
+	const AStarSearchState *states = context->states.ptr();
+	int pc = _get_path_length(context, a, b);
+
 	PoolVector<Vector3> path;
 	path.resize(pc);
 
 	{
 		PoolVector<Vector3>::Write w = path.write();
 
-		Point *p2 = end_point;
+		int p = b;
 		int idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
+		while (p != a) {
+			w[idx--] = point_data[p].pos;
+			p = states[p].prev_point;
 		}
 
-		w[0] = p2->pos; // Assign first
+		w[0] = point_data[p].pos; // Assign first
 	}
 
+	_release_context(context);
+
 	return path;
 }
 
 PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 
-	ERR_FAIL_COND_V(!points.has(p_from_id), PoolVector<int>());
-	ERR_FAIL_COND_V(!points.has(p_to_id), PoolVector<int>());
+	RWLockRead read_lock(points_lock);
 
-	pass++;
-
-	Point *a = points[p_from_id];
-	Point *b = points[p_to_id];
+	int a = _get_slot(p_from_id);
+	int b = _get_slot(p_to_id);
+	ERR_FAIL_COND_V(a < 0, PoolVector<int>());
+	ERR_FAIL_COND_V(b < 0, PoolVector<int>());
 
 	if (a == b) {
 		PoolVector<int> ret;
-		ret.push_back(a->id);
+		ret.push_back(p_from_id);
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	AStarSearchContext *context = _acquire_context();
 
-	if (!found_route)
+	if (!_solve(context, a, b)) {
+		_release_context(context);
 		return PoolVector<int>();
-
-	// Midpoints
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
 	}
 
+	const AStarSearchState *states = context->states.ptr();
+	int pc = _get_path_length(context, a, b);
+
 	PoolVector<int> path;
 	path.resize(pc);
 
 	{
 		PoolVector<int>::Write w = path.write();
 
-		p = end_point;
+		int p = b;
 		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+		while (p != a) {
+			w[idx--] = point_data[p].id;
+			p = states[p].prev_point;
 		}
 
-		w[0] = p->id; // Assign first
+		w[0] = point_data[p].id; // Assign first
 	}
 
+	_release_context(context);
+
 	return path;
 }
 
+class AStarPathRequest : public PathRequestQueue::Request {
+
+public:
+	AStar *astar;
+	int from_id;
+	int to_id;
+	bool ids;
+	bool script_costs;
+
+	PoolVector<Vector3> point_path;
+	PoolVector<int> id_path;
+
+	virtual bool is_thread_safe() const {
+
+		// Scripts run on the main thread.
+		return !script_costs;
+	}
+
+	virtual void solve() {
+
+		if (ids) {
+			id_path = astar->get_id_path(from_id, to_id);
+		} else {
+			point_path = astar->get_point_path(from_id, to_id);
+		}
+	}
+
+	virtual void deliver(Object *p_owner) {
+
+		if (ids) {
+			p_owner->emit_signal("path_request_completed", get_id(), id_path);
+		} else {
+			p_owner->emit_signal("path_request_completed", get_id(), point_path);
+		}
+	}
+};
+
+int AStar::_request_path(int p_from_id, int p_to_id, bool p_ids) {
+
+	ERR_FAIL_COND_V(!PathRequestQueue::get_singleton(), 0);
+	ERR_FAIL_COND_V(_get_slot(p_from_id) < 0, 0);
+	ERR_FAIL_COND_V(_get_slot(p_to_id) < 0, 0);
+
+	AStarPathRequest *request = memnew(AStarPathRequest);
+	request->astar = this;
+	request->from_id = p_from_id;
+	request->to_id = p_to_id;
+	request->ids = p_ids;
+	request->script_costs = _get_cost_script(SceneStringNames::get_singleton()->_estimate_cost) || _get_cost_script(SceneStringNames::get_singleton()->_compute_cost);
+
+	return PathRequestQueue::get_singleton()->push_request(this, request);
+}
+
+int AStar::request_point_path(int p_from_id, int p_to_id) {
+
+	return _request_path(p_from_id, p_to_id, false);
+}
+
+int AStar::request_id_path(int p_from_id, int p_to_id) {
+
+	return _request_path(p_from_id, p_to_id, true);
+}
+
+void AStar::cancel_path_request(int p_request_id) {
+
+	if (PathRequestQueue::get_singleton()) {
+		PathRequestQueue::get_singleton()->cancel_request(this, p_request_id);
+	}
+}
+
+Ref<AStarFlowField> AStar::create_flow_field(int p_to_id) {
+
+	ERR_FAIL_COND_V(!has_point(p_to_id), Ref<AStarFlowField>());
+	ERR_EXPLAIN("Can't change the points of an AStar from its cost methods.");
+	ERR_FAIL_COND_V(_is_computing_script_costs(), Ref<AStarFlowField>());
+
+	Ref<AStarFlowField> field;
+	field.instance();
+	field->astar = this;
+	field->goal_id = p_to_id;
+
+	RWLockWrite write_lock(points_lock);
+	flow_fields.push_back(field.ptr());
+
+	return field;
+}
+
 void AStar::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar::get_available_point_id);
@@ -448,6 +808,8 @@ void AStar::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_point_weight_scale", "id", "weight_scale"), &AStar::set_point_weight_scale);
 	ClassDB::bind_method(D_METHOD("remove_point", "id"), &AStar::remove_point);
 	ClassDB::bind_method(D_METHOD("has_point", "id"), &AStar::has_point);
+	ClassDB::bind_method(D_METHOD("set_point_disabled", "id", "disabled"), &AStar::set_point_disabled, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_point_disabled", "id"), &AStar::is_point_disabled);
 	ClassDB::bind_method(D_METHOD("get_points"), &AStar::get_points);
 
 	ClassDB::bind_method(D_METHOD("get_point_connections", "id"), &AStar::get_point_connections);
@@ -458,23 +820,344 @@ void AStar::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("clear"), &AStar::clear);
 
-	ClassDB::bind_method(D_METHOD("get_closest_point", "to_position"), &AStar::get_closest_point);
+	ClassDB::bind_method(D_METHOD("get_closest_point", "to_position", "include_disabled"), &AStar::get_closest_point, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_position_in_segment", "to_position"), &AStar::get_closest_position_in_segment);
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar::get_id_path);
 
+	ClassDB::bind_method(D_METHOD("request_point_path", "from_id", "to_id"), &AStar::request_point_path);
+	ClassDB::bind_method(D_METHOD("request_id_path", "from_id", "to_id"), &AStar::request_id_path);
+	ClassDB::bind_method(D_METHOD("cancel_path_request", "request_id"), &AStar::cancel_path_request);
+
+	ClassDB::bind_method(D_METHOD("create_flow_field", "to_id"), &AStar::create_flow_field);
+
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_estimate_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_compute_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
+
+	ADD_SIGNAL(MethodInfo("path_request_completed", PropertyInfo(Variant::INT, "request_id"), PropertyInfo(Variant::NIL, "path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NIL_IS_VARIANT)));
+}
+
+void AStar::_notification(int p_what) {
+
+	if (p_what == NOTIFICATION_PREDELETE) {
+		// Before subclasses are destroyed, as requests being solved may still call their cost methods.
+		if (PathRequestQueue::get_singleton()) {
+			PathRequestQueue::get_singleton()->cancel_requests(this);
+		}
+	}
 }
 
 AStar::AStar() {
 
-	pass = 1;
+	max_id = -1;
+	max_id_dirty = false;
+	adjacency_dirty = false;
+	context_mutex = Mutex::create();
+	points_lock = RWLock::create();
+	script_cost_count = 0;
 }
 
 AStar::~AStar() {
 
-	pass = 1;
-	clear();
+	{
+		// Fields may be referenced elsewhere and outlive this.
+		RWLockWrite write_lock(points_lock);
+		for (int i = 0; i < flow_fields.size(); i++) {
+			flow_fields[i]->astar = NULL;
+		}
+	}
+
+	for (int i = 0; i < free_contexts.size(); i++) {
+		memdelete(free_contexts[i]);
+	}
+	memdelete(context_mutex);
+	memdelete(points_lock);
+}
+
+void AStarFlowField::_propagate() {
+
+	Cell *c = cells.ptrw();
+	const AStar::Point *pts = astar->point_data.ptr();
+	const int *offsets = incoming_offsets.ptr();
+	const int *in = incoming.ptr();
+
+	while (!open_list.empty()) {
+
+		int p = open_list.pop(c);
+
+		for (int i = offsets[p]; i < offsets[p + 1]; i++) {
+
+			int e = in[i];
+			if (!pts[e].enabled)
+				continue;
+
+			// Moving from e to p, as a search would.
+			real_t cost = c[p].f_score + astar->_get_cost(compute_script, e, p) * pts[p].weight_scale;
+			if (cost >= c[e].f_score)
+				continue;
+
+			c[e].f_score = cost;
+			c[e].next_slot = p;
+			if (c[e].open_index < 0) {
+				open_list.push(c, e);
+			} else {
+				open_list.decrease(c, e);
+			}
+		}
+	}
+}
+
+void AStarFlowField::_seed(int p_slot) {
+
+	// Cheapest way to the goal through the neighbours, whose costs are known.
+	Cell *c = cells.ptrw();
+	const AStar::Point &p = astar->point_data[p_slot];
+	if (!p.enabled)
+		return;
+
+	bool lowered = false;
+	for (int i = 0; i < p.neighbours.size(); i++) {
+
+		int n = p.neighbours[i];
+		const AStar::Point &np = astar->point_data[n];
+		if (!np.enabled || c[n].f_score == Math_INF)
+			continue;
+
+		real_t cost = c[n].f_score + astar->_get_cost(compute_script, p_slot, n) * np.weight_scale;
+		if (cost < c[p_slot].f_score) {
+			c[p_slot].f_score = cost;
+			c[p_slot].next_slot = n;
+			lowered = true;
+		}
+	}
+
+	if (!lowered)
+		return;
+
+	if (c[p_slot].open_index < 0) {
+		open_list.push(c, p_slot);
+	} else {
+		open_list.decrease(c, p_slot);
+	}
+}
+
+void AStarFlowField::_rebuild() {
+
+	int count = astar->point_data.size();
+	const AStar::Point *pts = astar->point_data.ptr();
+
+	cells.resize(count);
+	Cell *c = cells.ptrw();
+	for (int i = 0; i < count; i++) {
+		c[i].f_score = Math_INF;
+		c[i].open_index = -1;
+		c[i].next_slot = -1;
+	}
+
+	incoming_offsets.resize(count + 1);
+	int *offsets = incoming_offsets.ptrw();
+	for (int i = 0; i <= count; i++) {
+		offsets[i] = 0;
+	}
+	for (int i = 0; i < count; i++) {
+		for (int j = 0; j < pts[i].neighbours.size(); j++) {
+			offsets[pts[i].neighbours[j] + 1]++;
+		}
+	}
+	for (int i = 0; i < count; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	incoming.resize(offsets[count]);
+	int *in = incoming.ptrw();
+	for (int i = 0; i < count; i++) {
+		for (int j = 0; j < pts[i].neighbours.size(); j++) {
+			in[offsets[pts[i].neighbours[j]]++] = i;
+		}
+	}
+	// Filling moved every offset to the start of the next slot.
+	for (int i = count; i > 0; i--) {
+		offsets[i] = offsets[i - 1];
+	}
+	offsets[0] = 0;
+
+	rebuild = false;
+	toggled_slots.clear();
+
+	int goal = astar->_get_slot(goal_id);
+	if (goal < 0 || !pts[goal].enabled)
+		return;
+
+	c[goal].f_score = 0;
+	open_list.push(c, goal);
+	_propagate();
+}
+
+void AStarFlowField::_repair() {
+
+	int goal = astar->_get_slot(goal_id);
+	const AStar::Point *pts = astar->point_data.ptr();
+	Cell *c = cells.ptrw();
+
+	for (int i = 0; i < toggled_slots.size(); i++) {
+		if (toggled_slots[i] == goal) {
+			_rebuild();
+			return;
+		}
+	}
+
+	// Disabled points cut off every point whose way to the goal went through them.
+	Vector<int> affected;
+	for (int i = 0; i < toggled_slots.size(); i++) {
+
+		int slot = toggled_slots[i];
+		if (pts[slot].enabled || c[slot].f_score == Math_INF)
+			continue;
+
+		c[slot].f_score = Math_INF;
+		c[slot].next_slot = -1;
+		affected.push_back(slot);
+
+		for (int j = affected.size() - 1; j < affected.size(); j++) {
+			int p = affected[j];
+			for (int k = incoming_offsets[p]; k < incoming_offsets[p + 1]; k++) {
+				int e = incoming[k];
+				if (c[e].next_slot == p) {
+					c[e].f_score = Math_INF;
+					c[e].next_slot = -1;
+					affected.push_back(e);
+				}
+			}
+		}
+	}
+
+	// Cut off points look for another way through the rest, and enabled points may offer a shorter one.
+	for (int i = 0; i < affected.size(); i++) {
+		_seed(affected[i]);
+	}
+	for (int i = 0; i < toggled_slots.size(); i++) {
+		if (pts[toggled_slots[i]].enabled) {
+			_seed(toggled_slots[i]);
+		}
+	}
+
+	toggled_slots.clear();
+	_propagate();
+}
+
+int AStarFlowField::_update(int p_id) {
+
+	if (rebuild || toggled_slots.size()) {
+		compute_script = astar->_get_cost_script(SceneStringNames::get_singleton()->_compute_cost);
+		if (compute_script) {
+			astar->_begin_script_costs();
+		}
+
+		if (rebuild) {
+			_rebuild();
+		} else {
+			_repair();
+		}
+
+		if (compute_script) {
+			astar->_end_script_costs();
+		}
+	}
+
+	return astar->_get_slot(p_id);
+}
+
+int AStarFlowField::get_goal_id() const {
+
+	return goal_id;
+}
+
+bool AStarFlowField::is_point_reachable(int p_id) {
+
+	ERR_EXPLAIN("The AStar of this flow field was freed.");
+	ERR_FAIL_COND_V(!astar, false);
+
+	RWLockRead read_lock(astar->points_lock);
+	MutexLock lock(mutex);
+
+	int slot = _update(p_id);
+	ERR_FAIL_COND_V(slot < 0, false);
+
+	return cells[slot].f_score < Math_INF;
+}
+
+real_t AStarFlowField::get_point_cost(int p_id) {
+
+	ERR_EXPLAIN("The AStar of this flow field was freed.");
+	ERR_FAIL_COND_V(!astar, Math_INF);
+
+	RWLockRead read_lock(astar->points_lock);
+	MutexLock lock(mutex);
+
+	int slot = _update(p_id);
+	ERR_FAIL_COND_V(slot < 0, Math_INF);
+
+	return cells[slot].f_score;
+}
+
+int AStarFlowField::get_next_point(int p_id) {
+
+	ERR_EXPLAIN("The AStar of this flow field was freed.");
+	ERR_FAIL_COND_V(!astar, -1);
+
+	RWLockRead read_lock(astar->points_lock);
+	MutexLock lock(mutex);
+
+	int slot = _update(p_id);
+	ERR_FAIL_COND_V(slot < 0, -1);
+
+	int next = cells[slot].next_slot;
+	return next < 0 ? -1 : astar->point_data[next].id;
+}
+
+Vector3 AStarFlowField::get_point_direction(int p_id) {
+
+	ERR_EXPLAIN("The AStar of this flow field was freed.");
+	ERR_FAIL_COND_V(!astar, Vector3());
+
+	RWLockRead read_lock(astar->points_lock);
+	MutexLock lock(mutex);
+
+	int slot = _update(p_id);
+	ERR_FAIL_COND_V(slot < 0, Vector3());
+
+	int next = cells[slot].next_slot;
+	if (next < 0)
+		return Vector3();
+
+	return (astar->point_data[next].pos - astar->point_data[slot].pos).normalized();
+}
+
+void AStarFlowField::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("get_goal_id"), &AStarFlowField::get_goal_id);
+
+	ClassDB::bind_method(D_METHOD("is_point_reachable", "id"), &AStarFlowField::is_point_reachable);
+	ClassDB::bind_method(D_METHOD("get_point_cost", "id"), &AStarFlowField::get_point_cost);
+	ClassDB::bind_method(D_METHOD("get_next_point", "id"), &AStarFlowField::get_next_point);
+	ClassDB::bind_method(D_METHOD("get_point_direction", "id"), &AStarFlowField::get_point_direction);
+}
+
+AStarFlowField::AStarFlowField() {
+
+	astar = NULL;
+	goal_id = -1;
+	rebuild = true;
+	compute_script = NULL;
+	mutex = Mutex::create();
+}
+
+AStarFlowField::~AStarFlowField() {
+
+	if (astar) {
+		RWLockWrite write_lock(astar->points_lock);
+		astar->flow_fields.erase(this);
+	}
+	memdelete(mutex);
 }
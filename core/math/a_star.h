@@ -31,8 +31,11 @@
 #ifndef ASTAR_H
 #define ASTAR_H
 
+#include "core/oa_hash_map.h"
+#include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
+#include "core/os/thread.h"
 #include "core/reference.h"
-#include "core/self_list.h"
 
 /**
 	A* pathfinding algorithm
@@ -40,32 +43,159 @@
 	@author Juan Linietsky <reduzio@gmail.com>
 */
 
+// Binary min-heap of indices into an array of search states, ordered by their F score.
+// Each state remembers its position in the heap, so its score can be lowered in place.
+template <class S>
+class AStarOpenList {
+
+	Vector<int> heap; // Only grows, so it's not reallocated between searches.
+	int count;
+
+	_FORCE_INLINE_ void _place(S *p_states, int p_pos, int p_index) {
+
+		heap.ptrw()[p_pos] = p_index;
+		p_states[p_index].open_index = p_pos;
+	}
+
+	void _sift_up(S *p_states, int p_pos) {
+
+		int index = heap[p_pos];
+		real_t f = p_states[index].f_score;
+		while (p_pos > 0) {
+			int parent = (p_pos - 1) >> 1;
+			if (p_states[heap[parent]].f_score <= f)
+				break;
+			_place(p_states, p_pos, heap[parent]);
+			p_pos = parent;
+		}
+		_place(p_states, p_pos, index);
+	}
+
+	void _sift_down(S *p_states, int p_pos) {
+
+		int index = heap[p_pos];
+		real_t f = p_states[index].f_score;
+		while (true) {
+			int child = (p_pos << 1) + 1;
+			if (child >= count)
+				break;
+			if (child + 1 < count && p_states[heap[child + 1]].f_score < p_states[heap[child]].f_score)
+				child++;
+			if (f <= p_states[heap[child]].f_score)
+				break;
+			_place(p_states, p_pos, heap[child]);
+			p_pos = child;
+		}
+		_place(p_states, p_pos, index);
+	}
+
+public:
+	_FORCE_INLINE_ bool empty() const { return count == 0; }
+	_FORCE_INLINE_ void clear() { count = 0; }
+
+	void push(S *p_states, int p_index) {
+
+		if (count == heap.size()) {
+			heap.resize(MAX(16, count * 2));
+		}
+		heap.ptrw()[count] = p_index;
+		_sift_up(p_states, count++);
+	}
+
+	// Must be called after lowering the F score of an index already in the list.
+	void decrease(S *p_states, int p_index) {
+
+		_sift_up(p_states, p_states[p_index].open_index);
+	}
+
+	int pop(S *p_states) {
+
+		int index = heap[0];
+		int last = heap[--count];
+		if (count) {
+			_place(p_states, 0, last);
+			_sift_down(p_states, 0);
+		}
+		p_states[index].open_index = -1;
+		return index;
+	}
+
+	AStarOpenList() { count = 0; }
+};
+
+// State of a point during a single search.
+struct AStarSearchState {
+
+	real_t g_score;
+	real_t f_score;
+	int prev_point;
+	int open_index;
+	uint32_t pass;
+	bool closed;
+};
+
+// Scratch space of a single path query, so several queries can run at once on the same points.
+struct AStarSearchContext {
+
+	Vector<AStarSearchState> states;
+	AStarOpenList<AStarSearchState> open_list;
+	uint32_t pass;
+
+	// Script methods overriding the costs, looked up once at the start of the search.
+	ScriptInstance *estimate_script;
+	ScriptInstance *compute_script;
+
+	AStarSearchState *begin_search(int p_point_count);
+
+	AStarSearchContext() {
+		pass = 0;
+		estimate_script = NULL;
+		compute_script = NULL;
+	}
+};
+
+class AStarFlowField;
+
 class AStar : public Reference {
 
 	GDCLASS(AStar, Reference)
 
-	uint64_t pass;
+	friend class AStarFlowField;
 
 	struct Point {
 
-		SelfList<Point> list;
-
-		int id;
+		int id; // -1 if the slot is free.
 		Vector3 pos;
 		real_t weight_scale;
-		uint64_t last_pass;
+		bool enabled;
+
+		Vector<int> neighbours; // Slots reachable from this point.
+		Vector<int> unlinked_neighbours; // Slots connected one-way to this point.
+	};
 
-		Set<Point *> neighbours;
+	Vector<Point> point_data;
+	Vector<int> free_slots;
+	OAHashMap<int, int> point_ids; // Id to slot.
+	int max_id;
+	bool max_id_dirty;
 
-		// Used for pathfinding
-		Point *prev_point;
-		real_t distance;
+	// Neighbours of every slot packed in a single array (compressed sparse rows),
+	// rebuilt on the next search after connections change.
+	Vector<int> adjacency_offsets;
+	Vector<int> adjacency;
+	bool adjacency_dirty;
 
-		Point() :
-				list(this) {}
-	};
+	// Unused search contexts, kept to avoid reallocating their states.
+	Vector<AStarSearchContext *> free_contexts;
+	Mutex *context_mutex;
 
-	Map<int, Point *> points;
+	RWLock *points_lock; // Searches read while points are added, removed, moved or connected.
+
+	// Threads running cost scripts, which must not change the points while the search holds the lock.
+	Vector<Thread::ID> script_cost_threads;
+	volatile uint32_t script_cost_count;
+
+	Vector<AStarFlowField *> flow_fields; // Told about changes, so they can update lazily.
 
 	struct Segment {
 		union {
@@ -76,8 +206,8 @@ class AStar : public Reference {
 			uint64_t key;
 		};
 
-		Point *from_point;
-		Point *to_point;
+		int from_slot;
+		int to_slot;
 
 		bool operator<(const Segment &p_s) const { return key < p_s.key; }
 		Segment() { key = 0; }
@@ -93,9 +223,34 @@ class AStar : public Reference {
 
 	Set<Segment> segments;
 
-	bool _solve(Point *begin_point, Point *end_point);
+	_FORCE_INLINE_ int _get_slot(int p_id) const {
+
+		// Points added in order from 0 usually sit at the slot of their id.
+		if (p_id >= 0 && p_id < point_data.size() && point_data[p_id].id == p_id)
+			return p_id;
+
+		int slot;
+		// Lookups don't modify the map, it just lacks const accessors.
+		return const_cast<OAHashMap<int, int> &>(point_ids).lookup(p_id, slot) ? slot : -1;
+	}
+
+	ScriptInstance *_get_cost_script(const StringName &p_method) const;
+	void _begin_script_costs();
+	void _end_script_costs();
+	bool _is_computing_script_costs() const;
+	_FORCE_INLINE_ real_t _get_estimate(ScriptInstance *p_script, int p_from_slot, int p_to_slot);
+	_FORCE_INLINE_ real_t _get_cost(ScriptInstance *p_script, int p_from_slot, int p_to_slot);
+
+	void _build_adjacency();
+	AStarSearchContext *_acquire_context();
+	void _release_context(AStarSearchContext *p_context);
+	bool _solve(AStarSearchContext *p_context, int p_begin_slot, int p_end_slot);
+	int _get_path_length(const AStarSearchContext *p_context, int p_begin_slot, int p_end_slot) const;
+	int _request_path(int p_from_id, int p_to_id, bool p_ids);
+	void _invalidate_flow_fields();
 
 protected:
+	void _notification(int p_what);
 	static void _bind_methods();
 
 	virtual float _estimate_cost(int p_from_id, int p_to_id);
@@ -111,6 +266,8 @@ public:
 	void set_point_weight_scale(int p_id, real_t p_weight_scale);
 	void remove_point(int p_id);
 	bool has_point(int p_id) const;
+	void set_point_disabled(int p_id, bool p_disabled = true);
+	bool is_point_disabled(int p_id) const;
 	PoolVector<int> get_point_connections(int p_id);
 	Array get_points();
 
@@ -120,14 +277,72 @@ public:
 
 	void clear();
 
-	int get_closest_point(const Vector3 &p_point) const;
+	int get_closest_point(const Vector3 &p_point, bool p_include_disabled = false) const;
 	Vector3 get_closest_position_in_segment(const Vector3 &p_point) const;
 
 	PoolVector<Vector3> get_point_path(int p_from_id, int p_to_id);
 	PoolVector<int> get_id_path(int p_from_id, int p_to_id);
 
+	int request_point_path(int p_from_id, int p_to_id);
+	int request_id_path(int p_from_id, int p_to_id);
+	void cancel_path_request(int p_request_id);
+
+	Ref<AStarFlowField> create_flow_field(int p_to_id);
+
 	AStar();
 	~AStar();
 };
 
+// Cost to reach a goal from every point, and the next point to move to, so many agents heading
+// to the same goal don't search their paths separately. Disabling or enabling points only updates
+// the points affected, other changes to the AStar recompute the whole field on the next access.
+class AStarFlowField : public Reference {
+
+	GDCLASS(AStarFlowField, Reference)
+
+	friend class AStar;
+
+	struct Cell {
+
+		real_t f_score; // Cost to reach the goal, as ordered by the open list.
+		int open_index;
+		int next_slot;
+	};
+
+	AStar *astar; // Not referenced, as the AStar keeps a list of its fields. Cleared when it's freed.
+	int goal_id;
+
+	Vector<Cell> cells;
+	AStarOpenList<Cell> open_list;
+
+	// Points with a connection towards every slot (compressed sparse rows).
+	Vector<int> incoming_offsets;
+	Vector<int> incoming;
+
+	bool rebuild;
+	Vector<int> toggled_slots; // Disabled or enabled since the last update.
+	ScriptInstance *compute_script; // Looked up at the start of each update.
+	Mutex *mutex;
+
+	void _propagate();
+	void _seed(int p_slot);
+	void _rebuild();
+	void _repair();
+	int _update(int p_id);
+
+protected:
+	static void _bind_methods();
+
+public:
+	int get_goal_id() const;
+
+	bool is_point_reachable(int p_id);
+	real_t get_point_cost(int p_id);
+	int get_next_point(int p_id);
+	Vector3 get_point_direction(int p_id);
+
+	AStarFlowField();
+	~AStarFlowField();
+};
+
 #endif // ASTAR_H
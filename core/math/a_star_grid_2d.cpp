@@ -0,0 +1,480 @@
+/*************************************************************************/
+/*  a_star_grid_2d.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "a_star_grid_2d.h"
+
+void AStarGrid2D::set_size(const Vector2 &p_size) {
+
+	ERR_FAIL_COND(p_size.x < 0 || p_size.y < 0);
+
+	width = p_size.x;
+	height = p_size.y;
+
+	solid.resize(width * height);
+	if (solid.size()) {
+		zeromem(solid.ptrw(), solid.size());
+	}
+}
+
+Vector2 AStarGrid2D::get_size() const {
+
+	return Vector2(width, height);
+}
+
+void AStarGrid2D::set_cell_size(const Vector2 &p_cell_size) {
+
+	ERR_FAIL_COND(p_cell_size.x <= 0 || p_cell_size.y <= 0);
+
+	cell_size = p_cell_size;
+}
+
+Vector2 AStarGrid2D::get_cell_size() const {
+
+	return cell_size;
+}
+
+void AStarGrid2D::set_diagonal_enabled(bool p_enabled) {
+
+	diagonal_enabled = p_enabled;
+}
+
+bool AStarGrid2D::is_diagonal_enabled() const {
+
+	return diagonal_enabled;
+}
+
+void AStarGrid2D::set_jumping_enabled(bool p_enabled) {
+
+	jumping_enabled = p_enabled;
+}
+
+bool AStarGrid2D::is_jumping_enabled() const {
+
+	return jumping_enabled;
+}
+
+bool AStarGrid2D::is_in_bounds(const Vector2 &p_cell) const {
+
+	int x = p_cell.x;
+	int y = p_cell.y;
+	return x >= 0 && y >= 0 && x < width && y < height;
+}
+
+void AStarGrid2D::set_point_solid(const Vector2 &p_cell, bool p_solid) {
+
+	ERR_FAIL_COND(!is_in_bounds(p_cell));
+
+	solid.write[(int)p_cell.y * width + (int)p_cell.x] = p_solid;
+}
+
+bool AStarGrid2D::is_point_solid(const Vector2 &p_cell) const {
+
+	ERR_FAIL_COND_V(!is_in_bounds(p_cell), false);
+
+	return solid[(int)p_cell.y * width + (int)p_cell.x];
+}
+
+Vector2 AStarGrid2D::get_point_position(const Vector2 &p_cell) const {
+
+	return Vector2((int)p_cell.x, (int)p_cell.y) * cell_size;
+}
+
+void AStarGrid2D::clear() {
+
+	set_size(Vector2());
+}
+
+int AStarGrid2D::_jump_straight(int p_x, int p_y, int p_dx, int p_dy, int p_end) const {
+
+	while (_is_walkable(p_x, p_y)) {
+
+		int point = p_y * width + p_x;
+		if (point == p_end)
+			return point;
+
+		// A cell is a jump point if it has a neighbour only reachable through it.
+		if (p_dx != 0) {
+			if ((_is_walkable(p_x, p_y - 1) && !_is_walkable(p_x - p_dx, p_y - 1)) ||
+					(_is_walkable(p_x, p_y + 1) && !_is_walkable(p_x - p_dx, p_y + 1)))
+				return point;
+		} else {
+			if ((_is_walkable(p_x - 1, p_y) && !_is_walkable(p_x - 1, p_y - p_dy)) ||
+					(_is_walkable(p_x + 1, p_y) && !_is_walkable(p_x + 1, p_y - p_dy)))
+				return point;
+		}
+
+		p_x += p_dx;
+		p_y += p_dy;
+	}
+
+	return -1;
+}
+
+int AStarGrid2D::_jump(int p_x, int p_y, int p_dx, int p_dy, int p_end) const {
+
+	if (p_dx == 0 || p_dy == 0)
+		return _jump_straight(p_x, p_y, p_dx, p_dy, p_end);
+
+	while (_is_walkable(p_x, p_y)) {
+
+		int point = p_y * width + p_x;
+		if (point == p_end)
+			return point;
+
+		if (_jump_straight(p_x + p_dx, p_y, p_dx, 0, p_end) >= 0 || _jump_straight(p_x, p_y + p_dy, 0, p_dy, p_end) >= 0)
+			return point;
+
+		// Diagonal moves can't cut corners.
+		if (!_is_walkable(p_x + p_dx, p_y) || !_is_walkable(p_x, p_y + p_dy))
+			return -1;
+
+		p_x += p_dx;
+		p_y += p_dy;
+	}
+
+	return -1;
+}
+
+int AStarGrid2D::_get_neighbours(int p_point, int *r_neighbours) const {
+
+	int x = p_point % width;
+	int y = p_point / width;
+	int count = 0;
+
+	bool left = _is_walkable(x - 1, y);
+	bool right = _is_walkable(x + 1, y);
+	bool up = _is_walkable(x, y - 1);
+	bool down = _is_walkable(x, y + 1);
+
+	if (left)
+		r_neighbours[count++] = p_point - 1;
+	if (right)
+		r_neighbours[count++] = p_point + 1;
+	if (up)
+		r_neighbours[count++] = p_point - width;
+	if (down)
+		r_neighbours[count++] = p_point + width;
+
+	if (diagonal_enabled) {
+		if (left && up && _is_walkable(x - 1, y - 1))
+			r_neighbours[count++] = p_point - width - 1;
+		if (right && up && _is_walkable(x + 1, y - 1))
+			r_neighbours[count++] = p_point - width + 1;
+		if (left && down && _is_walkable(x - 1, y + 1))
+			r_neighbours[count++] = p_point + width - 1;
+		if (right && down && _is_walkable(x + 1, y + 1))
+			r_neighbours[count++] = p_point + width + 1;
+	}
+
+	return count;
+}
+
+int AStarGrid2D::_get_successors(int p_point, int p_parent, int p_end, int *r_successors) const {
+
+	int neighbours[8];
+	int neighbour_count = 0;
+
+	int x = p_point % width;
+	int y = p_point / width;
+	int parent = p_parent;
+
+	if (parent < 0) {
+		neighbour_count = _get_neighbours(p_point, neighbours);
+	} else {
+		// Only keep the neighbours that can't be reached as cheaply without going through this point.
+		int dx = SGN(x - parent % width);
+		int dy = SGN(y - parent / width);
+
+		if (dx != 0 && dy != 0) {
+			bool next_x = _is_walkable(x + dx, y);
+			bool next_y = _is_walkable(x, y + dy);
+			if (next_y)
+				neighbours[neighbour_count++] = p_point + dy * width;
+			if (next_x)
+				neighbours[neighbour_count++] = p_point + dx;
+			if (next_x && next_y && _is_walkable(x + dx, y + dy))
+				neighbours[neighbour_count++] = p_point + dy * width + dx;
+		} else if (dx != 0) {
+			bool next = _is_walkable(x + dx, y);
+			bool top = _is_walkable(x, y - 1);
+			bool bottom = _is_walkable(x, y + 1);
+			if (next) {
+				neighbours[neighbour_count++] = p_point + dx;
+				if (top && _is_walkable(x + dx, y - 1))
+					neighbours[neighbour_count++] = p_point - width + dx;
+				if (bottom && _is_walkable(x + dx, y + 1))
+					neighbours[neighbour_count++] = p_point + width + dx;
+			}
+			if (top)
+				neighbours[neighbour_count++] = p_point - width;
+			if (bottom)
+				neighbours[neighbour_count++] = p_point + width;
+		} else {
+			bool next = _is_walkable(x, y + dy);
+			bool left = _is_walkable(x - 1, y);
+			bool right = _is_walkable(x + 1, y);
+			if (next) {
+				neighbours[neighbour_count++] = p_point + dy * width;
+				if (left && _is_walkable(x - 1, y + dy))
+					neighbours[neighbour_count++] = p_point + dy * width - 1;
+				if (right && _is_walkable(x + 1, y + dy))
+					neighbours[neighbour_count++] = p_point + dy * width + 1;
+			}
+			if (left)
+				neighbours[neighbour_count++] = p_point - 1;
+			if (right)
+				neighbours[neighbour_count++] = p_point + 1;
+		}
+	}
+
+	int count = 0;
+	for (int i = 0; i < neighbour_count; i++) {
+		int nx = neighbours[i] % width;
+		int ny = neighbours[i] / width;
+		int jump_point = _jump(nx, ny, nx - x, ny - y, p_end);
+		if (jump_point >= 0) {
+			r_successors[count++] = jump_point;
+		}
+	}
+
+	return count;
+}
+
+AStarSearchContext *AStarGrid2D::_acquire_context() {
+
+	MutexLock lock(context_mutex);
+
+	if (free_contexts.empty()) {
+		return memnew(AStarSearchContext);
+	}
+
+	AStarSearchContext *context = free_contexts[free_contexts.size() - 1];
+	free_contexts.resize(free_contexts.size() - 1);
+	return context;
+}
+
+void AStarGrid2D::_release_context(AStarSearchContext *p_context) {
+
+	MutexLock lock(context_mutex);
+	free_contexts.push_back(p_context);
+}
+
+bool AStarGrid2D::_solve(AStarSearchContext *p_context, int p_begin, int p_end) {
+
+	AStarSearchState *states = p_context->begin_search(solid.size());
+	AStarOpenList<AStarSearchState> &open_list = p_context->open_list;
+	uint32_t pass = p_context->pass;
+
+	int end_x = p_end % width;
+	int end_y = p_end / width;
+	bool jumping = jumping_enabled && diagonal_enabled;
+
+	AStarSearchState &begin = states[p_begin];
+	begin.g_score = 0;
+	begin.f_score = _get_cost(end_x - p_begin % width, end_y - p_begin / width);
+	begin.prev_point = -1;
+	begin.pass = pass;
+	begin.closed = false;
+
+	open_list.push(states, p_begin);
+
+	bool found_route = false;
+	int successors[8];
+
+	while (!open_list.empty()) {
+
+		int p = open_list.pop(states);
+		if (p == p_end) {
+			found_route = true;
+			break;
+		}
+
+		states[p].closed = true;
+
+		int x = p % width;
+		int y = p / width;
+		int count = jumping ? _get_successors(p, states[p].prev_point, p_end, successors) : _get_neighbours(p, successors);
+
+		for (int i = 0; i < count; i++) {
+
+			int e = successors[i];
+			AStarSearchState &es = states[e];
+
+			if (es.pass == pass && es.closed)
+				continue;
+
+			int ex = e % width;
+			int ey = e / width;
+			real_t g_score = states[p].g_score + _get_cost(ex - x, ey - y);
+
+			if (es.pass != pass) {
+				es.pass = pass;
+				es.closed = false;
+				es.prev_point = p;
+				es.g_score = g_score;
+				es.f_score = g_score + _get_cost(end_x - ex, end_y - ey);
+				open_list.push(states, e);
+			} else if (g_score < es.g_score) {
+				es.f_score -= es.g_score - g_score;
+				es.prev_point = p;
+				es.g_score = g_score;
+				open_list.decrease(states, e);
+			}
+		}
+	}
+
+	open_list.clear();
+
+	return found_route;
+}
+
+PoolVector<Vector2> AStarGrid2D::_get_path(const Vector2 &p_from, const Vector2 &p_to, bool p_positions) {
+
+	ERR_FAIL_COND_V(!is_in_bounds(p_from), PoolVector<Vector2>());
+	ERR_FAIL_COND_V(!is_in_bounds(p_to), PoolVector<Vector2>());
+
+	int a = (int)p_from.y * width + (int)p_from.x;
+	int b = (int)p_to.y * width + (int)p_to.x;
+
+	if (solid[a] || solid[b])
+		return PoolVector<Vector2>();
+
+	AStarSearchContext *context = NULL;
+	const AStarSearchState *states = NULL;
+
+	if (a != b) {
+		context = _acquire_context();
+
+		if (!_solve(context, a, b)) {
+			_release_context(context);
+			return PoolVector<Vector2>();
+		}
+
+		states = context->states.ptr();
+	}
+
+	// Jump points are joined by straight or diagonal lines, count every cell along them.
+	int pc = 1; // Begin point
+	for (int p = b; p != a; p = states[p].prev_point) {
+		int prev = states[p].prev_point;
+		pc += MAX(ABS(p % width - prev % width), ABS(p / width - prev / width));
+	}
+
+	PoolVector<Vector2> path;
+	path.resize(pc);
+
+	{
+		PoolVector<Vector2>::Write w = path.write();
+
+		int idx = pc - 1;
+		int p = b;
+		while (p != a) {
+			int prev = states[p].prev_point;
+			int x = p % width;
+			int y = p / width;
+			int dx = SGN(prev % width - x);
+			int dy = SGN(prev / width - y);
+			while (x != prev % width || y != prev / width) {
+				w[idx--] = Vector2(x, y);
+				x += dx;
+				y += dy;
+			}
+			p = prev;
+		}
+
+		w[0] = Vector2(a % width, a / width); // Assign first
+
+		if (p_positions) {
+			for (int i = 0; i < pc; i++) {
+				w[i] *= cell_size;
+			}
+		}
+	}
+
+	if (context) {
+		_release_context(context);
+	}
+
+	return path;
+}
+
+PoolVector<Vector2> AStarGrid2D::get_point_path(const Vector2 &p_from, const Vector2 &p_to) {
+
+	return _get_path(p_from, p_to, true);
+}
+
+PoolVector<Vector2> AStarGrid2D::get_id_path(const Vector2 &p_from, const Vector2 &p_to) {
+
+	return _get_path(p_from, p_to, false);
+}
+
+void AStarGrid2D::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("set_size", "size"), &AStarGrid2D::set_size);
+	ClassDB::bind_method(D_METHOD("get_size"), &AStarGrid2D::get_size);
+	ClassDB::bind_method(D_METHOD("set_cell_size", "cell_size"), &AStarGrid2D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &AStarGrid2D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("set_diagonal_enabled", "enabled"), &AStarGrid2D::set_diagonal_enabled);
+	ClassDB::bind_method(D_METHOD("is_diagonal_enabled"), &AStarGrid2D::is_diagonal_enabled);
+	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+
+	ClassDB::bind_method(D_METHOD("is_in_bounds", "cell"), &AStarGrid2D::is_in_bounds);
+	ClassDB::bind_method(D_METHOD("set_point_solid", "cell", "solid"), &AStarGrid2D::set_point_solid, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_point_solid", "cell"), &AStarGrid2D::is_point_solid);
+	ClassDB::bind_method(D_METHOD("get_point_position", "cell"), &AStarGrid2D::get_point_position);
+	ClassDB::bind_method(D_METHOD("clear"), &AStarGrid2D::clear);
+
+	ClassDB::bind_method(D_METHOD("get_point_path", "from", "to"), &AStarGrid2D::get_point_path);
+	ClassDB::bind_method(D_METHOD("get_id_path", "from", "to"), &AStarGrid2D::get_id_path);
+
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "size"), "set_size", "get_size");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "cell_size"), "set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "diagonal_enabled"), "set_diagonal_enabled", "is_diagonal_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+}
+
+AStarGrid2D::AStarGrid2D() {
+
+	width = 0;
+	height = 0;
+	cell_size = Vector2(1, 1);
+	diagonal_enabled = true;
+	jumping_enabled = true;
+	context_mutex = Mutex::create();
+}
+
+AStarGrid2D::~AStarGrid2D() {
+
+	for (int i = 0; i < free_contexts.size(); i++) {
+		memdelete(free_contexts[i]);
+	}
+	memdelete(context_mutex);
+}
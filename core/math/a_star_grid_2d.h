@@ -0,0 +1,111 @@
+/*************************************************************************/
+/*  a_star_grid_2d.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef ASTAR_GRID_2D_H
+#define ASTAR_GRID_2D_H
+
+#include "core/math/a_star.h"
+
+/**
+	A* pathfinding on a uniform grid, using jump point search
+	to skip over open areas when diagonal movement is enabled.
+*/
+
+class AStarGrid2D : public Reference {
+
+	GDCLASS(AStarGrid2D, Reference)
+
+	int width;
+	int height;
+	Vector2 cell_size;
+	bool diagonal_enabled;
+	bool jumping_enabled;
+
+	Vector<uint8_t> solid;
+
+	Vector<AStarSearchContext *> free_contexts;
+	Mutex *context_mutex;
+
+	_FORCE_INLINE_ bool _is_walkable(int p_x, int p_y) const {
+
+		return p_x >= 0 && p_y >= 0 && p_x < width && p_y < height && !solid.ptr()[p_y * width + p_x];
+	}
+
+	_FORCE_INLINE_ real_t _get_cost(int p_dx, int p_dy) const {
+
+		p_dx = ABS(p_dx);
+		p_dy = ABS(p_dy);
+		if (!diagonal_enabled)
+			return p_dx * cell_size.x + p_dy * cell_size.y;
+
+		int diagonal = MIN(p_dx, p_dy);
+		return diagonal * cell_size.length() + (p_dx - diagonal) * cell_size.x + (p_dy - diagonal) * cell_size.y;
+	}
+
+	int _jump_straight(int p_x, int p_y, int p_dx, int p_dy, int p_end) const;
+	int _jump(int p_x, int p_y, int p_dx, int p_dy, int p_end) const;
+	int _get_neighbours(int p_point, int *r_neighbours) const;
+	int _get_successors(int p_point, int p_parent, int p_end, int *r_successors) const;
+	AStarSearchContext *_acquire_context();
+	void _release_context(AStarSearchContext *p_context);
+	bool _solve(AStarSearchContext *p_context, int p_begin, int p_end);
+	PoolVector<Vector2> _get_path(const Vector2 &p_from, const Vector2 &p_to, bool p_positions);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_size(const Vector2 &p_size);
+	Vector2 get_size() const;
+
+	void set_cell_size(const Vector2 &p_cell_size);
+	Vector2 get_cell_size() const;
+
+	void set_diagonal_enabled(bool p_enabled);
+	bool is_diagonal_enabled() const;
+
+	void set_jumping_enabled(bool p_enabled);
+	bool is_jumping_enabled() const;
+
+	bool is_in_bounds(const Vector2 &p_cell) const;
+	void set_point_solid(const Vector2 &p_cell, bool p_solid = true);
+	bool is_point_solid(const Vector2 &p_cell) const;
+	Vector2 get_point_position(const Vector2 &p_cell) const;
+
+	void clear();
+
+	PoolVector<Vector2> get_point_path(const Vector2 &p_from, const Vector2 &p_to);
+	PoolVector<Vector2> get_id_path(const Vector2 &p_from, const Vector2 &p_to);
+
+	AStarGrid2D();
+	~AStarGrid2D();
+};
+
+#endif // ASTAR_GRID_2D_H
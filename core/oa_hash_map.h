@@ -251,6 +251,21 @@ public:
 		num_elements--;
 	}
 
+	void clear() {
+
+		for (uint32_t i = 0; i < capacity; i++) {
+
+			if (hashes[i] != EMPTY_HASH && !(hashes[i] & DELETED_HASH_BIT)) {
+				values[i].~TValue();
+				keys[i].~TKey();
+			}
+
+			hashes[i] = EMPTY_HASH;
+		}
+
+		num_elements = 0;
+	}
+
 	struct Iterator {
 		bool valid;
 
@@ -36,6 +36,7 @@
 #include "core/os/os.h"
 #include "core/print_string.h"
 #include "core/resource.h"
+#include "core/safe_refcount.h"
 #include "core/script_language.h"
 #include "core/translation.h"
 
@@ -2015,17 +2016,60 @@ void postinitialize_handler(Object *p_object) {
 	p_object->_postinitialize();
 }
 
-HashMap<ObjectID, Object *> ObjectDB::instances;
-ObjectID ObjectDB::instance_counter = 1;
+ObjectDB::ObjectSlot *volatile ObjectDB::slot_chunks[ObjectDB::MAX_CHUNKS] = {};
+volatile uint32_t ObjectDB::slot_count = 1; // slot 0 is reserved, so no valid ID is ever 0
+uint32_t ObjectDB::free_head = 0;
+uint32_t ObjectDB::free_tail = 0;
+int ObjectDB::object_count = 0;
 HashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
+
 ObjectID ObjectDB::add_instance(Object *p_object) {
 
 	ERR_FAIL_COND_V(p_object->get_instance_id() != 0, 0);
 
 	rw_lock->write_lock();
-	ObjectID instance_id = ++instance_counter;
-	instances[instance_id] = p_object;
+
+	uint32_t slot;
+	if (free_head) {
+		// Reuse the oldest freed slot first, so generations advance slowly.
+		slot = free_head;
+		free_head = _get_slot(slot).next_free;
+		if (!free_head)
+			free_tail = 0;
+	} else {
+		slot = slot_count;
+		if (slot > SLOT_MASK) {
+			rw_lock->write_unlock();
+			ERR_EXPLAIN("Out of ObjectDB slots, too many objects alive.");
+			ERR_FAIL_V(0);
+		}
+
+		uint32_t chunk = slot >> CHUNK_BITS;
+		if (!slot_chunks[chunk]) {
+			ObjectSlot *slots = (ObjectSlot *)memalloc(sizeof(ObjectSlot) * CHUNK_SIZE);
+			for (int i = 0; i < CHUNK_SIZE; i++) {
+				slots[i].validator = 0;
+				slots[i].object = NULL;
+				slots[i].generation = 0;
+				slots[i].next_free = 0;
+			}
+			slot_chunks[chunk] = slots;
+		}
+
+		// Readers check slot_count before touching a chunk, so the chunk must be visible first.
+		atomic_memory_barrier();
+		slot_count = slot + 1;
+	}
+
+	ObjectSlot &s = _get_slot(slot);
+	ObjectID instance_id = ((ObjectID)s.generation << SLOT_BITS) | slot;
+
+	s.object = p_object;
+	atomic_memory_barrier();
+	s.validator = _make_validator(s.generation);
+
 	instance_checks[p_object] = instance_id;
+	object_count++;
 
 	rw_lock->write_unlock();
 
@@ -2034,32 +2078,74 @@ ObjectID ObjectDB::add_instance(Object *p_object) {
 
 void ObjectDB::remove_instance(Object *p_object) {
 
+	ObjectID instance_id = p_object->get_instance_id();
+	uint32_t slot = instance_id & SLOT_MASK;
+
 	rw_lock->write_lock();
 
-	instances.erase(p_object->get_instance_id());
+	if (slot != 0 && slot < slot_count) {
+
+		ObjectSlot &s = _get_slot(slot);
+		if (s.validator && (instance_id >> SLOT_BITS) == s.generation) {
+
+			s.validator = 0;
+			atomic_memory_barrier();
+			s.object = NULL;
+			s.generation = (s.generation + 1) & GENERATION_MASK;
+			s.next_free = 0;
+
+			if (free_tail)
+				_get_slot(free_tail).next_free = slot;
+			else
+				free_head = slot;
+			free_tail = slot;
+
+			object_count--;
+		}
+	}
+
 	instance_checks.erase(p_object);
 
 	rw_lock->write_unlock();
 }
+
 Object *ObjectDB::get_instance(ObjectID p_instance_ID) {
 
-	rw_lock->read_lock();
-	Object **obj = instances.getptr(p_instance_ID);
-	rw_lock->read_unlock();
+	// Lock-free: chunks are never moved or freed, and a slot always publishes
+	// its object before its validator, so re-checking the validator after reading
+	// the object rejects any slot that was freed or reused in between.
+	uint32_t slot = p_instance_ID & SLOT_MASK;
+	if (slot == 0 || slot >= slot_count)
+		return NULL;
+	ObjectID generation = p_instance_ID >> SLOT_BITS;
+	if (generation > GENERATION_MASK)
+		return NULL;
+	uint32_t validator = _make_validator(generation);
+	atomic_memory_barrier();
 
-	if (!obj)
+	ObjectSlot &s = _get_slot(slot);
+	if (s.validator != validator)
 		return NULL;
-	return *obj;
+	atomic_memory_barrier();
+
+	Object *object = s.object;
+	atomic_memory_barrier();
+
+	if (s.validator != validator)
+		return NULL;
+
+	return object;
 }
 
 void ObjectDB::debug_objects(DebugFunc p_func) {
 
 	rw_lock->read_lock();
 
-	const ObjectID *K = NULL;
-	while ((K = instances.next(K))) {
+	for (uint32_t i = 1; i < slot_count; i++) {
 
-		p_func(instances[*K]);
+		ObjectSlot &s = _get_slot(i);
+		if (s.validator)
+			p_func(s.object);
 	}
 
 	rw_lock->read_unlock();
@@ -2070,11 +2156,7 @@ void Object::get_argument_options(const StringName &p_function, int p_idx, List<
 
 int ObjectDB::get_object_count() {
 
-	rw_lock->read_lock();
-	int count = instances.size();
-	rw_lock->read_unlock();
-
-	return count;
+	return object_count;
 }
 
 RWLock *ObjectDB::rw_lock = NULL;
@@ -2087,23 +2169,38 @@ void ObjectDB::setup() {
 void ObjectDB::cleanup() {
 
 	rw_lock->write_lock();
-	if (instances.size()) {
+	if (object_count) {
 
 		WARN_PRINT("ObjectDB Instances still exist!");
 		if (OS::get_singleton()->is_stdout_verbose()) {
-			const ObjectID *K = NULL;
-			while ((K = instances.next(K))) {
+			for (uint32_t i = 1; i < slot_count; i++) {
+
+				ObjectSlot &s = _get_slot(i);
+				if (!s.validator)
+					continue;
 
+				Object *obj = s.object;
 				String node_name;
-				if (instances[*K]->is_class("Node"))
-					node_name = " - Node name: " + String(instances[*K]->call("get_name"));
-				if (instances[*K]->is_class("Resource"))
-					node_name = " - Resource name: " + String(instances[*K]->call("get_name")) + " Path: " + String(instances[*K]->call("get_path"));
-				print_line("Leaked instance: " + String(instances[*K]->get_class()) + ":" + itos(*K) + node_name);
+				if (obj->is_class("Node"))
+					node_name = " - Node name: " + String(obj->call("get_name"));
+				if (obj->is_class("Resource"))
+					node_name = " - Resource name: " + String(obj->call("get_name")) + " Path: " + String(obj->call("get_path"));
+				print_line("Leaked instance: " + String(obj->get_class()) + ":" + itos(((ObjectID)s.generation << SLOT_BITS) | i) + node_name);
 			}
 		}
 	}
-	instances.clear();
+
+	for (int i = 0; i < MAX_CHUNKS; i++) {
+		if (slot_chunks[i]) {
+			memfree(slot_chunks[i]);
+			slot_chunks[i] = NULL;
+		}
+	}
+	slot_count = 1;
+	free_head = 0;
+	free_tail = 0;
+	object_count = 0;
+
 	instance_checks.clear();
 	rw_lock->write_unlock();
 	memdelete(rw_lock);
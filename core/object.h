@@ -757,10 +757,48 @@ class ObjectDB {
 		}
 	};
 
-	static HashMap<ObjectID, Object *> instances;
+	// Live objects are stored in a table of slots, indexed by the low bits of
+	// their ObjectID. The high bits hold the generation of the slot, which is
+	// bumped every time it is freed, so stale IDs never resolve to a newer object.
+	// Slots live in fixed-size chunks that are never moved or freed while the
+	// engine runs, which lets get_instance() read them without taking the lock.
+	// Readers only check the 32-bit validator, so lookups never depend on
+	// a 64-bit read being atomic.
+	enum {
+		SLOT_BITS = 24,
+		SLOT_MASK = (1 << SLOT_BITS) - 1,
+		GENERATION_MASK = 0x7FFFFFFF,
+		CHUNK_BITS = 12,
+		CHUNK_SIZE = 1 << CHUNK_BITS,
+		CHUNK_MASK = CHUNK_SIZE - 1,
+		MAX_CHUNKS = 1 << (SLOT_BITS - CHUNK_BITS),
+	};
+
+	struct ObjectSlot {
+		volatile uint32_t validator; // (generation << 1) | 1 while the slot holds an object, 0 when free
+		Object *volatile object;
+		uint32_t generation;
+		uint32_t next_free;
+	};
+
+	static ObjectSlot *volatile slot_chunks[MAX_CHUNKS];
+	static volatile uint32_t slot_count;
+	static uint32_t free_head;
+	static uint32_t free_tail;
+	static int object_count;
+
 	static HashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
 
-	static ObjectID instance_counter;
+	_FORCE_INLINE_ static ObjectSlot &_get_slot(uint32_t p_slot) {
+
+		return slot_chunks[p_slot >> CHUNK_BITS][p_slot & CHUNK_MASK];
+	}
+
+	_FORCE_INLINE_ static uint32_t _make_validator(uint32_t p_generation) {
+
+		return (p_generation << 1) | 1;
+	}
+
 	friend class Object;
 	friend void unregister_core_types();
 
@@ -0,0 +1,324 @@
+/*************************************************************************/
+/*  path_request_queue.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "path_request_queue.h"
+
+#include "core/os/os.h"
+#include "core/project_settings.h"
+
+PathRequestQueue *PathRequestQueue::singleton = NULL;
+
+PathRequestQueue *PathRequestQueue::get_singleton() {
+
+	return singleton;
+}
+
+PathRequestQueue::Request *PathRequestQueue::_take_request(bool p_worker) {
+
+	// Workers take thread safe requests, the main thread the rest, or all of them without workers.
+	for (List<Request *>::Element *E = queued.front(); E; E = E->next()) {
+
+		Request *request = E->get();
+		bool thread_safe = request->is_thread_safe();
+		if (p_worker ? thread_safe : (!thread_safe || threads.empty())) {
+			queued.erase(E);
+			return request;
+		}
+	}
+
+	return NULL;
+}
+
+void PathRequestQueue::_solve(Request *p_request) {
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	p_request->solve();
+	p_request->solve_usec = OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+void PathRequestQueue::_thread_func(void *p_userdata) {
+
+	PathRequestQueue *queue = (PathRequestQueue *)p_userdata;
+
+	while (true) {
+
+		queue->semaphore->wait();
+
+		queue->mutex->lock();
+		if (queue->exit_threads) {
+			queue->mutex->unlock();
+			break;
+		}
+		Request *request = queue->_take_request(true);
+		if (!request) {
+			// Cancelled before a thread got to it.
+			queue->mutex->unlock();
+			continue;
+		}
+		List<Request *>::Element *E = queue->solving.push_back(request);
+		queue->mutex->unlock();
+
+		queue->_solve(request);
+
+		queue->mutex->lock();
+		queue->solving.erase(E);
+		queue->solved.push_back(request);
+		for (int i = 0; i < queue->finished_waiters; i++) {
+			queue->finished_semaphore->post();
+		}
+		queue->finished_waiters = 0;
+		queue->mutex->unlock();
+	}
+}
+
+int PathRequestQueue::push_request(Object *p_owner, Request *p_request) {
+
+	ERR_FAIL_NULL_V(p_owner, 0);
+	ERR_FAIL_NULL_V(p_request, 0);
+
+	mutex->lock();
+	p_request->owner = p_owner->get_instance_id();
+	p_request->id = ++last_id;
+	queued.push_back(p_request);
+	mutex->unlock();
+
+	if (threads.size() && p_request->is_thread_safe()) {
+		semaphore->post();
+	}
+
+	return p_request->id;
+}
+
+void PathRequestQueue::cancel_request(Object *p_owner, int p_id) {
+
+	ERR_FAIL_NULL(p_owner);
+
+	ObjectID owner = p_owner->get_instance_id();
+	MutexLock lock(mutex);
+
+	for (List<Request *>::Element *E = queued.front(); E; E = E->next()) {
+		if (E->get()->owner == owner && E->get()->id == p_id) {
+			memdelete(E->get());
+			queued.erase(E);
+			return;
+		}
+	}
+
+	// Already being solved, just don't deliver it.
+	for (List<Request *>::Element *E = solving.front(); E; E = E->next()) {
+		if (E->get()->owner == owner && E->get()->id == p_id) {
+			E->get()->cancelled = true;
+			return;
+		}
+	}
+	for (List<Request *>::Element *E = solved.front(); E; E = E->next()) {
+		if (E->get()->owner == owner && E->get()->id == p_id) {
+			E->get()->cancelled = true;
+			return;
+		}
+	}
+}
+
+void PathRequestQueue::cancel_requests(Object *p_owner) {
+
+	ERR_FAIL_NULL(p_owner);
+
+	ObjectID owner = p_owner->get_instance_id();
+
+	while (true) {
+
+		mutex->lock();
+
+		List<Request *>::Element *E = queued.front();
+		while (E) {
+			List<Request *>::Element *N = E->next();
+			if (E->get()->owner == owner) {
+				memdelete(E->get());
+				queued.erase(E);
+			}
+			E = N;
+		}
+
+		for (E = solved.front(); E; E = E->next()) {
+			if (E->get()->owner == owner) {
+				E->get()->cancelled = true;
+			}
+		}
+
+		bool busy = false;
+		for (E = solving.front(); E; E = E->next()) {
+			if (E->get()->owner == owner) {
+				E->get()->cancelled = true;
+				busy = true;
+			}
+		}
+
+		if (busy) {
+			finished_waiters++;
+		}
+
+		mutex->unlock();
+
+		if (!busy) {
+			break;
+		}
+
+		// The owner is about to be destroyed, wait until no thread reads from it.
+		finished_semaphore->wait();
+	}
+}
+
+void PathRequestQueue::process() {
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	// At least one request is solved every frame, even if it takes longer than the budget.
+	while (true) {
+
+		mutex->lock();
+		Request *request = _take_request(false);
+		mutex->unlock();
+
+		if (!request) {
+			break;
+		}
+
+		_solve(request);
+
+		mutex->lock();
+		solved.push_back(request);
+		mutex->unlock();
+
+		if (OS::get_singleton()->get_ticks_usec() - begin >= frame_budget_usec) {
+			break;
+		}
+	}
+
+	completed_in_frame = 0;
+	solve_usec_in_frame = 0;
+
+	while (true) {
+
+		// Delivering may push or cancel requests, so the lock isn't held while doing it.
+		mutex->lock();
+		if (solved.empty()) {
+			mutex->unlock();
+			break;
+		}
+		Request *request = solved.front()->get();
+		solved.pop_front();
+		mutex->unlock();
+
+		completed_in_frame++;
+		solve_usec_in_frame += request->solve_usec;
+
+		if (!request->cancelled) {
+			Object *owner = ObjectDB::get_instance(request->owner);
+			if (owner) {
+				request->deliver(owner);
+			}
+		}
+		memdelete(request);
+	}
+}
+
+int PathRequestQueue::get_queued_count() const {
+
+	MutexLock lock(mutex);
+	return queued.size() + solving.size();
+}
+
+int PathRequestQueue::get_completed_in_frame() const {
+
+	return completed_in_frame;
+}
+
+float PathRequestQueue::get_solve_time_in_frame() const {
+
+	return USEC_TO_SEC(solve_usec_in_frame);
+}
+
+PathRequestQueue::PathRequestQueue() {
+
+	singleton = this;
+
+	mutex = Mutex::create();
+	semaphore = NULL;
+	exit_threads = false;
+	finished_semaphore = NULL;
+	finished_waiters = 0;
+	last_id = 0;
+	completed_in_frame = 0;
+	solve_usec_in_frame = 0;
+
+	frame_budget_usec = (uint64_t)(GLOBAL_DEF("navigation/path_requests/frame_budget_msec", 2.0).operator double() * 1000.0);
+	ProjectSettings::get_singleton()->set_custom_property_info("navigation/path_requests/frame_budget_msec", PropertyInfo(Variant::REAL, "navigation/path_requests/frame_budget_msec", PROPERTY_HINT_RANGE, "0,100,0.1,or_greater"));
+
+	int thread_count = GLOBAL_DEF("navigation/path_requests/worker_threads", 1);
+	ProjectSettings::get_singleton()->set_custom_property_info("navigation/path_requests/worker_threads", PropertyInfo(Variant::INT, "navigation/path_requests/worker_threads", PROPERTY_HINT_RANGE, "0,16,1"));
+
+	if (thread_count > 0 && OS::get_singleton()->can_use_threads()) {
+		semaphore = Semaphore::create();
+		finished_semaphore = Semaphore::create();
+		for (int i = 0; i < thread_count; i++) {
+			threads.push_back(Thread::create(_thread_func, this));
+		}
+	}
+}
+
+PathRequestQueue::~PathRequestQueue() {
+
+	mutex->lock();
+	exit_threads = true;
+	mutex->unlock();
+
+	for (int i = 0; i < threads.size(); i++) {
+		semaphore->post();
+	}
+	for (int i = 0; i < threads.size(); i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	for (List<Request *>::Element *E = queued.front(); E; E = E->next()) {
+		memdelete(E->get());
+	}
+	for (List<Request *>::Element *E = solved.front(); E; E = E->next()) {
+		memdelete(E->get());
+	}
+
+	if (semaphore) {
+		memdelete(semaphore);
+		memdelete(finished_semaphore);
+	}
+	memdelete(mutex);
+
+	singleton = NULL;
+}
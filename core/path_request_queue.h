@@ -0,0 +1,119 @@
+/*************************************************************************/
+/*  path_request_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef PATH_REQUEST_QUEUE_H
+#define PATH_REQUEST_QUEUE_H
+
+#include "core/list.h"
+#include "core/object.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+// Solves path queries outside of the calling code, either on worker threads or
+// on the main thread within a time budget each frame. Results are delivered on
+// the main thread, so owners can emit signals from them safely.
+class PathRequestQueue {
+
+public:
+	class Request {
+
+		friend class PathRequestQueue;
+
+		ObjectID owner;
+		int id;
+		bool cancelled;
+		uint64_t solve_usec;
+
+	public:
+		_FORCE_INLINE_ int get_id() const { return id; }
+
+		// Requests that can't be solved on the worker threads, like those calling scripts, are solved on the main thread.
+		virtual bool is_thread_safe() const { return true; }
+		// Runs on any thread if thread safe, must only read from the owner.
+		virtual void solve() = 0;
+		// Runs on the main thread, if the owner still exists and the request wasn't cancelled.
+		virtual void deliver(Object *p_owner) = 0;
+
+		Request() {
+			owner = 0;
+			id = 0;
+			cancelled = false;
+			solve_usec = 0;
+		}
+		virtual ~Request() {}
+	};
+
+private:
+	static PathRequestQueue *singleton;
+
+	Mutex *mutex;
+	Semaphore *semaphore;
+	Vector<Thread *> threads;
+	bool exit_threads;
+
+	// Posted once for every waiter when a worker finishes a request, while requests are being cancelled.
+	Semaphore *finished_semaphore;
+	int finished_waiters;
+
+	List<Request *> queued;
+	List<Request *> solving;
+	List<Request *> solved;
+	int last_id;
+
+	uint64_t frame_budget_usec;
+
+	int completed_in_frame;
+	uint64_t solve_usec_in_frame;
+
+	Request *_take_request(bool p_worker);
+	void _solve(Request *p_request);
+	static void _thread_func(void *p_userdata);
+
+public:
+	static PathRequestQueue *get_singleton();
+
+	int push_request(Object *p_owner, Request *p_request);
+	void cancel_request(Object *p_owner, int p_id);
+	// Also waits for the requests being solved, call it before destroying what they read,
+	// e.g. on NOTIFICATION_PREDELETE.
+	void cancel_requests(Object *p_owner);
+
+	void process();
+
+	int get_queued_count() const;
+	int get_completed_in_frame() const;
+	float get_solve_time_in_frame() const;
+
+	PathRequestQueue();
+	~PathRequestQueue();
+};
+
+#endif // PATH_REQUEST_QUEUE_H
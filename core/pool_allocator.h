@@ -44,7 +44,8 @@
 
 enum {
 
-	POOL_ALLOCATOR_INVALID_ID = -1 ///< default invalid value. use INVALID_ID( id ) to test
+	POOL_ALLOCATOR_INVALID_ID = -1, ///< default invalid value. use INVALID_ID( id ) to test
+	POOL_ALLOCATOR_EXTERNAL_ID = -2 ///< read-only memory not allocated by Godot, see PoolVector::adopt_external
 };
 
 class PoolAllocator {
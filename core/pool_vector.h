@@ -56,12 +56,18 @@ struct MemoryPool {
 
 		Alloc *free_list;
 
+		// Releases external memory, see PoolVector::adopt_external().
+		void (*free_external_func)(void *p_userdata);
+		void *free_external_userdata;
+
 		Alloc() :
 				lock(0),
 				mem(NULL),
 				pool_id(POOL_ALLOCATOR_INVALID_ID),
 				size(0),
-				free_list(NULL) {
+				free_list(NULL),
+				free_external_func(NULL),
+				free_external_userdata(NULL) {
 		}
 	};
 
@@ -73,6 +79,16 @@ struct MemoryPool {
 	static size_t total_memory;
 	static size_t max_memory;
 
+	static void free_mem(Alloc *p_alloc) {
+		if (p_alloc->pool_id == POOL_ALLOCATOR_EXTERNAL_ID) {
+			p_alloc->free_external_func(p_alloc->free_external_userdata);
+			p_alloc->free_external_func = NULL;
+			p_alloc->free_external_userdata = NULL;
+		} else {
+			memfree(p_alloc->mem);
+		}
+	}
+
 	static void setup(uint32_t p_max_allocs = (1 << 16));
 	static void cleanup();
 };
@@ -94,8 +110,8 @@ class PoolVector {
 		//		ERR_FAIL_COND(alloc->lock>0); should not be illegal to lock this for copy on write, as it's a copy on write after all
 
 		// Refcount should not be zero, otherwise it's a misuse of COW
-		if (alloc->refcount.get() == 1)
-			return; //nothing to do
+		if (alloc->refcount.get() == 1 && alloc->pool_id != POOL_ALLOCATOR_EXTERNAL_ID)
+			return; //nothing to do, external memory is read-only so it's always copied
 
 		//must allocate something
 
@@ -175,7 +191,7 @@ class PoolVector {
 				//if some resize
 			} else {
 
-				memfree(old_alloc->mem);
+				MemoryPool::free_mem(old_alloc);
 				old_alloc->mem = NULL;
 				old_alloc->size = 0;
 
@@ -243,7 +259,7 @@ class PoolVector {
 			//if some resize
 		} else {
 
-			memfree(alloc->mem);
+			MemoryPool::free_mem(alloc);
 			alloc->mem = NULL;
 			alloc->size = 0;
 
@@ -460,6 +476,8 @@ public:
 
 	void invert();
 
+	Error adopt_external(const T *p_mem, int p_size, void (*p_free_func)(void *p_userdata), void *p_userdata);
+
 	void operator=(const PoolVector &p_pool_vector) { _reference(p_pool_vector); }
 	PoolVector() { alloc = NULL; }
 	PoolVector(const PoolVector &p_pool_vector) {
@@ -551,7 +569,7 @@ Error PoolVector<T>::resize(int p_size) {
 		return OK;
 	}
 
-	_copy_on_write(); // make it unique
+	_copy_on_write(); // make it unique, this also moves external memory to the heap
 
 #ifdef DEBUG_ENABLED
 	MemoryPool::alloc_mutex->lock();
@@ -626,6 +644,48 @@ Error PoolVector<T>::resize(int p_size) {
 	return OK;
 }
 
+// Uses p_size elements at p_mem without copying them, e.g. from a mapped file. The elements need no construction
+// and are never written: the first write copies them to the heap. p_free_func is called with p_userdata when the
+// memory is no longer used. On failure nothing is adopted and p_free_func is not called.
+template <class T>
+Error PoolVector<T>::adopt_external(const T *p_mem, int p_size, void (*p_free_func)(void *p_userdata), void *p_userdata) {
+
+	ERR_FAIL_NULL_V(p_free_func, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_size <= 0, ERR_INVALID_PARAMETER);
+
+	_unreference();
+
+	MemoryPool::alloc_mutex->lock();
+	if (MemoryPool::allocs_used == MemoryPool::alloc_count) {
+		MemoryPool::alloc_mutex->unlock();
+		ERR_EXPLAINC("All memory pool allocations are in use.");
+		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+	}
+
+	alloc = MemoryPool::free_list;
+	MemoryPool::free_list = alloc->free_list;
+	MemoryPool::allocs_used++;
+
+	alloc->refcount.init();
+	alloc->pool_id = POOL_ALLOCATOR_EXTERNAL_ID;
+	alloc->lock = 0;
+	alloc->mem = (void *)p_mem;
+	alloc->size = sizeof(T) * p_size;
+	alloc->free_external_func = p_free_func;
+	alloc->free_external_userdata = p_userdata;
+
+#ifdef DEBUG_ENABLED
+	MemoryPool::total_memory += alloc->size;
+	if (MemoryPool::total_memory > MemoryPool::max_memory) {
+		MemoryPool::max_memory = MemoryPool::total_memory;
+	}
+#endif
+
+	MemoryPool::alloc_mutex->unlock();
+
+	return OK;
+}
+
 template <class T>
 void PoolVector<T>::invert() {
 	T temp;
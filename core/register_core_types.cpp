@@ -38,7 +38,9 @@
 #include "core/func_ref.h"
 #include "core/input_map.h"
 #include "core/io/config_file.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/http_client.h"
+#include "core/io/http_client_pool.h"
 #include "core/io/image_loader.h"
 #include "core/io/marshalls.h"
 #include "core/io/multiplayer_api.h"
@@ -53,6 +55,7 @@
 #include "core/io/translation_loader_po.h"
 #include "core/io/xml_parser.h"
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
 #include "core/math/expression.h"
 #include "core/math/geometry.h"
 #include "core/math/random_number_generator.h"
@@ -93,6 +96,7 @@ extern void unregister_variant_methods();
 void register_core_types() {
 
 	ObjectDB::setup();
+	FileAccessCompressed::setup();
 	ResourceCache::setup();
 	MemoryPool::setup();
 
@@ -162,6 +166,7 @@ void register_core_types() {
 	ClassDB::register_class<PHashTranslation>();
 	ClassDB::register_class<UndoRedo>();
 	ClassDB::register_class<HTTPClient>();
+	ClassDB::register_class<HTTPClientPool>();
 	ClassDB::register_class<TriangleMesh>();
 
 	ClassDB::register_virtual_class<ResourceInteractiveLoader>();
@@ -184,6 +189,8 @@ void register_core_types() {
 	ClassDB::register_class<PackedDataContainer>();
 	ClassDB::register_virtual_class<PackedDataContainerRef>();
 	ClassDB::register_class<AStar>();
+	ClassDB::register_virtual_class<AStarFlowField>();
+	ClassDB::register_class<AStarGrid2D>();
 	ClassDB::register_class<EncodedObjectAsID>();
 	ClassDB::register_class<RandomNumberGenerator>();
 
@@ -271,6 +278,7 @@ void unregister_core_types() {
 		memdelete(ip);
 
 	ResourceLoader::finalize();
+	FileAccessCompressed::cleanup();
 
 	ObjectDB::cleanup();
 
@@ -33,9 +33,9 @@
 RID_Data::~RID_Data() {
 }
 
-SafeRefCount RID_OwnerBase::refcount;
+volatile uint32_t RID_OwnerBase::validator_counter = 0;
 
 void RID_OwnerBase::init_rid() {
 
-	refcount.init();
+	validator_counter = 0;
 }
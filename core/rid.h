@@ -27,98 +27,79 @@
 /* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
-
 #ifndef RID_H
 #define RID_H
 
 #include "core/list.h"
 #include "core/os/memory.h"
+#include "core/os/mutex.h"
 #include "core/safe_refcount.h"
-#include "core/set.h"
 #include "core/typedefs.h"
+#include "core/vector.h"
 
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
 */
 
-class RID_OwnerBase;
-
 class RID_Data {
 
-	friend class RID_OwnerBase;
-
-#ifndef DEBUG_ENABLED
-	RID_OwnerBase *_owner;
-#endif
-	uint32_t _id;
-
 public:
-	_FORCE_INLINE_ uint32_t get_id() const { return _id; }
-
 	virtual ~RID_Data();
 };
 
 class RID {
 	friend class RID_OwnerBase;
 
-	mutable RID_Data *_data;
+	uint64_t _id; // validator in the high 32 bits, slot index in the low 32 bits, 0 if invalid
 
 public:
-	_FORCE_INLINE_ RID_Data *get_data() const { return _data; }
-
 	_FORCE_INLINE_ bool operator==(const RID &p_rid) const {
 
-		return _data == p_rid._data;
+		return _id == p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator<(const RID &p_rid) const {
 
-		return _data < p_rid._data;
+		return _id < p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator<=(const RID &p_rid) const {
 
-		return _data <= p_rid._data;
+		return _id <= p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator>(const RID &p_rid) const {
 
-		return _data > p_rid._data;
+		return _id > p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator!=(const RID &p_rid) const {
 
-		return _data != p_rid._data;
+		return _id != p_rid._id;
 	}
-	_FORCE_INLINE_ bool is_valid() const { return _data != NULL; }
+	_FORCE_INLINE_ bool is_valid() const { return _id != 0; }
 
-	_FORCE_INLINE_ uint32_t get_id() const { return _data ? _data->get_id() : 0; }
+	_FORCE_INLINE_ uint64_t get_id() const { return _id; }
 
 	_FORCE_INLINE_ RID() {
-		_data = NULL;
+		_id = 0;
 	}
 };
 
 class RID_OwnerBase {
 protected:
-	static SafeRefCount refcount;
-	_FORCE_INLINE_ void _set_data(RID &p_rid, RID_Data *p_data) {
-		p_rid._data = p_data;
-		refcount.ref();
-		p_data->_id = refcount.get();
-#ifndef DEBUG_ENABLED
-		p_data->_owner = this;
-#endif
-	}
+	static volatile uint32_t validator_counter;
 
-#ifndef DEBUG_ENABLED
+	// Validators come from a counter shared by all owners, so a RID is never
+	// accepted by an owner other than the one that made it.
+	static uint32_t _gen_validator() {
 
-	_FORCE_INLINE_ bool _is_owner(const RID &p_rid) const {
-
-		return this == p_rid._data->_owner;
+		uint32_t validator;
+		do {
+			validator = atomic_increment(&validator_counter);
+		} while (validator == 0);
+		return validator;
 	}
 
-	_FORCE_INLINE_ void _remove_owner(RID &p_rid) {
-
-		p_rid._data->_owner = NULL;
+	_FORCE_INLINE_ static void _set_id(RID &p_rid, uint64_t p_id) {
+		p_rid._id = p_id;
 	}
-#endif
 
 public:
 	virtual void get_owned_list(List<RID> *p_owned) = 0;
@@ -127,81 +108,266 @@ public:
 	virtual ~RID_OwnerBase() {}
 };
 
+/**
+	Stores owned objects in slots kept in fixed-size chunks. A RID holds the
+	index of its slot and the validator the slot was given when the RID was
+	made. Freeing a slot clears its validator, so stale RIDs are rejected by
+	comparing validators, without dereferencing anything they point to.
+
+	Chunks never move once allocated, and a grown chunk table is only
+	released with the owner, so lookups don't lock. Making and freeing RIDs
+	is serialized with a mutex, so it is safe from any thread. Lookups only
+	use acquire loads, which are plain loads on x86, and pair them with
+	release stores when making and freeing RIDs.
+
+	Bulk passes can walk every slot below get_slot_count() with
+	get_by_slot(), which doesn't lock either.
+
+	Slots hold pointers, since servers allocate their objects themselves,
+	often as subclasses of the owned type.
+*/
+
 template <class T>
 class RID_Owner : public RID_OwnerBase {
+
+	enum {
+		CHUNK_BITS = 8,
+		CHUNK_SIZE = 1 << CHUNK_BITS,
+		CHUNK_MASK = CHUNK_SIZE - 1,
+	};
+
+	struct Slot {
+		T *volatile data;
+		volatile uint32_t validator; // 0 when the slot is free
+		uint32_t next_free; // index + 1 of the next free slot, 0 for none
+	};
+
+	Slot **volatile chunks;
+	uint32_t chunk_count;
+	uint32_t chunk_max;
+	volatile uint32_t slot_count;
+	uint32_t free_head;
+	volatile uint32_t owned_count;
+	Vector<Slot **> retired_chunk_tables;
+
+	Mutex *alloc_mutex;
+
+	_FORCE_INLINE_ Slot *_get_slot(const RID &p_rid) const {
+
+		uint64_t id = p_rid.get_id();
+		uint32_t index = id & 0xFFFFFFFF;
+		uint32_t validator = id >> 32;
+
+		// The chunk table and the chunk were written before the slot count was raised.
+		if (unlikely(validator == 0 || index >= atomic_load_acquire(&slot_count)))
+			return NULL;
+
+		// Acquire, so the data isn't read before the validator that accepted it.
+		Slot *slot = &chunks[index >> CHUNK_BITS][index & CHUNK_MASK];
+		return atomic_load_acquire(&slot->validator) == validator ? slot : NULL;
+	}
+
+	_FORCE_INLINE_ T *_get(const RID &p_rid) const {
+
+		Slot *slot = _get_slot(p_rid);
+		if (!slot)
+			return NULL;
+
+		// Acquire, so the validator is checked again after reading the data,
+		// in case the slot was freed or reused meanwhile.
+		T *data = atomic_load_acquire(&slot->data);
+		return slot->validator == uint32_t(p_rid.get_id() >> 32) ? data : NULL;
+	}
+
+	void _grow() {
+
+		if (chunk_count == chunk_max) {
+
+			uint32_t new_max = chunk_max ? chunk_max * 2 : 4;
+			Slot **new_chunks = (Slot **)memalloc(sizeof(Slot *) * new_max);
+			for (uint32_t i = 0; i < chunk_count; i++) {
+				new_chunks[i] = chunks[i];
+			}
+
+			// lookups may still be reading the old table, so it is kept until destruction
+			Slot **old_chunks = chunks;
+			if (old_chunks) {
+				retired_chunk_tables.push_back(old_chunks);
+			}
+
+			// Release, so lookups reading the new table see the copied chunks.
+			atomic_store_release(&chunks, new_chunks);
+			chunk_max = new_max;
+		}
+
+		Slot *chunk = (Slot *)memalloc(sizeof(Slot) * CHUNK_SIZE);
+		for (int i = 0; i < CHUNK_SIZE; i++) {
+			chunk[i].data = NULL;
+			chunk[i].validator = 0;
+			chunk[i].next_free = 0;
+		}
+
+		chunks[chunk_count++] = chunk;
+	}
+
 public:
-#ifdef DEBUG_ENABLED
-	mutable Set<RID_Data *> id_map;
-#endif
-public:
-	_FORCE_INLINE_ RID make_rid(T *p_data) {
+	RID make_rid(T *p_data) {
+
+		MutexLock lock(alloc_mutex);
+
+		uint32_t index;
+		if (free_head) {
+			index = free_head - 1;
+			free_head = chunks[index >> CHUNK_BITS][index & CHUNK_MASK].next_free;
+		} else {
+			index = slot_count;
+			if ((index >> CHUNK_BITS) >= chunk_count) {
+				_grow();
+			}
+		}
 
-		RID rid;
-		_set_data(rid, p_data);
+		Slot &slot = chunks[index >> CHUNK_BITS][index & CHUNK_MASK];
+		uint32_t validator = _gen_validator();
 
-#ifdef DEBUG_ENABLED
-		id_map.insert(p_data);
-#endif
+		// Release, so a lookup reading the new data also sees the validator of
+		// the slot's previous RID cleared by free().
+		atomic_store_release(&slot.data, p_data);
+		slot.next_free = 0;
+		// Release, so the data is visible before the validator accepts the RID.
+		atomic_store_release(&slot.validator, validator);
+		owned_count++;
+
+		if (index == slot_count) {
+			// Release, so the chunk holding the slot is visible before the slot is.
+			atomic_store_release(&slot_count, index + 1);
+		}
 
+		RID rid;
+		_set_id(rid, ((uint64_t)validator << 32) | index);
 		return rid;
 	}
 
 	_FORCE_INLINE_ T *get(const RID &p_rid) {
 
-#ifdef DEBUG_ENABLED
-
 		ERR_FAIL_COND_V(!p_rid.is_valid(), NULL);
-		ERR_FAIL_COND_V(!id_map.has(p_rid.get_data()), NULL);
-#endif
-		return static_cast<T *>(p_rid.get_data());
+		T *data = _get(p_rid);
+		ERR_FAIL_COND_V(!data, NULL);
+
+		return data;
 	}
 
 	_FORCE_INLINE_ T *getornull(const RID &p_rid) {
 
-#ifdef DEBUG_ENABLED
+		if (!p_rid.is_valid())
+			return NULL;
 
-		if (p_rid.get_data()) {
-			ERR_FAIL_COND_V(!id_map.has(p_rid.get_data()), NULL);
-		}
-#endif
-		return static_cast<T *>(p_rid.get_data());
+		T *data = _get(p_rid);
+		ERR_FAIL_COND_V(!data, NULL);
+
+		return data;
 	}
 
 	_FORCE_INLINE_ T *getptr(const RID &p_rid) {
 
-		return static_cast<T *>(p_rid.get_data());
+		return _get(p_rid);
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
 
-		if (p_rid.get_data() == NULL)
-			return false;
-#ifdef DEBUG_ENABLED
-		return id_map.has(p_rid.get_data());
-#else
-		return _is_owner(p_rid);
-#endif
+		return _get_slot(p_rid) != NULL;
 	}
 
 	void free(RID p_rid) {
 
-#ifdef DEBUG_ENABLED
-		id_map.erase(p_rid.get_data());
-#else
-		_remove_owner(p_rid);
-#endif
+		MutexLock lock(alloc_mutex);
+
+		Slot *slot = _get_slot(p_rid);
+		if (!slot)
+			return;
+
+		// Release, so a lookup reading the cleared data also sees the cleared validator.
+		slot->validator = 0;
+		atomic_store_release(&slot->data, (T *)NULL);
+
+		uint32_t index = p_rid.get_id() & 0xFFFFFFFF;
+		slot->next_free = free_head;
+		free_head = index + 1;
+		owned_count--;
+	}
+
+	_FORCE_INLINE_ uint32_t get_owned_count() const {
+
+		return owned_count;
+	}
+
+	// Slots below this count may be free, get_by_slot() returns NULL for them.
+	// RIDs made or freed while iterating may or may not be visited.
+	_FORCE_INLINE_ uint32_t get_slot_count() const {
+
+		return atomic_load_acquire(&slot_count);
+	}
+
+	_FORCE_INLINE_ T *get_by_slot(uint32_t p_slot, RID *r_rid = NULL) const {
+
+		ERR_FAIL_COND_V(p_slot >= atomic_load_acquire(&slot_count), NULL);
+
+		// Same ordering as lookups by RID.
+		const Slot &slot = chunks[p_slot >> CHUNK_BITS][p_slot & CHUNK_MASK];
+		uint32_t validator = atomic_load_acquire(&slot.validator);
+		if (!validator)
+			return NULL;
+
+		T *data = atomic_load_acquire(&slot.data);
+		if (slot.validator != validator)
+			return NULL;
+
+		if (r_rid) {
+			_set_id(*r_rid, ((uint64_t)validator << 32) | p_slot);
+		}
+		return data;
 	}
 
 	void get_owned_list(List<RID> *p_owned) {
 
-#ifdef DEBUG_ENABLED
+		MutexLock lock(alloc_mutex);
+
+		for (uint32_t i = 0; i < slot_count; i++) {
 
-		for (typename Set<RID_Data *>::Element *E = id_map.front(); E; E = E->next()) {
-			RID r;
-			_set_data(r, static_cast<T *>(E->get()));
-			p_owned->push_back(r);
+			const Slot &slot = chunks[i >> CHUNK_BITS][i & CHUNK_MASK];
+			if (slot.validator) {
+				RID r;
+				_set_id(r, ((uint64_t)slot.validator << 32) | i);
+				p_owned->push_back(r);
+			}
+		}
+	}
+
+	RID_Owner() {
+
+		chunks = NULL;
+		chunk_count = 0;
+		chunk_max = 0;
+		slot_count = 0;
+		free_head = 0;
+		owned_count = 0;
+		alloc_mutex = Mutex::create();
+	}
+
+	~RID_Owner() {
+
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			memfree(chunks[i]);
+		}
+		if (chunks) {
+			memfree(chunks);
+		}
+		for (int i = 0; i < retired_chunk_tables.size(); i++) {
+			memfree(retired_chunk_tables[i]);
+		}
+
+		if (alloc_mutex) {
+			memdelete(alloc_mutex);
 		}
-#endif
 	}
 };
 
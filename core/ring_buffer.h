@@ -129,6 +129,13 @@ public:
 		return -1;
 	}
 
+	// Returns a pointer to the next p_size elements, or NULL if they wrap around the end of the buffer.
+	inline const T *contiguous_read_ptr(int p_size) const {
+		if (p_size > data_left() || read_pos + p_size > size())
+			return NULL;
+		return data.ptr() + read_pos;
+	};
+
 	inline int advance_read(int p_n) {
 		p_n = MIN(p_n, data_left());
 		inc(read_pos, p_n);
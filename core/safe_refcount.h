@@ -93,6 +93,21 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	return *pw;
 }
 
+static _ALWAYS_INLINE_ void atomic_memory_barrier() {
+}
+
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+
+	return *pw;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(volatile T *pw, V val) {
+
+	*pw = val;
+}
+
 #elif defined(__GNUC__)
 
 /* Implementation for GCC & Clang */
@@ -148,6 +163,26 @@ static _ALWAYS_INLINE_ T atomic_exchange_if_greater(volatile T *pw, volatile V v
 	}
 }
 
+static _ALWAYS_INLINE_ void atomic_memory_barrier() {
+
+	__sync_synchronize();
+}
+
+// Loads after an acquire load can't be moved before it, and stores before a
+// release store can't be moved after it. Unlike a full barrier, these compile
+// to plain moves on x86.
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+
+	return __atomic_load_n(pw, __ATOMIC_ACQUIRE);
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(volatile T *pw, V val) {
+
+	__atomic_store_n(pw, (T)val, __ATOMIC_RELEASE);
+}
+
 #elif defined(_MSC_VER)
 // For MSVC use a separate compilation unit to prevent windows.h from polluting
 // the global namespace.
@@ -165,6 +200,29 @@ uint64_t atomic_sub(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_add(volatile uint64_t *pw, volatile uint64_t val);
 uint64_t atomic_exchange_if_greater(volatile uint64_t *pw, volatile uint64_t val);
 
+void atomic_memory_barrier();
+
+// Volatile accesses already have acquire and release semantics on x86 and x64
+// (/volatile:ms, the default there), other architectures need the barrier.
+template <class T>
+static _ALWAYS_INLINE_ T atomic_load_acquire(volatile T *pw) {
+
+	T val = *pw;
+#if !defined(_M_IX86) && !defined(_M_X64)
+	atomic_memory_barrier();
+#endif
+	return val;
+}
+
+template <class T, class V>
+static _ALWAYS_INLINE_ void atomic_store_release(volatile T *pw, V val) {
+
+#if !defined(_M_IX86) && !defined(_M_X64)
+	atomic_memory_barrier();
+#endif
+	*pw = val;
+}
+
 #else
 //no threads supported?
 #error Must provide atomic functions for this platform or compiler!
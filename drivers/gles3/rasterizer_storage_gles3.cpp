@@ -5055,6 +5055,32 @@ void RasterizerStorageGLES3::skeleton_bone_set_transform(RID p_skeleton, int p_b
 	}
 }
 
+void RasterizerStorageGLES3::skeleton_set_as_bulk_array(RID p_skeleton, const PoolVector<float> &p_array) {
+
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+
+	ERR_FAIL_COND(!skeleton);
+	ERR_FAIL_COND(skeleton->use_2d);
+	ERR_FAIL_COND(p_array.size() != skeleton->size * 4 * 3);
+
+	float *texture = skeleton->skel_texture.ptrw();
+	PoolVector<float>::Read r = p_array.read();
+	const float *src = r.ptr();
+
+	for (int i = 0; i < skeleton->size; i++) {
+
+		// each row of the bone transform goes to its own row of the texture
+		int base_ofs = ((i / 256) * 256) * 3 * 4 + (i % 256) * 4;
+		for (int j = 0; j < 3; j++) {
+			copymem(&texture[base_ofs + j * 256 * 4], &src[i * 12 + j * 4], 4 * sizeof(float));
+		}
+	}
+
+	if (!skeleton->update_list.in_list()) {
+		skeleton_update_list.add(&skeleton->update_list);
+	}
+}
+
 Transform RasterizerStorageGLES3::skeleton_bone_get_transform(RID p_skeleton, int p_bone) const {
 
 	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
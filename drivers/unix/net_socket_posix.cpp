@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "net_socket_posix.h"
+#include "core/os/os.h"
 
 #if defined(UNIX_ENABLED)
 
@@ -156,6 +157,7 @@ void NetSocketPosix::make_default() {
 	}
 #endif
 	_create = _create_func;
+	NetSocketSetPosix::make_default();
 }
 
 void NetSocketPosix::cleanup() {
@@ -614,3 +616,260 @@ Ref<NetSocket> NetSocketPosix::accept(IP_Address &r_ip, uint16_t &r_port) {
 	ns->set_blocking_enabled(false);
 	return Ref<NetSocket>(ns);
 }
+
+NetSocketSet *NetSocketSetPosix::_create_func() {
+	return memnew(NetSocketSetPosix);
+}
+
+void NetSocketSetPosix::make_default(bool p_force_poll) {
+#ifdef NET_SOCKET_SET_EPOLL
+	if (!p_force_poll) {
+		_create = NetSocketSetEpoll::_create_func;
+		return;
+	}
+#endif
+	_create = _create_func;
+}
+
+static short _get_poll_events(NetSocket::PollType p_type) {
+
+	switch (p_type) {
+		case NetSocket::POLL_TYPE_IN:
+			return POLLIN;
+		case NetSocket::POLL_TYPE_OUT:
+			return POLLOUT;
+		default:
+			return POLLIN | POLLOUT;
+	}
+}
+
+Error NetSocketSetPosix::add(const Ref<NetSocket> &p_socket, NetSocket::PollType p_type, int p_id) {
+
+	ERR_FAIL_COND_V(p_socket.is_null() || !p_socket->is_open(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(id_map.has(p_id), ERR_ALREADY_EXISTS);
+
+	SOCKET_TYPE sock = static_cast<const NetSocketPosix *>(p_socket.ptr())->_sock;
+
+	PollFD pfd;
+	pfd.fd = sock;
+	pfd.events = _get_poll_events(p_type);
+	pfd.revents = 0;
+
+	index_map[p_id] = fds.size();
+	fds.push_back(pfd);
+	fd_ids.push_back(p_id);
+	id_map[p_id] = sock;
+	return OK;
+}
+
+Error NetSocketSetPosix::modify(int p_id, NetSocket::PollType p_type) {
+
+	const int *index = index_map.getptr(p_id);
+	ERR_FAIL_COND_V(!index, ERR_DOES_NOT_EXIST);
+
+	fds.write[*index].events = _get_poll_events(p_type);
+	return OK;
+}
+
+void NetSocketSetPosix::remove(int p_id) {
+
+	const int *index_ptr = index_map.getptr(p_id);
+	if (!index_ptr)
+		return;
+
+	// Swap with the last one to keep the array packed.
+	int index = *index_ptr;
+	int last = fds.size() - 1;
+	if (index != last) {
+		fds.write[index] = fds[last];
+		fd_ids.write[index] = fd_ids[last];
+		index_map[fd_ids[index]] = index;
+	}
+	fds.resize(last);
+	fd_ids.resize(last);
+
+	index_map.erase(p_id);
+	id_map.erase(p_id);
+}
+
+Error NetSocketSetPosix::wait(int p_timeout, Vector<Event> &r_events) {
+
+	r_events.clear();
+	if (fds.empty()) {
+		if (p_timeout > 0) {
+			OS::get_singleton()->delay_usec(p_timeout * 1000);
+		}
+		return OK;
+	}
+
+#if defined(WINDOWS_ENABLED)
+	int ret = WSAPoll(fds.ptrw(), fds.size(), p_timeout);
+	ERR_FAIL_COND_V(ret == SOCKET_ERROR, FAILED);
+#else
+	int ret = ::poll(fds.ptrw(), fds.size(), p_timeout);
+	if (ret < 0) {
+		ERR_FAIL_COND_V(errno != EINTR, FAILED);
+		return OK; // Interrupted, same as a timeout.
+	}
+#endif
+
+	for (int i = 0; i < fds.size() && r_events.size() < ret; i++) {
+
+		short revents = fds[i].revents;
+		if (!revents)
+			continue;
+
+		Event ev;
+		ev.id = fd_ids[i];
+		ev.readable = revents & POLLIN;
+		ev.writable = revents & POLLOUT;
+		ev.error = revents & (POLLERR | POLLHUP | POLLNVAL);
+		r_events.push_back(ev);
+	}
+
+	return OK;
+}
+
+bool NetSocketSetPosix::has(int p_id) const {
+
+	return id_map.has(p_id);
+}
+
+int NetSocketSetPosix::get_count() const {
+
+	return id_map.size();
+}
+
+#ifdef NET_SOCKET_SET_EPOLL
+
+NetSocketSet *NetSocketSetEpoll::_create_func() {
+	return memnew(NetSocketSetEpoll);
+}
+
+static uint32_t _get_epoll_events(NetSocket::PollType p_type) {
+
+	switch (p_type) {
+		case NetSocket::POLL_TYPE_IN:
+			return EPOLLIN;
+		case NetSocket::POLL_TYPE_OUT:
+			return EPOLLOUT;
+		default:
+			return EPOLLIN | EPOLLOUT;
+	}
+}
+
+Error NetSocketSetEpoll::add(const Ref<NetSocket> &p_socket, NetSocket::PollType p_type, int p_id) {
+
+	ERR_FAIL_COND_V(epoll_fd < 0, ERR_UNCONFIGURED);
+	ERR_FAIL_COND_V(p_socket.is_null() || !p_socket->is_open(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(id_map.has(p_id), ERR_ALREADY_EXISTS);
+
+	SOCKET_TYPE sock = static_cast<const NetSocketPosix *>(p_socket.ptr())->_sock;
+
+	struct epoll_event ev;
+	ev.events = _get_epoll_events(p_type);
+	ev.data.u64 = p_id;
+
+	int op = EPOLL_CTL_ADD;
+	const int *stale = fd_map.getptr(sock);
+	if (stale) {
+		// Registered under an ID whose socket was closed without being removed, and the socket was reused.
+		id_map.erase(*stale);
+		op = EPOLL_CTL_MOD;
+	}
+
+	if (epoll_ctl(epoll_fd, op, sock, &ev) != 0) {
+		if (op != EPOLL_CTL_ADD || errno != EEXIST || epoll_ctl(epoll_fd, EPOLL_CTL_MOD, sock, &ev) != 0) {
+			fd_map.erase(sock);
+			ERR_FAIL_V(FAILED);
+		}
+	}
+
+	id_map[p_id] = sock;
+	fd_map[sock] = p_id;
+	return OK;
+}
+
+Error NetSocketSetEpoll::modify(int p_id, NetSocket::PollType p_type) {
+
+	const SOCKET_TYPE *sock = id_map.getptr(p_id);
+	ERR_FAIL_COND_V(!sock, ERR_DOES_NOT_EXIST);
+
+	struct epoll_event ev;
+	ev.events = _get_epoll_events(p_type);
+	ev.data.u64 = p_id;
+
+	return epoll_ctl(epoll_fd, EPOLL_CTL_MOD, *sock, &ev) == 0 ? OK : FAILED;
+}
+
+void NetSocketSetEpoll::remove(int p_id) {
+
+	const SOCKET_TYPE *sock = id_map.getptr(p_id);
+	if (!sock)
+		return;
+
+	const int *owner = fd_map.getptr(*sock);
+	if (owner && *owner == p_id) {
+		// Fails if the socket was closed already, which also unregistered it.
+		struct epoll_event ev;
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, *sock, &ev);
+		fd_map.erase(*sock);
+	}
+	id_map.erase(p_id);
+}
+
+Error NetSocketSetEpoll::wait(int p_timeout, Vector<Event> &r_events) {
+
+	r_events.clear();
+	ERR_FAIL_COND_V(epoll_fd < 0, ERR_UNCONFIGURED);
+
+	// Level triggered, so sockets that don't fit are reported on the next call.
+	int max_events = CLAMP(id_map.size(), 1, 1024);
+	if (events.size() < max_events) {
+		events.resize(max_events);
+	}
+
+	int ret = epoll_wait(epoll_fd, events.ptrw(), max_events, p_timeout);
+	if (ret < 0) {
+		ERR_FAIL_COND_V(errno != EINTR, FAILED);
+		return OK; // Interrupted, same as a timeout.
+	}
+
+	r_events.resize(ret);
+	Event *w = r_events.ptrw();
+	for (int i = 0; i < ret; i++) {
+		w[i].id = events[i].data.u64;
+		w[i].readable = events[i].events & EPOLLIN;
+		w[i].writable = events[i].events & EPOLLOUT;
+		w[i].error = events[i].events & (EPOLLERR | EPOLLHUP);
+	}
+
+	return OK;
+}
+
+NetSocketSetEpoll::NetSocketSetEpoll() {
+
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd < 0) {
+		ERR_PRINT("Unable to create epoll instance.");
+	}
+}
+
+NetSocketSetEpoll::~NetSocketSetEpoll() {
+
+	if (epoll_fd >= 0) {
+		::close(epoll_fd);
+	}
+}
+
+bool NetSocketSetEpoll::has(int p_id) const {
+
+	return id_map.has(p_id);
+}
+
+int NetSocketSetEpoll::get_count() const {
+
+	return id_map.size();
+}
+
+#endif
@@ -31,6 +31,7 @@
 #ifndef NET_SOCKET_UNIX_H
 #define NET_SOCKET_UNIX_H
 
+#include "core/hash_map.h"
 #include "core/io/net_socket.h"
 
 #if defined(WINDOWS_ENABLED)
@@ -39,13 +40,22 @@
 #define SOCKET_TYPE SOCKET
 
 #else
+#include <poll.h>
 #include <sys/socket.h>
 #define SOCKET_TYPE int
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#define NET_SOCKET_SET_EPOLL
+#endif
+
 #endif
 
 class NetSocketPosix : public NetSocket {
 
+	friend class NetSocketSetPosix;
+	friend class NetSocketSetEpoll;
+
 private:
 	SOCKET_TYPE _sock;
 	IP::Type _ip_type;
@@ -98,4 +108,61 @@ public:
 	~NetSocketPosix();
 };
 
+// Waits with poll(), or WSAPoll() on Windows.
+class NetSocketSetPosix : public NetSocketSet {
+
+private:
+#if defined(WINDOWS_ENABLED)
+	typedef WSAPOLLFD PollFD;
+#else
+	typedef struct pollfd PollFD;
+#endif
+
+	HashMap<int, SOCKET_TYPE> id_map;
+	Vector<PollFD> fds;
+	Vector<int> fd_ids;
+	HashMap<int, int> index_map; // ID to index in fds.
+
+protected:
+	static NetSocketSet *_create_func();
+
+public:
+	// Sets use epoll where available, unless p_force_poll is set to test the fallback.
+	static void make_default(bool p_force_poll = false);
+
+	virtual Error add(const Ref<NetSocket> &p_socket, NetSocket::PollType p_type, int p_id);
+	virtual Error modify(int p_id, NetSocket::PollType p_type);
+	virtual void remove(int p_id);
+	virtual bool has(int p_id) const;
+	virtual int get_count() const;
+	virtual Error wait(int p_timeout, Vector<Event> &r_events);
+};
+
+#ifdef NET_SOCKET_SET_EPOLL
+class NetSocketSetEpoll : public NetSocketSet {
+
+	friend class NetSocketSetPosix;
+
+private:
+	HashMap<int, SOCKET_TYPE> id_map;
+	int epoll_fd;
+	HashMap<int, int> fd_map; // Socket to ID, to tell stale registrations apart.
+	Vector<struct epoll_event> events;
+
+protected:
+	static NetSocketSet *_create_func();
+
+public:
+	virtual Error add(const Ref<NetSocket> &p_socket, NetSocket::PollType p_type, int p_id);
+	virtual Error modify(int p_id, NetSocket::PollType p_type);
+	virtual void remove(int p_id);
+	virtual bool has(int p_id) const;
+	virtual int get_count() const;
+	virtual Error wait(int p_timeout, Vector<Event> &r_events);
+
+	NetSocketSetEpoll();
+	~NetSocketSetEpoll();
+};
+#endif
+
 #endif
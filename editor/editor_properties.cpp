@@ -1964,8 +1964,7 @@ EditorPropertyNodePath::EditorPropertyNodePath() {
 void EditorPropertyRID::update_property() {
 	RID rid = get_edited_object()->get(get_edited_property());
 	if (rid.is_valid()) {
-		int id = rid.get_id();
-		label->set_text("RID: " + itos(id));
+		label->set_text("RID: " + itos(rid.get_id()));
 	} else {
 		label->set_text(TTR("Invalid RID"));
 	}
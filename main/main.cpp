@@ -42,6 +42,7 @@
 #include "core/message_queue.h"
 #include "core/os/dir_access.h"
 #include "core/os/os.h"
+#include "core/path_request_queue.h"
 #include "core/project_settings.h"
 #include "core/register_core_types.h"
 #include "core/script_debugger_local.h"
@@ -95,6 +96,7 @@ static ZipArchive *zip_packed_data = NULL;
 static FileAccessNetworkClient *file_access_network_client = NULL;
 static ScriptDebugger *script_debugger = NULL;
 static MessageQueue *message_queue = NULL;
+static PathRequestQueue *path_request_queue = NULL;
 
 // Initialized in setup2()
 static AudioServer *audio_server = NULL;
@@ -1033,6 +1035,7 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	Engine::get_singleton()->set_frame_delay(frame_delay);
 
 	message_queue = memnew(MessageQueue);
+	path_request_queue = memnew(PathRequestQueue);
 
 	if (p_second_phase)
 		return setup2();
@@ -1882,6 +1885,7 @@ bool Main::iteration() {
 
 	uint64_t idle_begin = OS::get_singleton()->get_ticks_usec();
 
+	path_request_queue->process();
 	OS::get_singleton()->get_main_loop()->idle(step * time_scale);
 	message_queue->flush();
 
@@ -1995,6 +1999,7 @@ void Main::cleanup() {
 
 	message_queue->flush();
 	memdelete(message_queue);
+	memdelete(path_request_queue);
 
 	if (script_debugger) {
 		if (use_debug_profiler) {
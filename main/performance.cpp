@@ -32,6 +32,8 @@
 
 #include "core/message_queue.h"
 #include "core/os/os.h"
+#include "core/path_request_queue.h"
+#include "scene/animation/animation_lod.h"
 #include "scene/main/scene_tree.h"
 #include "servers/audio_server.h"
 #include "servers/physics_2d_server.h"
@@ -72,6 +74,12 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_REQUESTS_QUEUED);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_REQUESTS_COMPLETED);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_REQUEST_TIME);
+	BIND_ENUM_CONSTANT(ANIMATION_EVALUATED);
+	BIND_ENUM_CONSTANT(ANIMATION_REDUCED);
+	BIND_ENUM_CONSTANT(ANIMATION_SKIPPED);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -109,6 +117,12 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"navigation/path_requests_queued",
+		"navigation/path_requests_completed",
+		"navigation/path_request_time",
+		"animation/evaluated",
+		"animation/reduced",
+		"animation/skipped",
 
 	};
 
@@ -153,6 +167,12 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case PHYSICS_3D_COLLISION_PAIRS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_COLLISION_PAIRS);
 		case PHYSICS_3D_ISLAND_COUNT: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY: return AudioServer::get_singleton()->get_output_latency();
+		case NAVIGATION_PATH_REQUESTS_QUEUED: return PathRequestQueue::get_singleton() ? PathRequestQueue::get_singleton()->get_queued_count() : 0;
+		case NAVIGATION_PATH_REQUESTS_COMPLETED: return PathRequestQueue::get_singleton() ? PathRequestQueue::get_singleton()->get_completed_in_frame() : 0;
+		case NAVIGATION_PATH_REQUEST_TIME: return PathRequestQueue::get_singleton() ? PathRequestQueue::get_singleton()->get_solve_time_in_frame() : 0;
+		case ANIMATION_EVALUATED: return AnimationLOD::get_evaluated_count();
+		case ANIMATION_REDUCED: return AnimationLOD::get_reduced_count();
+		case ANIMATION_SKIPPED: return AnimationLOD::get_skipped_count();
 
 		default: {}
 	}
@@ -193,6 +213,12 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
@@ -78,6 +78,12 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		NAVIGATION_PATH_REQUESTS_QUEUED,
+		NAVIGATION_PATH_REQUESTS_COMPLETED,
+		NAVIGATION_PATH_REQUEST_TIME,
+		ANIMATION_EVALUATED,
+		ANIMATION_REDUCED,
+		ANIMATION_SKIPPED,
 		MONITOR_MAX
 	};
 
@@ -0,0 +1,139 @@
+/*************************************************************************/
+/*  test_animation.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_animation.h"
+
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+#include "scene/resources/animation.h"
+
+namespace TestAnimation {
+
+const float LINEAR_ERR = 0.001;
+const float ANGULAR_ERR = 0.001;
+const float EPSILON = 0.00001; // Float rounding when comparing.
+
+// A bone moving along a curve with straight parts, turning, and keeping its scale.
+static Ref<Animation> make_animation() {
+
+	Ref<Animation> anim;
+	anim.instance();
+	anim->set_length(2);
+
+	int track = anim->add_track(Animation::TYPE_TRANSFORM);
+	anim->track_set_path(track, NodePath("Skeleton:bone"));
+	anim->track_set_interpolation_type(track, Animation::INTERPOLATION_LINEAR);
+
+	for (int i = 0; i <= 200; i++) {
+		float t = i / 100.0;
+		Vector3 loc = t < 1 ? Vector3(t * 3, 0, 0) : Vector3(3, Math::sin((t - 1) * Math_PI) * 2, t);
+		Quat rot(Vector3(0, 1, 0), t * Math_PI * 0.75);
+		anim->transform_track_insert_key(track, t, loc, rot, Vector3(1, 1, 1));
+	}
+
+	return anim;
+}
+
+static bool compare_keys(const PoolVector<real_t> &p_a, const PoolVector<real_t> &p_b, float p_epsilon) {
+
+	if (p_a.size() != p_b.size() || p_a.size() == 0)
+		return false;
+
+	PoolVector<real_t>::Read a = p_a.read();
+	PoolVector<real_t>::Read b = p_b.read();
+	for (int i = 0; i < p_a.size(); i++) {
+		if (Math::abs(a[i] - b[i]) > p_epsilon)
+			return false;
+	}
+	return true;
+}
+
+static bool test_error() {
+
+	Ref<Animation> original = make_animation();
+	Ref<Animation> anim = make_animation();
+	anim->transform_track_compress(0, LINEAR_ERR, ANGULAR_ERR);
+
+	int keys = anim->track_get_key_count(0);
+	bool ok = anim->transform_track_is_compressed(0) && keys < original->track_get_key_count(0);
+
+	float max_linear = 0;
+	float max_angular = 0;
+	for (int i = 0; i < original->track_get_key_count(0); i++) {
+
+		float t = original->track_get_key_time(0, i);
+		Vector3 loc[2], scale[2];
+		Quat rot[2];
+		original->transform_track_interpolate(0, t, &loc[0], &rot[0], &scale[0]);
+		anim->transform_track_interpolate(0, t, &loc[1], &rot[1], &scale[1]);
+
+		max_linear = MAX(max_linear, MAX(loc[0].distance_to(loc[1]), scale[0].distance_to(scale[1])));
+		max_angular = MAX(max_angular, Math::acos(MIN(Math::abs(rot[0].dot(rot[1])), (real_t)1.0)) * 2);
+	}
+	ok = ok && max_linear <= LINEAR_ERR + EPSILON && max_angular <= ANGULAR_ERR + EPSILON;
+
+	OS::get_singleton()->print("Compressed %i keys to %i, largest error %f (allowed %f), %f rad (allowed %f): %s\n", original->track_get_key_count(0), keys, max_linear, LINEAR_ERR, max_angular, ANGULAR_ERR, ok ? "passed" : "failed");
+	return ok;
+}
+
+// Text files store reals with fewer digits, binary ones keep them exactly.
+static bool test_save_load(const String &p_extension, float p_epsilon) {
+
+	Ref<Animation> anim = make_animation();
+	anim->transform_track_compress(0, LINEAR_ERR, ANGULAR_ERR);
+	PoolVector<real_t> keys = anim->get("tracks/0/keys");
+
+	String path = OS::get_singleton()->get_user_data_dir().plus_file("test_animation." + p_extension);
+	bool ok = ResourceSaver::save(path, anim) == OK;
+
+	Ref<Animation> loaded = ResourceLoader::load(path, "", true);
+	ok = ok && loaded.is_valid() && loaded->transform_track_is_compressed(0);
+	ok = ok && compare_keys(keys, loaded->get("tracks/0/keys"), p_epsilon);
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(path);
+	memdelete(da);
+
+	OS::get_singleton()->print("Compressed keys survive saving to .%s: %s\n", p_extension.utf8().get_data(), ok ? "passed" : "failed");
+	return ok;
+}
+
+MainLoop *test() {
+
+	bool ok = test_error();
+	ok = test_save_load("res", 0) && ok;
+	ok = test_save_load("tres", 0.0001) && ok;
+
+	OS::get_singleton()->print("Animation compression: %s\n", ok ? "passed" : "failed");
+	return NULL;
+}
+} // namespace TestAnimation
@@ -31,7 +31,11 @@
 #include "test_astar.h"
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
+#include "core/math/math_funcs.h"
 #include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/path_request_queue.h"
 
 #include <stdio.h>
 
@@ -87,11 +91,439 @@ bool test_abcx() {
 	return ok;
 }
 
+// Builds on the default cost, once with the points asked for and once with other ones.
+class Detour : public AStar {
+public:
+	enum { A,
+		B,
+		C };
+
+	Detour() {
+		add_point(A, Vector3(0, 0, 0));
+		add_point(B, Vector3(1, 0, 0));
+		add_point(C, Vector3(0.5, 0.1, 0));
+		connect_points(A, B);
+		connect_points(A, C);
+		connect_points(C, B);
+	}
+
+	float _compute_cost(int p_from, int p_to) {
+		if (p_from == A && p_to == B) {
+			return AStar::_compute_cost(p_from, p_to) * 10;
+		}
+		return AStar::_compute_cost(p_to, p_from);
+	}
+};
+
+bool test_cost_override() {
+	Detour detour;
+	PoolVector<int> path = detour.get_id_path(Detour::A, Detour::B);
+	bool ok = path.size() == 3 && path[1] == Detour::C;
+	path = detour.get_id_path(Detour::B, Detour::A);
+	ok = ok && path.size() == 2;
+	return ok;
+}
+
+bool test_remove_connect() {
+	AStar a;
+	a.add_point(1, Vector3(0, 0, 0));
+	a.add_point(2, Vector3(1, 0, 0));
+	a.add_point(3, Vector3(2, 0, 0));
+	a.connect_points(1, 2, false);
+	a.connect_points(2, 3);
+
+	bool ok = a.get_id_path(1, 3).size() == 3;
+	ok = ok && a.get_id_path(3, 1).size() == 0; // One-way.
+	ok = ok && a.are_points_connected(2, 1);
+
+	a.remove_point(2);
+	ok = ok && !a.are_points_connected(1, 2) && !a.are_points_connected(2, 3);
+	ok = ok && a.get_point_connections(1).size() == 0;
+	ok = ok && a.get_point_connections(3).size() == 0;
+	ok = ok && a.get_available_point_id() == 4;
+
+	// The freed slot is reused by the new point.
+	a.add_point(7, Vector3(1, 1, 0));
+	a.connect_points(1, 7);
+	a.connect_points(7, 3);
+	PoolVector<int> path = a.get_id_path(3, 1);
+	ok = ok && path.size() == 3 && path[1] == 7;
+	ok = ok && a.get_points().size() == 3 && (int)a.get_points()[2] == 7;
+
+	a.remove_point(7);
+	ok = ok && a.get_available_point_id() == 4;
+	return ok;
+}
+
+static real_t _get_path_cost(const PoolVector<Vector3> &p_path) {
+	real_t cost = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		cost += p_path[i].distance_to(p_path[i - 1]);
+	}
+	return cost;
+}
+
+static real_t _get_path_cost(const PoolVector<Vector2> &p_path) {
+	real_t cost = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		cost += p_path[i].distance_to(p_path[i - 1]);
+	}
+	return cost;
+}
+
+// Fills a grid, and a graph with the same 8-way connections, with random obstacles.
+static void _make_grid(AStarGrid2D &r_grid, AStar &r_graph, int p_size, int p_density) {
+	r_grid.set_size(Vector2(p_size, p_size));
+	r_graph.clear();
+
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			bool solid = Math::rand() % 100 < (uint32_t)p_density;
+			r_grid.set_point_solid(Vector2(x, y), solid);
+			if (!solid) {
+				r_graph.add_point(y * p_size + x, Vector3(x, y, 0));
+			}
+		}
+	}
+
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			int id = y * p_size + x;
+			if (!r_graph.has_point(id))
+				continue;
+			bool right = x + 1 < p_size && r_graph.has_point(id + 1);
+			bool down = y + 1 < p_size && r_graph.has_point(id + p_size);
+			if (right)
+				r_graph.connect_points(id, id + 1);
+			if (down)
+				r_graph.connect_points(id, id + p_size);
+			if (right && down && r_graph.has_point(id + p_size + 1))
+				r_graph.connect_points(id, id + p_size + 1);
+			bool left = x > 0 && r_graph.has_point(id - 1);
+			if (left && down && r_graph.has_point(id + p_size - 1))
+				r_graph.connect_points(id, id + p_size - 1);
+		}
+	}
+}
+
+bool test_grid() {
+	Math::seed(7);
+
+	const int size = 32;
+	AStarGrid2D grid;
+	AStar graph;
+	bool ok = true;
+
+	for (int i = 0; i < 20 && ok; i++) {
+		_make_grid(grid, graph, size, i * 2);
+
+		for (int j = 0; j < 20 && ok; j++) {
+			Vector2 from(Math::rand() % size, Math::rand() % size);
+			Vector2 to(Math::rand() % size, Math::rand() % size);
+			if (grid.is_point_solid(from) || grid.is_point_solid(to))
+				continue;
+
+			PoolVector<Vector3> expected = graph.get_point_path(from.y * size + from.x, to.y * size + to.x);
+
+			grid.set_jumping_enabled(true);
+			PoolVector<Vector2> jumped = grid.get_id_path(from, to);
+			grid.set_jumping_enabled(false);
+			PoolVector<Vector2> walked = grid.get_id_path(from, to);
+
+			ok = ok && (jumped.size() > 0) == (expected.size() > 0);
+			ok = ok && (walked.size() > 0) == (expected.size() > 0);
+			if (ok && expected.size()) {
+				real_t cost = _get_path_cost(expected);
+				ok = ok && Math::is_equal_approx(_get_path_cost(jumped), cost, (real_t)0.001);
+				ok = ok && Math::is_equal_approx(_get_path_cost(walked), cost, (real_t)0.001);
+				ok = ok && jumped[0] == from && jumped[jumped.size() - 1] == to;
+			}
+		}
+	}
+
+	return ok;
+}
+
+bool test_flow_field() {
+	Math::seed(17);
+
+	const int size = 16;
+	AStarGrid2D grid;
+	Ref<AStar> graph;
+	graph.instance();
+	_make_grid(grid, *graph.ptr(), size, 15);
+
+	Array points = graph->get_points();
+	int goal = points[Math::rand() % points.size()];
+	Ref<AStarFlowField> field = graph->create_flow_field(goal);
+	if (graph->reference_get_count() != 1) {
+		OS::get_singleton()->print("	The flow field references its AStar.\n");
+		return false;
+	}
+
+	// Every round disables or enables a few points, which the field repairs incrementally.
+	bool ok = true;
+	for (int round = 0; round < 8 && ok; round++) {
+
+		for (int i = 0; i < 6; i++) {
+			int id = points[Math::rand() % points.size()];
+			if (id != goal) {
+				graph->set_point_disabled(id, !graph->is_point_disabled(id));
+			}
+		}
+
+		for (int i = 0; i < points.size(); i++) {
+
+			int id = points[i];
+			if (graph->is_point_disabled(id) || id == goal)
+				continue;
+
+			PoolVector<Vector3> path = graph->get_point_path(id, goal);
+			bool reachable = field->is_point_reachable(id);
+			if (reachable != (path.size() > 0) || (reachable && Math::abs(field->get_point_cost(id) - _get_path_cost(path)) > 0.001)) {
+				OS::get_singleton()->print("\tFlow field from %i to %i differs in round %i.\n", id, goal, round);
+				ok = false;
+				break;
+			}
+
+			int next = field->get_next_point(id);
+			if (reachable && (next < 0 || graph->is_point_disabled(next) || !graph->are_points_connected(id, next))) {
+				OS::get_singleton()->print("\tFlow field from %i leads to %i.\n", id, next);
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	return ok;
+}
+
+struct ThreadedQueries {
+	AStar *graph;
+	AStarGrid2D *grid;
+	int size;
+	int offset;
+	bool ok;
+};
+
+static void _run_queries(void *p_userdata) {
+	ThreadedQueries *q = (ThreadedQueries *)p_userdata;
+	q->ok = true;
+
+	// Every thread asks for the same paths, from different starting points.
+	for (int i = 0; i < q->size * q->size; i++) {
+		int from = (i + q->offset) % (q->size * q->size);
+		int to = q->size * q->size - 1 - from;
+		PoolVector<Vector3> path = q->graph->get_point_path(from, to);
+		PoolVector<Vector2> grid_path = q->grid->get_id_path(Vector2(from % q->size, from / q->size), Vector2(to % q->size, to / q->size));
+		if (!Math::is_equal_approx(_get_path_cost(path), _get_path_cost(grid_path), (real_t)0.001)) {
+			q->ok = false;
+		}
+	}
+}
+
+bool test_threads() {
+	Math::seed(11);
+
+	const int size = 24;
+	AStarGrid2D grid;
+	AStar graph;
+	_make_grid(grid, graph, size, 0);
+
+	const int thread_count = 4;
+	ThreadedQueries queries[thread_count];
+	Thread *threads[thread_count];
+
+	for (int i = 0; i < thread_count; i++) {
+		queries[i].graph = &graph;
+		queries[i].grid = &grid;
+		queries[i].size = size;
+		queries[i].offset = i * size * size / thread_count;
+		threads[i] = Thread::create(_run_queries, &queries[i]);
+	}
+
+	bool ok = true;
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+		ok = ok && queries[i].ok;
+	}
+
+	return ok;
+}
+
+struct QueuedQuery {
+	int from;
+	int to;
+	PoolVector<int> path;
+	bool delivered;
+	bool thread_safe;
+	Thread::ID solved_on;
+};
+
+class TestPathRequest : public PathRequestQueue::Request {
+
+public:
+	AStar *graph;
+	QueuedQuery *query;
+
+	virtual bool is_thread_safe() const {
+		return query->thread_safe;
+	}
+
+	virtual void solve() {
+		query->path = graph->get_id_path(query->from, query->to);
+		query->solved_on = Thread::get_caller_id();
+	}
+
+	virtual void deliver(Object *p_owner) {
+		query->delivered = true;
+	}
+};
+
+bool test_path_requests() {
+	Math::seed(13);
+
+	PathRequestQueue *queue = PathRequestQueue::get_singleton();
+	if (!queue) {
+		OS::get_singleton()->print("	No path request queue.\n");
+		return false;
+	}
+
+	const int size = 24;
+	AStarGrid2D grid;
+	AStar graph;
+	_make_grid(grid, graph, size, 20);
+
+	Object *owner = memnew(Object);
+
+	const int query_count = 64;
+	QueuedQuery queries[query_count];
+	int ids[query_count];
+	for (int i = 0; i < query_count; i++) {
+		do {
+			queries[i].from = Math::rand() % (size * size);
+		} while (!graph.has_point(queries[i].from));
+		do {
+			queries[i].to = Math::rand() % (size * size);
+		} while (!graph.has_point(queries[i].to));
+		queries[i].delivered = false;
+		queries[i].thread_safe = i % 8 != 0;
+		queries[i].solved_on = 0;
+
+		TestPathRequest *request = memnew(TestPathRequest);
+		request->graph = &graph;
+		request->query = &queries[i];
+		ids[i] = queue->push_request(owner, request);
+	}
+
+	// A cancelled request is never delivered, even if it's already being solved.
+	queue->cancel_request(owner, ids[0]);
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	int delivered = 0;
+	while (delivered < query_count - 1 && OS::get_singleton()->get_ticks_usec() - t < 5000000) {
+		queue->process();
+		delivered = 0;
+		for (int i = 0; i < query_count; i++) {
+			delivered += queries[i].delivered;
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	queue->cancel_requests(owner);
+	memdelete(owner);
+
+	bool ok = delivered == query_count - 1 && !queries[0].delivered;
+	for (int i = 1; i < query_count; i++) {
+		if (!queries[i].thread_safe && queries[i].solved_on != Thread::get_main_id()) {
+			OS::get_singleton()->print("	Queued path %i wasn't solved on the main thread.\n", i);
+			ok = false;
+		}
+		PoolVector<int> path = graph.get_id_path(queries[i].from, queries[i].to);
+		if (path.size() != queries[i].path.size()) {
+			OS::get_singleton()->print("	Queued path %i from %i to %i differs.\n", i, queries[i].from, queries[i].to);
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+bool test_benchmark() {
+	const int size = 1000; // One million points.
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+
+	AStar graph;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			graph.add_point(y * size + x, Vector3(x, y, 0));
+		}
+	}
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			int id = y * size + x;
+			if (x + 1 < size)
+				graph.connect_points(id, id + 1);
+			if (y + 1 < size)
+				graph.connect_points(id, id + size);
+		}
+	}
+	OS::get_singleton()->print("\tAStar: built %i points in %i msec\n", size * size, int((OS::get_singleton()->get_ticks_usec() - t) / 1000));
+
+	t = OS::get_singleton()->get_ticks_usec();
+	PoolVector<int> path = graph.get_id_path(0, size * size - 1);
+	OS::get_singleton()->print("\tAStar: corner to corner in %i msec\n", int((OS::get_singleton()->get_ticks_usec() - t) / 1000));
+	bool ok = path.size() == size * 2 - 1;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	const int queries = 1000;
+	for (int i = 0; i < queries; i++) {
+		int from = Math::rand() % (size * size);
+		int to = CLAMP(from + (int)(Math::rand() % 41) - 20 + ((int)(Math::rand() % 41) - 20) * size, 0, size * size - 1);
+		ok = ok && graph.get_id_path(from, to).size() > 0;
+	}
+	OS::get_singleton()->print("\tAStar: %i short paths in %i msec\n", queries, int((OS::get_singleton()->get_ticks_usec() - t) / 1000));
+
+	// Walls with a single gap, where jumping skips over the open areas.
+	AStarGrid2D grid;
+	grid.set_size(Vector2(size, size));
+	for (int x = 100; x < size; x += 100) {
+		int gap = Math::rand() % size;
+		for (int y = 0; y < size; y++) {
+			if (ABS(y - gap) > 3) {
+				grid.set_point_solid(Vector2(x, y));
+			}
+		}
+	}
+
+	real_t cost[2];
+	for (int i = 0; i < 2; i++) {
+		grid.set_jumping_enabled(i == 1);
+		t = OS::get_singleton()->get_ticks_usec();
+		PoolVector<Vector2> grid_path = grid.get_point_path(Vector2(), Vector2(size - 1, size - 1));
+		OS::get_singleton()->print("\tAStarGrid2D: corner to corner %s in %i msec\n", i ? "jumping" : "walking", int((OS::get_singleton()->get_ticks_usec() - t) / 1000));
+		ok = ok && grid_path.size() > 0;
+		cost[i] = _get_path_cost(grid_path);
+	}
+	ok = ok && Math::is_equal_approx(cost[0], cost[1], (real_t)0.01);
+
+	return ok;
+}
+
 typedef bool (*TestFunc)(void);
 
 TestFunc test_funcs[] = {
 	test_abc,
 	test_abcx,
+	test_cost_override,
+	test_remove_connect,
+	test_grid,
+	test_flow_field,
+	test_threads,
+	test_path_requests,
+	test_benchmark,
 	NULL
 };
 
@@ -0,0 +1,241 @@
+/*************************************************************************/
+/*  test_http_client_pool.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_http_client_pool.h"
+
+#include "core/io/http_client_pool.h"
+#include "core/io/tcp_server.h"
+#include "core/os/os.h"
+
+namespace TestHTTPClientPool {
+
+// Minimal keep-alive HTTP/1.1 server: every response body is the requested path,
+// except for "/large", which returns LARGE_SIZE bytes.
+enum {
+	LARGE_SIZE = 256 * 1024
+};
+
+class LocalServer {
+
+	struct Client {
+		Ref<StreamPeerTCP> peer;
+		String buffer;
+	};
+
+	Ref<TCP_Server> server;
+	List<Client> clients;
+
+	void _respond(Client &p_client, const String &p_path) {
+
+		CharString body;
+		if (p_path == "/large") {
+			body.resize(LARGE_SIZE + 1);
+			for (int i = 0; i < LARGE_SIZE; i++) {
+				body.set(i, 'a' + i % 26);
+			}
+			body.set(LARGE_SIZE, 0);
+		} else {
+			body = p_path.utf8();
+		}
+
+		String header = "HTTP/1.1 200 OK\r\nContent-Length: " + itos(body.length()) + "\r\n\r\n";
+		CharString h = header.utf8();
+		p_client.peer->put_data((const uint8_t *)h.get_data(), h.length());
+		p_client.peer->put_data((const uint8_t *)body.get_data(), body.length());
+		requests++;
+	}
+
+public:
+	int accepted;
+	int requests;
+
+	Error listen(int p_port) {
+
+		server.instance();
+		server->set_watch_connections(true);
+		return server->listen(p_port, IP_Address("127.0.0.1"));
+	}
+
+	void poll() {
+
+		while (server->is_connection_available()) {
+			Client c;
+			c.peer = server->take_connection();
+			c.peer->set_no_delay(true);
+			clients.push_back(c);
+			accepted++;
+		}
+
+		server->poll(0);
+
+		for (List<Client>::Element *E = clients.front(); E; E = E->next()) {
+			Client &c = E->get();
+			int available = c.peer->get_available_bytes();
+			if (available <= 0)
+				continue;
+
+			Vector<uint8_t> data;
+			data.resize(available);
+			c.peer->get_data(data.ptrw(), available);
+			String s;
+			s.parse_utf8((const char *)data.ptr(), available);
+			c.buffer += s;
+
+			int end = c.buffer.find("\r\n\r\n");
+			while (end != -1) {
+				String request_line = c.buffer.get_slice("\r\n", 0);
+				_respond(c, request_line.get_slice(" ", 1));
+				c.buffer = c.buffer.substr(end + 4, c.buffer.length());
+				end = c.buffer.find("\r\n\r\n");
+			}
+		}
+	}
+
+	LocalServer() {
+		accepted = 0;
+		requests = 0;
+	}
+
+	~LocalServer() {
+		if (server.is_valid())
+			server->stop();
+	}
+};
+
+class Listener : public Object {
+
+	GDCLASS(Listener, Object);
+
+public:
+	Map<int, String> bodies;
+	Map<int, int> streamed;
+	int completed;
+	int failed;
+
+	void _request_completed(int p_id, int p_result, int p_code, const PoolStringArray &p_headers, const PoolByteArray &p_body) {
+
+		completed++;
+		if (p_result != HTTPClientPool::RESULT_SUCCESS || p_code != 200) {
+			failed++;
+			return;
+		}
+		String s;
+		PoolByteArray::Read r = p_body.read();
+		s.parse_utf8((const char *)r.ptr(), p_body.size());
+		bodies[p_id] = s;
+	}
+
+	void _body_chunk_received(int p_id, const PoolByteArray &p_chunk) {
+
+		if (!streamed.has(p_id))
+			streamed[p_id] = 0;
+		streamed[p_id] += p_chunk.size();
+	}
+
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("_request_completed"), &Listener::_request_completed);
+		ClassDB::bind_method(D_METHOD("_body_chunk_received"), &Listener::_body_chunk_received);
+	}
+
+	Listener() {
+		completed = 0;
+		failed = 0;
+	}
+};
+
+static bool run(bool p_threads, int p_port) {
+
+	const int request_count = 64;
+	const int max_connections = 4;
+
+	LocalServer server;
+	if (server.listen(p_port) != OK) {
+		OS::get_singleton()->print("Unable to listen on port %i.\n", p_port);
+		return false;
+	}
+
+	Ref<HTTPClientPool> pool;
+	pool.instance();
+	pool->set_max_connections_per_host(max_connections);
+	pool->set_use_threads(p_threads);
+
+	Listener *listener = memnew(Listener);
+	pool->connect("request_completed", listener, "_request_completed");
+	pool->connect("body_chunk_received", listener, "_body_chunk_received");
+
+	String base = "http://127.0.0.1:" + itos(p_port);
+	Map<int, String> expected;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < request_count; i++) {
+		String path = "/item/" + itos(i);
+		expected[pool->request(base + path)] = path;
+	}
+	int large_id = pool->request(base + "/large", Vector<String>(), HTTPClient::METHOD_GET, PoolVector<uint8_t>(), true);
+
+	while (listener->completed < request_count + 1 && OS::get_singleton()->get_ticks_usec() - begin < 10000000) {
+		server.poll();
+		pool->poll();
+		OS::get_singleton()->delay_usec(100);
+	}
+
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	bool ok = listener->failed == 0 && listener->completed == request_count + 1;
+	for (Map<int, String>::Element *E = expected.front(); E; E = E->next()) {
+		if (!listener->bodies.has(E->key()) || listener->bodies[E->key()] != E->get())
+			ok = false;
+	}
+
+	int streamed = listener->streamed.has(large_id) ? listener->streamed[large_id] : 0;
+	if (streamed != LARGE_SIZE || listener->bodies[large_id] != "")
+		ok = false;
+
+	if (server.accepted > max_connections)
+		ok = false;
+
+	OS::get_singleton()->print("%s: %i requests in %i ms over %i connections, %i bytes streamed: %s\n", p_threads ? "I/O thread" : "poll", server.requests, int(elapsed / 1000), server.accepted, streamed, ok ? "OK" : "FAIL");
+
+	pool.unref();
+	memdelete(listener);
+	return ok;
+}
+
+MainLoop *test() {
+
+	bool ok = run(false, 9390);
+	ok = run(true, 9391) && ok;
+
+	OS::get_singleton()->print("HTTPClientPool test %s\n", ok ? "passed" : "FAILED");
+	return NULL;
+}
+} // namespace TestHTTPClientPool
@@ -33,17 +33,28 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_animation.h"
 #include "test_astar.h"
 #include "test_gdscript.h"
 #include "test_gui.h"
+#include "test_http_client_pool.h"
+#include "test_marshalls.h"
 #include "test_math.h"
+#include "test_multiplayer.h"
 #include "test_oa_hash_map.h"
+#include "test_object_db.h"
 #include "test_ordered_hash_map.h"
+#include "test_packed_scene.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
 #include "test_render.h"
+#include "test_resource_binary.h"
+#include "test_rid.h"
 #include "test_shader_lang.h"
+#include "test_skeleton.h"
 #include "test_string.h"
+#include "test_tcp_server.h"
+#include "test_websocket.h"
 
 const char **tests_get_names() {
 
@@ -62,6 +73,17 @@ const char **tests_get_names() {
 		"gd_bytecode",
 		"ordered_hash_map",
 		"astar",
+		"packed_scene",
+		"marshalls",
+		"multiplayer",
+		"websocket",
+		"http_client_pool",
+		"object_db",
+		"rid",
+		"resource_binary",
+		"animation",
+		"skeleton",
+		"tcp_server",
 		NULL
 	};
 
@@ -142,6 +164,61 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestAStar::test();
 	}
 
+	if (p_test == "packed_scene") {
+
+		return TestPackedScene::test();
+	}
+
+	if (p_test == "marshalls") {
+
+		return TestMarshalls::test();
+	}
+
+	if (p_test == "multiplayer") {
+
+		return TestMultiplayer::test();
+	}
+
+	if (p_test == "websocket") {
+
+		return TestWebSocket::test();
+	}
+
+	if (p_test == "http_client_pool") {
+
+		return TestHTTPClientPool::test();
+	}
+
+	if (p_test == "object_db") {
+
+		return TestObjectDB::test();
+	}
+
+	if (p_test == "rid") {
+
+		return TestRID::test();
+	}
+
+	if (p_test == "resource_binary") {
+
+		return TestResourceBinary::test();
+	}
+
+	if (p_test == "animation") {
+
+		return TestAnimation::test();
+	}
+
+	if (p_test == "skeleton") {
+
+		return TestSkeleton::test();
+	}
+
+	if (p_test == "tcp_server") {
+
+		return TestTCPServer::test();
+	}
+
 	print_line("Unknown test: " + p_test);
 	return NULL;
 }
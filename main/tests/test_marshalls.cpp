@@ -0,0 +1,231 @@
+/*************************************************************************/
+/*  test_marshalls.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_marshalls.h"
+
+#include "core/io/marshalls.h"
+#include "core/os/os.h"
+
+namespace TestMarshalls {
+
+// Arguments of a typical RPC: a transform update, an input snapshot and a chat message.
+static Array make_payload() {
+
+	Array args;
+	args.push_back(Vector3(1, 2, 3));
+	args.push_back(Quat(0, 0.7071, 0, 0.7071));
+	args.push_back(12345);
+	args.push_back(0.5);
+	args.push_back(true);
+
+	Dictionary input;
+	input["move"] = Vector2(0.5, -1);
+	input["jump"] = false;
+	input["seq"] = 987654;
+	args.push_back(input);
+
+	args.push_back("player_42");
+	args.push_back("Hello everyone, this is a chat message.");
+
+	PoolVector<uint8_t> bytes;
+	bytes.resize(37);
+	for (int i = 0; i < bytes.size(); i++) {
+		bytes.set(i, i * 7);
+	}
+	args.push_back(bytes);
+
+	PoolVector<Vector3> points;
+	for (int i = 0; i < 16; i++) {
+		points.push_back(Vector3(i, i * 2, i * 3));
+	}
+	args.push_back(points);
+
+	return args;
+}
+
+// Encodes with both encoders and compares with bytes written by hand from the wire format,
+// so a change to the format fails even if both encoders agree with each other.
+static bool check_golden(const char *p_name, const Variant &p_value, const uint8_t *p_bytes, int p_size) {
+
+	int len;
+	bool ok = encode_variant(p_value, NULL, len) == OK && len == p_size;
+
+	Vector<uint8_t> two_pass;
+	two_pass.resize(p_size);
+	ok = ok && encode_variant(p_value, two_pass.ptrw(), len) == OK && memcmp(two_pass.ptr(), p_bytes, p_size) == 0;
+
+	Vector<uint8_t> one_pass;
+	int pos = 0;
+	ok = ok && encode_variant_into(p_value, one_pass, pos) == OK && pos == p_size && memcmp(one_pass.ptr(), p_bytes, p_size) == 0;
+
+	Variant decoded;
+	ok = ok && decode_variant(decoded, p_bytes, p_size, &len) == OK && len == p_size && decoded.get_type() == p_value.get_type();
+
+	if (!ok) {
+		OS::get_singleton()->print("Wire format of %s changed.\n", p_name);
+	}
+	return ok;
+}
+
+static bool test_golden() {
+
+	const uint8_t nil[] = { 0, 0, 0, 0 };
+	const uint8_t boolean[] = { 1, 0, 0, 0, 1, 0, 0, 0 };
+	const uint8_t int32[] = { 2, 0, 0, 0, 0xE8, 0x03, 0, 0 };
+	const uint8_t negative[] = { 2, 0, 0, 0, 0xFE, 0xFF, 0xFF, 0xFF };
+	const uint8_t int64[] = { 2, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0 };
+	const uint8_t real32[] = { 3, 0, 0, 0, 0, 0, 0, 0x3F };
+	const uint8_t real64[] = { 3, 0, 1, 0, 0x9A, 0x99, 0x99, 0x99, 0x99, 0x99, 0xB9, 0x3F };
+	const uint8_t string[] = { 4, 0, 0, 0, 5, 0, 0, 0, 'a', 'b', 'c', 'd', 'e', 0, 0, 0 };
+	const uint8_t vector2[] = { 5, 0, 0, 0, 0, 0, 0x80, 0x3F, 0, 0, 0, 0xC0 };
+	const uint8_t vector3[] = { 7, 0, 0, 0, 0, 0, 0, 0x3F, 0, 0, 0, 0x40, 0, 0, 0x80, 0xBF };
+	const uint8_t dictionary[] = { 18, 0, 0, 0, 1, 0, 0, 0, 4, 0, 0, 0, 1, 0, 0, 0, 'k', 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0 };
+	const uint8_t array[] = { 19, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 4, 0, 0, 0, 1, 0, 0, 0, 'a', 0, 0, 0 };
+	const uint8_t byte_array[] = { 20, 0, 0, 0, 4, 0, 0, 0, 1, 2, 3, 4 };
+
+	Dictionary d;
+	d["k"] = false;
+
+	Array a;
+	a.push_back(1);
+	a.push_back("a");
+
+	PoolVector<uint8_t> bytes;
+	for (int i = 1; i <= 4; i++) {
+		bytes.push_back(i);
+	}
+
+	bool ok = check_golden("nil", Variant(), nil, sizeof(nil));
+	ok = check_golden("bool", true, boolean, sizeof(boolean)) && ok;
+	ok = check_golden("int", 1000, int32, sizeof(int32)) && ok;
+	ok = check_golden("negative int", -2, negative, sizeof(negative)) && ok;
+	ok = check_golden("64-bit int", (int64_t)1 << 40, int64, sizeof(int64)) && ok;
+	ok = check_golden("float", 0.5, real32, sizeof(real32)) && ok;
+	ok = check_golden("double", 0.1, real64, sizeof(real64)) && ok;
+	ok = check_golden("String", "abcde", string, sizeof(string)) && ok;
+	ok = check_golden("Vector2", Vector2(1, -2), vector2, sizeof(vector2)) && ok;
+	ok = check_golden("Vector3", Vector3(0.5, 2, -1), vector3, sizeof(vector3)) && ok;
+	ok = check_golden("Dictionary", d, dictionary, sizeof(dictionary)) && ok;
+	ok = check_golden("Array", a, array, sizeof(array)) && ok;
+	ok = check_golden("PoolByteArray", bytes, byte_array, sizeof(byte_array)) && ok;
+
+	OS::get_singleton()->print("Encoded bytes match the wire format: %s\n", ok ? "yes" : "no");
+	return ok;
+}
+
+MainLoop *test() {
+
+	const int iterations = 100000;
+
+	if (!test_golden())
+		return NULL;
+
+	Array payload = make_payload();
+
+	int len;
+	encode_variant(payload, NULL, len);
+	Vector<uint8_t> two_pass;
+	two_pass.resize(len);
+	encode_variant(payload, two_pass.ptrw(), len);
+
+	Vector<uint8_t> one_pass;
+	int pos = 0;
+	Error err = encode_variant_into(payload, one_pass, pos);
+
+	bool ok = err == OK && pos == len && memcmp(one_pass.ptr(), two_pass.ptr(), len) == 0;
+	OS::get_singleton()->print("Single pass encoding matches two pass encoding: %s\n", ok ? "yes" : "no");
+	if (!ok)
+		return NULL;
+
+	// Dictionaries compare by reference, so compare the re-encoded bytes instead.
+	Variant decoded;
+	Variant reused;
+	Vector<uint8_t> reencoded;
+	ok = decode_variant(decoded, two_pass.ptr(), len) == OK;
+	ok = ok && decode_variant_reuse(reused, two_pass.ptr(), len) == OK && decode_variant_reuse(reused, two_pass.ptr(), len) == OK;
+	for (int i = 0; ok && i < 2; i++) {
+		pos = 0;
+		ok = encode_variant_into(i == 0 ? decoded : reused, reencoded, pos) == OK && pos == len && memcmp(reencoded.ptr(), two_pass.ptr(), len) == 0;
+	}
+	OS::get_singleton()->print("Decoded payload matches original: %s\n", ok ? "yes" : "no");
+	if (!ok)
+		return NULL;
+
+	Array args = payload;
+	int bytes_ofs = 0;
+	for (int i = 0; i < args.size() - 2; i++) {
+		int used;
+		encode_variant(args[i], NULL, used);
+		bytes_ofs += used;
+	}
+	bytes_ofs += 8; // array type and size
+	const uint8_t *bytes_data;
+	int bytes_size;
+	ok = decode_variant_bytes(two_pass.ptr() + bytes_ofs, len - bytes_ofs, bytes_data, bytes_size) == OK && bytes_size == 37 && bytes_data[36] == uint8_t(36 * 7);
+	OS::get_singleton()->print("Borrowed byte array matches: %s\n", ok ? "yes" : "no");
+	if (!ok)
+		return NULL;
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		Vector<uint8_t> buf;
+		encode_variant(payload, NULL, len);
+		buf.resize(len);
+		encode_variant(payload, buf.ptrw(), len);
+	}
+	uint64_t t_two_pass = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		pos = 0;
+		encode_variant_into(payload, one_pass, pos);
+	}
+	uint64_t t_one_pass = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("Encoding %d payloads of %d bytes: two pass %.3f ms, single pass %.3f ms.\n", iterations, len, t_two_pass / 1000.0, t_one_pass / 1000.0);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		Variant v;
+		decode_variant(v, two_pass.ptr(), len);
+	}
+	uint64_t t_decode = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		decode_variant_reuse(reused, two_pass.ptr(), len);
+	}
+	uint64_t t_reuse = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("Decoding %d payloads: fresh %.3f ms, reusing %.3f ms.\n", iterations, t_decode / 1000.0, t_reuse / 1000.0);
+
+	return NULL;
+}
+} // namespace TestMarshalls
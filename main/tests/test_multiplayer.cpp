@@ -0,0 +1,564 @@
+/*************************************************************************/
+/*  test_multiplayer.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_multiplayer.h"
+
+#include "core/io/marshalls.h"
+#include "core/io/multiplayer_api.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+
+namespace TestMultiplayer {
+
+struct RPCSample {
+	const char *name;
+	Vector<Variant> args;
+};
+
+static Vector<RPCSample> make_samples() {
+
+	Vector<RPCSample> samples;
+
+	RPCSample move;
+	move.name = "update_transform";
+	move.args.push_back(Vector3(10.5, 0, -3.25));
+	move.args.push_back(Quat(0, 0.7071, 0, 0.7071));
+	samples.push_back(move);
+
+	RPCSample input;
+	input.name = "send_input";
+	input.args.push_back(1234); // Sequence number.
+	input.args.push_back(true);
+	input.args.push_back(false);
+	input.args.push_back(0.5);
+	samples.push_back(input);
+
+	RPCSample hit;
+	hit.name = "take_damage";
+	hit.args.push_back(25);
+	hit.args.push_back(7);
+	samples.push_back(hit);
+
+	RPCSample chat;
+	chat.name = "chat";
+	chat.args.push_back("gg");
+	samples.push_back(chat);
+
+	return samples;
+}
+
+// Delivers packets in order to the other peers of the same network, like a reliable connection.
+class LoopbackPeer : public NetworkedMultiplayerPeer {
+
+	struct Packet {
+		int from;
+		Vector<uint8_t> data;
+	};
+
+	Vector<LoopbackPeer *> *network;
+	int unique_id;
+	int target_peer;
+	TransferMode transfer_mode;
+	List<Packet> incoming;
+	Packet current;
+
+public:
+	Vector<int> sent_sizes; // every packet put, in order
+
+	virtual int get_available_packet_count() const { return incoming.size(); }
+
+	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
+
+		ERR_FAIL_COND_V(incoming.empty(), ERR_UNAVAILABLE);
+		current = incoming.front()->get();
+		incoming.pop_front();
+		*r_buffer = current.data.ptr();
+		r_buffer_size = current.data.size();
+		return OK;
+	}
+
+	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) {
+
+		sent_sizes.push_back(p_buffer_size);
+
+		Packet packet;
+		packet.from = unique_id;
+		packet.data.resize(p_buffer_size);
+		copymem(packet.data.ptrw(), p_buffer, p_buffer_size);
+
+		for (int i = 0; i < network->size(); i++) {
+			LoopbackPeer *peer = (*network)[i];
+			if (peer == this)
+				continue;
+			if (target_peer == 0 || target_peer == peer->unique_id || (target_peer < 0 && peer->unique_id != -target_peer)) {
+				peer->incoming.push_back(packet);
+			}
+		}
+		return OK;
+	}
+
+	virtual int get_max_packet_size() const { return 1 << 24; }
+
+	virtual void set_transfer_mode(TransferMode p_mode) { transfer_mode = p_mode; }
+	virtual TransferMode get_transfer_mode() const { return transfer_mode; }
+	virtual void set_target_peer(int p_peer_id) { target_peer = p_peer_id; }
+	virtual int get_packet_peer() const { return incoming.empty() ? 0 : incoming.front()->get().from; }
+	virtual bool is_server() const { return unique_id == TARGET_PEER_SERVER; }
+	virtual void poll() {}
+	virtual int get_unique_id() const { return unique_id; }
+	virtual void set_refuse_new_connections(bool p_enable) {}
+	virtual bool is_refusing_new_connections() const { return false; }
+	virtual ConnectionStatus get_connection_status() const { return CONNECTION_CONNECTED; }
+
+	int get_last_sent_size() const { return sent_sizes.size() ? sent_sizes[sent_sizes.size() - 1] : 0; }
+
+	LoopbackPeer(Vector<LoopbackPeer *> *p_network, int p_unique_id) {
+
+		network = p_network;
+		unique_id = p_unique_id;
+		target_peer = 0;
+		transfer_mode = TRANSFER_MODE_RELIABLE;
+		network->push_back(this);
+	}
+};
+
+// Size of a remote call to a cached node in the format used before IDs were negotiated for names.
+static int legacy_size(const RPCSample &p_sample) {
+
+	int len = 1 + 4 + strlen(p_sample.name) + 1 + 1;
+	for (int i = 0; i < p_sample.args.size(); i++) {
+		int vlen;
+		encode_variant(p_sample.args[i], NULL, vlen);
+		len += vlen;
+	}
+	return len;
+}
+
+// Size of a remote call to a cached node and name, both IDs fit in a byte.
+static int compact_size(Ref<MultiplayerAPI> p_api, const RPCSample &p_sample, Vector<uint8_t> &r_buffer) {
+
+	int len = 0;
+	for (int i = 0; i < p_sample.args.size(); i++) {
+		p_api->encode_and_compress_variant(p_sample.args[i], r_buffer, len);
+	}
+	return 1 + 1 + 1 + 1 + len;
+}
+
+static bool check_round_trip(Ref<MultiplayerAPI> p_api, const Variant &p_value) {
+
+	Vector<uint8_t> buffer;
+	int len = 0;
+	if (p_api->encode_and_compress_variant(p_value, buffer, len) != OK)
+		return false;
+
+	Variant decoded;
+	int used;
+	if (p_api->decode_and_decompress_variant(decoded, buffer.ptr(), len, &used) != OK)
+		return false;
+
+	return used == len && decoded.get_type() == p_value.get_type() && decoded == p_value;
+}
+
+// Checks interest filtering against testing every peer, and times both.
+static bool test_interest(Node *p_root) {
+
+	const int peers = 64;
+	const int nodes = 1000;
+	const real_t map_size = 2000;
+	const real_t radius = 150;
+
+	RandomPCG rng(1234);
+
+	// Only the server side exists, clients are connected through its peer.
+	Vector<LoopbackPeer *> network;
+	Ref<LoopbackPeer> peer = memnew(LoopbackPeer(&network, 1));
+
+	Ref<MultiplayerAPI> api;
+	api.instance();
+	api->set_root_node(p_root);
+	api->set_network_peer(peer);
+	api->set_interest_enabled(true);
+	api->set_interest_radius(radius);
+
+	Vector<Vector3> peer_origins;
+	for (int i = 0; i < peers; i++) {
+		Vector3 origin(rng.randf() * map_size, 0, rng.randf() * map_size);
+		peer_origins.push_back(origin);
+		peer->emit_signal("peer_connected", i + 2);
+		api->set_peer_interest_origin(i + 2, origin);
+	}
+
+	Vector<Node *> node_list;
+	Vector<Vector3> node_origins;
+	for (int i = 0; i < nodes; i++) {
+		Node *node = memnew(Node);
+		p_root->add_child(node);
+		Vector3 origin(rng.randf() * map_size, 0, rng.randf() * map_size);
+		node_list.push_back(node);
+		node_origins.push_back(origin);
+		api->set_node_interest(node, origin);
+	}
+
+	bool ok = true;
+	int relevant = 0;
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < nodes; i++) {
+		Vector<int> expected;
+		for (int j = 0; j < peers; j++) {
+			if (peer_origins[j].distance_squared_to(node_origins[i]) <= radius * radius)
+				expected.push_back(j + 2);
+		}
+		relevant += expected.size();
+
+		Vector<int> got = api->get_interested_peers(node_list[i]);
+		got.sort();
+		if (got.size() != expected.size()) {
+			ok = false;
+			continue;
+		}
+		for (int j = 0; j < got.size(); j++) {
+			if (got[j] != expected[j])
+				ok = false;
+		}
+	}
+	uint64_t t_total = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("Interest matches distance checks: %s, %.2f of %d peers relevant per node.\n", ok ? "yes" : "no", double(relevant) / nodes, peers);
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < nodes; i++) {
+		api->get_interested_peers(node_list[i]);
+	}
+	uint64_t t_grid = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("Interest queries for %d nodes: %.3f ms (%.3f ms including brute force checks).\n", nodes, t_grid / 1000.0, t_total / 1000.0);
+
+	// Freed nodes forget their interest on their own.
+	for (int i = 0; i < nodes; i++) {
+		memdelete(node_list[i]);
+	}
+	for (int i = 0; i < peers; i++) {
+		peer->emit_signal("peer_disconnected", i + 2);
+	}
+	api->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+
+	return ok;
+}
+
+// Polls every API until no packets are left in flight.
+static void flush(Vector<Ref<MultiplayerAPI> > &p_apis) {
+
+	bool pending = true;
+	while (pending) {
+		pending = false;
+		for (int i = 0; i < p_apis.size(); i++) {
+			p_apis.write[i]->poll();
+		}
+		for (int i = 0; i < p_apis.size(); i++) {
+			if (p_apis[i]->get_network_peer()->get_available_packet_count())
+				pending = true;
+		}
+	}
+}
+
+static int encoded_size(Ref<MultiplayerAPI> p_api, const Variant &p_value) {
+
+	Vector<uint8_t> buffer;
+	int len = 0;
+	p_api->encode_and_compress_variant(p_value, buffer, len);
+	return len;
+}
+
+// Sends calls and sets between a server and a client through loopback peers, checking the packets they produce.
+class TestMainLoop : public SceneTree {
+
+	Vector<LoopbackPeer *> network;
+	Vector<Ref<MultiplayerAPI> > apis;
+	Vector<Ref<LoopbackPeer> > peers;
+	Vector<Node2D *> players;
+
+	void _add_peer(const String &p_name, int p_id) {
+
+		Node *root = memnew(Node);
+		root->set_name(p_name);
+		get_root()->add_child(root);
+
+		Node2D *player = memnew(Node2D);
+		player->set_name("Player");
+		player->rpc_config("set_position", MultiplayerAPI::RPC_MODE_REMOTE);
+		player->rset_config("position", MultiplayerAPI::RPC_MODE_REMOTE);
+		root->add_child(player);
+		players.push_back(player);
+
+		Ref<LoopbackPeer> peer = memnew(LoopbackPeer(&network, p_id));
+		peers.push_back(peer);
+
+		Ref<MultiplayerAPI> api;
+		api.instance();
+		api->set_root_node(root);
+		api->set_network_peer(peer);
+		apis.push_back(api);
+	}
+
+	// Peers are connected to each other the way the server and its clients see it.
+	void _connect_peers() {
+
+		for (int i = 1; i < peers.size(); i++) {
+			peers.write[0]->emit_signal("peer_connected", i + 1);
+			peers.write[i]->emit_signal("peer_connected", 1);
+		}
+	}
+
+	bool _test_rpc() {
+
+		Ref<MultiplayerAPI> server = apis[0];
+		Ref<LoopbackPeer> server_peer = peers[0];
+		Node2D *client_player = players[1];
+
+		RPCSample sample;
+		sample.name = "set_position";
+		sample.args.push_back(Vector2(3, 4));
+		const Variant *args[1] = { &sample.args[0] };
+
+		// The first call carries the path and name, the client caches both.
+		server->rpcp(players[0], 2, false, "set_position", args, 1);
+		int inline_size = server_peer->get_last_sent_size();
+		flush(apis);
+		bool ok = client_player->get_position() == Vector2(3, 4);
+
+		sample.args.write[0] = Vector2(5, 6);
+		args[0] = &sample.args[0];
+		server_peer->sent_sizes.clear();
+		server->rpcp(players[0], 2, false, "set_position", args, 1);
+		int size = server_peer->get_last_sent_size();
+		flush(apis);
+
+		// Header, node ID, name ID, argument count and the argument.
+		int expected = 1 + 1 + 1 + 1 + encoded_size(server, sample.args[0]);
+		ok = ok && server_peer->sent_sizes.size() == 1 && size == expected;
+		ok = ok && client_player->get_position() == Vector2(5, 6);
+
+		OS::get_singleton()->print("RPC %s: %d bytes once cached (%d bytes before, was %d bytes), decoded: %s\n", sample.name, size, inline_size, legacy_size(sample), ok ? "yes" : "no");
+		return ok;
+	}
+
+	// A broadcast only reaches the clients close to the node, until the node leaves the tree.
+	bool _test_interest_filtering() {
+
+		Ref<MultiplayerAPI> server = apis[0];
+		Node2D *player = players[0];
+
+		server->set_interest_enabled(true);
+		server->set_interest_radius(10);
+		server->set_peer_interest_origin(2, Vector3(0, 0, 0));
+		server->set_peer_interest_origin(3, Vector3(100, 0, 0));
+		server->set_node_interest(player, Vector3(1, 0, 0));
+
+		Variant pos = Vector2(11, 12);
+		const Variant *args[1] = { &pos };
+		server->rpcp(player, 0, false, "set_position", args, 1);
+		flush(apis);
+		bool ok = players[1]->get_position() == Vector2(11, 12) && players[2]->get_position() != Vector2(11, 12);
+
+		OS::get_singleton()->print("Broadcast reaches only the near client: %s\n", ok ? "yes" : "no");
+
+		Node *parent = player->get_parent();
+		parent->remove_child(player);
+		parent->add_child(player);
+
+		pos = Vector2(13, 14);
+		server->rpcp(player, 0, false, "set_position", args, 1);
+		flush(apis);
+		bool cleared = server->get_interested_peers(player).size() == 2 && players[1]->get_position() == Vector2(13, 14) && players[2]->get_position() == Vector2(13, 14);
+
+		OS::get_singleton()->print("Interest cleared when leaving the tree: %s\n", cleared ? "yes" : "no");
+
+		server->set_interest_enabled(false);
+		server->clear_peer_interest_origin(2);
+		server->clear_peer_interest_origin(3);
+
+		return ok && cleared;
+	}
+
+	bool _test_rset() {
+
+		Ref<MultiplayerAPI> server = apis[0];
+		Ref<LoopbackPeer> server_peer = peers[0];
+		Node2D *client_player = players[1];
+
+		Variant value = Vector2(7, 8);
+		server->rsetp(players[0], 2, false, "position", value);
+		flush(apis);
+		bool ok = client_player->get_position() == Vector2(7, 8);
+
+		// Same value again, the client applies its baseline.
+		client_player->set_position(Vector2());
+		server_peer->sent_sizes.clear();
+		server->rsetp(players[0], 2, false, "position", value);
+		int unchanged_size = server_peer->get_last_sent_size();
+		flush(apis);
+		bool unchanged_ok = server_peer->sent_sizes.size() == 1 && unchanged_size == 3 && client_player->get_position() == Vector2(7, 8);
+
+		OS::get_singleton()->print("Unchanged reliable rset: %d bytes, decoded: %s\n", unchanged_size, unchanged_ok ? "yes" : "no");
+
+		value = Vector2(9, 10);
+		server_peer->sent_sizes.clear();
+		server->rsetp(players[0], 2, false, "position", value);
+		int changed_size = server_peer->get_last_sent_size();
+		flush(apis);
+		bool changed_ok = server_peer->sent_sizes.size() == 1 && changed_size == 3 + encoded_size(server, value) && client_player->get_position() == Vector2(9, 10);
+
+		OS::get_singleton()->print("Changed reliable rset: %d bytes, decoded: %s\n", changed_size, changed_ok ? "yes" : "no");
+
+		// Unreliable sets never use the baseline.
+		server_peer->sent_sizes.clear();
+		server->rsetp(players[0], 2, true, "position", value);
+		int unreliable_size = server_peer->get_last_sent_size();
+		flush(apis);
+		bool unreliable_ok = unreliable_size == 3 + encoded_size(server, value) && client_player->get_position() == Vector2(9, 10);
+
+		OS::get_singleton()->print("Unreliable rset: %d bytes, decoded: %s\n", unreliable_size, unreliable_ok ? "yes" : "no");
+
+		return ok && unchanged_ok && changed_ok && unreliable_ok;
+	}
+
+	void _clear() {
+
+		for (int i = 0; i < apis.size(); i++) {
+			apis.write[i]->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+			memdelete(players[i]->get_parent());
+		}
+		apis.clear();
+		peers.clear();
+		players.clear();
+		network.clear();
+	}
+
+public:
+	virtual void init() {
+
+		SceneTree::init();
+
+		_add_peer("Server", 1);
+		_add_peer("Client2", 2);
+		_add_peer("Client3", 3);
+		_connect_peers();
+
+		bool ok = _test_rpc();
+		ok = _test_rset() && ok;
+		ok = _test_interest_filtering() && ok;
+
+		Node *interest_root = memnew(Node);
+		interest_root->set_name("Interest");
+		get_root()->add_child(interest_root);
+		ok = test_interest(interest_root) && ok;
+		memdelete(interest_root);
+
+		OS::get_singleton()->print("Remote calls and sets over loopback peers: %s\n", ok ? "passed" : "failed");
+
+		_clear();
+		quit();
+	}
+};
+
+MainLoop *test() {
+
+	const int iterations = 100000;
+
+	Ref<MultiplayerAPI> api;
+	api.instance();
+
+	Variant values[] = {
+		Variant(), true, false, 0, -1, 127, -128, 128, -129, 32767, -32768, 40000, -40000, int64_t(1) << 40, -(int64_t(1) << 40),
+		0.5, 0.1, 1e300, Vector3(1, 2, 3), String("name"), Color(1, 0, 0)
+	};
+
+	bool ok = true;
+	for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+		if (!check_round_trip(api, values[i])) {
+			OS::get_singleton()->print("Round trip failed for %s\n", String(values[i]).utf8().get_data());
+			ok = false;
+		}
+	}
+	OS::get_singleton()->print("Compressed arguments decode to the original values: %s\n", ok ? "yes" : "no");
+	if (!ok)
+		return NULL;
+
+	Vector<RPCSample> samples = make_samples();
+	Vector<uint8_t> buffer;
+
+	for (int i = 0; i < samples.size(); i++) {
+		OS::get_singleton()->print("RPC %s: %d bytes, was %d bytes.\n", samples[i].name, compact_size(api, samples[i], buffer), legacy_size(samples[i]));
+	}
+
+	Vector<Variant> decoded;
+	decoded.resize(8);
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		const RPCSample &sample = samples[i % samples.size()];
+		int len = 0;
+		for (int j = 0; j < sample.args.size(); j++) {
+			encode_variant_into(sample.args[j], buffer, len);
+		}
+		int ofs = 0;
+		for (int j = 0; j < sample.args.size(); j++) {
+			int vlen;
+			decode_variant(decoded.write[j], buffer.ptr() + ofs, len - ofs, &vlen);
+			ofs += vlen;
+		}
+	}
+	uint64_t t_legacy = OS::get_singleton()->get_ticks_usec() - t;
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		const RPCSample &sample = samples[i % samples.size()];
+		int len = 0;
+		for (int j = 0; j < sample.args.size(); j++) {
+			api->encode_and_compress_variant(sample.args[j], buffer, len);
+		}
+		int ofs = 0;
+		for (int j = 0; j < sample.args.size(); j++) {
+			int vlen;
+			api->decode_and_decompress_variant(decoded.write[j], buffer.ptr() + ofs, len - ofs, &vlen);
+			ofs += vlen;
+		}
+	}
+	uint64_t t_compact = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("Encoding and decoding arguments: %.3f usec per RPC, was %.3f usec.\n", double(t_compact) / iterations, double(t_legacy) / iterations);
+
+	return memnew(TestMainLoop);
+}
+} // namespace TestMultiplayer
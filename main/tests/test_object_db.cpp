@@ -0,0 +1,118 @@
+/*************************************************************************/
+/*  test_object_db.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_object_db.h"
+
+#include "core/object.h"
+#include "core/os/os.h"
+
+#ifdef GDSCRIPT_ENABLED
+#include "modules/gdscript/gdscript_functions.h"
+#endif
+
+namespace TestObjectDB {
+
+static const ObjectID SLOT_MASK = (1 << 24) - 1;
+
+// Creates objects until one lands in the slot of p_id, keeping the others alive
+// so they don't go back to the free list.
+static Object *reuse_slot(ObjectID p_id, Vector<Object *> &r_alive) {
+
+	for (int i = 0; i < 1000000; i++) {
+
+		Object *obj = memnew(Object);
+		if ((obj->get_instance_id() & SLOT_MASK) == (p_id & SLOT_MASK)) {
+			return obj;
+		}
+		r_alive.push_back(obj);
+	}
+
+	return NULL;
+}
+
+MainLoop *test() {
+
+	Vector<Object *> alive;
+
+	Object *first = memnew(Object);
+	ObjectID first_id = first->get_instance_id();
+	memdelete(first);
+
+	Object *reused = reuse_slot(first_id, alive);
+	bool ok = reused && reused->get_instance_id() != first_id;
+	ok = ok && ObjectDB::get_instance(first_id) == NULL && ObjectDB::get_instance(reused->get_instance_id()) == reused;
+
+	OS::get_singleton()->print("Reused slot gets a new ID and rejects the old one: %s\n", ok ? "yes" : "no");
+
+	// cycle the slot until its generation no longer fits in 32-bit IDs
+	Vector<ObjectID> stale;
+	while (reused && reused->get_instance_id() <= 0xFFFFFFFF) {
+		stale.push_back(reused->get_instance_id());
+		ObjectID id = reused->get_instance_id();
+		memdelete(reused);
+		reused = reuse_slot(id, alive);
+	}
+
+	ok = reused != NULL;
+	for (int i = 0; ok && i < stale.size(); i++) {
+		ok = ObjectDB::get_instance(stale[i]) == NULL;
+	}
+	if (ok) {
+		ObjectID id = reused->get_instance_id();
+		Variant v = id;
+		ok = ObjectDB::get_instance(v) == reused;
+		ok = ok && ObjectDB::get_instance(id & 0xFFFFFFFF) == NULL;
+	}
+
+	OS::get_singleton()->print("IDs above 32 bits resolve, stale and truncated IDs don't: %s\n", ok ? "yes" : "no");
+
+#ifdef GDSCRIPT_ENABLED
+	if (reused) {
+		Variant arg = reused->get_instance_id();
+		const Variant *args[1] = { &arg };
+		Variant ret;
+		Variant::CallError ce;
+		GDScriptFunctions::call(GDScriptFunctions::INSTANCE_FROM_ID, args, 1, ret, ce);
+		ok = ce.error == Variant::CallError::CALL_OK && (Object *)ret == reused;
+
+		OS::get_singleton()->print("instance_from_id() resolves IDs above 32 bits: %s\n", ok ? "yes" : "no");
+	}
+#endif
+
+	if (reused) {
+		memdelete(reused);
+	}
+	for (int i = 0; i < alive.size(); i++) {
+		memdelete(alive[i]);
+	}
+
+	return NULL;
+}
+} // namespace TestObjectDB
@@ -0,0 +1,217 @@
+/*************************************************************************/
+/*  test_packed_scene.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_packed_scene.h"
+
+#include "core/os/os.h"
+#include "core/script_language.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/scene_pool.h"
+#include "scene/resources/packed_scene.h"
+
+namespace TestPackedScene {
+
+static Node *make_scene(int p_children) {
+
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+
+	for (int i = 0; i < p_children; i++) {
+
+		Node2D *child = memnew(Node2D);
+		child->set_name("Child" + itos(i));
+		child->set_position(Vector2(i, i * 2));
+		child->set_rotation(i * 0.1);
+		child->set_scale(Vector2(2, 2));
+		child->set_modulate(Color(1, 0.5, 0.25));
+		child->set_z_index(i % 4);
+		root->add_child(child);
+		child->set_owner(root);
+
+		child->connect("visibility_changed", root, "update", varray(), Object::CONNECT_PERSIST);
+	}
+
+	return root;
+}
+
+static bool check_instance(Node *p_node, int p_children) {
+
+	if (p_node->get_child_count() != p_children)
+		return false;
+
+	for (int i = 0; i < p_children; i++) {
+
+		Node2D *child = Object::cast_to<Node2D>(p_node->get_child(i));
+		if (!child || child->get_name() != "Child" + itos(i))
+			return false;
+		if (child->get_position() != Vector2(i, i * 2) || child->get_scale() != Vector2(2, 2) || child->get_z_index() != i % 4)
+			return false;
+		if (!child->is_connected("visibility_changed", p_node, "update"))
+			return false;
+	}
+
+	return true;
+}
+
+MainLoop *test() {
+
+	const int children = 32;
+	const int iterations = 2000;
+
+	Node *scene = make_scene(children);
+	Ref<PackedScene> packed;
+	packed.instance();
+	Error err = packed->pack(scene);
+	memdelete(scene);
+
+	if (err != OK) {
+		OS::get_singleton()->print("Pack failed: %d\n", err);
+		return NULL;
+	}
+
+	Node *first = packed->instance();
+	bool ok = first && check_instance(first, children);
+	if (first)
+		memdelete(first);
+
+	OS::get_singleton()->print("Instanced scene matches packed scene: %s\n", ok ? "yes" : "no");
+	if (!ok)
+		return NULL;
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		memdelete(packed->instance());
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("Instanced %d scenes of %d nodes in %.3f ms (%.1f instances/s).\n", iterations, children + 1, t / 1000.0, iterations * 1000000.0 / MAX(t, (uint64_t)1));
+
+	Ref<ScenePool> pool;
+	pool.instance();
+
+	Node *pooled = pool->acquire(packed);
+	Object::cast_to<Node2D>(pooled->get_child(1))->set_position(Vector2(100, 100));
+	pool->release(pooled);
+
+	Node *reused = pool->acquire(packed);
+	ok = reused == pooled && check_instance(reused, children);
+	pool->release(reused);
+
+	OS::get_singleton()->print("Pooled instance is reused and reset: %s\n", ok ? "yes" : "no");
+
+	// properties left at their default when packing are reset too
+	pooled = pool->acquire(packed);
+	Object::cast_to<Node2D>(pooled->get_child(2))->set_self_modulate(Color(0, 0, 0));
+	Object::cast_to<Node2D>(pooled)->set_position(Vector2(5, 5));
+	pool->release(pooled);
+
+	reused = pool->acquire(packed);
+	ok = reused == pooled && check_instance(reused, children);
+	ok = ok && Object::cast_to<Node2D>(reused->get_child(2))->get_self_modulate() == Color(1, 1, 1);
+	ok = ok && Object::cast_to<Node2D>(reused)->get_position() == Vector2();
+	pool->release(reused);
+
+	OS::get_singleton()->print("Unstored properties are reset to their defaults: %s\n", ok ? "yes" : "no");
+
+	// nodes added at runtime are freed on release
+	pooled = pool->acquire(packed);
+	Node *added = memnew(Node);
+	ObjectID added_id = added->get_instance_id();
+	pooled->get_child(3)->add_child(added);
+	Node2D *added_root = memnew(Node2D);
+	ObjectID added_root_id = added_root->get_instance_id();
+	pooled->add_child(added_root);
+	pool->release(pooled);
+
+	reused = pool->acquire(packed);
+	ok = reused == pooled && check_instance(reused, children) && reused->get_child(3)->get_child_count() == 0;
+	ok = ok && !ObjectDB::get_instance(added_id) && !ObjectDB::get_instance(added_root_id);
+	pool->release(reused);
+
+	OS::get_singleton()->print("Nodes added at runtime are removed: %s\n", ok ? "yes" : "no");
+
+	// instances missing packed nodes can't be reset and are freed instead
+	pooled = pool->acquire(packed);
+	ObjectID pooled_id = pooled->get_instance_id();
+	memdelete(pooled->get_child(4));
+	pool->release(pooled);
+
+	ok = !ObjectDB::get_instance(pooled_id);
+	reused = pool->acquire(packed);
+	ok = ok && check_instance(reused, children);
+	pool->release(reused);
+
+	OS::get_singleton()->print("Instances with removed nodes are not reused: %s\n", ok ? "yes" : "no");
+
+	// script instances are recreated, so member variables start over
+	ScriptLanguage *gdscript = NULL;
+	for (int i = 0; i < ScriptServer::get_language_count(); i++) {
+		if (ScriptServer::get_language(i)->get_name() == "GDScript") {
+			gdscript = ScriptServer::get_language(i);
+		}
+	}
+
+	if (gdscript) {
+
+		Ref<Script> script = gdscript->create_script();
+		script->set_source_code("extends Node2D\nvar counter = 0\n");
+		script->reload();
+
+		Node *scripted = make_scene(children);
+		scripted->set_script(script.get_ref_ptr());
+		Ref<PackedScene> packed_scripted;
+		packed_scripted.instance();
+		packed_scripted->pack(scripted);
+		memdelete(scripted);
+
+		pooled = pool->acquire(packed_scripted);
+		pooled->set("counter", 5);
+		pooled->get_child(5)->set_script(script.get_ref_ptr());
+		pool->release(pooled);
+
+		reused = pool->acquire(packed_scripted);
+		ok = reused == pooled && check_instance(reused, children);
+		ok = ok && int(reused->get("counter")) == 0 && reused->get_child(5)->get_script().is_null();
+		pool->release(reused);
+
+		OS::get_singleton()->print("Script variables are reset: %s\n", ok ? "yes" : "no");
+	}
+
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		pool->release(pool->acquire(packed));
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+
+	OS::get_singleton()->print("Acquired and released %d pooled scenes in %.3f ms (%.1f instances/s).\n", iterations, t / 1000.0, iterations * 1000000.0 / MAX(t, (uint64_t)1));
+
+	return NULL;
+}
+} // namespace TestPackedScene
@@ -0,0 +1,147 @@
+/*************************************************************************/
+/*  test_resource_binary.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_resource_binary.h"
+
+#include "core/io/resource_format_binary.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/math/random_pcg.h"
+#include "core/os/dir_access.h"
+#include "core/os/os.h"
+
+namespace TestResourceBinary {
+
+// Arrays large enough to be mapped, and a small one that is always read.
+static Ref<Resource> make_resource() {
+
+	const int count = 40000;
+	RandomPCG rng(1234);
+
+	PoolVector<uint8_t> bytes;
+	PoolVector<int> ints;
+	PoolVector<real_t> reals;
+	PoolVector<Vector2> vector2s;
+	PoolVector<Vector3> vector3s;
+	PoolVector<Color> colors;
+	PoolVector<int> small;
+
+	for (int i = 0; i < count; i++) {
+		bytes.push_back(rng.rand() & 0xFF);
+		bytes.push_back(rng.rand() & 0xFF);
+		ints.push_back(rng.rand());
+		reals.push_back(rng.randf());
+		vector2s.push_back(Vector2(rng.randf(), rng.randf()));
+		vector3s.push_back(Vector3(rng.randf(), rng.randf(), rng.randf()));
+		colors.push_back(Color(rng.randf(), rng.randf(), rng.randf(), rng.randf()));
+	}
+	for (int i = 0; i < 16; i++) {
+		small.push_back(i);
+	}
+
+	Ref<Resource> res;
+	res.instance();
+	res->set_meta("bytes", bytes);
+	res->set_meta("ints", ints);
+	res->set_meta("reals", reals);
+	res->set_meta("vector2s", vector2s);
+	res->set_meta("vector3s", vector3s);
+	res->set_meta("colors", colors);
+	res->set_meta("small", small);
+	return res;
+}
+
+static bool compare(const Ref<Resource> &p_a, const Ref<Resource> &p_b) {
+
+	if (p_a.is_null() || p_b.is_null())
+		return false;
+
+	List<String> keys;
+	p_a->get_meta_list(&keys);
+	for (List<String>::Element *E = keys.front(); E; E = E->next()) {
+		Variant a = p_a->get_meta(E->get());
+		Variant b = p_b->get_meta(E->get());
+		if (a.get_type() != b.get_type() || a != b)
+			return false;
+	}
+	return keys.size() > 0;
+}
+
+// Saves the arrays in format 4 and loads them back mapped and read, writing to the mapped copy in between.
+MainLoop *test() {
+
+	String path = OS::get_singleton()->get_user_data_dir().plus_file("test_resource_binary.res");
+
+	Ref<Resource> res = make_resource();
+	Error err = ResourceSaver::save(path, res);
+	if (err != OK) {
+		OS::get_singleton()->print("Unable to save %s.\n", path.utf8().get_data());
+		return NULL;
+	}
+
+	bool mapping = ResourceFormatLoaderBinary::is_array_mapping_enabled();
+
+	ResourceFormatLoaderBinary::set_array_mapping(true);
+	Ref<Resource> mapped = ResourceLoader::load(path, "", true);
+	bool mapped_ok = compare(res, mapped);
+	OS::get_singleton()->print("Mapped arrays match: %s\n", mapped_ok ? "yes" : "no");
+
+	// Writing copies the array, the file and other loads are not affected.
+	bool write_ok = false;
+	if (mapped.is_valid()) {
+		PoolVector<real_t> reals = mapped->get_meta("reals");
+		PoolVector<real_t> original = reals;
+		reals.set(0, -1.0);
+		reals.resize(reals.size() + 1);
+		mapped->set_meta("reals", reals);
+		write_ok = reals[0] == -1.0 && original[0] != -1.0 && original.size() + 1 == reals.size();
+	}
+	OS::get_singleton()->print("Writing a mapped array copies it: %s\n", write_ok ? "yes" : "no");
+
+	ResourceFormatLoaderBinary::set_array_mapping(false);
+	Ref<Resource> read = ResourceLoader::load(path, "", true);
+	bool read_ok = compare(res, read);
+	OS::get_singleton()->print("Read arrays match: %s\n", read_ok ? "yes" : "no");
+
+	ResourceFormatLoaderBinary::set_array_mapping(mapping);
+
+	// Mapped arrays stay valid after the loader is gone, and are unmapped with the resource.
+	mapped = Ref<Resource>();
+	read = Ref<Resource>();
+
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->remove(path);
+	memdelete(da);
+
+	OS::get_singleton()->print("Binary resource arrays: %s\n", mapped_ok && write_ok && read_ok ? "passed" : "failed");
+
+	return NULL;
+}
+} // namespace TestResourceBinary
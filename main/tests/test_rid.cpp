@@ -0,0 +1,188 @@
+/*************************************************************************/
+/*  test_rid.cpp                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_rid.h"
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/rid.h"
+
+namespace TestRID {
+
+struct Data : public RID_Data {
+	int value;
+};
+
+struct ThreadData {
+	RID_Owner<Data> *owner;
+	int iterations;
+	bool ok;
+};
+
+// Walks every slot the way a bulk server pass would, without locking.
+static int visit_slots(const RID_Owner<Data> &p_owner, bool *r_ok) {
+
+	int visited = 0;
+	uint32_t count = p_owner.get_slot_count();
+	for (uint32_t i = 0; i < count; i++) {
+
+		RID rid;
+		if (p_owner.get_by_slot(i, &rid)) {
+			*r_ok = *r_ok && (rid.get_id() & 0xFFFFFFFF) == i;
+			visited++;
+		}
+	}
+	return visited;
+}
+
+static void thread_func(void *p_userdata) {
+
+	ThreadData *td = (ThreadData *)p_userdata;
+	Vector<RID> rids;
+	Vector<Data *> datas;
+
+	for (int i = 0; i < td->iterations; i++) {
+
+		Data *d = memnew(Data);
+		d->value = i;
+		rids.push_back(td->owner->make_rid(d));
+		datas.push_back(d);
+
+		// free every other one right away, so slots get reused concurrently
+		if (i % 2) {
+			int last = rids.size() - 1;
+			td->ok = td->ok && td->owner->getornull(rids[last]) == d;
+			td->owner->free(rids[last]);
+			memdelete(d);
+			rids.remove(last);
+			datas.remove(last);
+		}
+	}
+
+	for (int i = 0; i < rids.size(); i++) {
+		td->ok = td->ok && td->owner->getornull(rids[i]) == datas[i] && datas[i]->value == i * 2;
+		td->owner->free(rids[i]);
+		memdelete(datas[i]);
+	}
+}
+
+MainLoop *test() {
+
+	RID_Owner<Data> owner;
+	RID_Owner<Data> other_owner;
+
+	Data *first = memnew(Data);
+	RID first_rid = owner.make_rid(first);
+	bool ok = owner.owns(first_rid) && owner.getornull(first_rid) == first && !other_owner.owns(first_rid);
+
+	OS::get_singleton()->print("RID resolves only in its owner: %s\n", ok ? "yes" : "no");
+
+	owner.free(first_rid);
+	memdelete(first);
+
+	// the freed slot is reused right away by the next RID
+	Data *second = memnew(Data);
+	RID second_rid = owner.make_rid(second);
+	ok = (second_rid.get_id() & 0xFFFFFFFF) == (first_rid.get_id() & 0xFFFFFFFF);
+	ok = ok && second_rid != first_rid && !owner.owns(first_rid) && owner.getptr(first_rid) == NULL;
+	ok = ok && owner.getornull(second_rid) == second;
+
+	OS::get_singleton()->print("Freed then reused slot rejects the old RID: %s\n", ok ? "yes" : "no");
+
+	owner.free(second_rid);
+	memdelete(second);
+
+	// Every other object freed, iteration must visit exactly the rest.
+	Vector<RID> rids;
+	Vector<Data *> datas;
+	for (int i = 0; i < 100; i++) {
+		Data *d = memnew(Data);
+		d->value = i;
+		rids.push_back(owner.make_rid(d));
+		datas.push_back(d);
+	}
+	for (int i = 1; i < 100; i += 2) {
+		owner.free(rids[i]);
+		memdelete(datas[i]);
+	}
+
+	ok = owner.get_owned_count() == 50;
+	int visited = 0;
+	for (uint32_t i = 0; i < owner.get_slot_count(); i++) {
+
+		RID rid;
+		Data *d = owner.get_by_slot(i, &rid);
+		if (!d)
+			continue;
+
+		ok = ok && d->value % 2 == 0 && rid == rids[d->value] && owner.getornull(rid) == d;
+		visited++;
+	}
+	ok = ok && visited == 50;
+
+	OS::get_singleton()->print("Iterating slots visits every owned object once: %s\n", ok ? "yes" : "no");
+
+	for (int i = 0; i < 100; i += 2) {
+		owner.free(rids[i]);
+		memdelete(datas[i]);
+	}
+
+	const int thread_count = 4;
+	ThreadData td[thread_count];
+	Thread *threads[thread_count];
+
+	for (int i = 0; i < thread_count; i++) {
+		td[i].owner = &owner;
+		td[i].iterations = 20000;
+		td[i].ok = true;
+		threads[i] = Thread::create(thread_func, &td[i]);
+	}
+
+	// Iterating while the threads make and free RIDs must only return live slots.
+	ok = true;
+	for (int i = 0; i < 100; i++) {
+		visit_slots(owner, &ok);
+	}
+
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+		ok = ok && td[i].ok;
+	}
+
+	List<RID> owned;
+	owner.get_owned_list(&owned);
+	ok = ok && owned.size() == 0 && owner.get_owned_count() == 0 && visit_slots(owner, &ok) == 0;
+
+	OS::get_singleton()->print("RIDs made and freed from %d threads stay consistent: %s\n", thread_count, ok ? "yes" : "no");
+
+	return NULL;
+}
+} // namespace TestRID
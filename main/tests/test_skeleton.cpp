@@ -0,0 +1,153 @@
+/*************************************************************************/
+/*  test_skeleton.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_skeleton.h"
+
+#include "core/os/os.h"
+#include "scene/3d/skeleton.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/viewport.h"
+
+namespace TestSkeleton {
+
+enum {
+	BONE_ROOT,
+	BONE_ARM,
+	BONE_HAND,
+	BONE_LEG,
+	BONE_MAX
+};
+
+class TestMainLoop : public SceneTree {
+
+	Skeleton *skeleton;
+	Spatial *attachments[BONE_MAX];
+
+	// Bound nodes are only moved when their bone is recomputed, so a node
+	// that still holds this transform afterwards belongs to a bone that was skipped.
+	Transform marker;
+
+	void _create_skeleton() {
+
+		skeleton = memnew(Skeleton);
+		get_root()->add_child(skeleton);
+
+		const char *names[BONE_MAX] = { "root", "arm", "hand", "leg" };
+		const int parents[BONE_MAX] = { -1, BONE_ROOT, BONE_ARM, BONE_ROOT };
+
+		for (int i = 0; i < BONE_MAX; i++) {
+
+			skeleton->add_bone(names[i]);
+			skeleton->set_bone_parent(i, parents[i]);
+			skeleton->set_bone_rest(i, Transform(Basis(Vector3(0, 0, 1), i * 0.25), Vector3(0, 1, 0)));
+
+			attachments[i] = memnew(Spatial);
+			skeleton->add_child(attachments[i]);
+			skeleton->bind_child_node_to_bone(i, attachments[i]);
+		}
+
+		marker = Transform(Basis(), Vector3(100, 100, 100));
+	}
+
+	void _mark_attachments() {
+
+		for (int i = 0; i < BONE_MAX; i++) {
+			attachments[i]->set_transform(marker);
+		}
+	}
+
+	bool _is_recomputed(int p_bone) const {
+
+		return attachments[p_bone]->get_transform() == skeleton->get_bone_global_pose(p_bone);
+	}
+
+	bool _is_equal(const Transform &p_a, const Transform &p_b) const {
+
+		return p_a.basis.is_equal_approx(p_a.basis, p_b.basis) && p_a.origin.distance_to(p_b.origin) < CMP_EPSILON;
+	}
+
+	bool _test_pose_chain() {
+
+		skeleton->get_bone_global_pose(BONE_ROOT);
+		_mark_attachments();
+
+		Transform pose(Basis(Vector3(1, 0, 0), Math_PI * 0.5), Vector3(0, 0.5, 0));
+		skeleton->set_bone_pose(BONE_ARM, pose);
+
+		Transform root = skeleton->get_bone_rest(BONE_ROOT);
+		Transform arm = root * (skeleton->get_bone_rest(BONE_ARM) * pose);
+		Transform hand = arm * skeleton->get_bone_rest(BONE_HAND);
+
+		bool ok = _is_equal(skeleton->get_bone_global_pose(BONE_HAND), hand);
+		ok = ok && _is_equal(skeleton->get_bone_global_pose(BONE_ARM), arm);
+		ok = ok && _is_recomputed(BONE_ARM) && _is_recomputed(BONE_HAND);
+		ok = ok && attachments[BONE_ROOT]->get_transform() == marker && attachments[BONE_LEG]->get_transform() == marker;
+
+		OS::get_singleton()->print("Posing a bone recomputes its descendants only: %s\n", ok ? "passed" : "failed");
+		return ok;
+	}
+
+	bool _test_rest_rebuild() {
+
+		_mark_attachments();
+		skeleton->set_bone_rest(BONE_LEG, Transform(Basis(), Vector3(0, -1, 0)));
+		skeleton->get_bone_global_pose(BONE_LEG);
+
+		bool ok = true;
+		for (int i = 0; i < BONE_MAX; i++) {
+			ok = ok && _is_recomputed(i);
+		}
+
+		OS::get_singleton()->print("Changing a rest recomputes every bone: %s\n", ok ? "passed" : "failed");
+		return ok;
+	}
+
+public:
+	virtual void init() {
+
+		SceneTree::init();
+
+		_create_skeleton();
+
+		bool ok = _test_pose_chain();
+		ok = _test_rest_rebuild() && ok;
+
+		OS::get_singleton()->print("Skeleton dirty chain: %s\n", ok ? "passed" : "failed");
+
+		memdelete(skeleton);
+		quit();
+	}
+};
+
+MainLoop *test() {
+
+	return memnew(TestMainLoop);
+}
+} // namespace TestSkeleton
@@ -0,0 +1,148 @@
+/*************************************************************************/
+/*  test_tcp_server.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_tcp_server.h"
+
+#include "core/io/tcp_server.h"
+#include "core/os/os.h"
+#include "drivers/unix/net_socket_posix.h"
+
+namespace TestTCPServer {
+
+enum {
+	PEER_COUNT = 3,
+	TIMEOUT_USEC = 2000000
+};
+
+// Polls until some connections are ready, or the timeout passes.
+static Array wait_ready(Ref<TCP_Server> &p_server) {
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	while (OS::get_singleton()->get_ticks_usec() - begin < TIMEOUT_USEC) {
+		p_server->poll(10);
+		if (p_server->get_ready_connections().size())
+			break;
+	}
+	return p_server->get_ready_connections();
+}
+
+static String read_all(Ref<StreamPeerTCP> &p_peer) {
+
+	int available = p_peer->get_available_bytes();
+	if (available <= 0)
+		return String();
+
+	Vector<uint8_t> data;
+	data.resize(available);
+	p_peer->get_data(data.ptrw(), available);
+
+	String s;
+	s.parse_utf8((const char *)data.ptr(), available);
+	return s;
+}
+
+static bool run(const char *p_name, int p_port) {
+
+	Ref<TCP_Server> server;
+	server.instance();
+	server->set_watch_connections(true);
+	if (server->listen(p_port, IP_Address("127.0.0.1")) != OK) {
+		OS::get_singleton()->print("Unable to listen on port %i.\n", p_port);
+		return false;
+	}
+
+	Ref<StreamPeerTCP> clients[PEER_COUNT];
+	Ref<StreamPeerTCP> accepted[PEER_COUNT];
+	for (int i = 0; i < PEER_COUNT; i++) {
+		clients[i].instance();
+		clients[i]->connect_to_host(IP_Address("127.0.0.1"), p_port);
+	}
+
+	int accepted_count = 0;
+	bool connected = false;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	while (!connected && OS::get_singleton()->get_ticks_usec() - begin < TIMEOUT_USEC) {
+
+		while (accepted_count < PEER_COUNT && server->is_connection_available()) {
+			accepted[accepted_count++] = server->take_connection();
+		}
+
+		connected = accepted_count == PEER_COUNT;
+		for (int i = 0; i < PEER_COUNT; i++) {
+			connected = connected && clients[i]->get_status() == StreamPeerTCP::STATUS_CONNECTED;
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+
+	bool ok = connected && server->poll(0) == OK && server->get_ready_connections().size() == 0;
+
+	// Only the peer that was written to is reported, and it's reported until it's read.
+	const char *message = "second";
+	clients[1]->put_data((const uint8_t *)message, strlen(message));
+
+	Array ready = wait_ready(server);
+	ok = ok && ready.size() == 1;
+	Ref<StreamPeerTCP> peer = ok ? Ref<StreamPeerTCP>(ready[0]) : Ref<StreamPeerTCP>();
+	ok = ok && peer.is_valid() && read_all(peer) == message;
+	for (int i = 0; ok && i < PEER_COUNT; i++) {
+		ok = accepted[i] == peer || accepted[i]->get_available_bytes() == 0;
+	}
+	ok = ok && server->poll(0) == OK && server->get_ready_connections().size() == 0;
+
+	// Closed peers are reported too, so they can be dropped.
+	clients[2]->disconnect_from_host();
+	ready = wait_ready(server);
+	ok = ok && ready.size() == 1 && Ref<StreamPeerTCP>(ready[0]) != peer;
+
+	OS::get_singleton()->print("%s: ready connections reported: %s\n", p_name, ok ? "OK" : "FAIL");
+
+	for (int i = 0; i < PEER_COUNT; i++) {
+		clients[i]->disconnect_from_host();
+		if (accepted[i].is_valid()) {
+			accepted[i]->disconnect_from_host();
+		}
+	}
+	server->stop();
+	return ok;
+}
+
+MainLoop *test() {
+
+	// The set used by a server is chosen when watching is enabled.
+	bool ok = run("Default", 9392);
+
+	NetSocketSetPosix::make_default(true);
+	ok = run("poll() fallback", 9393) && ok;
+	NetSocketSetPosix::make_default();
+
+	OS::get_singleton()->print("TCP_Server test %s\n", ok ? "passed" : "FAILED");
+	return NULL;
+}
+} // namespace TestTCPServer
@@ -0,0 +1,197 @@
+/*************************************************************************/
+/*  test_websocket.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_websocket.h"
+
+#include "core/class_db.h"
+#include "core/io/networked_multiplayer_peer.h"
+#include "core/os/os.h"
+
+// Local load harness for the WebSocket server. The module is driven through ClassDB,
+// so this test builds even when the module is disabled.
+// Usage: --test websocket [--clients N] [--messages N] [--size BYTES] [--port PORT]
+
+namespace TestWebSocket {
+
+static int _get_arg(const String &p_name, int p_default) {
+
+	List<String> args = OS::get_singleton()->get_cmdline_args();
+	for (List<String>::Element *E = args.front(); E; E = E->next()) {
+		if (E->get() == p_name && E->next())
+			return E->next()->get().to_int();
+	}
+	return p_default;
+}
+
+static Ref<NetworkedMultiplayerPeer> _instance(const StringName &p_class) {
+
+	return Ref<NetworkedMultiplayerPeer>(Object::cast_to<NetworkedMultiplayerPeer>(ClassDB::instance(p_class)));
+}
+
+static void _poll_all(Ref<NetworkedMultiplayerPeer> &p_server, Vector<Ref<NetworkedMultiplayerPeer> > &p_clients) {
+
+	p_server->poll();
+	for (int i = 0; i < p_clients.size(); i++) {
+		p_clients.write[i]->poll();
+	}
+}
+
+static PoolVector<uint8_t> _make_payload(int p_size) {
+
+	PoolVector<uint8_t> payload;
+	payload.resize(p_size);
+	PoolVector<uint8_t>::Write w = payload.write();
+	for (int i = 0; i < p_size; i++) {
+		w[i] = i & 0xFF;
+	}
+	return payload;
+}
+
+// Services until every peer received p_expected messages in total, or the timeout.
+static int _receive_all(Ref<NetworkedMultiplayerPeer> &p_server, Vector<Ref<NetworkedMultiplayerPeer> > &p_clients, Vector<Ref<PacketPeer> > &p_peers, int p_expected, int p_size, uint64_t p_timeout, int &r_corrupt) {
+
+	int received = 0;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	while (received < p_expected && OS::get_singleton()->get_ticks_usec() - begin < p_timeout) {
+		_poll_all(p_server, p_clients);
+		for (int i = 0; i < p_peers.size(); i++) {
+			while (p_peers.write[i]->get_available_packet_count() > 0) {
+				const uint8_t *buffer;
+				int size;
+				if (p_peers.write[i]->get_packet(&buffer, size) != OK)
+					break;
+				if (size != p_size || (size > 1 && buffer[size - 1] != ((size - 1) & 0xFF)))
+					r_corrupt++;
+				received++;
+			}
+		}
+	}
+
+	return received;
+}
+
+MainLoop *test() {
+
+	if (!ClassDB::class_exists("WebSocketServer")) {
+		OS::get_singleton()->print("WebSocket module not available, skipping.\n");
+		return NULL;
+	}
+
+	int client_count = _get_arg("--clients", 100);
+	int message_count = _get_arg("--messages", 100);
+	int message_size = _get_arg("--size", 256);
+	int port = _get_arg("--port", 9380);
+	const uint64_t timeout = 30000000;
+
+	Ref<NetworkedMultiplayerPeer> server = _instance("WebSocketServer");
+	ERR_FAIL_COND_V(server.is_null(), NULL);
+
+	Error err = (Error)(int)server->call("listen", port);
+	if (err != OK) {
+		OS::get_singleton()->print("Unable to listen on port %i.\n", port);
+		return NULL;
+	}
+
+	OS::get_singleton()->print("Connecting %i clients...\n", client_count);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	String url = "ws://127.0.0.1:" + itos(port);
+	Vector<Ref<NetworkedMultiplayerPeer> > clients;
+	for (int i = 0; i < client_count; i++) {
+		Ref<NetworkedMultiplayerPeer> client = _instance("WebSocketClient");
+		ERR_FAIL_COND_V(client.is_null(), NULL);
+		client->call("connect_to_url", url);
+		clients.push_back(client);
+	}
+
+	int connected = 0;
+	while (connected < client_count && OS::get_singleton()->get_ticks_usec() - begin < timeout) {
+		_poll_all(server, clients);
+		connected = 0;
+		for (int i = 0; i < client_count; i++) {
+			if (clients.write[i]->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_CONNECTED)
+				connected++;
+		}
+	}
+
+	uint64_t connect_time = OS::get_singleton()->get_ticks_usec() - begin;
+	OS::get_singleton()->print("%i/%i clients connected in %i ms.\n", connected, client_count, int(connect_time / 1000));
+
+	Vector<Ref<PacketPeer> > peers;
+	for (int i = 0; i < client_count; i++) {
+		if (clients.write[i]->get_connection_status() == NetworkedMultiplayerPeer::CONNECTION_CONNECTED)
+			peers.push_back(Ref<PacketPeer>(Object::cast_to<PacketPeer>(clients.write[i]->call("get_peer", 1))));
+	}
+
+	PoolVector<uint8_t> payload = _make_payload(message_size);
+
+	// Broadcast everything at once, then service until every client received every message.
+	int expected = peers.size() * message_count;
+	int corrupt = 0;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < message_count; i++) {
+		server->call("broadcast_packet", payload);
+	}
+
+	int received = _receive_all(server, clients, peers, expected, message_size, timeout, corrupt);
+
+	uint64_t broadcast_time = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+	double seconds = broadcast_time / 1000000.0;
+
+	OS::get_singleton()->print("Delivered %i/%i messages of %i bytes in %i ms (%i corrupt).\n", received, expected, message_size, int(broadcast_time / 1000), corrupt);
+	OS::get_singleton()->print("%.0f messages/s, %.2f MB/s.\n", received / seconds, (double)received * message_size / seconds / (1024 * 1024));
+
+	// Once the queue is drained the last packet read must not hold space in the input buffer,
+	// so two messages of three quarters of it each have to arrive one after the other.
+	if (peers.size()) {
+		int large_size = peers.write[0]->get_max_packet_size() * 3 / 4;
+		PoolVector<uint8_t> large = _make_payload(large_size);
+		int large_received = 0;
+		int large_corrupt = 0;
+		for (int i = 0; i < 2; i++) {
+			server->call("broadcast_packet", large);
+			large_received += _receive_all(server, clients, peers, peers.size(), large_size, timeout, large_corrupt);
+		}
+		OS::get_singleton()->print("Large messages after draining: %i/%i of %i bytes delivered (%i corrupt).\n", large_received, peers.size() * 2, large_size, large_corrupt);
+	}
+
+	for (int i = 0; i < clients.size(); i++) {
+		clients.write[i]->call("disconnect_from_host");
+	}
+	_poll_all(server, clients);
+	server->call("stop");
+
+	return NULL;
+}
+} // namespace TestWebSocket
@@ -49,6 +49,8 @@ class BulletPhysicsServer : public PhysicsServer {
 
 	friend class BulletPhysicsDirectSpaceState;
 
+	static BulletPhysicsServer *singleton;
+
 	bool active;
 	char active_spaces_count;
 	Vector<SpaceBullet *> active_spaces;
@@ -189,8 +191,8 @@ public:
 	virtual void body_clear_shapes(RID p_body);
 
 	// Used for Rigid and Soft Bodies
-	virtual void body_attach_object_instance_id(RID p_body, uint32_t p_ID);
-	virtual uint32_t body_get_object_instance_id(RID p_body) const;
+	virtual void body_attach_object_instance_id(RID p_body, ObjectID p_ID);
+	virtual ObjectID body_get_object_instance_id(RID p_body) const;
 
 	virtual void body_set_enable_continuous_collision_detection(RID p_body, bool p_enable);
 	virtual bool body_is_continuous_collision_detection_enabled(RID p_body) const;
@@ -387,7 +389,7 @@ public:
 	}
 
 	static bool singleton_isActive() {
-		return static_cast<BulletPhysicsServer *>(get_singleton())->active;
+		return singleton->active;
 	}
 
 	bool isActive() {
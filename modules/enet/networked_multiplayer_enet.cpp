@@ -106,6 +106,8 @@ Error NetworkedMultiplayerENet::create_server(int p_port, int p_max_clients, int
 	ERR_FAIL_COND_V(!host, ERR_CANT_CREATE);
 
 	_setup_compressor();
+	_clear_batches();
+	batches.resize(channel_count);
 	active = true;
 	server = true;
 	refuse_connections = false;
@@ -157,6 +159,8 @@ Error NetworkedMultiplayerENet::create_client(const String &p_address, int p_por
 	ERR_FAIL_COND_V(!host, ERR_CANT_CREATE);
 
 	_setup_compressor();
+	_clear_batches();
+	batches.resize(channel_count);
 
 	IP_Address ip;
 	if (p_address.is_valid_ip_address()) {
@@ -206,6 +210,11 @@ void NetworkedMultiplayerENet::poll() {
 
 	_pop_current_packet();
 
+	// Packets put since the last poll go out together.
+	if (batching) {
+		flush();
+	}
+
 	ENetEvent event;
 	/* Keep servicing until there are no available events left in queue. */
 	while (true) {
@@ -364,35 +373,17 @@ void NetworkedMultiplayerENet::poll() {
 						if (target == 0) {
 							// Re-send to everyone but sender :|
 
-							incoming_packets.push_back(packet);
-							// And make copies for sending
-							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
-
-								if (uint32_t(E->key()) == source) // Do not resend to self
-									continue;
-
-								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
-
-								enet_peer_send(E->get(), event.channelID, packet2);
-							}
+							_relay_packet(source, 0, event.channelID, packet.packet, flags);
+							_queue_incoming(packet, flags);
 
 						} else if (target < 0) {
 							// To all but one
 
-							// And make copies for sending
-							for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
-
-								if (uint32_t(E->key()) == source || E->key() == -target) // Do not resend to self, also do not send to excluded
-									continue;
-
-								ENetPacket *packet2 = enet_packet_create(packet.packet->data, packet.packet->dataLength, flags);
-
-								enet_peer_send(E->get(), event.channelID, packet2);
-							}
+							_relay_packet(source, -target, event.channelID, packet.packet, flags);
 
 							if (-target != 1) {
 								// Server is not excluded
-								incoming_packets.push_back(packet);
+								_queue_incoming(packet, flags);
 							} else {
 								// Server is excluded, erase packet
 								enet_packet_destroy(packet.packet);
@@ -400,7 +391,7 @@ void NetworkedMultiplayerENet::poll() {
 
 						} else if (target == 1) {
 							// To myself and only myself
-							incoming_packets.push_back(packet);
+							_queue_incoming(packet, flags);
 						} else {
 							// To someone else, specifically
 							ERR_CONTINUE(!peer_map.has(target));
@@ -408,7 +399,7 @@ void NetworkedMultiplayerENet::poll() {
 						}
 					} else {
 
-						incoming_packets.push_back(packet);
+						_queue_incoming(packet, flags);
 					}
 
 					// Destroy packet later
@@ -435,6 +426,7 @@ void NetworkedMultiplayerENet::close_connection(uint32_t wait_usec) {
 	ERR_FAIL_COND(!active);
 
 	_pop_current_packet();
+	_clear_batches();
 
 	bool peers_disconnected = false;
 	for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
@@ -454,7 +446,11 @@ void NetworkedMultiplayerENet::close_connection(uint32_t wait_usec) {
 
 	enet_host_destroy(host);
 	active = false;
-	incoming_packets.clear();
+	while (incoming_packets.size()) {
+		current_packet = incoming_packets.front()->get();
+		incoming_packets.pop_front();
+		_pop_current_packet();
+	}
 	unique_id = 1; // Server is 1
 	connection_status = CONNECTION_DISCONNECTED;
 }
@@ -503,8 +499,8 @@ Error NetworkedMultiplayerENet::get_packet(const uint8_t **r_buffer, int &r_buff
 	current_packet = incoming_packets.front()->get();
 	incoming_packets.pop_front();
 
-	*r_buffer = (const uint8_t *)(&current_packet.packet->data[12]);
-	r_buffer_size = current_packet.packet->dataLength - 12;
+	*r_buffer = (const uint8_t *)(&current_packet.packet->data[current_packet.offset]);
+	r_buffer_size = current_packet.size;
 
 	return OK;
 }
@@ -549,45 +545,196 @@ Error NetworkedMultiplayerENet::put_packet(const uint8_t *p_buffer, int p_buffer
 		}
 	}
 
+	if (batching && p_buffer_size + 2 <= batch_size - 12 && channel < batches.size()) {
+
+		Batch &batch = batches.write[channel];
+		if (batch.packet && (batch.target != target_peer || batch.flags != packet_flags || batch.size + 2 + p_buffer_size > batch_size)) {
+			// Keep the order of the channel, the open batch goes first.
+			_flush_batch(channel);
+		}
+
+		if (!batch.packet) {
+			// Written in place, the packet is only shrunk to its final size when sent.
+			batch.packet = enet_packet_create(NULL, batch_size, packet_flags);
+			batch.target = target_peer;
+			batch.flags = packet_flags;
+			batch.size = 12;
+			batch.count = 0;
+			encode_uint32(unique_id, &batch.packet->data[0]); // Source ID
+			encode_uint32(target_peer, &batch.packet->data[4]); // Dest ID
+			encode_uint32(packet_flags | SYSFLAG_BATCH, &batch.packet->data[8]); // Flags
+		}
+
+		encode_uint16(p_buffer_size, &batch.packet->data[batch.size]);
+		copymem(&batch.packet->data[batch.size + 2], p_buffer, p_buffer_size);
+		batch.size += 2 + p_buffer_size;
+		batch.count++;
+
+		return OK;
+	}
+
+	if (batching) {
+		// Too big to batch, but it must not overtake what is waiting on its channel.
+		_flush_batch(channel);
+	}
+
 	ENetPacket *packet = enet_packet_create(NULL, p_buffer_size + 12, packet_flags);
 	encode_uint32(unique_id, &packet->data[0]); // Source ID
 	encode_uint32(target_peer, &packet->data[4]); // Dest ID
-	encode_uint32(packet_flags, &packet->data[8]); // Dest ID
+	encode_uint32(packet_flags, &packet->data[8]); // Flags
 	copymem(&packet->data[12], p_buffer, p_buffer_size);
 
+	_send_packet(target_peer, channel, packet);
+
+	if (!batching) {
+		enet_host_flush(host);
+	}
+
+	return OK;
+}
+
+void NetworkedMultiplayerENet::_send_packet(int p_target, int p_channel, ENetPacket *p_packet) {
+
 	if (server) {
 
-		if (target_peer == 0) {
-			enet_host_broadcast(host, channel, packet);
-		} else if (target_peer < 0) {
-			// Send to all but one
-			// and make copies for sending
+		if (p_target == 0) {
+			enet_host_broadcast(host, p_channel, p_packet);
+		} else if (p_target < 0) {
+			// Send to all but one, every peer references the same packet.
 
-			int exclude = -target_peer;
+			int exclude = -p_target;
 
 			for (Map<int, ENetPeer *>::Element *F = peer_map.front(); F; F = F->next()) {
 
 				if (F->key() == exclude) // Exclude packet
 					continue;
 
-				ENetPacket *packet2 = enet_packet_create(packet->data, packet->dataLength, packet_flags);
-
-				enet_peer_send(F->get(), channel, packet2);
+				enet_peer_send(F->get(), p_channel, p_packet);
 			}
 
-			enet_packet_destroy(packet); // Original packet no longer needed
+			if (p_packet->referenceCount == 0) {
+				enet_packet_destroy(p_packet); // Nobody to send to
+			}
 		} else {
-			enet_peer_send(E->get(), channel, packet);
+			Map<int, ENetPeer *>::Element *E = peer_map.find(p_target);
+			if (!E) {
+				// Disconnected since the packet was batched.
+				enet_packet_destroy(p_packet);
+				return;
+			}
+			enet_peer_send(E->get(), p_channel, p_packet);
 		}
 	} else {
 
-		ERR_FAIL_COND_V(!peer_map.has(1), ERR_BUG);
-		enet_peer_send(peer_map[1], channel, packet); // Send to server for broadcast
+		Map<int, ENetPeer *>::Element *E = peer_map.find(1);
+		if (!E || !E->get()) {
+			enet_packet_destroy(p_packet);
+			ERR_FAIL();
+		}
+		enet_peer_send(E->get(), p_channel, p_packet); // Send to server for broadcast
 	}
+}
 
-	enet_host_flush(host);
+void NetworkedMultiplayerENet::_relay_packet(int p_source, int p_exclude, int p_channel, const ENetPacket *p_packet, uint32_t p_flags) {
 
-	return OK;
+	// One copy is shared by all the peers it is relayed to.
+	ENetPacket *relay = NULL;
+
+	for (Map<int, ENetPeer *>::Element *E = peer_map.front(); E; E = E->next()) {
+
+		if (E->key() == p_source || E->key() == p_exclude) // Do not resend to self, also do not send to excluded
+			continue;
+
+		if (!relay) {
+			relay = enet_packet_create(p_packet->data, p_packet->dataLength, p_flags & ~SYSFLAG_BATCH);
+		}
+		enet_peer_send(E->get(), p_channel, relay);
+	}
+
+	if (relay && relay->referenceCount == 0) {
+		enet_packet_destroy(relay);
+	}
+}
+
+void NetworkedMultiplayerENet::_queue_incoming(const Packet &p_packet, uint32_t p_flags) {
+
+	Packet packet = p_packet;
+
+	if (!(p_flags & SYSFLAG_BATCH)) {
+		packet.offset = 12;
+		packet.size = packet.packet->dataLength - 12;
+		packet.packet->referenceCount = 1;
+		incoming_packets.push_back(packet);
+		return;
+	}
+
+	// Every packet in the batch points into it, the batch is destroyed with the last one.
+	int ofs = 12;
+	int len = packet.packet->dataLength;
+	packet.packet->referenceCount = 0;
+
+	while (ofs + 2 <= len) {
+
+		int size = decode_uint16(&packet.packet->data[ofs]);
+		ofs += 2;
+		if (ofs + size > len) {
+			ERR_PRINT("Invalid batch received. Size smaller than declared.");
+			break;
+		}
+
+		packet.offset = ofs;
+		packet.size = size;
+		packet.packet->referenceCount++;
+		incoming_packets.push_back(packet);
+		ofs += size;
+	}
+
+	if (packet.packet->referenceCount == 0) {
+		enet_packet_destroy(packet.packet);
+	}
+}
+
+void NetworkedMultiplayerENet::_flush_batch(int p_channel) {
+
+	Batch &batch = batches.write[p_channel];
+	if (!batch.packet)
+		return;
+
+	ENetPacket *packet = batch.packet;
+	batch.packet = NULL;
+
+	if (batch.count == 1) {
+		// Send a lone packet as a regular one, without the size prefix.
+		int size = batch.size - 12 - 2;
+		encode_uint32(batch.flags, &packet->data[8]);
+		memmove(&packet->data[12], &packet->data[14], size);
+		enet_packet_resize(packet, 12 + size);
+	} else {
+		enet_packet_resize(packet, batch.size);
+	}
+
+	_send_packet(batch.target, p_channel, packet);
+}
+
+void NetworkedMultiplayerENet::_clear_batches() {
+
+	for (int i = 0; i < batches.size(); i++) {
+		if (batches[i].packet) {
+			enet_packet_destroy(batches[i].packet);
+		}
+	}
+	batches.clear();
+}
+
+void NetworkedMultiplayerENet::flush() {
+
+	ERR_FAIL_COND(!active);
+
+	for (int i = 0; i < batches.size(); i++) {
+		_flush_batch(i);
+	}
+
+	enet_host_flush(host);
 }
 
 int NetworkedMultiplayerENet::get_max_packet_size() const {
@@ -598,7 +745,10 @@ int NetworkedMultiplayerENet::get_max_packet_size() const {
 void NetworkedMultiplayerENet::_pop_current_packet() {
 
 	if (current_packet.packet) {
-		enet_packet_destroy(current_packet.packet);
+		// Batched packets share their ENet packet.
+		if (--current_packet.packet->referenceCount == 0) {
+			enet_packet_destroy(current_packet.packet);
+		}
 		current_packet.packet = NULL;
 		current_packet.from = 0;
 		current_packet.channel = -1;
@@ -823,6 +973,31 @@ bool NetworkedMultiplayerENet::is_always_ordered() const {
 	return always_ordered;
 }
 
+void NetworkedMultiplayerENet::set_batching_enabled(bool p_enabled) {
+
+	if (!p_enabled && active) {
+		flush();
+	}
+	batching = p_enabled;
+}
+
+bool NetworkedMultiplayerENet::is_batching_enabled() const {
+	return batching;
+}
+
+void NetworkedMultiplayerENet::set_batch_size(int p_size) {
+
+	ERR_FAIL_COND(p_size < 64 || p_size > 65535);
+	if (active) {
+		flush();
+	}
+	batch_size = p_size;
+}
+
+int NetworkedMultiplayerENet::get_batch_size() const {
+	return batch_size;
+}
+
 void NetworkedMultiplayerENet::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("create_server", "port", "max_clients", "in_bandwidth", "out_bandwidth"), &NetworkedMultiplayerENet::create_server, DEFVAL(32), DEFVAL(0), DEFVAL(0));
@@ -843,11 +1018,18 @@ void NetworkedMultiplayerENet::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_channel_count"), &NetworkedMultiplayerENet::get_channel_count);
 	ClassDB::bind_method(D_METHOD("set_always_ordered", "ordered"), &NetworkedMultiplayerENet::set_always_ordered);
 	ClassDB::bind_method(D_METHOD("is_always_ordered"), &NetworkedMultiplayerENet::is_always_ordered);
+	ClassDB::bind_method(D_METHOD("set_batching_enabled", "enabled"), &NetworkedMultiplayerENet::set_batching_enabled);
+	ClassDB::bind_method(D_METHOD("is_batching_enabled"), &NetworkedMultiplayerENet::is_batching_enabled);
+	ClassDB::bind_method(D_METHOD("set_batch_size", "size"), &NetworkedMultiplayerENet::set_batch_size);
+	ClassDB::bind_method(D_METHOD("get_batch_size"), &NetworkedMultiplayerENet::get_batch_size);
+	ClassDB::bind_method(D_METHOD("flush"), &NetworkedMultiplayerENet::flush);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "compression_mode", PROPERTY_HINT_ENUM, "None,Range Coder,FastLZ,ZLib,ZStd"), "set_compression_mode", "get_compression_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "transfer_channel"), "set_transfer_channel", "get_transfer_channel");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "channel_count"), "set_channel_count", "get_channel_count");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "always_ordered"), "set_always_ordered", "is_always_ordered");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batching_enabled"), "set_batching_enabled", "is_batching_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "batch_size", PROPERTY_HINT_RANGE, "64,65535,1"), "set_batch_size", "get_batch_size");
 
 	BIND_ENUM_CONSTANT(COMPRESS_NONE);
 	BIND_ENUM_CONSTANT(COMPRESS_RANGE_CODER);
@@ -868,6 +1050,8 @@ NetworkedMultiplayerENet::NetworkedMultiplayerENet() {
 	channel_count = SYSCH_MAX;
 	transfer_channel = -1;
 	always_ordered = false;
+	batching = false;
+	batch_size = 1200;
 	connection_status = CONNECTION_DISCONNECTED;
 	compression_mode = COMPRESS_NONE;
 	enet_compressor.context = this;
@@ -61,6 +61,10 @@ private:
 		SYSCH_MAX
 	};
 
+	enum {
+		SYSFLAG_BATCH = 1 << 16 // Stored with the ENet packet flags in the header, the payload holds several size prefixed packets.
+	};
+
 	bool active;
 	bool server;
 
@@ -87,8 +91,32 @@ private:
 		ENetPacket *packet;
 		int from;
 		int channel;
+		int offset;
+		int size;
 	};
 
+	// Packets put on a channel are appended here until the target or flags change, the batch is full or it's flushed.
+	struct Batch {
+
+		ENetPacket *packet;
+		int target;
+		int flags;
+		int size;
+		int count;
+
+		Batch() {
+			packet = NULL;
+			target = 0;
+			flags = 0;
+			size = 0;
+			count = 0;
+		}
+	};
+
+	bool batching;
+	int batch_size;
+	Vector<Batch> batches;
+
 	CompressionMode compression_mode;
 
 	List<Packet> incoming_packets;
@@ -97,6 +125,11 @@ private:
 
 	uint32_t _gen_unique_id() const;
 	void _pop_current_packet();
+	void _queue_incoming(const Packet &p_packet, uint32_t p_flags);
+	void _send_packet(int p_target, int p_channel, ENetPacket *p_packet);
+	void _relay_packet(int p_source, int p_exclude, int p_channel, const ENetPacket *p_packet, uint32_t p_flags);
+	void _flush_batch(int p_channel);
+	void _clear_batches();
 
 	Vector<uint8_t> src_compressor_mem;
 	Vector<uint8_t> dst_compressor_mem;
@@ -157,6 +190,12 @@ public:
 	int get_channel_count() const;
 	void set_always_ordered(bool p_ordered);
 	bool is_always_ordered() const;
+	void set_batching_enabled(bool p_enabled);
+	bool is_batching_enabled() const;
+	void set_batch_size(int p_size);
+	int get_batch_size() const;
+
+	void flush();
 
 	NetworkedMultiplayerENet();
 	~NetworkedMultiplayerENet();
@@ -42,12 +42,30 @@
 
 #include "drivers/unix/net_socket_posix.h"
 
+LWSSharedPacket *LWSSharedPacket::create(const uint8_t *p_buffer, int p_size) {
+
+	LWSSharedPacket *packet = (LWSSharedPacket *)memalloc(sizeof(LWSSharedPacket) + LWS_PRE + p_size);
+	ERR_FAIL_COND_V(!packet, NULL);
+	packet->refcount.init();
+	packet->size = p_size;
+	if (p_size > 0)
+		copymem(packet->get_payload(), p_buffer, p_size);
+	return packet;
+}
+
+void LWSSharedPacket::unreference() {
+
+	if (refcount.unref())
+		memfree(this);
+}
+
 void LWSPeer::set_wsi(struct lws *p_wsi, unsigned int p_in_buf_size, unsigned int p_in_pkt_size, unsigned int p_out_buf_size, unsigned int p_out_pkt_size) {
 	ERR_FAIL_COND(wsi != NULL);
 
 	_in_buffer.resize(p_in_pkt_size, p_in_buf_size);
 	_out_buffer.resize(p_out_pkt_size, p_out_buf_size);
-	_packet_buffer.resize((1 << MAX(p_in_buf_size, p_out_buf_size)) + LWS_PRE);
+	// The packet buffer is grown on demand, most packets are read in place from the input ring.
+	_max_packet_size = 1 << MAX(p_in_buf_size, p_out_buf_size);
 	wsi = p_wsi;
 };
 
@@ -63,6 +81,9 @@ Error LWSPeer::read_wsi(void *in, size_t len) {
 
 	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
 
+	// Data is received while polling, which invalidates the last packet returned by get_packet.
+	_release_in_pending();
+
 	if (lws_is_first_fragment(wsi))
 		_in_size = 0;
 	else if (_in_size == -1) // Trash this frame
@@ -95,19 +116,25 @@ Error LWSPeer::write_wsi() {
 
 	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
 
-	PoolVector<uint8_t> tmp;
 	int count = _out_buffer.packets_left();
 
 	if (count == 0)
 		return OK;
 
 	int read = 0;
-	uint8_t is_string = 0;
-	PoolVector<uint8_t>::Write rw = _packet_buffer.write();
-	_out_buffer.read_packet(&(rw[LWS_PRE]), _packet_buffer.size() - LWS_PRE, &is_string, read);
-
-	enum lws_write_protocol mode = is_string ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
-	lws_write(wsi, &(rw[LWS_PRE]), read, mode);
+	OutPacket out;
+	uint8_t *buffer = _out_packet_buffer.size() > 0 ? _out_packet_buffer.ptrw() + LWS_PRE : NULL;
+	Error err = _out_buffer.read_packet(buffer, MAX(_out_packet_buffer.size() - LWS_PRE, 0), &out, read);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	enum lws_write_protocol mode = out.is_string ? LWS_WRITE_TEXT : LWS_WRITE_BINARY;
+	if (out.shared) {
+		// lws only writes the frame header in front of the payload, so the same buffer can be sent to every peer.
+		lws_write(wsi, out.shared->get_payload(), out.shared->size, mode);
+		out.shared->unreference();
+	} else {
+		lws_write(wsi, buffer, read, mode);
+	}
 
 	if (count > 1)
 		lws_callback_on_writable(wsi); // we want to write more!
@@ -119,26 +146,69 @@ Error LWSPeer::put_packet(const uint8_t *p_buffer, int p_buffer_size) {
 
 	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
 
-	uint8_t is_string = write_mode == WRITE_MODE_TEXT;
-	_out_buffer.write_packet(p_buffer, p_buffer_size, &is_string);
+	OutPacket out;
+	out.is_string = write_mode == WRITE_MODE_TEXT;
+	out.shared = NULL;
+	Error err = _out_buffer.write_packet(p_buffer, p_buffer_size, &out);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	if (_out_packet_buffer.size() < p_buffer_size + LWS_PRE)
+		_out_packet_buffer.resize(p_buffer_size + LWS_PRE);
+
 	lws_callback_on_writable(wsi); // notify that we want to write
 	return OK;
 };
 
+Error LWSPeer::put_shared_packet(LWSSharedPacket *p_packet) {
+
+	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
+	ERR_FAIL_COND_V(p_packet->size > _max_packet_size, ERR_OUT_OF_MEMORY);
+
+	OutPacket out;
+	out.is_string = write_mode == WRITE_MODE_TEXT;
+	out.shared = p_packet;
+	// Only the packet information is queued, the payload is not copied.
+	Error err = _out_buffer.write_packet(NULL, 0, &out);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	p_packet->reference();
+	lws_callback_on_writable(wsi); // notify that we want to write
+	return OK;
+}
+
+void LWSPeer::_release_in_pending() {
+
+	_in_buffer.release_payload(_in_pending);
+	_in_pending = 0;
+}
+
+void LWSPeer::_clear_out_buffer() {
+
+	OutPacket out;
+	while (_out_buffer.packets_left() > 0) {
+		_out_buffer.skip_packet(&out);
+		if (out.shared)
+			out.shared->unreference();
+	}
+	_out_buffer.clear();
+}
+
 Error LWSPeer::get_packet(const uint8_t **r_buffer, int &r_buffer_size) {
 
 	r_buffer_size = 0;
 
 	ERR_FAIL_COND_V(!is_connected_to_host(), FAILED);
 
+	// The previous packet is no longer referenced by the caller.
+	_release_in_pending();
+
 	if (_in_buffer.packets_left() == 0)
 		return ERR_UNAVAILABLE;
 
 	int read = 0;
-	PoolVector<uint8_t>::Write rw = _packet_buffer.write();
-	_in_buffer.read_packet(rw.ptr(), _packet_buffer.size(), &_is_string, read);
+	Error err = _in_buffer.peek_packet(r_buffer, _packet_buffer, &_is_string, read, _in_pending);
+	ERR_FAIL_COND_V(err != OK, err);
 
-	*r_buffer = rw.ptr();
 	r_buffer_size = read;
 
 	return OK;
@@ -208,10 +278,13 @@ void LWSPeer::close(int p_code, String p_reason) {
 	}
 	wsi = NULL;
 	_in_buffer.clear();
-	_out_buffer.clear();
+	_clear_out_buffer();
 	_in_size = 0;
+	_in_pending = 0;
 	_is_string = 0;
 	_packet_buffer.resize(0);
+	_out_packet_buffer.resize(0);
+	_max_packet_size = 0;
 };
 
 IP_Address LWSPeer::get_connected_host() const {
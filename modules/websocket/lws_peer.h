@@ -36,23 +36,50 @@
 #include "core/error_list.h"
 #include "core/io/packet_peer.h"
 #include "core/ring_buffer.h"
+#include "core/safe_refcount.h"
 #include "libwebsockets.h"
 #include "lws_config.h"
 #include "packet_buffer.h"
 #include "websocket_peer.h"
 
+// A packet serialized once and queued on many peers (see LWSPeer::put_shared_packet).
+// The payload is preceded by LWS_PRE bytes, which lws_write uses for the frame header.
+struct LWSSharedPacket {
+
+	SafeRefCount refcount;
+	int size;
+
+	uint8_t *get_payload() { return (uint8_t *)(this + 1) + LWS_PRE; }
+
+	static LWSSharedPacket *create(const uint8_t *p_buffer, int p_size);
+	void reference() { refcount.ref(); }
+	void unreference();
+};
+
 class LWSPeer : public WebSocketPeer {
 
 	GDCIIMPL(LWSPeer, WebSocketPeer);
 
 private:
+	struct OutPacket {
+		uint8_t is_string;
+		LWSSharedPacket *shared; // NULL if the payload is in _out_buffer.
+	};
+
 	int _in_size;
+	int _in_pending; // Bytes of the last received packet still referenced by get_packet.
 	uint8_t _is_string;
 	// Our packet info is just a boolean (is_string), using uint8_t for it.
 	PacketBuffer<uint8_t> _in_buffer;
-	PacketBuffer<uint8_t> _out_buffer;
+	PacketBuffer<OutPacket> _out_buffer;
+
+	// Both grown on demand: most packets are read in place from the input ring, and broadcasts are not copied.
+	Vector<uint8_t> _packet_buffer;
+	Vector<uint8_t> _out_packet_buffer;
+	int _max_packet_size;
 
-	PoolVector<uint8_t> _packet_buffer;
+	void _release_in_pending();
+	void _clear_out_buffer();
 
 	struct lws *wsi;
 	WriteMode write_mode;
@@ -70,7 +97,7 @@ public:
 	virtual int get_available_packet_count() const;
 	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size);
 	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size);
-	virtual int get_max_packet_size() const { return _packet_buffer.size(); };
+	virtual int get_max_packet_size() const { return _max_packet_size; };
 
 	virtual void close(int p_code = 1000, String p_reason = "");
 	virtual bool is_connected_to_host() const;
@@ -84,6 +111,7 @@ public:
 	void set_wsi(struct lws *wsi, unsigned int _in_buf_size, unsigned int _in_pkt_size, unsigned int _out_buf_size, unsigned int _out_pkt_size);
 	Error read_wsi(void *in, size_t len);
 	Error write_wsi();
+	Error put_shared_packet(LWSSharedPacket *p_packet);
 	void send_close_status(struct lws *wsi);
 	String get_close_reason(void *in, size_t len, int &r_code);
 
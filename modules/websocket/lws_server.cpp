@@ -191,6 +191,26 @@ int LWSServer::get_peer_port(int p_peer_id) const {
 	return _peer_map[p_peer_id]->get_connected_port();
 }
 
+Error LWSServer::_put_packet_to_peers(const uint8_t *p_buffer, int p_buffer_size, const Vector<int32_t> &p_peers) {
+
+	if (p_peers.size() == 0)
+		return OK;
+
+	// Serialize once, every peer queues a reference to the same buffer.
+	LWSSharedPacket *packet = LWSSharedPacket::create(p_buffer, p_buffer_size);
+	ERR_FAIL_COND_V(!packet, ERR_OUT_OF_MEMORY);
+
+	for (int i = 0; i < p_peers.size(); i++) {
+		Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.find(p_peers[i]);
+		if (!E)
+			continue;
+		static_cast<Ref<LWSPeer> >(E->get())->put_shared_packet(packet);
+	}
+
+	packet->unreference();
+	return OK;
+}
+
 void LWSServer::disconnect_peer(int p_peer_id, int p_code, String p_reason) {
 	ERR_FAIL_COND(!has_peer(p_peer_id));
 
@@ -63,6 +63,11 @@ public:
 	void disconnect_peer(int p_peer_id, int p_code = 1000, String p_reason = "");
 	virtual void poll() { _lws_poll(); }
 
+protected:
+	virtual Error _put_packet_to_peers(const uint8_t *p_buffer, int p_buffer_size, const Vector<int32_t> &p_peers);
+
+public:
+
 	LWSServer();
 	~LWSServer();
 };
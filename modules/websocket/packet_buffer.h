@@ -92,8 +92,49 @@ public:
 		return OK;
 	}
 
+	// Reads the next packet without copying its payload when it is contiguous in the ring.
+	// In that case r_payload points inside the buffer, and the space is only freed by release_payload(r_pending).
+	// Otherwise the payload is copied to r_copy, growing it if needed, and r_pending is zero.
+	Error peek_packet(const uint8_t **r_payload, Vector<uint8_t> &r_copy, T *r_info, int &r_read, int &r_pending) {
+		ERR_FAIL_COND_V(_packets.data_left() < 1, ERR_UNAVAILABLE);
+		_Packet p;
+		_packets.read(&p, 1);
+		ERR_FAIL_COND_V(_payload.data_left() < (int)p.size, ERR_BUG);
+
+		r_read = p.size;
+		copymem(r_info, &p.info, sizeof(T));
+
+		const uint8_t *ptr = _payload.contiguous_read_ptr(p.size);
+		if (ptr) {
+			*r_payload = ptr;
+			r_pending = p.size;
+			return OK;
+		}
+
+		if (r_copy.size() < (int)p.size)
+			r_copy.resize(p.size);
+		_payload.read(r_copy.ptrw(), p.size);
+		*r_payload = r_copy.ptr();
+		r_pending = 0;
+		return OK;
+	}
+
+	void release_payload(int p_size) {
+		_payload.advance_read(p_size);
+	}
+
+	// Drops the next packet, returning only its information.
+	Error skip_packet(T *r_info) {
+		ERR_FAIL_COND_V(_packets.data_left() < 1, ERR_UNAVAILABLE);
+		_Packet p;
+		_packets.read(&p, 1);
+		copymem(r_info, &p.info, sizeof(T));
+		_payload.advance_read(p.size);
+		return OK;
+	}
+
 	void discard_payload(int p_size) {
-		_packets.decrease_write(p_size);
+		_payload.decrease_write(p_size);
 	}
 
 	void resize(int p_pkt_shift, int p_buf_shift) {
@@ -248,21 +248,15 @@ Error WebSocketMultiplayerPeer::_server_relay(int32_t p_from, int32_t p_to, cons
 
 		return OK; // Will not send to self
 
-	} else if (p_to == 0) {
-
-		for (Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.front(); E; E = E->next()) {
-			if (E->key() != p_from)
-				E->get()->put_packet(p_buffer, p_buffer_size);
-		}
-		return OK; // Sent to all but sender
-
-	} else if (p_to < 0) {
+	} else if (p_to <= 0) {
 
+		Vector<int32_t> peers;
 		for (Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.front(); E; E = E->next()) {
 			if (E->key() != p_from && E->key() != -p_to)
-				E->get()->put_packet(p_buffer, p_buffer_size);
+				peers.push_back(E->key());
 		}
-		return OK; // Sent to all but sender and excluded
+		_put_packet_to_peers(p_buffer, p_buffer_size, peers);
+		return OK; // Sent to all but sender (and excluded)
 
 	} else {
 
@@ -272,6 +266,16 @@ Error WebSocketMultiplayerPeer::_server_relay(int32_t p_from, int32_t p_to, cons
 	}
 }
 
+Error WebSocketMultiplayerPeer::_put_packet_to_peers(const uint8_t *p_buffer, int p_buffer_size, const Vector<int32_t> &p_peers) {
+
+	for (int i = 0; i < p_peers.size(); i++) {
+		Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.find(p_peers[i]);
+		if (E)
+			E->get()->put_packet(p_buffer, p_buffer_size);
+	}
+	return OK;
+}
+
 void WebSocketMultiplayerPeer::_process_multiplayer(Ref<WebSocketPeer> p_peer, uint32_t p_peer_id) {
 
 	ERR_FAIL_COND(!p_peer.is_valid());
@@ -78,6 +78,9 @@ protected:
 	void _send_del(int32_t p_peer_id);
 	int _gen_unique_id() const;
 
+	// Sends the same packet to many peers, implementations can avoid copying it for each one.
+	virtual Error _put_packet_to_peers(const uint8_t *p_buffer, int p_buffer_size, const Vector<int32_t> &p_peers);
+
 public:
 	/* NetworkedMultiplayerPeer */
 	void set_transfer_mode(TransferMode p_mode);
@@ -48,6 +48,7 @@ void WebSocketServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_peer_address", "id"), &WebSocketServer::get_peer_address);
 	ClassDB::bind_method(D_METHOD("get_peer_port", "id"), &WebSocketServer::get_peer_port);
 	ClassDB::bind_method(D_METHOD("disconnect_peer", "id", "code", "reason"), &WebSocketServer::disconnect_peer, DEFVAL(1000), DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("broadcast_packet", "packet", "peers"), &WebSocketServer::broadcast_packet, DEFVAL(PoolVector<int>()));
 
 	ADD_SIGNAL(MethodInfo("client_close_request", PropertyInfo(Variant::INT, "id"), PropertyInfo(Variant::INT, "code"), PropertyInfo(Variant::STRING, "reason")));
 	ADD_SIGNAL(MethodInfo("client_disconnected", PropertyInfo(Variant::INT, "id"), PropertyInfo(Variant::BOOL, "was_clean_close")));
@@ -62,6 +63,26 @@ NetworkedMultiplayerPeer::ConnectionStatus WebSocketServer::get_connection_statu
 	return CONNECTION_DISCONNECTED;
 };
 
+Error WebSocketServer::broadcast_packet(const PoolVector<uint8_t> &p_packet, const PoolVector<int> &p_peers) {
+
+	ERR_FAIL_COND_V(!is_listening(), ERR_UNCONFIGURED);
+
+	Vector<int32_t> peers;
+	if (p_peers.size() == 0) {
+		for (Map<int, Ref<WebSocketPeer> >::Element *E = _peer_map.front(); E; E = E->next()) {
+			peers.push_back(E->key());
+		}
+	} else {
+		PoolVector<int>::Read r = p_peers.read();
+		for (int i = 0; i < p_peers.size(); i++) {
+			peers.push_back(r[i]);
+		}
+	}
+
+	PoolVector<uint8_t>::Read r = p_packet.read();
+	return _put_packet_to_peers(r.ptr(), p_packet.size(), peers);
+}
+
 bool WebSocketServer::is_server() const {
 
 	return true;
@@ -56,6 +56,7 @@ public:
 	virtual IP_Address get_peer_address(int p_peer_id) const = 0;
 	virtual int get_peer_port(int p_peer_id) const = 0;
 	virtual void disconnect_peer(int p_peer_id, int p_code = 1000, String p_reason = "") = 0;
+	Error broadcast_packet(const PoolVector<uint8_t> &p_packet, const PoolVector<int> &p_peers = PoolVector<int>());
 
 	void _on_peer_packet(int32_t p_peer_id);
 	void _on_connect(int32_t p_peer_id, String p_protocol);
@@ -2104,6 +2104,45 @@ Error OS_Windows::get_dynamic_library_symbol_handle(void *p_library_handle, cons
 	return OK;
 }
 
+Error OS_Windows::map_file(const String &p_path, const uint8_t *&r_data, uint64_t &r_size) {
+
+	HANDLE file = CreateFileW(p_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return ERR_FILE_CANT_OPEN;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 || (uint64_t)size.QuadPart > (uint64_t)SIZE_MAX) {
+		CloseHandle(file);
+		return ERR_FILE_CANT_READ;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (!mapping) {
+		return ERR_FILE_CANT_READ;
+	}
+
+	// The view keeps the mapping alive, so the handle can be closed right away.
+	void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!data) {
+		return ERR_FILE_CANT_READ;
+	}
+
+	r_data = (const uint8_t *)data;
+	r_size = size.QuadPart;
+	return OK;
+}
+
+Error OS_Windows::unmap_file(const uint8_t *p_data, uint64_t p_size) {
+
+	if (!UnmapViewOfFile(p_data)) {
+		return FAILED;
+	}
+	return OK;
+}
+
 void OS_Windows::request_attention() {
 
 	FLASHWINFO info;
@@ -30,8 +30,213 @@
 
 #include "navigation_2d.h"
 
+#include "core/math/a_star.h"
+#include "core/path_request_queue.h"
+#include "core/sort_array.h"
+
 #define USE_ENTRY_POINT
 
+static _FORCE_INLINE_ real_t _get_distance_squared(const Rect2 &p_rect, const Vector2 &p_point) {
+
+	Vector2 d;
+	for (int i = 0; i < 2; i++) {
+		d[i] = MAX(MAX(p_rect.position[i] - p_point[i], p_point[i] - p_rect.position[i] - p_rect.size[i]), 0);
+	}
+	return d.length_squared();
+}
+
+void Navigation2D::PathQuery::begin(int p_polygon_count) {
+
+	if (states.size() < p_polygon_count) {
+		int prev_size = states.size();
+		states.resize(p_polygon_count);
+		for (int i = prev_size; i < p_polygon_count; i++) {
+			states.write[i].pass = 0;
+		}
+	}
+
+	pass++;
+	if (pass == 0) {
+		// Wrapped around, old passes could match again.
+		for (int i = 0; i < states.size(); i++) {
+			states.write[i].pass = 0;
+		}
+		pass = 1;
+	}
+}
+
+Navigation2D::PathQuery *Navigation2D::_acquire_query() {
+
+	MutexLock lock(query_mutex);
+
+	if (free_queries.empty()) {
+		return memnew(PathQuery);
+	}
+
+	PathQuery *query = free_queries[free_queries.size() - 1];
+	free_queries.resize(free_queries.size() - 1);
+	return query;
+}
+
+void Navigation2D::_release_query(PathQuery *p_query) {
+
+	MutexLock lock(query_mutex);
+	free_queries.push_back(p_query);
+}
+
+void Navigation2D::_update_polygon_indices() {
+
+	polygon_count = 0;
+	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+			F->get().index = polygon_count++;
+		}
+	}
+}
+
+void Navigation2D::_build_bvh() {
+
+	bvh_nodes.clear();
+	bvh_polygons.clear();
+
+	Vector<BVHItem> items;
+	items.resize(polygon_count);
+	BVHItem *w = items.ptrw();
+	int count = 0;
+
+	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+
+			Polygon &p = F->get();
+			if (p.edges.size() == 0)
+				continue;
+
+			Rect2 rect(_get_vertex(p.edges[0].point), Vector2());
+			for (int i = 1; i < p.edges.size(); i++) {
+				rect.expand_to(_get_vertex(p.edges[i].point));
+			}
+
+			w[count].rect = rect;
+			w[count].polygon = &p;
+			count++;
+		}
+	}
+
+	if (count == 0)
+		return;
+
+	bvh_nodes.resize(1);
+	_build_bvh_node(0, w, 0, count);
+}
+
+void Navigation2D::_build_bvh_node(int p_node, BVHItem *p_items, int p_from, int p_to) {
+
+	Rect2 rect = p_items[p_from].rect;
+	Rect2 centers(rect.position + rect.size * 0.5, Vector2());
+	for (int i = p_from + 1; i < p_to; i++) {
+		rect = rect.merge(p_items[i].rect);
+		centers.expand_to(p_items[i].rect.position + p_items[i].rect.size * 0.5);
+	}
+
+	if (p_to - p_from <= BVH_LEAF_SIZE) {
+
+		BVHNode &node = bvh_nodes.write[p_node];
+		node.rect = rect;
+		node.first = bvh_polygons.size();
+		node.count = p_to - p_from;
+		for (int i = p_from; i < p_to; i++) {
+			bvh_polygons.push_back(p_items[i].polygon);
+		}
+		return;
+	}
+
+	// Split at the median along the axis where polygons are most spread, which keeps the tree balanced.
+	SortArray<BVHItem, BVHItemSort> sorter;
+	sorter.compare.axis = centers.size.x >= centers.size.y ? 0 : 1;
+	int mid = (p_from + p_to) / 2;
+	sorter.nth_element(p_from, p_to, mid, p_items);
+
+	int first = bvh_nodes.size();
+	bvh_nodes.resize(first + 2);
+
+	BVHNode &node = bvh_nodes.write[p_node];
+	node.rect = rect;
+	node.first = first;
+	node.count = 0;
+
+	_build_bvh_node(first, p_items, p_from, mid);
+	_build_bvh_node(first + 1, p_items, mid, p_to);
+}
+
+// Returns the polygon containing the point, or else the one with the closest edge.
+Navigation2D::Polygon *Navigation2D::_get_closest_polygon(const Vector2 &p_point, Vector2 &r_point) const {
+
+	if (bvh_nodes.empty())
+		return NULL;
+
+	const BVHNode *nodes = bvh_nodes.ptr();
+	Polygon *const *polygons = bvh_polygons.ptr();
+
+	Polygon *closest = NULL;
+	real_t closest_d = Math_INF;
+
+	int stack[64]; // The tree is balanced, so its depth is about log2 of the polygon count.
+	int stack_size = 1;
+	stack[0] = 0;
+
+	while (stack_size) {
+
+		const BVHNode &node = nodes[stack[--stack_size]];
+		if (_get_distance_squared(node.rect, p_point) >= closest_d)
+			continue;
+
+		if (node.count == 0) {
+			// Visit the closest child first, as it's the most likely to prune the other.
+			int closer = node.first;
+			int farther = node.first + 1;
+			if (_get_distance_squared(nodes[farther].rect, p_point) < _get_distance_squared(nodes[closer].rect, p_point)) {
+				SWAP(closer, farther);
+			}
+			stack[stack_size++] = farther;
+			stack[stack_size++] = closer;
+			continue;
+		}
+
+		for (int i = node.first; i < node.first + node.count; i++) {
+
+			Polygon *p = polygons[i];
+
+			for (int j = 2; j < p->edges.size(); j++) {
+
+				if (Geometry::is_point_in_triangle(p_point, _get_vertex(p->edges[0].point), _get_vertex(p->edges[j - 1].point), _get_vertex(p->edges[j].point))) {
+
+					r_point = p_point; //inside triangle, nothing else to discuss
+					return p;
+				}
+			}
+
+			int es = p->edges.size();
+			for (int j = 0; j < es; j++) {
+
+				Vector2 edge[2] = {
+					_get_vertex(p->edges[j].point),
+					_get_vertex(p->edges[(j + 1) % es].point)
+				};
+
+				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
+				real_t d = spoint.distance_squared_to(p_point);
+				if (d < closest_d) {
+					closest_d = d;
+					closest = p;
+					r_point = spoint;
+				}
+			}
+		}
+	}
+
+	return closest;
+}
+
 void Navigation2D::_navpoly_link(int p_id) {
 
 	ERR_FAIL_COND(!navpoly_map.has(p_id));
@@ -135,6 +340,9 @@ void Navigation2D::_navpoly_link(int p_id) {
 	}
 
 	nm.linked = true;
+	_update_polygon_indices();
+	_build_bvh();
+	_invalidate_flow_fields();
 }
 
 void Navigation2D::_navpoly_unlink(int p_id) {
@@ -201,10 +409,15 @@ void Navigation2D::_navpoly_unlink(int p_id) {
 	nm.polygons.clear();
 
 	nm.linked = false;
+	_update_polygon_indices();
+	_build_bvh();
+	_invalidate_flow_fields();
 }
 
 int Navigation2D::navpoly_add(const Ref<NavigationPolygon> &p_mesh, const Transform2D &p_xform, Object *p_owner) {
 
+	RWLockWrite write_lock(navpoly_lock);
+
 	int id = last_id++;
 	NavMesh nm;
 	nm.linked = false;
@@ -220,6 +433,8 @@ int Navigation2D::navpoly_add(const Ref<NavigationPolygon> &p_mesh, const Transf
 
 void Navigation2D::navpoly_set_transform(int p_id, const Transform2D &p_xform) {
 
+	RWLockWrite write_lock(navpoly_lock);
+
 	ERR_FAIL_COND(!navpoly_map.has(p_id));
 	NavMesh &nm = navpoly_map[p_id];
 	if (nm.xform == p_xform)
@@ -230,6 +445,8 @@ void Navigation2D::navpoly_set_transform(int p_id, const Transform2D &p_xform) {
 }
 void Navigation2D::navpoly_remove(int p_id) {
 
+	RWLockWrite write_lock(navpoly_lock);
+
 	ERR_FAIL_COND(!navpoly_map.has(p_id));
 	_navpoly_unlink(p_id);
 	navpoly_map.erase(p_id);
@@ -237,95 +454,12 @@ void Navigation2D::navpoly_remove(int p_id) {
 
 Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
 
-	Polygon *begin_poly = NULL;
-	Polygon *end_poly = NULL;
+	RWLockRead read_lock(navpoly_lock);
+
 	Vector2 begin_point;
 	Vector2 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-
-	//look for point inside triangle
-
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
-
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-
-			Polygon &p = F->get();
-			if (begin_d || end_d) {
-				for (int i = 2; i < p.edges.size(); i++) {
-
-					if (begin_d > 0) {
-
-						if (Geometry::is_point_in_triangle(p_start, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
-
-							begin_poly = &p;
-							begin_point = p_start;
-							begin_d = 0;
-							if (end_d == 0)
-								break;
-						}
-					}
-
-					if (end_d > 0) {
-
-						if (Geometry::is_point_in_triangle(p_end, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
-
-							end_poly = &p;
-							end_point = p_end;
-							end_d = 0;
-							if (begin_d == 0)
-								break;
-						}
-					}
-				}
-			}
-
-			p.prev_edge = -1;
-		}
-	}
-
-	//start or end not inside triangle.. look for closest segment :|
-	if (begin_d || end_d) {
-		for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
-
-			if (!E->get().linked)
-				continue;
-			for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-
-				Polygon &p = F->get();
-				int es = p.edges.size();
-				for (int i = 0; i < es; i++) {
-
-					Vector2 edge[2] = {
-						_get_vertex(p.edges[i].point),
-						_get_vertex(p.edges[(i + 1) % es].point)
-					};
-
-					if (begin_d > 0) {
-						Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_start, edge);
-						float d = spoint.distance_to(p_start);
-						if (d < begin_d) {
-							begin_poly = &p;
-							begin_point = spoint;
-							begin_d = d;
-						}
-					}
-
-					if (end_d > 0) {
-						Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_end, edge);
-						float d = spoint.distance_to(p_end);
-						if (d < end_d) {
-							end_poly = &p;
-							end_point = spoint;
-							end_d = d;
-						}
-					}
-				}
-			}
-		}
-	}
+	Polygon *begin_poly = _get_closest_polygon(p_start, begin_point);
+	Polygon *end_poly = _get_closest_polygon(p_end, end_point);
 
 	if (!begin_poly || !end_poly) {
 
@@ -341,28 +475,33 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 		return path;
 	}
 
+	PathQuery *query = _acquire_query();
+	query->begin(polygon_count);
+	PolygonState &begin_state = query->get(begin_poly);
+	begin_state.entry = p_start;
+
 	bool found_route = false;
 
 	List<Polygon *> open_list;
 
-	begin_poly->entry = p_start;
 
 	for (int i = 0; i < begin_poly->edges.size(); i++) {
 
 		if (begin_poly->edges[i].C) {
 
-			begin_poly->edges[i].C->prev_edge = begin_poly->edges[i].C_edge;
+			PolygonState &cs = query->get(begin_poly->edges[i].C);
+			cs.prev_edge = begin_poly->edges[i].C_edge;
 #ifdef USE_ENTRY_POINT
 			Vector2 edge[2] = {
 				_get_vertex(begin_poly->edges[i].point),
 				_get_vertex(begin_poly->edges[(i + 1) % begin_poly->edges.size()].point)
 			};
 
-			Vector2 entry = Geometry::get_closest_point_to_segment_2d(begin_poly->entry, edge);
-			begin_poly->edges[i].C->distance = begin_poly->entry.distance_to(entry);
-			begin_poly->edges[i].C->entry = entry;
+			Vector2 entry = Geometry::get_closest_point_to_segment_2d(begin_state.entry, edge);
+			cs.distance = begin_state.entry.distance_to(entry);
+			cs.entry = entry;
 #else
-			begin_poly->edges[i].C->distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
+			cs.distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
 #endif
 			open_list.push_back(begin_poly->edges[i].C);
 
@@ -386,8 +525,9 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 		for (List<Polygon *>::Element *E = open_list.front(); E; E = E->next()) {
 
 			Polygon *p = E->get();
+			const PolygonState &ps = query->get(p);
 
-			float cost = p->distance;
+			float cost = ps.distance;
 
 #ifdef USE_ENTRY_POINT
 			int es = p->edges.size();
@@ -405,8 +545,8 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 					_get_vertex(p->edges[(i + 1) % es].point)
 				};
 
-				Vector2 edge_point = Geometry::get_closest_point_to_segment_2d(p->entry, edge);
-				float dist = p->entry.distance_to(edge_point);
+				Vector2 edge_point = Geometry::get_closest_point_to_segment_2d(ps.entry, edge);
+				float dist = ps.entry.distance_to(edge_point);
 				if (dist < shortest_distance)
 					shortest_distance = dist;
 			}
@@ -422,6 +562,7 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 		}
 
 		Polygon *p = least_cost_poly->get();
+		const PolygonState &ps = query->get(p);
 		//open the neighbours for search
 		int es = p->edges.size();
 
@@ -438,33 +579,35 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 				_get_vertex(p->edges[(i + 1) % es].point)
 			};
 
-			Vector2 edge_entry = Geometry::get_closest_point_to_segment_2d(p->entry, edge);
-			float distance = p->entry.distance_to(edge_entry) + p->distance;
+			Vector2 edge_entry = Geometry::get_closest_point_to_segment_2d(ps.entry, edge);
+			float distance = ps.entry.distance_to(edge_entry) + ps.distance;
 
 #else
 
-			float distance = p->center.distance_to(e.C->center) + p->distance;
+			float distance = p->center.distance_to(e.C->center) + ps.distance;
 
 #endif
 
-			if (e.C->prev_edge != -1) {
+			PolygonState &cs = query->get(e.C);
+
+			if (cs.prev_edge != -1) {
 				//oh this was visited already, can we win the cost?
 
-				if (e.C->distance > distance) {
+				if (cs.distance > distance) {
 
-					e.C->prev_edge = e.C_edge;
-					e.C->distance = distance;
+					cs.prev_edge = e.C_edge;
+					cs.distance = distance;
 #ifdef USE_ENTRY_POINT
-					e.C->entry = edge_entry;
+					cs.entry = edge_entry;
 #endif
 				}
 			} else {
 				//add to open neighbours
 
-				e.C->prev_edge = e.C_edge;
-				e.C->distance = distance;
+				cs.prev_edge = e.C_edge;
+				cs.distance = distance;
 #ifdef USE_ENTRY_POINT
-				e.C->entry = edge_entry;
+				cs.entry = edge_entry;
 #endif
 
 				open_list.push_back(e.C);
@@ -509,8 +652,8 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 					left = begin_point;
 					right = begin_point;
 				} else {
-					int prev = p->prev_edge;
-					int prev_n = (p->prev_edge + 1) % p->edges.size();
+					int prev = query->get(p).prev_edge;
+					int prev_n = (prev + 1) % p->edges.size();
 					left = _get_vertex(p->edges[prev].point);
 					right = _get_vertex(p->edges[prev_n].point);
 
@@ -576,7 +719,7 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 				}
 
 				if (p != begin_poly)
-					p = p->edges[p->prev_edge].C;
+					p = p->edges[query->get(p).prev_edge].C;
 				else
 					p = NULL;
 			}
@@ -586,8 +729,8 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 			Polygon *p = end_poly;
 
 			while (true) {
-				int prev = p->prev_edge;
-				int prev_n = (p->prev_edge + 1) % p->edges.size();
+				int prev = query->get(p).prev_edge;
+				int prev_n = (prev + 1) % p->edges.size();
 				Vector2 point = (_get_vertex(p->edges[prev].point) + _get_vertex(p->edges[prev_n].point)) * 0.5;
 				path.push_back(point);
 				p = p->edges[prev].C;
@@ -610,114 +753,247 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 			path.write[path.size() - 1] = end_point; // Replace last midpoint by the exact end point
 		}
 
+		_release_query(query);
 		return path;
 	}
 
+	_release_query(query);
 	return Vector<Vector2>();
 }
 
 Vector2 Navigation2D::get_closest_point(const Vector2 &p_point) {
 
-	Vector2 closest_point = Vector2();
-	float closest_point_d = 1e20;
+	RWLockRead read_lock(navpoly_lock);
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+	Vector2 closest_point;
+	_get_closest_polygon(p_point, closest_point);
+	return closest_point;
+}
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+Object *Navigation2D::get_closest_point_owner(const Vector2 &p_point) {
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+	RWLockRead read_lock(navpoly_lock);
 
-				if (Geometry::is_point_in_triangle(p_point, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
+	Vector2 closest_point;
+	Polygon *closest = _get_closest_polygon(p_point, closest_point);
+	return closest ? closest->owner->owner : NULL;
+}
 
-					return p_point; //inside triangle, nothing else to discuss
-				}
-			}
-		}
+void Navigation2D::_invalidate_flow_fields() {
+
+	MutexLock lock(flow_field_mutex);
+	for (Map<int, FlowField>::Element *E = flow_field_map.front(); E; E = E->next()) {
+		E->get().dirty = true;
 	}
+}
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+void Navigation2D::_update_flow_field(FlowField &r_field) {
 
-		if (!E->get().linked)
-			continue;
+	r_field.dirty = false;
+	r_field.cells.resize(polygon_count);
+	FlowFieldCell *cells = r_field.cells.ptrw();
+	for (int i = 0; i < polygon_count; i++) {
+		cells[i].f_score = Math_INF;
+		cells[i].open_index = -1;
+		cells[i].next_edge = -1;
+	}
+
+	Vector2 goal_point;
+	Polygon *goal_poly = _get_closest_polygon(r_field.goal, goal_point);
+	if (!goal_poly)
+		return;
+
+	Vector<Polygon *> polygons;
+	polygons.resize(polygon_count);
+	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
 		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+			polygons.write[F->get().index] = &F->get();
+		}
+	}
 
-			Polygon &p = F->get();
-			int es = p.edges.size();
-			for (int i = 0; i < es; i++) {
+	AStarOpenList<FlowFieldCell> open_list;
+	cells[goal_poly->index].f_score = 0;
+	cells[goal_poly->index].entry = goal_point;
+	open_list.push(cells, goal_poly->index);
 
-				Vector2 edge[2] = {
-					_get_vertex(p.edges[i].point),
-					_get_vertex(p.edges[(i + 1) % es].point)
-				};
+	while (!open_list.empty()) {
 
-				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
-				float d = spoint.distance_squared_to(p_point);
-				if (d < closest_point_d) {
+		int i = open_list.pop(cells);
+		const Polygon *p = polygons[i];
+		int es = p->edges.size();
 
-					closest_point = spoint;
-					closest_point_d = d;
-				}
+		for (int j = 0; j < es; j++) {
+
+			const Polygon::Edge &e = p->edges[j];
+			if (!e.C)
+				continue;
+
+			// The connected polygon shares this edge, and reaches this polygon through it.
+			Vector2 portal = (_get_vertex(e.point) + _get_vertex(p->edges[(j + 1) % es].point)) * 0.5;
+			real_t distance = cells[i].f_score + portal.distance_to(cells[i].entry);
+
+			FlowFieldCell &c = cells[e.C->index];
+			if (distance >= c.f_score)
+				continue;
+
+			c.f_score = distance;
+			c.next_edge = e.C_edge;
+			c.entry = portal;
+			if (c.open_index < 0) {
+				open_list.push(cells, e.C->index);
+			} else {
+				open_list.decrease(cells, e.C->index);
 			}
 		}
 	}
+}
 
-	return closest_point;
+int Navigation2D::flow_field_create(const Vector2 &p_goal) {
+
+	MutexLock lock(flow_field_mutex);
+
+	FlowField field;
+	field.goal = p_goal;
+	field.dirty = true;
+
+	int id = ++last_flow_field_id;
+	flow_field_map[id] = field;
+	return id;
 }
 
-Object *Navigation2D::get_closest_point_owner(const Vector2 &p_point) {
+void Navigation2D::flow_field_set_goal(int p_id, const Vector2 &p_goal) {
 
-	Object *owner = NULL;
-	Vector2 closest_point = Vector2();
-	float closest_point_d = 1e20;
+	MutexLock lock(flow_field_mutex);
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+	Map<int, FlowField>::Element *E = flow_field_map.find(p_id);
+	ERR_FAIL_COND(!E);
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	E->get().goal = p_goal;
+	E->get().dirty = true;
+}
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+Vector2 Navigation2D::flow_field_get_goal(int p_id) const {
 
-				if (Geometry::is_point_in_triangle(p_point, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
+	MutexLock lock(flow_field_mutex);
 
-					return E->get().owner;
-				}
-			}
-		}
+	const Map<int, FlowField>::Element *E = flow_field_map.find(p_id);
+	ERR_FAIL_COND_V(!E, Vector2());
+
+	return E->get().goal;
+}
+
+Vector2 Navigation2D::flow_field_get_direction(int p_id, const Vector2 &p_point) {
+
+	RWLockRead read_lock(navpoly_lock);
+	MutexLock lock(flow_field_mutex);
+
+	Map<int, FlowField>::Element *E = flow_field_map.find(p_id);
+	ERR_FAIL_COND_V(!E, Vector2());
+
+	FlowField &field = E->get();
+	if (field.dirty) {
+		_update_flow_field(field);
 	}
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+	Vector2 closest;
+	Polygon *p = _get_closest_polygon(p_point, closest);
+	if (!p)
+		return Vector2();
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	const FlowFieldCell &c = field.cells[p->index];
+	if (c.f_score == Math_INF)
+		return Vector2();
 
-			Polygon &p = F->get();
-			int es = p.edges.size();
-			for (int i = 0; i < es; i++) {
+	if (c.next_edge < 0) {
+		return (c.entry - p_point).normalized();
+	}
 
-				Vector2 edge[2] = {
-					_get_vertex(p.edges[i].point),
-					_get_vertex(p.edges[(i + 1) % es].point)
-				};
+	Vector2 edge[2] = {
+		_get_vertex(p->edges[c.next_edge].point),
+		_get_vertex(p->edges[(c.next_edge + 1) % p->edges.size()].point)
+	};
 
-				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
-				float d = spoint.distance_squared_to(p_point);
-				if (d < closest_point_d) {
+	Vector2 target = Geometry::get_closest_point_to_segment_2d(p_point, edge);
+	if (target.distance_squared_to(p_point) < CMP_EPSILON2) {
+		// Already on the edge, head into the next polygon.
+		target = p->edges[c.next_edge].C->center;
+	}
 
-					closest_point = spoint;
-					closest_point_d = d;
-					owner = E->get().owner;
-				}
-			}
-		}
+	return (target - p_point).normalized();
+}
+
+real_t Navigation2D::flow_field_get_distance(int p_id, const Vector2 &p_point) {
+
+	RWLockRead read_lock(navpoly_lock);
+	MutexLock lock(flow_field_mutex);
+
+	Map<int, FlowField>::Element *E = flow_field_map.find(p_id);
+	ERR_FAIL_COND_V(!E, Math_INF);
+
+	FlowField &field = E->get();
+	if (field.dirty) {
+		_update_flow_field(field);
 	}
 
-	return owner;
+	Vector2 closest;
+	Polygon *p = _get_closest_polygon(p_point, closest);
+	if (!p)
+		return Math_INF;
+
+	const FlowFieldCell &c = field.cells[p->index];
+	if (c.f_score == Math_INF)
+		return Math_INF;
+
+	return c.f_score + p_point.distance_to(c.entry);
+}
+
+void Navigation2D::flow_field_remove(int p_id) {
+
+	MutexLock lock(flow_field_mutex);
+
+	ERR_FAIL_COND(!flow_field_map.has(p_id));
+	flow_field_map.erase(p_id);
+}
+
+class Navigation2DPathRequest : public PathRequestQueue::Request {
+
+public:
+	Navigation2D *navigation;
+	Vector2 start;
+	Vector2 end;
+	bool optimize;
+
+	Vector<Vector2> path;
+
+	virtual void solve() {
+
+		path = navigation->get_simple_path(start, end, optimize);
+	}
+
+	virtual void deliver(Object *p_owner) {
+
+		p_owner->emit_signal("path_request_completed", get_id(), path);
+	}
+};
+
+int Navigation2D::request_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
+
+	ERR_FAIL_COND_V(!PathRequestQueue::get_singleton(), 0);
+
+	Navigation2DPathRequest *request = memnew(Navigation2DPathRequest);
+	request->navigation = this;
+	request->start = p_start;
+	request->end = p_end;
+	request->optimize = p_optimize;
+
+	return PathRequestQueue::get_singleton()->push_request(this, request);
+}
+
+void Navigation2D::cancel_path_request(int p_request_id) {
+
+	if (PathRequestQueue::get_singleton()) {
+		PathRequestQueue::get_singleton()->cancel_request(this, p_request_id);
+	}
 }
 
 void Navigation2D::_bind_methods() {
@@ -729,6 +1005,18 @@ void Navigation2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_simple_path", "start", "end", "optimize"), &Navigation2D::get_simple_path, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Navigation2D::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_point_owner", "to_point"), &Navigation2D::get_closest_point_owner);
+
+	ClassDB::bind_method(D_METHOD("request_simple_path", "start", "end", "optimize"), &Navigation2D::request_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("cancel_path_request", "request_id"), &Navigation2D::cancel_path_request);
+
+	ClassDB::bind_method(D_METHOD("flow_field_create", "goal"), &Navigation2D::flow_field_create);
+	ClassDB::bind_method(D_METHOD("flow_field_set_goal", "id", "goal"), &Navigation2D::flow_field_set_goal);
+	ClassDB::bind_method(D_METHOD("flow_field_get_goal", "id"), &Navigation2D::flow_field_get_goal);
+	ClassDB::bind_method(D_METHOD("flow_field_get_direction", "id", "point"), &Navigation2D::flow_field_get_direction);
+	ClassDB::bind_method(D_METHOD("flow_field_get_distance", "id", "point"), &Navigation2D::flow_field_get_distance);
+	ClassDB::bind_method(D_METHOD("flow_field_remove", "id"), &Navigation2D::flow_field_remove);
+
+	ADD_SIGNAL(MethodInfo("path_request_completed", PropertyInfo(Variant::INT, "request_id"), PropertyInfo(Variant::POOL_VECTOR2_ARRAY, "path")));
 }
 
 Navigation2D::Navigation2D() {
@@ -736,4 +1024,23 @@ Navigation2D::Navigation2D() {
 	ERR_FAIL_COND(sizeof(Point) != 8);
 	cell_size = 1; // one pixel
 	last_id = 1;
+	polygon_count = 0;
+	query_mutex = Mutex::create();
+	flow_field_mutex = Mutex::create();
+	last_flow_field_id = 0;
+	navpoly_lock = RWLock::create();
+}
+
+Navigation2D::~Navigation2D() {
+
+	if (PathRequestQueue::get_singleton()) {
+		PathRequestQueue::get_singleton()->cancel_requests(this);
+	}
+
+	for (int i = 0; i < free_queries.size(); i++) {
+		memdelete(free_queries[i]);
+	}
+	memdelete(query_mutex);
+	memdelete(flow_field_mutex);
+	memdelete(navpoly_lock);
 }
@@ -30,8 +30,200 @@
 
 #include "navigation.h"
 
+#include "core/math/a_star.h"
+#include "core/path_request_queue.h"
+#include "core/sort_array.h"
+
 #define USE_ENTRY_POINT
 
+static _FORCE_INLINE_ real_t _get_distance_squared(const AABB &p_aabb, const Vector3 &p_point) {
+
+	Vector3 d;
+	for (int i = 0; i < 3; i++) {
+		d[i] = MAX(MAX(p_aabb.position[i] - p_point[i], p_point[i] - p_aabb.position[i] - p_aabb.size[i]), 0);
+	}
+	return d.length_squared();
+}
+
+void Navigation::PathQuery::begin(int p_polygon_count) {
+
+	if (states.size() < p_polygon_count) {
+		int prev_size = states.size();
+		states.resize(p_polygon_count);
+		for (int i = prev_size; i < p_polygon_count; i++) {
+			states.write[i].pass = 0;
+		}
+	}
+
+	pass++;
+	if (pass == 0) {
+		// Wrapped around, old passes could match again.
+		for (int i = 0; i < states.size(); i++) {
+			states.write[i].pass = 0;
+		}
+		pass = 1;
+	}
+}
+
+Navigation::PathQuery *Navigation::_acquire_query() {
+
+	MutexLock lock(query_mutex);
+
+	if (free_queries.empty()) {
+		return memnew(PathQuery);
+	}
+
+	PathQuery *query = free_queries[free_queries.size() - 1];
+	free_queries.resize(free_queries.size() - 1);
+	return query;
+}
+
+void Navigation::_release_query(PathQuery *p_query) {
+
+	MutexLock lock(query_mutex);
+	free_queries.push_back(p_query);
+}
+
+void Navigation::_update_polygon_indices() {
+
+	polygon_count = 0;
+	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+			F->get().index = polygon_count++;
+		}
+	}
+}
+
+void Navigation::_build_bvh() {
+
+	bvh_nodes.clear();
+	bvh_polygons.clear();
+
+	Vector<BVHItem> items;
+	items.resize(polygon_count);
+	BVHItem *w = items.ptrw();
+	int count = 0;
+
+	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+
+			Polygon &p = F->get();
+			if (p.edges.size() == 0)
+				continue;
+
+			AABB aabb(_get_vertex(p.edges[0].point), Vector3());
+			for (int i = 1; i < p.edges.size(); i++) {
+				aabb.expand_to(_get_vertex(p.edges[i].point));
+			}
+
+			w[count].aabb = aabb;
+			w[count].polygon = &p;
+			count++;
+		}
+	}
+
+	if (count == 0)
+		return;
+
+	bvh_nodes.resize(1);
+	_build_bvh_node(0, w, 0, count);
+}
+
+void Navigation::_build_bvh_node(int p_node, BVHItem *p_items, int p_from, int p_to) {
+
+	AABB aabb = p_items[p_from].aabb;
+	AABB centers(aabb.position + aabb.size * 0.5, Vector3());
+	for (int i = p_from + 1; i < p_to; i++) {
+		aabb.merge_with(p_items[i].aabb);
+		centers.expand_to(p_items[i].aabb.position + p_items[i].aabb.size * 0.5);
+	}
+
+	if (p_to - p_from <= BVH_LEAF_SIZE) {
+
+		BVHNode &node = bvh_nodes.write[p_node];
+		node.aabb = aabb;
+		node.first = bvh_polygons.size();
+		node.count = p_to - p_from;
+		for (int i = p_from; i < p_to; i++) {
+			bvh_polygons.push_back(p_items[i].polygon);
+		}
+		return;
+	}
+
+	// Split at the median along the axis where polygons are most spread, which keeps the tree balanced.
+	SortArray<BVHItem, BVHItemSort> sorter;
+	sorter.compare.axis = centers.get_longest_axis_index();
+	int mid = (p_from + p_to) / 2;
+	sorter.nth_element(p_from, p_to, mid, p_items);
+
+	int first = bvh_nodes.size();
+	bvh_nodes.resize(first + 2);
+
+	BVHNode &node = bvh_nodes.write[p_node];
+	node.aabb = aabb;
+	node.first = first;
+	node.count = 0;
+
+	_build_bvh_node(first, p_items, p_from, mid);
+	_build_bvh_node(first + 1, p_items, mid, p_to);
+}
+
+Navigation::Polygon *Navigation::_get_closest_polygon(const Vector3 &p_point, Vector3 &r_point, Vector3 *r_normal) const {
+
+	if (bvh_nodes.empty())
+		return NULL;
+
+	const BVHNode *nodes = bvh_nodes.ptr();
+	Polygon *const *polygons = bvh_polygons.ptr();
+
+	Polygon *closest = NULL;
+	real_t closest_d = Math_INF;
+
+	int stack[64]; // The tree is balanced, so its depth is about log2 of the polygon count.
+	int stack_size = 1;
+	stack[0] = 0;
+
+	while (stack_size) {
+
+		const BVHNode &node = nodes[stack[--stack_size]];
+		if (_get_distance_squared(node.aabb, p_point) >= closest_d)
+			continue;
+
+		if (node.count == 0) {
+			// Visit the closest child first, as it's the most likely to prune the other.
+			int closer = node.first;
+			int farther = node.first + 1;
+			if (_get_distance_squared(nodes[farther].aabb, p_point) < _get_distance_squared(nodes[closer].aabb, p_point)) {
+				SWAP(closer, farther);
+			}
+			stack[stack_size++] = farther;
+			stack[stack_size++] = closer;
+			continue;
+		}
+
+		for (int i = node.first; i < node.first + node.count; i++) {
+
+			Polygon *p = polygons[i];
+			for (int j = 2; j < p->edges.size(); j++) {
+
+				Face3 f(_get_vertex(p->edges[0].point), _get_vertex(p->edges[j - 1].point), _get_vertex(p->edges[j].point));
+				Vector3 spoint = f.get_closest_point_to(p_point);
+				real_t d = spoint.distance_squared_to(p_point);
+				if (d < closest_d) {
+					closest_d = d;
+					closest = p;
+					r_point = spoint;
+					if (r_normal) {
+						*r_normal = f.get_plane().normal;
+					}
+				}
+			}
+		}
+	}
+
+	return closest;
+}
+
 void Navigation::_navmesh_link(int p_id) {
 
 	ERR_FAIL_COND(!navmesh_map.has(p_id));
@@ -136,6 +328,9 @@ void Navigation::_navmesh_link(int p_id) {
 	}
 
 	nm.linked = true;
+	_update_polygon_indices();
+	_build_bvh();
+	_invalidate_flow_fields();
 }
 
 void Navigation::_navmesh_unlink(int p_id) {
@@ -202,10 +397,15 @@ void Navigation::_navmesh_unlink(int p_id) {
 	nm.polygons.clear();
 
 	nm.linked = false;
+	_update_polygon_indices();
+	_build_bvh();
+	_invalidate_flow_fields();
 }
 
 int Navigation::navmesh_add(const Ref<NavigationMesh> &p_mesh, const Transform &p_xform, Object *p_owner) {
 
+	RWLockWrite write_lock(navmesh_lock);
+
 	int id = last_id++;
 	NavMesh nm;
 	nm.linked = false;
@@ -221,6 +421,8 @@ int Navigation::navmesh_add(const Ref<NavigationMesh> &p_mesh, const Transform &
 
 void Navigation::navmesh_set_transform(int p_id, const Transform &p_xform) {
 
+	RWLockWrite write_lock(navmesh_lock);
+
 	ERR_FAIL_COND(!navmesh_map.has(p_id));
 	NavMesh &nm = navmesh_map[p_id];
 	if (nm.xform == p_xform)
@@ -231,12 +433,14 @@ void Navigation::navmesh_set_transform(int p_id, const Transform &p_xform) {
 }
 void Navigation::navmesh_remove(int p_id) {
 
+	RWLockWrite write_lock(navmesh_lock);
+
 	ERR_FAIL_COND(!navmesh_map.has(p_id));
 	_navmesh_unlink(p_id);
 	navmesh_map.erase(p_id);
 }
 
-void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly) {
+void Navigation::_clip_path(PathQuery *p_query, Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly) {
 
 	Vector3 from = path[path.size() - 1];
 
@@ -251,7 +455,7 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 
 	while (from_poly != p_to_poly) {
 
-		int pe = from_poly->prev_edge;
+		int pe = p_query->get(from_poly).prev_edge;
 		Vector3 a = _get_vertex(from_poly->edges[pe].point);
 		Vector3 b = _get_vertex(from_poly->edges[(pe + 1) % from_poly->edges.size()].point);
 
@@ -272,43 +476,12 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 
 Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
 
-	Polygon *begin_poly = NULL;
-	Polygon *end_poly = NULL;
+	RWLockRead read_lock(navmesh_lock);
+
 	Vector3 begin_point;
 	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 spoint = f.get_closest_point_to(p_start);
-				float dpoint = spoint.distance_to(p_start);
-				if (dpoint < begin_d) {
-					begin_d = dpoint;
-					begin_poly = &p;
-					begin_point = spoint;
-				}
-
-				spoint = f.get_closest_point_to(p_end);
-				dpoint = spoint.distance_to(p_end);
-				if (dpoint < end_d) {
-					end_d = dpoint;
-					end_poly = &p;
-					end_point = spoint;
-				}
-			}
-
-			p.prev_edge = -1;
-		}
-	}
+	Polygon *begin_poly = _get_closest_polygon(p_start, begin_point);
+	Polygon *end_poly = _get_closest_polygon(p_end, end_point);
 
 	if (!begin_poly || !end_poly) {
 
@@ -324,6 +497,11 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		return path;
 	}
 
+	PathQuery *query = _acquire_query();
+	query->begin(polygon_count);
+	PolygonState &begin_state = query->get(begin_poly);
+	begin_state.entry = begin_point;
+
 	bool found_route = false;
 
 	List<Polygon *> open_list;
@@ -332,18 +510,19 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 
 		if (begin_poly->edges[i].C) {
 
-			begin_poly->edges[i].C->prev_edge = begin_poly->edges[i].C_edge;
+			PolygonState &cs = query->get(begin_poly->edges[i].C);
+			cs.prev_edge = begin_poly->edges[i].C_edge;
 #ifdef USE_ENTRY_POINT
 			Vector3 edge[2] = {
 				_get_vertex(begin_poly->edges[i].point),
 				_get_vertex(begin_poly->edges[(i + 1) % begin_poly->edges.size()].point)
 			};
 
-			Vector3 entry = Geometry::get_closest_point_to_segment(begin_poly->entry, edge);
-			begin_poly->edges[i].C->distance = begin_poly->entry.distance_to(entry);
-			begin_poly->edges[i].C->entry = entry;
+			Vector3 entry = Geometry::get_closest_point_to_segment(begin_state.entry, edge);
+			cs.distance = begin_state.entry.distance_to(entry);
+			cs.entry = entry;
 #else
-			begin_poly->edges[i].C->distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
+			cs.distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
 #endif
 			open_list.push_back(begin_poly->edges[i].C);
 
@@ -367,8 +546,9 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		for (List<Polygon *>::Element *E = open_list.front(); E; E = E->next()) {
 
 			Polygon *p = E->get();
+			const PolygonState &ps = query->get(p);
 
-			float cost = p->distance;
+			float cost = ps.distance;
 #ifdef USE_ENTRY_POINT
 			int es = p->edges.size();
 
@@ -385,8 +565,8 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 					_get_vertex(p->edges[(i + 1) % es].point)
 				};
 
-				Vector3 edge_point = Geometry::get_closest_point_to_segment(p->entry, edge);
-				float dist = p->entry.distance_to(edge_point);
+				Vector3 edge_point = Geometry::get_closest_point_to_segment(ps.entry, edge);
+				float dist = ps.entry.distance_to(edge_point);
 				if (dist < shortest_distance)
 					shortest_distance = dist;
 			}
@@ -402,6 +582,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		}
 
 		Polygon *p = least_cost_poly->get();
+		const PolygonState &ps = query->get(p);
 		//open the neighbours for search
 
 		for (int i = 0; i < p->edges.size(); i++) {
@@ -411,21 +592,23 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 			if (!e.C)
 				continue;
 
-			float distance = p->center.distance_to(e.C->center) + p->distance;
+			float distance = p->center.distance_to(e.C->center) + ps.distance;
+
+			PolygonState &cs = query->get(e.C);
 
-			if (e.C->prev_edge != -1) {
+			if (cs.prev_edge != -1) {
 				//oh this was visited already, can we win the cost?
 
-				if (e.C->distance > distance) {
+				if (cs.distance > distance) {
 
-					e.C->prev_edge = e.C_edge;
-					e.C->distance = distance;
+					cs.prev_edge = e.C_edge;
+					cs.distance = distance;
 				}
 			} else {
 				//add to open neighbours
 
-				e.C->prev_edge = e.C_edge;
-				e.C->distance = distance;
+				cs.prev_edge = e.C_edge;
+				cs.distance = distance;
 				open_list.push_back(e.C);
 
 				if (e.C == end_poly) {
@@ -469,8 +652,8 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 					left = begin_point;
 					right = begin_point;
 				} else {
-					int prev = p->prev_edge;
-					int prev_n = (p->prev_edge + 1) % p->edges.size();
+					int prev = query->get(p).prev_edge;
+					int prev_n = (prev + 1) % p->edges.size();
 					left = _get_vertex(p->edges[prev].point);
 					right = _get_vertex(p->edges[prev_n].point);
 
@@ -489,7 +672,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 						portal_left = left;
 					} else {
 
-						_clip_path(path, apex_poly, portal_right, right_poly);
+						_clip_path(query, path, apex_poly, portal_right, right_poly);
 
 						apex_point = portal_right;
 						p = right_poly;
@@ -509,7 +692,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 						portal_right = right;
 					} else {
 
-						_clip_path(path, apex_poly, portal_left, left_poly);
+						_clip_path(query, path, apex_poly, portal_left, left_poly);
 
 						apex_point = portal_left;
 						p = left_poly;
@@ -522,7 +705,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 				}
 
 				if (p != begin_poly)
-					p = p->edges[p->prev_edge].C;
+					p = p->edges[query->get(p).prev_edge].C;
 				else
 					p = NULL;
 			}
@@ -538,8 +721,8 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 
 			path.push_back(end_point);
 			while (true) {
-				int prev = p->prev_edge;
-				int prev_n = (p->prev_edge + 1) % p->edges.size();
+				int prev = query->get(p).prev_edge;
+				int prev_n = (prev + 1) % p->edges.size();
 				Vector3 point = (_get_vertex(p->edges[prev].point) + _get_vertex(p->edges[prev_n].point)) * 0.5;
 				path.push_back(point);
 				p = p->edges[prev].C;
@@ -552,14 +735,18 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 			path.invert();
 		}
 
+		_release_query(query);
 		return path;
 	}
 
+	_release_query(query);
 	return Vector<Vector3>();
 }
 
 Vector3 Navigation::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool &p_use_collision) {
 
+	RWLockRead read_lock(navmesh_lock);
+
 	bool use_collision = p_use_collision;
 	Vector3 closest_point;
 	float closest_point_d = 1e20;
@@ -613,100 +800,257 @@ Vector3 Navigation::get_closest_point_to_segment(const Vector3 &p_from, const Ve
 
 Vector3 Navigation::get_closest_point(const Vector3 &p_point) {
 
+	RWLockRead read_lock(navmesh_lock);
+
 	Vector3 closest_point;
-	float closest_point_d = 1e20;
+	_get_closest_polygon(p_point, closest_point);
+	return closest_point;
+}
 
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+Vector3 Navigation::get_closest_point_normal(const Vector3 &p_point) {
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	RWLockRead read_lock(navmesh_lock);
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+	Vector3 closest_point;
+	Vector3 closest_normal;
+	_get_closest_polygon(p_point, closest_point, &closest_normal);
+	return closest_normal;
+}
 
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-				}
-			}
-		}
-	}
+Object *Navigation::get_closest_point_owner(const Vector3 &p_point) {
 
-	return closest_point;
+	RWLockRead read_lock(navmesh_lock);
+
+	Vector3 closest_point;
+	Polygon *closest = _get_closest_polygon(p_point, closest_point);
+	return closest ? closest->owner->owner : NULL;
 }
 
-Vector3 Navigation::get_closest_point_normal(const Vector3 &p_point) {
+void Navigation::set_up_vector(const Vector3 &p_up) {
 
-	Vector3 closest_point;
-	Vector3 closest_normal;
-	float closest_point_d = 1e20;
+	up = p_up;
+}
 
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+Vector3 Navigation::get_up_vector() const {
 
-		if (!E->get().linked)
-			continue;
+	return up;
+}
+
+void Navigation::_invalidate_flow_fields() {
+
+	MutexLock lock(flow_field_mutex);
+	for (Map<int, FlowField>::Element *E = flow_field_map.front(); E; E = E->next()) {
+		E->get().dirty = true;
+	}
+}
+
+void Navigation::_update_flow_field(FlowField &r_field) {
+
+	r_field.dirty = false;
+	r_field.cells.resize(polygon_count);
+	FlowFieldCell *cells = r_field.cells.ptrw();
+	for (int i = 0; i < polygon_count; i++) {
+		cells[i].f_score = Math_INF;
+		cells[i].open_index = -1;
+		cells[i].next_edge = -1;
+	}
+
+	Vector3 goal_point;
+	Polygon *goal_poly = _get_closest_polygon(r_field.goal, goal_point);
+	if (!goal_poly)
+		return;
+
+	Vector<Polygon *> polygons;
+	polygons.resize(polygon_count);
+	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
 		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+			polygons.write[F->get().index] = &F->get();
+		}
+	}
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+	AStarOpenList<FlowFieldCell> open_list;
+	cells[goal_poly->index].f_score = 0;
+	cells[goal_poly->index].entry = goal_point;
+	open_list.push(cells, goal_poly->index);
 
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-					closest_normal = f.get_plane().normal;
-				}
+	while (!open_list.empty()) {
+
+		int i = open_list.pop(cells);
+		const Polygon *p = polygons[i];
+		int es = p->edges.size();
+
+		for (int j = 0; j < es; j++) {
+
+			const Polygon::Edge &e = p->edges[j];
+			if (!e.C)
+				continue;
+
+			// The connected polygon shares this edge, and reaches this polygon through it.
+			Vector3 portal = (_get_vertex(e.point) + _get_vertex(p->edges[(j + 1) % es].point)) * 0.5;
+			real_t distance = cells[i].f_score + portal.distance_to(cells[i].entry);
+
+			FlowFieldCell &c = cells[e.C->index];
+			if (distance >= c.f_score)
+				continue;
+
+			c.f_score = distance;
+			c.next_edge = e.C_edge;
+			c.entry = portal;
+			if (c.open_index < 0) {
+				open_list.push(cells, e.C->index);
+			} else {
+				open_list.decrease(cells, e.C->index);
 			}
 		}
 	}
+}
 
-	return closest_normal;
+int Navigation::flow_field_create(const Vector3 &p_goal) {
+
+	MutexLock lock(flow_field_mutex);
+
+	FlowField field;
+	field.goal = p_goal;
+	field.dirty = true;
+
+	int id = ++last_flow_field_id;
+	flow_field_map[id] = field;
+	return id;
 }
 
-Object *Navigation::get_closest_point_owner(const Vector3 &p_point) {
+void Navigation::flow_field_set_goal(int p_id, const Vector3 &p_goal) {
 
-	Vector3 closest_point;
-	Object *owner = NULL;
-	float closest_point_d = 1e20;
+	MutexLock lock(flow_field_mutex);
 
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+	Map<int, FlowField>::Element *E = flow_field_map.find(p_id);
+	ERR_FAIL_COND(!E);
 
-		if (!E->get().linked)
-			continue;
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+	E->get().goal = p_goal;
+	E->get().dirty = true;
+}
 
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
+Vector3 Navigation::flow_field_get_goal(int p_id) const {
 
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-					owner = E->get().owner;
-				}
-			}
-		}
+	MutexLock lock(flow_field_mutex);
+
+	const Map<int, FlowField>::Element *E = flow_field_map.find(p_id);
+	ERR_FAIL_COND_V(!E, Vector3());
+
+	return E->get().goal;
+}
+
+Vector3 Navigation::flow_field_get_direction(int p_id, const Vector3 &p_point) {
+
+	RWLockRead read_lock(navmesh_lock);
+	MutexLock lock(flow_field_mutex);
+
+	Map<int, FlowField>::Element *E = flow_field_map.find(p_id);
+	ERR_FAIL_COND_V(!E, Vector3());
+
+	FlowField &field = E->get();
+	if (field.dirty) {
+		_update_flow_field(field);
 	}
 
-	return owner;
+	Vector3 closest;
+	Polygon *p = _get_closest_polygon(p_point, closest);
+	if (!p)
+		return Vector3();
+
+	const FlowFieldCell &c = field.cells[p->index];
+	if (c.f_score == Math_INF)
+		return Vector3();
+
+	if (c.next_edge < 0) {
+		return (c.entry - p_point).normalized();
+	}
+
+	Vector3 edge[2] = {
+		_get_vertex(p->edges[c.next_edge].point),
+		_get_vertex(p->edges[(c.next_edge + 1) % p->edges.size()].point)
+	};
+
+	Vector3 target = Geometry::get_closest_point_to_segment(p_point, edge);
+	if (target.distance_squared_to(p_point) < CMP_EPSILON2) {
+		// Already on the edge, head into the next polygon.
+		target = p->edges[c.next_edge].C->center;
+	}
+
+	return (target - p_point).normalized();
 }
 
-void Navigation::set_up_vector(const Vector3 &p_up) {
+real_t Navigation::flow_field_get_distance(int p_id, const Vector3 &p_point) {
 
-	up = p_up;
+	RWLockRead read_lock(navmesh_lock);
+	MutexLock lock(flow_field_mutex);
+
+	Map<int, FlowField>::Element *E = flow_field_map.find(p_id);
+	ERR_FAIL_COND_V(!E, Math_INF);
+
+	FlowField &field = E->get();
+	if (field.dirty) {
+		_update_flow_field(field);
+	}
+
+	Vector3 closest;
+	Polygon *p = _get_closest_polygon(p_point, closest);
+	if (!p)
+		return Math_INF;
+
+	const FlowFieldCell &c = field.cells[p->index];
+	if (c.f_score == Math_INF)
+		return Math_INF;
+
+	return c.f_score + p_point.distance_to(c.entry);
 }
 
-Vector3 Navigation::get_up_vector() const {
+void Navigation::flow_field_remove(int p_id) {
 
-	return up;
+	MutexLock lock(flow_field_mutex);
+
+	ERR_FAIL_COND(!flow_field_map.has(p_id));
+	flow_field_map.erase(p_id);
+}
+
+class NavigationPathRequest : public PathRequestQueue::Request {
+
+public:
+	Navigation *navigation;
+	Vector3 start;
+	Vector3 end;
+	bool optimize;
+
+	Vector<Vector3> path;
+
+	virtual void solve() {
+
+		path = navigation->get_simple_path(start, end, optimize);
+	}
+
+	virtual void deliver(Object *p_owner) {
+
+		p_owner->emit_signal("path_request_completed", get_id(), path);
+	}
+};
+
+int Navigation::request_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
+
+	ERR_FAIL_COND_V(!PathRequestQueue::get_singleton(), 0);
+
+	NavigationPathRequest *request = memnew(NavigationPathRequest);
+	request->navigation = this;
+	request->start = p_start;
+	request->end = p_end;
+	request->optimize = p_optimize;
+
+	return PathRequestQueue::get_singleton()->push_request(this, request);
+}
+
+void Navigation::cancel_path_request(int p_request_id) {
+
+	if (PathRequestQueue::get_singleton()) {
+		PathRequestQueue::get_singleton()->cancel_request(this, p_request_id);
+	}
 }
 
 void Navigation::_bind_methods() {
@@ -721,10 +1065,22 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_closest_point_normal", "to_point"), &Navigation::get_closest_point_normal);
 	ClassDB::bind_method(D_METHOD("get_closest_point_owner", "to_point"), &Navigation::get_closest_point_owner);
 
+	ClassDB::bind_method(D_METHOD("request_simple_path", "start", "end", "optimize"), &Navigation::request_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("cancel_path_request", "request_id"), &Navigation::cancel_path_request);
+
+	ClassDB::bind_method(D_METHOD("flow_field_create", "goal"), &Navigation::flow_field_create);
+	ClassDB::bind_method(D_METHOD("flow_field_set_goal", "id", "goal"), &Navigation::flow_field_set_goal);
+	ClassDB::bind_method(D_METHOD("flow_field_get_goal", "id"), &Navigation::flow_field_get_goal);
+	ClassDB::bind_method(D_METHOD("flow_field_get_direction", "id", "point"), &Navigation::flow_field_get_direction);
+	ClassDB::bind_method(D_METHOD("flow_field_get_distance", "id", "point"), &Navigation::flow_field_get_distance);
+	ClassDB::bind_method(D_METHOD("flow_field_remove", "id"), &Navigation::flow_field_remove);
+
 	ClassDB::bind_method(D_METHOD("set_up_vector", "up"), &Navigation::set_up_vector);
 	ClassDB::bind_method(D_METHOD("get_up_vector"), &Navigation::get_up_vector);
 
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "up_vector"), "set_up_vector", "get_up_vector");
+
+	ADD_SIGNAL(MethodInfo("path_request_completed", PropertyInfo(Variant::INT, "request_id"), PropertyInfo(Variant::POOL_VECTOR3_ARRAY, "path")));
 }
 
 Navigation::Navigation() {
@@ -733,4 +1089,23 @@ Navigation::Navigation() {
 	cell_size = 0.01; //one centimeter
 	last_id = 1;
 	up = Vector3(0, 1, 0);
+	polygon_count = 0;
+	query_mutex = Mutex::create();
+	flow_field_mutex = Mutex::create();
+	last_flow_field_id = 0;
+	navmesh_lock = RWLock::create();
+}
+
+Navigation::~Navigation() {
+
+	if (PathRequestQueue::get_singleton()) {
+		PathRequestQueue::get_singleton()->cancel_requests(this);
+	}
+
+	for (int i = 0; i < free_queries.size(); i++) {
+		memdelete(free_queries[i]);
+	}
+	memdelete(query_mutex);
+	memdelete(flow_field_mutex);
+	memdelete(navmesh_lock);
 }
@@ -31,6 +31,8 @@
 #ifndef NAVIGATION_H
 #define NAVIGATION_H
 
+#include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
 #include "scene/3d/navigation_mesh.h"
 #include "scene/3d/spatial.h"
 
@@ -94,11 +96,8 @@ class Navigation : public Spatial {
 		Vector<Edge> edges;
 
 		Vector3 center;
-		Vector3 entry;
-
-		float distance;
-		int prev_edge;
 		bool clockwise;
+		int index; // Of its state in a path query.
 
 		NavMesh *owner;
 	};
@@ -122,6 +121,103 @@ class Navigation : public Spatial {
 
 	Map<EdgeKey, Connection> connections;
 
+	// State of a polygon during a single path query.
+	struct PolygonState {
+
+		Vector3 entry;
+		float distance;
+		int prev_edge;
+		uint32_t pass;
+	};
+
+	// Scratch space of a single path query, so several queries can run at once.
+	struct PathQuery {
+
+		Vector<PolygonState> states;
+		uint32_t pass;
+
+		void begin(int p_polygon_count);
+
+		// Returns the state of a polygon, reset if the current query didn't use it yet.
+		_FORCE_INLINE_ PolygonState &get(const Polygon *p_poly) {
+
+			PolygonState &state = states.write[p_poly->index];
+			if (state.pass != pass) {
+				state.pass = pass;
+				state.distance = 0;
+				state.prev_edge = -1;
+			}
+			return state;
+		}
+
+		PathQuery() { pass = 0; }
+	};
+
+	Vector<PathQuery *> free_queries;
+	Mutex *query_mutex;
+	RWLock *navmesh_lock; // Queries read while navmeshes are added, moved or removed.
+	int polygon_count;
+
+	PathQuery *_acquire_query();
+	void _release_query(PathQuery *p_query);
+	void _update_polygon_indices();
+
+	// Bounding volume hierarchy over the polygons of linked navmeshes, to find the closest ones quickly.
+	enum {
+		BVH_LEAF_SIZE = 4
+	};
+
+	struct BVHNode {
+
+		AABB aabb;
+		int first; // First of the two children for a branch, or of the polygons for a leaf.
+		int count; // Polygons of a leaf, 0 for a branch.
+	};
+
+	struct BVHItem {
+
+		AABB aabb;
+		Polygon *polygon;
+	};
+
+	struct BVHItemSort {
+
+		int axis;
+		_FORCE_INLINE_ bool operator()(const BVHItem &p_a, const BVHItem &p_b) const {
+			return p_a.aabb.position[axis] + p_a.aabb.size[axis] * 0.5 < p_b.aabb.position[axis] + p_b.aabb.size[axis] * 0.5;
+		}
+	};
+
+	Vector<BVHNode> bvh_nodes;
+	Vector<Polygon *> bvh_polygons;
+
+	void _build_bvh();
+	void _build_bvh_node(int p_node, BVHItem *p_items, int p_from, int p_to);
+	Polygon *_get_closest_polygon(const Vector3 &p_point, Vector3 &r_point, Vector3 *r_normal = NULL) const;
+
+	// Distance to a goal from every polygon, so many agents can steer towards it without searching.
+	struct FlowFieldCell {
+
+		real_t f_score; // Distance to the goal from the entry, as ordered by the open list.
+		int open_index;
+		int next_edge; // Edge leading to the next polygon towards the goal, -1 in the goal polygon.
+		Vector3 entry; // Midpoint of that edge, or the goal.
+	};
+
+	struct FlowField {
+
+		Vector3 goal;
+		bool dirty; // Recomputed on the next access after polygons are linked or unlinked.
+		Vector<FlowFieldCell> cells;
+	};
+
+	Map<int, FlowField> flow_field_map;
+	int last_flow_field_id;
+	Mutex *flow_field_mutex;
+
+	void _update_flow_field(FlowField &r_field);
+	void _invalidate_flow_fields();
+
 	struct NavMesh {
 
 		Object *owner;
@@ -158,7 +254,7 @@ class Navigation : public Spatial {
 	int last_id;
 
 	Vector3 up;
-	void _clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly);
+	void _clip_path(PathQuery *p_query, Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly);
 
 protected:
 	static void _bind_methods();
@@ -178,7 +274,18 @@ public:
 	Vector3 get_closest_point_normal(const Vector3 &p_point);
 	Object *get_closest_point_owner(const Vector3 &p_point);
 
+	int request_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize = true);
+	void cancel_path_request(int p_request_id);
+
+	int flow_field_create(const Vector3 &p_goal);
+	void flow_field_set_goal(int p_id, const Vector3 &p_goal);
+	Vector3 flow_field_get_goal(int p_id) const;
+	Vector3 flow_field_get_direction(int p_id, const Vector3 &p_point);
+	real_t flow_field_get_distance(int p_id, const Vector3 &p_point);
+	void flow_field_remove(int p_id);
+
 	Navigation();
+	~Navigation();
 };
 
 #endif // NAVIGATION_H
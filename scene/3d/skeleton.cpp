@@ -109,7 +109,7 @@ bool Skeleton::_get(const StringName &p_path, Variant &r_ret) const {
 	else if (what == "bound_children") {
 		Array children;
 
-		for (const List<uint32_t>::Element *E = bones[which].nodes_bound.front(); E; E = E->next()) {
+		for (const List<ObjectID>::Element *E = bones[which].nodes_bound.front(); E; E = E->next()) {
 
 			Object *obj = ObjectDB::get_instance(E->get());
 			ERR_CONTINUE(!obj);
@@ -192,6 +192,40 @@ void Skeleton::_update_process_order() {
 	process_order_dirty = false;
 }
 
+// Bone transforms travel as 12 floats per bone: the basis rows, each followed by
+// the matching origin component. Same layout as the VisualServer bulk array.
+static _FORCE_INLINE_ void _pack_transform(const Transform &p_transform, float *r_data) {
+
+	r_data[0] = p_transform.basis.elements[0][0];
+	r_data[1] = p_transform.basis.elements[0][1];
+	r_data[2] = p_transform.basis.elements[0][2];
+	r_data[3] = p_transform.origin.x;
+	r_data[4] = p_transform.basis.elements[1][0];
+	r_data[5] = p_transform.basis.elements[1][1];
+	r_data[6] = p_transform.basis.elements[1][2];
+	r_data[7] = p_transform.origin.y;
+	r_data[8] = p_transform.basis.elements[2][0];
+	r_data[9] = p_transform.basis.elements[2][1];
+	r_data[10] = p_transform.basis.elements[2][2];
+	r_data[11] = p_transform.origin.z;
+}
+
+static _FORCE_INLINE_ void _unpack_transform(const float *p_data, Transform &r_transform) {
+
+	r_transform.basis.elements[0][0] = p_data[0];
+	r_transform.basis.elements[0][1] = p_data[1];
+	r_transform.basis.elements[0][2] = p_data[2];
+	r_transform.origin.x = p_data[3];
+	r_transform.basis.elements[1][0] = p_data[4];
+	r_transform.basis.elements[1][1] = p_data[5];
+	r_transform.basis.elements[1][2] = p_data[6];
+	r_transform.origin.y = p_data[7];
+	r_transform.basis.elements[2][0] = p_data[8];
+	r_transform.basis.elements[2][1] = p_data[9];
+	r_transform.basis.elements[2][2] = p_data[10];
+	r_transform.origin.z = p_data[11];
+}
+
 void Skeleton::_notification(int p_what) {
 
 	switch (p_what) {
@@ -216,6 +250,11 @@ void Skeleton::_notification(int p_what) {
 
 			vs->skeleton_allocate(skeleton, len); // if same size, nothing really happens
 
+			if (bone_transforms.size() != len * 12) {
+				bone_transforms.resize(len * 12);
+				all_bones_dirty = true;
+			}
+
 			_update_process_order();
 
 			const int *order = process_order.ptr();
@@ -237,12 +276,26 @@ void Skeleton::_notification(int p_what) {
 				}
 
 				rest_global_inverse_dirty = false;
+				all_bones_dirty = true;
 			}
 
+			// Only bones whose pose changed, or whose parent was recomputed in
+			// this pass, need their global pose rebuilt.
+			update_pass++;
+			bool changed = false;
+			PoolVector<float>::Write w = bone_transforms.write();
+
 			for (int i = 0; i < len; i++) {
 
 				Bone &b = bonesptr[order[i]];
 
+				if (!all_bones_dirty && !b.pose_dirty && (b.parent < 0 || bonesptr[b.parent].update_pass != update_pass))
+					continue;
+
+				b.pose_dirty = false;
+				b.update_pass = update_pass;
+				changed = true;
+
 				if (b.disable_rest) {
 					if (b.enabled) {
 
@@ -299,9 +352,10 @@ void Skeleton::_notification(int p_what) {
 				}
 
 				b.transform_final = b.pose_global * b.rest_global_inverse;
-				vs->skeleton_bone_set_transform(skeleton, order[i], b.transform_final);
 
-				for (List<uint32_t>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
+				_pack_transform(b.transform_final, &w[order[i] * 12]);
+
+				for (List<ObjectID>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
 
 					Object *obj = ObjectDB::get_instance(E->get());
 					ERR_CONTINUE(!obj);
@@ -311,6 +365,13 @@ void Skeleton::_notification(int p_what) {
 				}
 			}
 
+			w = PoolVector<float>::Write();
+
+			if (changed) {
+				vs->skeleton_set_as_bulk_array(skeleton, bone_transforms);
+			}
+
+			all_bones_dirty = false;
 			dirty = false;
 		} break;
 	}
@@ -496,9 +557,9 @@ void Skeleton::bind_child_node_to_bone(int p_bone, Node *p_node) {
 	ERR_FAIL_NULL(p_node);
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
-	uint32_t id = p_node->get_instance_id();
+	ObjectID id = p_node->get_instance_id();
 
-	for (const List<uint32_t>::Element *E = bones[p_bone].nodes_bound.front(); E; E = E->next()) {
+	for (const List<ObjectID>::Element *E = bones[p_bone].nodes_bound.front(); E; E = E->next()) {
 
 		if (E->get() == id)
 			return; // already here
@@ -511,14 +572,14 @@ void Skeleton::unbind_child_node_from_bone(int p_bone, Node *p_node) {
 	ERR_FAIL_NULL(p_node);
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
-	uint32_t id = p_node->get_instance_id();
+	ObjectID id = p_node->get_instance_id();
 	bones.write[p_bone].nodes_bound.erase(id);
 }
 void Skeleton::get_bound_child_nodes_to_bone(int p_bone, List<Node *> *p_bound) const {
 
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
-	for (const List<uint32_t>::Element *E = bones[p_bone].nodes_bound.front(); E; E = E->next()) {
+	for (const List<ObjectID>::Element *E = bones[p_bone].nodes_bound.front(); E; E = E->next()) {
 
 		Object *obj = ObjectDB::get_instance(E->get());
 		ERR_CONTINUE(!obj);
@@ -543,7 +604,7 @@ void Skeleton::set_bone_pose(int p_bone, const Transform &p_pose) {
 	ERR_FAIL_COND(!is_inside_tree());
 
 	bones.write[p_bone].pose = p_pose;
-	_make_dirty();
+	_make_bone_dirty(p_bone);
 }
 Transform Skeleton::get_bone_pose(int p_bone) const {
 
@@ -551,6 +612,65 @@ Transform Skeleton::get_bone_pose(int p_bone) const {
 	return bones[p_bone].pose;
 }
 
+void Skeleton::set_bone_poses(const int *p_bones, const Transform *p_poses, int p_count) {
+
+	ERR_FAIL_COND(!is_inside_tree());
+
+	int bone_count = bones.size();
+	Bone *bonesptr = bones.ptrw();
+
+	for (int i = 0; i < p_count; i++) {
+
+		int bone = p_bones ? p_bones[i] : i;
+		ERR_CONTINUE(bone < 0 || bone >= bone_count);
+
+		bonesptr[bone].pose = p_poses[i];
+		bonesptr[bone].pose_dirty = true;
+	}
+
+	if (p_count > 0) {
+		_make_dirty_notify();
+	}
+}
+
+void Skeleton::_set_bone_poses(const PoolVector<float> &p_poses, const PoolVector<int> &p_bones) {
+
+	ERR_FAIL_COND(p_poses.size() % 12 != 0);
+	int count = p_poses.size() / 12;
+	ERR_FAIL_COND(p_bones.size() && p_bones.size() != count);
+
+	Vector<Transform> poses;
+	poses.resize(count);
+	Transform *posesptr = poses.ptrw();
+
+	PoolVector<float>::Read r = p_poses.read();
+	for (int i = 0; i < count; i++) {
+
+		_unpack_transform(&r[i * 12], posesptr[i]);
+	}
+
+	if (p_bones.size()) {
+		PoolVector<int>::Read rb = p_bones.read();
+		set_bone_poses(rb.ptr(), posesptr, count);
+	} else {
+		set_bone_poses(NULL, posesptr, count);
+	}
+}
+
+PoolVector<float> Skeleton::_get_bone_poses() const {
+
+	PoolVector<float> poses;
+	poses.resize(bones.size() * 12);
+	PoolVector<float>::Write w = poses.write();
+
+	for (int i = 0; i < bones.size(); i++) {
+
+		_pack_transform(bones[i].pose, &w[i * 12]);
+	}
+
+	return poses;
+}
+
 void Skeleton::set_bone_custom_pose(int p_bone, const Transform &p_custom_pose) {
 
 	ERR_FAIL_INDEX(p_bone, bones.size());
@@ -559,7 +679,7 @@ void Skeleton::set_bone_custom_pose(int p_bone, const Transform &p_custom_pose)
 	bones.write[p_bone].custom_pose_enable = (p_custom_pose != Transform());
 	bones.write[p_bone].custom_pose = p_custom_pose;
 
-	_make_dirty();
+	_make_bone_dirty(p_bone);
 }
 
 Transform Skeleton::get_bone_custom_pose(int p_bone) const {
@@ -570,6 +690,18 @@ Transform Skeleton::get_bone_custom_pose(int p_bone) const {
 
 void Skeleton::_make_dirty() {
 
+	all_bones_dirty = true;
+	_make_dirty_notify();
+}
+
+void Skeleton::_make_bone_dirty(int p_bone) {
+
+	bones.write[p_bone].pose_dirty = true;
+	_make_dirty_notify();
+}
+
+void Skeleton::_make_dirty_notify() {
+
 	if (dirty)
 		return;
 
@@ -784,6 +916,9 @@ void Skeleton::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_bone_pose", "bone_idx"), &Skeleton::get_bone_pose);
 	ClassDB::bind_method(D_METHOD("set_bone_pose", "bone_idx", "pose"), &Skeleton::set_bone_pose);
 
+	ClassDB::bind_method(D_METHOD("set_bone_poses", "poses", "bones"), &Skeleton::_set_bone_poses, DEFVAL(PoolVector<int>()));
+	ClassDB::bind_method(D_METHOD("get_bone_poses"), &Skeleton::_get_bone_poses);
+
 	ClassDB::bind_method(D_METHOD("set_bone_global_pose", "bone_idx", "pose"), &Skeleton::set_bone_global_pose);
 	ClassDB::bind_method(D_METHOD("get_bone_global_pose", "bone_idx"), &Skeleton::get_bone_global_pose);
 
@@ -814,6 +949,8 @@ Skeleton::Skeleton() {
 
 	rest_global_inverse_dirty = true;
 	dirty = false;
+	all_bones_dirty = true;
+	update_pass = 0;
 	process_order_dirty = true;
 	skeleton = VisualServer::get_singleton()->skeleton_create();
 	set_notify_transform(true);
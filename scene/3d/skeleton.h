@@ -70,12 +70,15 @@ class Skeleton : public Spatial {
 
 		Transform transform_final;
 
+		bool pose_dirty;
+		uint64_t update_pass;
+
 #ifndef _3D_DISABLED
 		PhysicalBone *physical_bone;
 		PhysicalBone *cache_parent_physical_bone;
 #endif // _3D_DISABLED
 
-		List<uint32_t> nodes_bound;
+		List<ObjectID> nodes_bound;
 
 		Bone() {
 			parent = -1;
@@ -83,6 +86,8 @@ class Skeleton : public Spatial {
 			ignore_animation = false;
 			custom_pose_enable = false;
 			disable_rest = false;
+			pose_dirty = true;
+			update_pass = 0;
 #ifndef _3D_DISABLED
 			physical_bone = NULL;
 			cache_parent_physical_bone = NULL;
@@ -97,9 +102,14 @@ class Skeleton : public Spatial {
 	bool process_order_dirty;
 
 	RID skeleton;
+	PoolVector<float> bone_transforms; // 12 floats per bone, uploaded in bulk
 
 	void _make_dirty();
+	void _make_bone_dirty(int p_bone);
+	void _make_dirty_notify();
 	bool dirty;
+	bool all_bones_dirty;
+	uint64_t update_pass;
 	bool use_bones_in_world_transform;
 
 	// bind helpers
@@ -116,6 +126,9 @@ class Skeleton : public Spatial {
 		return bound;
 	}
 
+	void _set_bone_poses(const PoolVector<float> &p_poses, const PoolVector<int> &p_bones);
+	PoolVector<float> _get_bone_poses() const;
+
 	void _update_process_order();
 
 protected:
@@ -174,6 +187,8 @@ public:
 	void set_bone_pose(int p_bone, const Transform &p_pose);
 	Transform get_bone_pose(int p_bone) const;
 
+	void set_bone_poses(const int *p_bones, const Transform *p_poses, int p_count);
+
 	void set_bone_custom_pose(int p_bone, const Transform &p_custom_pose);
 	Transform get_bone_custom_pose(int p_bone) const;
 
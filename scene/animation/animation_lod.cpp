@@ -0,0 +1,198 @@
+/*************************************************************************/
+/*  animation_lod.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "animation_lod.h"
+
+#include "core/engine.h"
+#include "scene/2d/visibility_notifier_2d.h"
+#include "scene/3d/camera.h"
+#include "scene/3d/skeleton.h"
+#include "scene/3d/visibility_notifier.h"
+#include "scene/main/viewport.h"
+
+uint64_t AnimationLOD::counted_frame = 0;
+int AnimationLOD::counts[LEVEL_MAX] = { 0, 0, 0 };
+int AnimationLOD::last_counts[LEVEL_MAX] = { 0, 0, 0 };
+
+void AnimationLOD::_rotate_counts() {
+
+	uint64_t frame = Engine::get_singleton()->get_idle_frames();
+	if (counted_frame == frame)
+		return;
+
+	for (int i = 0; i < LEVEL_MAX; i++) {
+		last_counts[i] = counted_frame + 1 == frame ? counts[i] : 0; // nothing counted in the last frame otherwise
+		counts[i] = 0;
+	}
+	counted_frame = frame;
+}
+
+void AnimationLOD::set_update_interval(int p_frames) {
+
+	ERR_FAIL_COND(p_frames < 1);
+	update_interval = p_frames;
+	frame_phase = -1;
+}
+
+int AnimationLOD::get_update_interval() const {
+
+	return update_interval;
+}
+
+void AnimationLOD::set_visibility_notifier(const NodePath &p_path) {
+
+	visibility_notifier = p_path;
+}
+
+NodePath AnimationLOD::get_visibility_notifier() const {
+
+	return visibility_notifier;
+}
+
+void AnimationLOD::set_reduced_distance(float p_distance) {
+
+	reduced_distance = p_distance;
+}
+
+float AnimationLOD::get_reduced_distance() const {
+
+	return reduced_distance;
+}
+
+void AnimationLOD::set_reduced_bone_depth(int p_depth) {
+
+	ERR_FAIL_COND(p_depth < 0);
+	reduced_bone_depth = p_depth;
+}
+
+int AnimationLOD::get_reduced_bone_depth() const {
+
+	return reduced_bone_depth;
+}
+
+AnimationLOD::Level AnimationLOD::update(Node *p_owner, Node *p_target, float p_delta, float &r_delta) {
+
+	r_delta = p_delta;
+
+	if (Engine::get_singleton()->is_editor_hint())
+		return LEVEL_FULL;
+
+	Level level = LEVEL_FULL;
+
+	if (update_interval > 1) {
+
+		if (frame_phase < 0) {
+			// spread owners over the frames, so they don't all evaluate on the same one
+			frame_phase = p_owner->get_instance_id() % update_interval;
+		}
+
+		frame_phase = (frame_phase + 1) % update_interval;
+		if (frame_phase != 0) {
+			level = LEVEL_SKIP;
+		}
+	}
+
+	if (level != LEVEL_SKIP && !visibility_notifier.is_empty() && p_owner->has_node(visibility_notifier)) {
+
+		Node *notifier = p_owner->get_node(visibility_notifier);
+		VisibilityNotifier *notifier_3d = Object::cast_to<VisibilityNotifier>(notifier);
+		VisibilityNotifier2D *notifier_2d = Object::cast_to<VisibilityNotifier2D>(notifier);
+
+		if ((notifier_3d && !notifier_3d->is_on_screen()) || (notifier_2d && !notifier_2d->is_on_screen())) {
+			level = LEVEL_SKIP;
+		}
+	}
+
+	if (level != LEVEL_SKIP && reduced_distance > 0) {
+
+		Spatial *target = Object::cast_to<Spatial>(p_target);
+		Camera *camera = p_owner->get_viewport() ? p_owner->get_viewport()->get_camera() : NULL;
+
+		if (target && camera && target->is_inside_tree()) {
+
+			float distance_squared = camera->get_global_transform().origin.distance_squared_to(target->get_global_transform().origin);
+			if (distance_squared > reduced_distance * reduced_distance) {
+				level = LEVEL_REDUCED;
+			}
+		}
+	}
+
+	_rotate_counts();
+	counts[level]++;
+
+	if (level == LEVEL_SKIP) {
+		// the time still passes, it's caught up on the next evaluation
+		skipped_delta += p_delta;
+		return LEVEL_SKIP;
+	}
+
+	r_delta = skipped_delta + p_delta;
+	skipped_delta = 0;
+	return level;
+}
+
+int AnimationLOD::get_bone_depth(const Skeleton *p_skeleton, int p_bone) {
+
+	int depth = 0;
+	int parent = p_skeleton->get_bone_parent(p_bone);
+	while (parent >= 0) {
+		depth++;
+		parent = p_skeleton->get_bone_parent(parent);
+	}
+
+	return depth;
+}
+
+int AnimationLOD::get_evaluated_count() {
+
+	_rotate_counts();
+	return last_counts[LEVEL_FULL] + last_counts[LEVEL_REDUCED];
+}
+
+int AnimationLOD::get_reduced_count() {
+
+	_rotate_counts();
+	return last_counts[LEVEL_REDUCED];
+}
+
+int AnimationLOD::get_skipped_count() {
+
+	_rotate_counts();
+	return last_counts[LEVEL_SKIP];
+}
+
+AnimationLOD::AnimationLOD() {
+
+	update_interval = 1;
+	reduced_distance = 0;
+	reduced_bone_depth = 2;
+	frame_phase = -1;
+	skipped_delta = 0;
+}
@@ -0,0 +1,94 @@
+/*************************************************************************/
+/*  animation_lod.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef ANIMATION_LOD_H
+#define ANIMATION_LOD_H
+
+#include "core/node_path.h"
+
+class Node;
+class Skeleton;
+
+// Level of detail shared by AnimationPlayer and AnimationTree: decides on
+// which frames they evaluate their animations, and whether they evaluate all
+// of their tracks.
+class AnimationLOD {
+
+public:
+	enum Level {
+		LEVEL_SKIP,
+		LEVEL_FULL,
+		LEVEL_REDUCED,
+		LEVEL_MAX
+	};
+
+private:
+	int update_interval;
+	NodePath visibility_notifier;
+	float reduced_distance;
+	int reduced_bone_depth;
+
+	int frame_phase;
+	float skipped_delta;
+
+	static uint64_t counted_frame;
+	static int counts[LEVEL_MAX];
+	static int last_counts[LEVEL_MAX];
+
+	static void _rotate_counts();
+
+public:
+	void set_update_interval(int p_frames);
+	int get_update_interval() const;
+
+	void set_visibility_notifier(const NodePath &p_path);
+	NodePath get_visibility_notifier() const;
+
+	void set_reduced_distance(float p_distance);
+	float get_reduced_distance() const;
+
+	void set_reduced_bone_depth(int p_depth);
+	int get_reduced_bone_depth() const;
+
+	// Returns the level to evaluate at this frame, and the time elapsed since the last evaluation.
+	// p_owner resolves the visibility notifier, p_target is measured against the camera.
+	Level update(Node *p_owner, Node *p_target, float p_delta, float &r_delta);
+
+	static int get_bone_depth(const Skeleton *p_skeleton, int p_bone);
+
+	// Counts of the last frame.
+	static int get_evaluated_count();
+	static int get_reduced_count();
+	static int get_skipped_count();
+
+	AnimationLOD();
+};
+
+#endif // ANIMATION_LOD_H
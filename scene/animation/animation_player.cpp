@@ -199,16 +199,18 @@ void AnimationPlayer::_notification(int p_what) {
 			if (animation_process_mode == ANIMATION_PROCESS_PHYSICS)
 				break;
 
-			if (processing)
-				_animation_process(get_process_delta_time());
+			float delta;
+			if (processing && _update_lod(get_process_delta_time(), delta))
+				_animation_process(delta);
 		} break;
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
 
 			if (animation_process_mode == ANIMATION_PROCESS_IDLE)
 				break;
 
-			if (processing)
-				_animation_process(get_physics_process_delta_time());
+			float delta;
+			if (processing && _update_lod(get_physics_process_delta_time(), delta))
+				_animation_process(delta);
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
 
@@ -241,7 +243,7 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 			ERR_EXPLAIN("On Animation: '" + p_anim->name + "', couldn't resolve track:  '" + String(a->track_get_path(i)) + "'");
 		}
 		ERR_CONTINUE(!child); // couldn't find the child node
-		uint32_t id = resource.is_valid() ? resource->get_instance_id() : child->get_instance_id();
+		ObjectID id = resource.is_valid() ? resource->get_instance_id() : child->get_instance_id();
 		int bone_idx = -1;
 
 		if (a->track_get_path(i).get_subname_count() == 1 && Object::cast_to<Skeleton>(child)) {
@@ -289,6 +291,7 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 						p_anim->node_cache[i]->spatial = NULL;
 						ERR_CONTINUE(p_anim->node_cache[i]->bone_idx < 0);
 					}
+					p_anim->node_cache[i]->bone_depth = AnimationLOD::get_bone_depth(p_anim->node_cache[i]->skeleton, p_anim->node_cache[i]->bone_idx);
 				} else {
 					// no property, just use spatialnode
 					p_anim->node_cache[i]->skeleton = NULL;
@@ -331,6 +334,13 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim) {
 			}
 		}
 	}
+
+	p_anim->transform_tracks.clear();
+	for (int i = 0; i < a->get_track_count(); i++) {
+		if (a->track_get_type(i) == Animation::TYPE_TRANSFORM && p_anim->node_cache[i] && p_anim->node_cache[i]->spatial) {
+			p_anim->transform_tracks.push_back(i);
+		}
+	}
 }
 
 void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current, bool p_seeked, bool p_started) {
@@ -341,6 +351,21 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 	Animation *a = p_anim->animation.operator->();
 	bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
 
+	if (p_anim->key_cursors.size() != a->get_track_count()) {
+		p_anim->key_cursors.resize(a->get_track_count());
+		for (int i = 0; i < p_anim->key_cursors.size(); i++) {
+			p_anim->key_cursors.write[i] = -1;
+		}
+	}
+	int *key_cursors = p_anim->key_cursors.ptrw();
+
+	// Sample the transform tracks bound to a node in one pass, instead of dispatching per track.
+	// At reduced LOD most bone tracks are skipped, so they are sampled one by one.
+	if (!lod_reduced) {
+		transform_samples.resize(a->get_track_count());
+		a->transform_tracks_interpolate(p_time, p_anim->transform_tracks.ptr(), p_anim->transform_tracks.size(), transform_samples.ptrw(), key_cursors);
+	}
+
 	for (int i = 0; i < a->get_track_count(); i++) {
 
 		// If an animation changes this animation (or it animates itself)
@@ -367,16 +392,28 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 				if (!nc->spatial)
 					continue;
 
-				Vector3 loc;
-				Quat rot;
-				Vector3 scale;
+				Animation::TransformTrackSample sample;
+				if (lod_reduced) {
+
+					if (nc->skeleton && nc->bone_depth > lod.get_reduced_bone_depth())
+						continue; // far away, leave the bone at its last pose
+
+					int *cursor = i < p_anim->key_cursors.size() ? &key_cursors[i] : NULL;
+					sample.valid = a->transform_track_interpolate(i, p_time, &sample.loc, &sample.rot, &sample.scale, cursor) == OK;
 
-				Error err = a->transform_track_interpolate(i, p_time, &loc, &rot, &scale);
-				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
+				} else if (i < transform_samples.size()) {
+					sample = transform_samples[i];
+				} else {
+					continue; // tracks were added while processing
+				}
 
-				if (err != OK)
+				if (!sample.valid)
 					continue;
 
+				const Vector3 &loc = sample.loc;
+				const Quat &rot = sample.rot;
+				const Vector3 &scale = sample.scale;
+
 				if (nc->accum_pass != accum_pass) {
 					ERR_CONTINUE(cache_update_size >= NODE_CACHE_UPDATE_MAX);
 					cache_update[cache_update_size++] = nc;
@@ -451,7 +488,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, float
 
 				if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE || (p_delta == 0 && update_mode == Animation::UPDATE_DISCRETE)) { //delta == 0 means seek
 
-					Variant value = a->value_track_interpolate(i, p_time);
+					Variant value = a->value_track_interpolate(i, p_time, i < p_anim->key_cursors.size() ? &key_cursors[i] : NULL);
 
 					if (value == Variant())
 						continue;
@@ -1397,6 +1434,7 @@ void AnimationPlayer::clear_caches() {
 	for (Map<StringName, AnimationData>::Element *E = animation_set.front(); E; E = E->next()) {
 
 		E->get().node_cache.clear();
+		E->get().transform_tracks.clear();
 	}
 
 	cache_update_size = 0;
@@ -1459,6 +1497,55 @@ AnimationPlayer::AnimationProcessMode AnimationPlayer::get_animation_process_mod
 	return animation_process_mode;
 }
 
+bool AnimationPlayer::_update_lod(float p_delta, float &r_delta) {
+
+	Node *target = has_node(root) ? get_node(root) : NULL;
+	AnimationLOD::Level level = lod.update(this, target, p_delta, r_delta);
+
+	lod_reduced = level == AnimationLOD::LEVEL_REDUCED;
+	return level != AnimationLOD::LEVEL_SKIP;
+}
+
+void AnimationPlayer::set_lod_update_interval(int p_frames) {
+
+	lod.set_update_interval(p_frames);
+}
+
+int AnimationPlayer::get_lod_update_interval() const {
+
+	return lod.get_update_interval();
+}
+
+void AnimationPlayer::set_lod_visibility_notifier(const NodePath &p_path) {
+
+	lod.set_visibility_notifier(p_path);
+}
+
+NodePath AnimationPlayer::get_lod_visibility_notifier() const {
+
+	return lod.get_visibility_notifier();
+}
+
+void AnimationPlayer::set_lod_reduced_distance(float p_distance) {
+
+	lod.set_reduced_distance(p_distance);
+}
+
+float AnimationPlayer::get_lod_reduced_distance() const {
+
+	return lod.get_reduced_distance();
+}
+
+void AnimationPlayer::set_lod_reduced_bone_depth(int p_depth) {
+
+	lod.set_reduced_bone_depth(p_depth);
+}
+
+int AnimationPlayer::get_lod_reduced_bone_depth() const {
+
+	return lod.get_reduced_bone_depth();
+}
+
 void AnimationPlayer::_set_process(bool p_process, bool p_force) {
 
 	if (processing == p_process && !p_force)
@@ -1640,6 +1727,15 @@ void AnimationPlayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_animation_process_mode", "mode"), &AnimationPlayer::set_animation_process_mode);
 	ClassDB::bind_method(D_METHOD("get_animation_process_mode"), &AnimationPlayer::get_animation_process_mode);
 
+	ClassDB::bind_method(D_METHOD("set_lod_update_interval", "frames"), &AnimationPlayer::set_lod_update_interval);
+	ClassDB::bind_method(D_METHOD("get_lod_update_interval"), &AnimationPlayer::get_lod_update_interval);
+	ClassDB::bind_method(D_METHOD("set_lod_visibility_notifier", "path"), &AnimationPlayer::set_lod_visibility_notifier);
+	ClassDB::bind_method(D_METHOD("get_lod_visibility_notifier"), &AnimationPlayer::get_lod_visibility_notifier);
+	ClassDB::bind_method(D_METHOD("set_lod_reduced_distance", "distance"), &AnimationPlayer::set_lod_reduced_distance);
+	ClassDB::bind_method(D_METHOD("get_lod_reduced_distance"), &AnimationPlayer::get_lod_reduced_distance);
+	ClassDB::bind_method(D_METHOD("set_lod_reduced_bone_depth", "depth"), &AnimationPlayer::set_lod_reduced_bone_depth);
+	ClassDB::bind_method(D_METHOD("get_lod_reduced_bone_depth"), &AnimationPlayer::get_lod_reduced_bone_depth);
+
 	ClassDB::bind_method(D_METHOD("get_current_animation_position"), &AnimationPlayer::get_current_animation_position);
 	ClassDB::bind_method(D_METHOD("get_current_animation_length"), &AnimationPlayer::get_current_animation_length);
 
@@ -1659,6 +1755,12 @@ void AnimationPlayer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playback_active", PROPERTY_HINT_NONE, "", 0), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "playback_speed", PROPERTY_HINT_RANGE, "-64,64,0.01"), "set_speed_scale", "get_speed_scale");
 
+	ADD_GROUP("LOD", "lod_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_update_interval", PROPERTY_HINT_RANGE, "1,60,1"), "set_lod_update_interval", "get_lod_update_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "lod_visibility_notifier", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "VisibilityNotifier,VisibilityNotifier2D"), "set_lod_visibility_notifier", "get_lod_visibility_notifier");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "lod_reduced_distance", PROPERTY_HINT_RANGE, "0,4096,0.01,or_greater"), "set_lod_reduced_distance", "get_lod_reduced_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_reduced_bone_depth", PROPERTY_HINT_RANGE, "0,64,1"), "set_lod_reduced_bone_depth", "get_lod_reduced_bone_depth");
+
 	ADD_SIGNAL(MethodInfo("animation_finished", PropertyInfo(Variant::STRING, "anim_name")));
 	ADD_SIGNAL(MethodInfo("animation_changed", PropertyInfo(Variant::STRING, "old_name"), PropertyInfo(Variant::STRING, "new_name")));
 	ADD_SIGNAL(MethodInfo("animation_started", PropertyInfo(Variant::STRING, "anim_name")));
@@ -1671,6 +1773,7 @@ void AnimationPlayer::_bind_methods() {
 
 AnimationPlayer::AnimationPlayer() {
 
+	lod_reduced = false;
 	accum_pass = 1;
 	cache_update_size = 0;
 	cache_update_prop_size = 0;
@@ -32,6 +32,7 @@
 #define ANIMATION_PLAYER_H
 
 #include "scene/2d/node_2d.h"
+#include "scene/animation/animation_lod.h"
 #include "scene/3d/skeleton.h"
 #include "scene/3d/spatial.h"
 #include "scene/resources/animation.h"
@@ -92,6 +93,7 @@ private:
 		Node2D *node_2d;
 		Skeleton *skeleton;
 		int bone_idx;
+		int bone_depth; // for LOD
 		// accumulated transforms
 
 		Vector3 loc_accum;
@@ -148,6 +150,7 @@ private:
 				node_2d(NULL),
 				skeleton(NULL),
 				bone_idx(-1),
+				bone_depth(0),
 				accum_pass(0),
 				audio_playing(false),
 				audio_start(0.0),
@@ -157,7 +160,7 @@ private:
 
 	struct TrackNodeCacheKey {
 
-		uint32_t id;
+		ObjectID id;
 		int bone_idx;
 
 		inline bool operator<(const TrackNodeCacheKey &p_right) const {
@@ -179,6 +182,7 @@ private:
 	int cache_update_prop_size;
 	TrackNodeCache::BezierAnim *cache_update_bezier[NODE_CACHE_UPDATE_MAX];
 	int cache_update_bezier_size;
+	Vector<Animation::TransformTrackSample> transform_samples;
 	Set<TrackNodeCache *> playing_caches;
 
 	uint64_t accum_pass;
@@ -189,6 +193,8 @@ private:
 		String name;
 		StringName next;
 		Vector<TrackNodeCache *> node_cache;
+		Vector<int> key_cursors; // Last key sampled in each track.
+		Vector<int> transform_tracks; // Transform tracks bound to a spatial node, sampled together.
 		Ref<Animation> animation;
 	};
 
@@ -249,6 +255,10 @@ private:
 	bool processing;
 	bool active;
 
+	AnimationLOD lod;
+	bool lod_reduced;
+	bool _update_lod(float p_delta, float &r_delta);
+
 	NodePath root;
 
 	void _animation_process_animation(AnimationData *p_anim, float p_time, float p_delta, float p_interp, bool p_is_current = true, bool p_seeked = false, bool p_started = false);
@@ -338,6 +348,18 @@ public:
 	void set_animation_process_mode(AnimationProcessMode p_mode);
 	AnimationProcessMode get_animation_process_mode() const;
 
+	void set_lod_update_interval(int p_frames);
+	int get_lod_update_interval() const;
+
+	void set_lod_visibility_notifier(const NodePath &p_path);
+	NodePath get_lod_visibility_notifier() const;
+
+	void set_lod_reduced_distance(float p_distance);
+	float get_lod_reduced_distance() const;
+
+	void set_lod_reduced_bone_depth(int p_depth);
+	int get_lod_reduced_bone_depth() const;
+
 	void seek(float p_time, bool p_update = false);
 	void seek_delta(float p_time, float p_delta);
 	float get_current_animation_position() const;
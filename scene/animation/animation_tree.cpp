@@ -33,6 +33,8 @@
 #include "animation_blend_tree.h"
 #include "core/engine.h"
 #include "core/method_bind_ext.gen.inc"
+#include "core/os/os.h"
+#include "core/project_settings.h"
 #include "scene/scene_string_names.h"
 #include "servers/audio/audio_stream.h"
 
@@ -626,6 +628,7 @@ bool AnimationTree::_update_caches(AnimationPlayer *player) {
 
 								track_xform->skeleton = sk;
 								track_xform->bone_idx = bone_idx;
+								track_xform->bone_depth = AnimationLOD::get_bone_depth(sk, bone_idx);
 							}
 						}
 
@@ -738,12 +741,14 @@ void AnimationTree::_clear_caches() {
 		memdelete(track_cache[*K]);
 	}
 	playing_caches.clear();
+	key_cursors.clear();
+	parallel_evaluated = false; // the caches it blended into are gone
 
 	track_cache.clear();
 	cache_valid = false;
 }
 
-void AnimationTree::_process_graph(float p_delta) {
+bool AnimationTree::_prepare_graph(float p_delta) {
 
 	_update_properties(); //if properties need updating, update them
 
@@ -755,14 +760,14 @@ void AnimationTree::_process_graph(float p_delta) {
 		ERR_PRINT("AnimationTree: root AnimationNode is not set, disabling playback.");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!has_node(animation_player)) {
 		ERR_PRINT("AnimationTree: no valid AnimationPlayer path set, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	AnimationPlayer *player = Object::cast_to<AnimationPlayer>(get_node(animation_player));
@@ -793,12 +798,12 @@ void AnimationTree::_process_graph(float p_delta) {
 		ERR_PRINT("AnimationTree: path points to a node not an AnimationPlayer, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!cache_valid) {
 		if (!_update_caches(player)) {
-			return;
+			return false;
 		}
 	}
 
@@ -836,9 +841,11 @@ void AnimationTree::_process_graph(float p_delta) {
 		root->_pre_process(SceneStringNames::get_singleton()->parameters_base_path, NULL, &state, p_delta, false, Vector<StringName>());
 	}
 
-	if (!state.valid) {
-		return; //state is not valid. do nothing.
-	}
+	return state.valid; //if state is not valid, do nothing.
+}
+
+void AnimationTree::_blend_tracks(bool p_sample, bool p_trigger) {
+
 	//apply value/transform/bezier blends to track caches and execute method/audio/animation tracks
 
 	{
@@ -854,8 +861,19 @@ void AnimationTree::_process_graph(float p_delta) {
 			float delta = as.delta;
 			bool seeked = as.seeked;
 
+			Vector<int> &cursors = key_cursors[a->get_instance_id()];
+			if (cursors.size() != a->get_track_count()) {
+				cursors.resize(a->get_track_count());
+				for (int i = 0; i < cursors.size(); i++) {
+					cursors.write[i] = -1;
+				}
+			}
+			int *cursors_ptr = cursors.ptrw();
+
 			for (int i = 0; i < a->get_track_count(); i++) {
 
+				int *cursor = i < cursors.size() ? &cursors_ptr[i] : NULL;
+
 				NodePath path = a->track_get_path(i);
 
 				ERR_CONTINUE(!track_cache.has(path));
@@ -877,12 +895,25 @@ void AnimationTree::_process_graph(float p_delta) {
 				if (blend < CMP_EPSILON)
 					continue; //nothing to blend
 
+				// sampled tracks only write to their cache, the others act on their objects right away
+				bool sampled = track->type == Animation::TYPE_TRANSFORM || track->type == Animation::TYPE_BEZIER;
+				if (track->type == Animation::TYPE_VALUE) {
+					Animation::UpdateMode update_mode = a->value_track_get_update_mode(i);
+					sampled = update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE;
+				}
+
+				if (sampled ? !p_sample : !p_trigger)
+					continue;
+
 				switch (track->type) {
 
 					case Animation::TYPE_TRANSFORM: {
 
 						TrackCacheTransform *t = static_cast<TrackCacheTransform *>(track);
 
+						if (lod_reduced && t->skeleton && t->bone_depth > lod.get_reduced_bone_depth() && !track->root_motion)
+							continue; // far away, leave the bone at its last pose
+
 						if (track->root_motion) {
 
 							if (t->process_pass != process_pass) {
@@ -909,12 +940,12 @@ void AnimationTree::_process_graph(float p_delta) {
 
 							if (prev_time > time) {
 
-								Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
+								Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0], cursor);
 								if (err != OK) {
 									continue;
 								}
 
-								a->transform_track_interpolate(i, a->get_length(), &loc[1], &rot[1], &scale[1]);
+								a->transform_track_interpolate(i, a->get_length(), &loc[1], &rot[1], &scale[1], cursor);
 
 								t->loc += (loc[1] - loc[0]) * blend;
 								t->scale += (scale[1] - scale[0]) * blend;
@@ -924,12 +955,12 @@ void AnimationTree::_process_graph(float p_delta) {
 								prev_time = 0;
 							}
 
-							Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
+							Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0], cursor);
 							if (err != OK) {
 								continue;
 							}
 
-							a->transform_track_interpolate(i, time, &loc[1], &rot[1], &scale[1]);
+							a->transform_track_interpolate(i, time, &loc[1], &rot[1], &scale[1], cursor);
 
 							t->loc += (loc[1] - loc[0]) * blend;
 							t->scale += (scale[1] - scale[0]) * blend;
@@ -943,7 +974,7 @@ void AnimationTree::_process_graph(float p_delta) {
 							Quat rot;
 							Vector3 scale;
 
-							Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale);
+							Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale, cursor);
 							//ERR_CONTINUE(err!=OK); //used for testing, should be removed
 
 							if (t->process_pass != process_pass) {
@@ -981,7 +1012,7 @@ void AnimationTree::_process_graph(float p_delta) {
 
 						if (update_mode == Animation::UPDATE_CONTINUOUS || update_mode == Animation::UPDATE_CAPTURE) { //delta == 0 means seek
 
-							Variant value = a->value_track_interpolate(i, time);
+							Variant value = a->value_track_interpolate(i, time, cursor);
 
 							if (value == Variant())
 								continue;
@@ -1223,6 +1254,9 @@ void AnimationTree::_process_graph(float p_delta) {
 			}
 		}
 	}
+}
+
+void AnimationTree::_apply_tracks() {
 
 	{
 		// finally, set the tracks
@@ -1282,6 +1316,251 @@ void AnimationTree::_process_graph(float p_delta) {
 	}
 }
 
+void AnimationTree::_process_graph(float p_delta) {
+
+	if (!_prepare_graph(p_delta))
+		return;
+
+	_blend_tracks(true, true);
+	_apply_tracks();
+}
+
+void AnimationTree::_parallel_thread(void *p_user) {
+
+	while (true) {
+
+		parallel_sem->wait();
+
+		parallel_mutex->lock();
+		bool exit = parallel_exit;
+		parallel_mutex->unlock();
+
+		if (exit)
+			break;
+
+		while (true) {
+
+			parallel_mutex->lock();
+			AnimationTree *tree = NULL;
+			if (parallel_queue.size()) {
+				tree = parallel_queue.front()->get();
+				parallel_queue.pop_front();
+			}
+			parallel_mutex->unlock();
+
+			if (!tree)
+				break; // the rest was taken by other threads
+
+			tree->_blend_tracks(true, false);
+
+			parallel_mutex->lock();
+			parallel_pending--;
+			if (parallel_pending == 0 && parallel_waiting) {
+				parallel_waiting = false;
+				parallel_done_sem->post();
+			}
+			parallel_mutex->unlock();
+		}
+	}
+}
+
+void AnimationTree::_evaluate_parallel(bool p_physics, uint64_t p_frame) {
+
+	// Prepare every tree due this frame on the main thread, as the graph may run scripts.
+	// Only sampling and blending, which just read animations and write to the caches, run on the workers.
+	Vector<AnimationTree *> trees;
+	for (SelfList<AnimationTree> *E = parallel_trees.first(); E; E = E->next()) {
+
+		AnimationTree *tree = E->self();
+		if (tree->parallel_frame == p_frame || !tree->active)
+			continue;
+		if (tree->process_mode != (p_physics ? ANIMATION_PROCESS_PHYSICS : ANIMATION_PROCESS_IDLE))
+			continue;
+
+		tree->parallel_frame = p_frame;
+
+		float delta;
+		tree->parallel_evaluated = tree->_update_lod(p_physics ? tree->get_physics_process_delta_time() : tree->get_process_delta_time(), delta) && tree->_prepare_graph(delta);
+		if (tree->parallel_evaluated) {
+			trees.push_back(tree);
+		}
+	}
+
+	if (trees.size() == 0)
+		return;
+
+	if (parallel_workers.size() == 0 && trees.size() > 1) {
+
+		int thread_count = GLOBAL_GET("animation/animation_tree/worker_threads");
+		if (thread_count <= 0) {
+			thread_count = OS::get_singleton()->get_processor_count() - 1;
+		}
+
+		for (int i = 0; i < thread_count; i++) {
+			parallel_workers.push_back(Thread::create(_parallel_thread, NULL));
+		}
+	}
+
+	parallel_mutex->lock();
+	for (int i = 0; i < trees.size(); i++) {
+		parallel_queue.push_back(trees[i]);
+	}
+	parallel_pending = trees.size();
+	parallel_mutex->unlock();
+
+	for (int i = 0; i < MIN(trees.size(), parallel_workers.size()); i++) {
+		parallel_sem->post();
+	}
+
+	// Help with the work, then wait for the trees taken by the workers.
+	while (true) {
+
+		parallel_mutex->lock();
+		AnimationTree *tree = NULL;
+		if (parallel_queue.size()) {
+			tree = parallel_queue.front()->get();
+			parallel_queue.pop_front();
+		}
+		parallel_mutex->unlock();
+
+		if (!tree)
+			break;
+
+		tree->_blend_tracks(true, false);
+
+		parallel_mutex->lock();
+		parallel_pending--;
+		parallel_mutex->unlock();
+	}
+
+	parallel_mutex->lock();
+	bool wait = parallel_pending > 0;
+	parallel_waiting = wait;
+	parallel_mutex->unlock();
+
+	if (wait) {
+		parallel_done_sem->wait();
+	}
+}
+
+void AnimationTree::_process_parallel(bool p_physics) {
+
+	uint64_t frame = p_physics ? Engine::get_singleton()->get_physics_frames() : Engine::get_singleton()->get_idle_frames();
+
+	if (parallel_frame != frame) {
+		// First tree processed this frame, evaluate all of them.
+		_evaluate_parallel(p_physics, frame);
+	}
+
+	if (parallel_evaluated) {
+		parallel_evaluated = false;
+		_blend_tracks(false, true);
+		_apply_tracks();
+	}
+}
+
+void AnimationTree::set_parallel_evaluation(bool p_enable) {
+
+	if (parallel_evaluation == p_enable)
+		return;
+
+	parallel_evaluation = p_enable;
+	parallel_evaluated = false;
+
+	if (!is_inside_tree())
+		return;
+
+	if (parallel_evaluation) {
+		parallel_trees.add(&parallel_list);
+	} else {
+		parallel_trees.remove(&parallel_list);
+	}
+}
+
+bool AnimationTree::is_parallel_evaluation_enabled() const {
+
+	return parallel_evaluation;
+}
+
+bool AnimationTree::_update_lod(float p_delta, float &r_delta) {
+
+	AnimationLOD::Level level = lod.update(this, get_parent(), p_delta, r_delta);
+
+	lod_reduced = level == AnimationLOD::LEVEL_REDUCED;
+	return level != AnimationLOD::LEVEL_SKIP;
+}
+
+void AnimationTree::set_lod_update_interval(int p_frames) {
+
+	lod.set_update_interval(p_frames);
+}
+
+int AnimationTree::get_lod_update_interval() const {
+
+	return lod.get_update_interval();
+}
+
+void AnimationTree::set_lod_visibility_notifier(const NodePath &p_path) {
+
+	lod.set_visibility_notifier(p_path);
+}
+
+NodePath AnimationTree::get_lod_visibility_notifier() const {
+
+	return lod.get_visibility_notifier();
+}
+
+void AnimationTree::set_lod_reduced_distance(float p_distance) {
+
+	lod.set_reduced_distance(p_distance);
+}
+
+float AnimationTree::get_lod_reduced_distance() const {
+
+	return lod.get_reduced_distance();
+}
+
+void AnimationTree::set_lod_reduced_bone_depth(int p_depth) {
+
+	lod.set_reduced_bone_depth(p_depth);
+}
+
+int AnimationTree::get_lod_reduced_bone_depth() const {
+
+	return lod.get_reduced_bone_depth();
+}
+
+void AnimationTree::setup() {
+
+	GLOBAL_DEF("animation/animation_tree/worker_threads", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("animation/animation_tree/worker_threads", PropertyInfo(Variant::INT, "animation/animation_tree/worker_threads", PROPERTY_HINT_RANGE, "0,64,1"));
+
+	parallel_mutex = Mutex::create();
+	parallel_sem = Semaphore::create();
+	parallel_done_sem = Semaphore::create();
+}
+
+void AnimationTree::cleanup() {
+
+	parallel_mutex->lock();
+	parallel_exit = true;
+	parallel_mutex->unlock();
+
+	for (int i = 0; i < parallel_workers.size(); i++) {
+		parallel_sem->post();
+	}
+
+	for (int i = 0; i < parallel_workers.size(); i++) {
+		Thread::wait_to_finish(parallel_workers[i]);
+		memdelete(parallel_workers[i]);
+	}
+	parallel_workers.clear();
+
+	memdelete(parallel_mutex);
+	memdelete(parallel_sem);
+	memdelete(parallel_done_sem);
+}
+
 void AnimationTree::advance(float p_time) {
 
 	_process_graph(p_time);
@@ -1290,14 +1569,33 @@ void AnimationTree::advance(float p_time) {
 void AnimationTree::_notification(int p_what) {
 
 	if (active && p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS && process_mode == ANIMATION_PROCESS_PHYSICS) {
-		_process_graph(get_physics_process_delta_time());
+		float delta;
+		if (parallel_evaluation) {
+			_process_parallel(true);
+		} else if (_update_lod(get_physics_process_delta_time(), delta)) {
+			_process_graph(delta);
+		}
 	}
 
 	if (active && p_what == NOTIFICATION_INTERNAL_PROCESS && process_mode == ANIMATION_PROCESS_IDLE) {
-		_process_graph(get_process_delta_time());
+		float delta;
+		if (parallel_evaluation) {
+			_process_parallel(false);
+		} else if (_update_lod(get_process_delta_time(), delta)) {
+			_process_graph(delta);
+		}
+	}
+
+	if (p_what == NOTIFICATION_ENTER_TREE) {
+		if (parallel_evaluation) {
+			parallel_trees.add(&parallel_list);
+		}
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
+		if (parallel_list.in_list()) {
+			parallel_trees.remove(&parallel_list);
+		}
 		_clear_caches();
 		if (last_animation_player) {
 
@@ -1539,6 +1837,18 @@ void AnimationTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_process_mode", "mode"), &AnimationTree::set_process_mode);
 	ClassDB::bind_method(D_METHOD("get_process_mode"), &AnimationTree::get_process_mode);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_evaluation", "enable"), &AnimationTree::set_parallel_evaluation);
+	ClassDB::bind_method(D_METHOD("is_parallel_evaluation_enabled"), &AnimationTree::is_parallel_evaluation_enabled);
+
+	ClassDB::bind_method(D_METHOD("set_lod_update_interval", "frames"), &AnimationTree::set_lod_update_interval);
+	ClassDB::bind_method(D_METHOD("get_lod_update_interval"), &AnimationTree::get_lod_update_interval);
+	ClassDB::bind_method(D_METHOD("set_lod_visibility_notifier", "path"), &AnimationTree::set_lod_visibility_notifier);
+	ClassDB::bind_method(D_METHOD("get_lod_visibility_notifier"), &AnimationTree::get_lod_visibility_notifier);
+	ClassDB::bind_method(D_METHOD("set_lod_reduced_distance", "distance"), &AnimationTree::set_lod_reduced_distance);
+	ClassDB::bind_method(D_METHOD("get_lod_reduced_distance"), &AnimationTree::get_lod_reduced_distance);
+	ClassDB::bind_method(D_METHOD("set_lod_reduced_bone_depth", "depth"), &AnimationTree::set_lod_reduced_bone_depth);
+	ClassDB::bind_method(D_METHOD("get_lod_reduced_bone_depth"), &AnimationTree::get_lod_reduced_bone_depth);
+
 	ClassDB::bind_method(D_METHOD("set_animation_player", "root"), &AnimationTree::set_animation_player);
 	ClassDB::bind_method(D_METHOD("get_animation_player"), &AnimationTree::get_animation_player);
 
@@ -1561,15 +1871,32 @@ void AnimationTree::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "anim_player", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "AnimationPlayer"), "set_animation_player", "get_animation_player");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_mode", PROPERTY_HINT_ENUM, "Physics,Idle,Manual"), "set_process_mode", "get_process_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_evaluation"), "set_parallel_evaluation", "is_parallel_evaluation_enabled");
 	ADD_GROUP("Root Motion", "root_motion_");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_motion_track"), "set_root_motion_track", "get_root_motion_track");
+	ADD_GROUP("LOD", "lod_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_update_interval", PROPERTY_HINT_RANGE, "1,60,1"), "set_lod_update_interval", "get_lod_update_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "lod_visibility_notifier", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "VisibilityNotifier,VisibilityNotifier2D"), "set_lod_visibility_notifier", "get_lod_visibility_notifier");
+	ADD_PROPERTY(PropertyInfo(Variant::REAL, "lod_reduced_distance", PROPERTY_HINT_RANGE, "0,4096,0.01,or_greater"), "set_lod_reduced_distance", "get_lod_reduced_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_reduced_bone_depth", PROPERTY_HINT_RANGE, "0,64,1"), "set_lod_reduced_bone_depth", "get_lod_reduced_bone_depth");
 
 	BIND_ENUM_CONSTANT(ANIMATION_PROCESS_PHYSICS);
 	BIND_ENUM_CONSTANT(ANIMATION_PROCESS_IDLE);
 	BIND_ENUM_CONSTANT(ANIMATION_PROCESS_MANUAL);
 }
 
-AnimationTree::AnimationTree() {
+SelfList<AnimationTree>::List AnimationTree::parallel_trees;
+Mutex *AnimationTree::parallel_mutex = NULL;
+Semaphore *AnimationTree::parallel_sem = NULL;
+Semaphore *AnimationTree::parallel_done_sem = NULL;
+Vector<Thread *> AnimationTree::parallel_workers;
+List<AnimationTree *> AnimationTree::parallel_queue;
+int AnimationTree::parallel_pending = 0;
+bool AnimationTree::parallel_waiting = false;
+bool AnimationTree::parallel_exit = false;
+
+AnimationTree::AnimationTree() :
+		parallel_list(this) {
 
 	process_mode = ANIMATION_PROCESS_IDLE;
 	active = false;
@@ -1578,6 +1905,10 @@ AnimationTree::AnimationTree() {
 	started = true;
 	properties_dirty = true;
 	last_animation_player = 0;
+	parallel_evaluation = false;
+	parallel_frame = 0;
+	lod_reduced = false;
+	parallel_evaluated = false;
 }
 
 AnimationTree::~AnimationTree() {
@@ -32,6 +32,10 @@
 #define ANIMATION_GRAPH_PLAYER_H
 
 #include "animation_player.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/self_list.h"
 #include "scene/3d/skeleton.h"
 #include "scene/3d/spatial.h"
 #include "scene/resources/animation.h"
@@ -193,6 +197,7 @@ private:
 		Spatial *spatial;
 		Skeleton *skeleton;
 		int bone_idx;
+		int bone_depth; // for LOD
 		Vector3 loc;
 		Quat rot;
 		float rot_blend_accum;
@@ -202,6 +207,7 @@ private:
 			type = Animation::TYPE_TRANSFORM;
 			spatial = NULL;
 			bone_idx = -1;
+			bone_depth = 0;
 			skeleton = NULL;
 		}
 	};
@@ -254,6 +260,7 @@ private:
 
 	HashMap<NodePath, TrackCache *> track_cache;
 	Set<TrackCache *> playing_caches;
+	HashMap<ObjectID, Vector<int> > key_cursors; // Last key sampled in each track, per animation.
 
 	Ref<AnimationNode> root;
 
@@ -268,8 +275,37 @@ private:
 
 	void _clear_caches();
 	bool _update_caches(AnimationPlayer *player);
+	bool _prepare_graph(float p_delta);
+	void _blend_tracks(bool p_sample, bool p_trigger);
+	void _apply_tracks();
 	void _process_graph(float p_delta);
 
+	// With parallel evaluation, the first tree processed each frame prepares all the others,
+	// then their tracks are sampled and blended on worker threads. Each tree applies the
+	// result when it gets processed.
+	bool parallel_evaluation;
+	SelfList<AnimationTree> parallel_list;
+	uint64_t parallel_frame;
+	bool parallel_evaluated;
+
+	static SelfList<AnimationTree>::List parallel_trees;
+	static Mutex *parallel_mutex;
+	static Semaphore *parallel_sem;
+	static Semaphore *parallel_done_sem;
+	static Vector<Thread *> parallel_workers;
+	static List<AnimationTree *> parallel_queue;
+	static int parallel_pending;
+	static bool parallel_waiting;
+	static bool parallel_exit;
+
+	static void _parallel_thread(void *p_user);
+	static void _evaluate_parallel(bool p_physics, uint64_t p_frame);
+	void _process_parallel(bool p_physics);
+
+	AnimationLOD lod;
+	bool lod_reduced;
+	bool _update_lod(float p_delta, float &r_delta);
+
 	uint64_t setup_pass;
 	uint64_t process_pass;
 
@@ -316,6 +352,21 @@ public:
 	void set_process_mode(AnimationProcessMode p_mode);
 	AnimationProcessMode get_process_mode() const;
 
+	void set_parallel_evaluation(bool p_enable);
+	bool is_parallel_evaluation_enabled() const;
+
+	void set_lod_update_interval(int p_frames);
+	int get_lod_update_interval() const;
+
+	void set_lod_visibility_notifier(const NodePath &p_path);
+	NodePath get_lod_visibility_notifier() const;
+
+	void set_lod_reduced_distance(float p_distance);
+	float get_lod_reduced_distance() const;
+
+	void set_lod_reduced_bone_depth(int p_depth);
+	int get_lod_reduced_bone_depth() const;
+
 	void set_animation_player(const NodePath &p_player);
 	NodePath get_animation_player() const;
 
@@ -335,6 +386,10 @@ public:
 	void rename_parameter(const String &p_base, const String &p_new_base);
 
 	uint64_t get_last_process_pass() const;
+
+	static void setup();
+	static void cleanup();
+
 	AnimationTree();
 	~AnimationTree();
 };
@@ -0,0 +1,235 @@
+/*************************************************************************/
+/*  scene_pool.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "scene_pool.h"
+
+ScenePool::Pool *ScenePool::_get_pool(const Ref<PackedScene> &p_scene) {
+
+	ObjectID id = p_scene->get_instance_id();
+	Map<ObjectID, Pool>::Element *E = pools.find(id);
+	if (!E) {
+		E = pools.insert(id, Pool());
+		E->get().scene = p_scene;
+	}
+
+	return &E->get();
+}
+
+ScenePool::Instance ScenePool::_instance(const Ref<PackedScene> &p_scene) const {
+
+	Instance instance;
+	instance.node = p_scene->instance();
+	if (instance.node) {
+		_get_descendants(instance.node, instance.nodes);
+	}
+
+	return instance;
+}
+
+void ScenePool::_get_descendants(Node *p_node, Vector<ObjectID> &r_nodes) {
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+
+		Node *child = p_node->get_child(i);
+		r_nodes.push_back(child->get_instance_id());
+		_get_descendants(child, r_nodes);
+	}
+}
+
+void ScenePool::_find_added_nodes(Node *p_node, const Vector<ObjectID> &p_nodes, int &r_index, List<Node *> *r_added) {
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+
+		Node *child = p_node->get_child(i);
+		if (r_index < p_nodes.size() && child->get_instance_id() == p_nodes[r_index]) {
+			r_index++;
+			_find_added_nodes(child, p_nodes, r_index, r_added);
+		} else {
+			r_added->push_back(child);
+		}
+	}
+}
+
+// Frees the nodes added to an instance since it was created. Returns false if
+// nodes of the original instance were removed or moved, in which case the
+// instance can't be reused.
+bool ScenePool::_remove_added_nodes(Node *p_node, const Vector<ObjectID> &p_nodes) {
+
+	int index = 0;
+	List<Node *> added;
+	_find_added_nodes(p_node, p_nodes, index, &added);
+
+	if (index != p_nodes.size()) {
+		return false;
+	}
+
+	for (List<Node *>::Element *E = added.front(); E; E = E->next()) {
+		E->get()->get_parent()->remove_child(E->get());
+		memdelete(E->get());
+	}
+
+	return true;
+}
+
+Node *ScenePool::acquire(const Ref<PackedScene> &p_scene) {
+
+	ERR_FAIL_COND_V(p_scene.is_null(), NULL);
+
+	Pool *pool = _get_pool(p_scene);
+
+	Instance instance;
+	if (pool->available.size()) {
+		int last = pool->available.size() - 1;
+		instance = pool->available[last];
+		pool->available.remove(last);
+	} else {
+		instance = _instance(p_scene);
+		ERR_FAIL_COND_V(!instance.node, NULL);
+	}
+
+	Acquired a;
+	a.scene = p_scene->get_instance_id();
+	a.nodes = instance.nodes;
+	acquired.set(instance.node->get_instance_id(), a);
+	return instance.node;
+}
+
+void ScenePool::release(Node *p_node) {
+
+	ERR_FAIL_NULL(p_node);
+
+	Acquired a;
+	if (!acquired.lookup(p_node->get_instance_id(), a)) {
+		ERR_EXPLAIN("Node was not acquired from this pool: " + String(p_node->get_name()));
+		ERR_FAIL();
+	}
+	acquired.remove(p_node->get_instance_id());
+
+	if (p_node->get_parent()) {
+		p_node->get_parent()->remove_child(p_node);
+	}
+
+	Map<ObjectID, Pool>::Element *E = pools.find(a.scene);
+	if (!E || p_node->is_queued_for_deletion() || E->get().available.size() >= max_size) {
+		memdelete(p_node);
+		return;
+	}
+
+	Pool &pool = E->get();
+
+	// nodes whose layout was changed since instancing can't be brought back to the packed state
+	if (!_remove_added_nodes(p_node, a.nodes) || !pool.scene->get_state()->reset_instance(p_node)) {
+		memdelete(p_node);
+		return;
+	}
+
+	Instance instance;
+	instance.node = p_node;
+	instance.nodes = a.nodes;
+	pool.available.push_back(instance);
+}
+
+void ScenePool::prefill(const Ref<PackedScene> &p_scene, int p_count) {
+
+	ERR_FAIL_COND(p_scene.is_null());
+
+	Pool *pool = _get_pool(p_scene);
+	int count = MIN(p_count, max_size);
+
+	while (pool->available.size() < count) {
+		Instance instance = _instance(p_scene);
+		ERR_FAIL_COND(!instance.node);
+		pool->available.push_back(instance);
+	}
+}
+
+int ScenePool::get_available_count(const Ref<PackedScene> &p_scene) const {
+
+	ERR_FAIL_COND_V(p_scene.is_null(), 0);
+
+	const Map<ObjectID, Pool>::Element *E = pools.find(p_scene->get_instance_id());
+	return E ? E->get().available.size() : 0;
+}
+
+void ScenePool::set_max_size(int p_max_size) {
+
+	ERR_FAIL_COND(p_max_size < 0);
+	max_size = p_max_size;
+
+	for (Map<ObjectID, Pool>::Element *E = pools.front(); E; E = E->next()) {
+		Vector<Instance> &available = E->get().available;
+		while (available.size() > max_size) {
+			memdelete(available[available.size() - 1].node);
+			available.resize(available.size() - 1);
+		}
+	}
+}
+
+int ScenePool::get_max_size() const {
+
+	return max_size;
+}
+
+void ScenePool::clear() {
+
+	for (Map<ObjectID, Pool>::Element *E = pools.front(); E; E = E->next()) {
+		const Vector<Instance> &available = E->get().available;
+		for (int i = 0; i < available.size(); i++) {
+			memdelete(available[i].node);
+		}
+	}
+
+	pools.clear();
+	acquired.clear();
+}
+
+void ScenePool::_bind_methods() {
+
+	ClassDB::bind_method(D_METHOD("acquire", "scene"), &ScenePool::acquire);
+	ClassDB::bind_method(D_METHOD("release", "node"), &ScenePool::release);
+	ClassDB::bind_method(D_METHOD("prefill", "scene", "count"), &ScenePool::prefill);
+	ClassDB::bind_method(D_METHOD("get_available_count", "scene"), &ScenePool::get_available_count);
+	ClassDB::bind_method(D_METHOD("clear"), &ScenePool::clear);
+
+	ClassDB::bind_method(D_METHOD("set_max_size", "max_size"), &ScenePool::set_max_size);
+	ClassDB::bind_method(D_METHOD("get_max_size"), &ScenePool::get_max_size);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_size", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), "set_max_size", "get_max_size");
+}
+
+ScenePool::ScenePool() {
+
+	max_size = 64;
+}
+
+ScenePool::~ScenePool() {
+
+	clear();
+}
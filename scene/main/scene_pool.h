@@ -0,0 +1,89 @@
+/*************************************************************************/
+/*  scene_pool.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SCENE_POOL_H
+#define SCENE_POOL_H
+
+#include "core/oa_hash_map.h"
+#include "core/reference.h"
+#include "scene/resources/packed_scene.h"
+
+class ScenePool : public Reference {
+
+	GDCLASS(ScenePool, Reference);
+
+	struct Instance {
+		Node *node;
+		Vector<ObjectID> nodes; // descendants right after instancing, in tree order
+		Instance() { node = NULL; }
+	};
+
+	struct Pool {
+		Ref<PackedScene> scene;
+		Vector<Instance> available;
+	};
+
+	struct Acquired {
+		ObjectID scene; // PackedScene instance ID
+		Vector<ObjectID> nodes;
+	};
+
+	Map<ObjectID, Pool> pools; // keyed by the PackedScene instance ID
+	OAHashMap<ObjectID, Acquired> acquired; // keyed by the node instance ID
+
+	int max_size;
+
+	Pool *_get_pool(const Ref<PackedScene> &p_scene);
+	Instance _instance(const Ref<PackedScene> &p_scene) const;
+
+	static void _get_descendants(Node *p_node, Vector<ObjectID> &r_nodes);
+	static void _find_added_nodes(Node *p_node, const Vector<ObjectID> &p_nodes, int &r_index, List<Node *> *r_added);
+	static bool _remove_added_nodes(Node *p_node, const Vector<ObjectID> &p_nodes);
+
+protected:
+	static void _bind_methods();
+
+public:
+	Node *acquire(const Ref<PackedScene> &p_scene);
+	void release(Node *p_node);
+
+	void prefill(const Ref<PackedScene> &p_scene, int p_count);
+	int get_available_count(const Ref<PackedScene> &p_scene) const;
+
+	void set_max_size(int p_max_size);
+	int get_max_size() const;
+
+	void clear();
+
+	ScenePool();
+	~ScenePool();
+};
+
+#endif // SCENE_POOL_H
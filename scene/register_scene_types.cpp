@@ -121,6 +121,7 @@
 #include "scene/main/http_request.h"
 #include "scene/main/instance_placeholder.h"
 #include "scene/main/resource_preloader.h"
+#include "scene/main/scene_pool.h"
 #include "scene/main/scene_tree.h"
 #include "scene/main/timer.h"
 #include "scene/main/viewport.h"
@@ -226,6 +227,7 @@ static Ref<ResourceFormatLoaderShader> resource_loader_shader;
 void register_scene_types() {
 
 	SceneStringNames::create();
+	AnimationTree::setup();
 
 	OS::get_singleton()->yield(); //may take time to init
 
@@ -269,6 +271,7 @@ void register_scene_types() {
 	ClassDB::register_class<CanvasLayer>();
 	ClassDB::register_class<CanvasModulate>();
 	ClassDB::register_class<ResourcePreloader>();
+	ClassDB::register_class<ScenePool>();
 
 	/* REGISTER GUI */
 	ClassDB::register_class<ButtonGroup>();
@@ -763,5 +766,6 @@ void unregister_scene_types() {
 	SpatialMaterial::finish_shaders();
 	ParticlesMaterial::finish_shaders();
 	CanvasItemMaterial::finish_shaders();
+	AnimationTree::cleanup();
 	SceneStringNames::free();
 }
@@ -31,6 +31,7 @@
 #include "animation.h"
 #include "scene/scene_string_names.h"
 
+#include "core/io/marshalls.h"
 #include "core/math/geometry.h"
 
 #define ANIM_MIN_LENGTH 0.001
@@ -86,7 +87,65 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 			track_set_imported(track, p_value);
 		else if (what == "enabled")
 			track_set_enabled(track, p_value);
-		else if (what == "keys" || what == "key_values") {
+		else if (what == "compressed") {
+
+			ERR_FAIL_COND_V(track_get_type(track) != TYPE_TRANSFORM, false);
+
+			TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
+			Dictionary d = p_value;
+			ERR_FAIL_COND_V(!d.has("times") || !d.has("transitions") || !d.has("channels"), false);
+			ERR_FAIL_COND_V(!d.has("constant") || !d.has("ranges") || !d.has("data"), false);
+
+			CompressedTransforms ct;
+
+			PoolVector<float> times = d["times"];
+			PoolVector<float> transitions = d["transitions"];
+			ERR_FAIL_COND_V(times.size() != transitions.size(), false);
+
+			ct.keys.resize(times.size());
+			{
+				PoolVector<float>::Read rt = times.read();
+				PoolVector<float>::Read rs = transitions.read();
+				for (int i = 0; i < times.size(); i++) {
+					ct.keys.write[i].time = rt[i];
+					ct.keys.write[i].transition = rs[i];
+				}
+			}
+
+			PoolVector<float> constant = d["constant"];
+			ERR_FAIL_COND_V(constant.size() != CompressedTransforms::MAX_COMPONENTS, false);
+			_set_transform_components(ct.constant, CompressedTransforms::CHANNEL_LOC | CompressedTransforms::CHANNEL_ROT | CompressedTransforms::CHANNEL_SCALE, constant.read().ptr());
+
+			ct.channels = d["channels"];
+			float components[CompressedTransforms::MAX_COMPONENTS];
+			ct.stride = _get_transform_components(ct.constant, ct.channels, components);
+
+			PoolVector<float> ranges = d["ranges"];
+			ERR_FAIL_COND_V(ranges.size() != ct.stride * 2, false);
+			{
+				PoolVector<float>::Read r = ranges.read();
+				for (int i = 0; i < ct.stride; i++) {
+					ct.offsets[i] = r[i * 2 + 0];
+					ct.steps[i] = r[i * 2 + 1];
+				}
+			}
+
+			PoolVector<uint8_t> data = d["data"];
+			ERR_FAIL_COND_V(data.size() != ct.keys.size() * ct.stride * 2, false);
+			ct.data.resize(ct.keys.size() * ct.stride);
+			{
+				PoolVector<uint8_t>::Read r = data.read();
+				for (int i = 0; i < ct.data.size(); i++) {
+					ct.data.write[i] = decode_uint16(&r[i * 2]);
+				}
+			}
+
+			tt->transforms.clear();
+			tt->compressed_transforms = ct;
+			tt->compressed = true;
+			return true;
+
+		} else if (what == "keys" || what == "key_values") {
 
 			if (track_get_type(track) == TYPE_TRANSFORM) {
 
@@ -97,6 +156,8 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 
 				PoolVector<float>::Read r = values.read();
 
+				tt->compressed = false;
+				tt->compressed_transforms = CompressedTransforms();
 				tt->transforms.resize(vcount / 12);
 
 				for (int i = 0; i < (vcount / 12); i++) {
@@ -369,7 +430,62 @@ bool Animation::_get(const StringName &p_name, Variant &r_ret) const {
 			r_ret = track_is_imported(track);
 		else if (what == "enabled")
 			r_ret = track_is_enabled(track);
-		else if (what == "keys") {
+		else if (what == "compressed") {
+
+			ERR_FAIL_COND_V(track_get_type(track) != TYPE_TRANSFORM, false);
+
+			const TransformTrack *tt = static_cast<const TransformTrack *>(tracks[track]);
+			ERR_FAIL_COND_V(!tt->compressed, false);
+			const CompressedTransforms &ct = tt->compressed_transforms;
+
+			PoolVector<float> times;
+			PoolVector<float> transitions;
+			times.resize(ct.keys.size());
+			transitions.resize(ct.keys.size());
+			{
+				PoolVector<float>::Write wt = times.write();
+				PoolVector<float>::Write ws = transitions.write();
+				for (int i = 0; i < ct.keys.size(); i++) {
+					wt[i] = ct.keys[i].time;
+					ws[i] = ct.keys[i].transition;
+				}
+			}
+
+			PoolVector<float> constant;
+			constant.resize(CompressedTransforms::MAX_COMPONENTS);
+			_get_transform_components(ct.constant, CompressedTransforms::CHANNEL_LOC | CompressedTransforms::CHANNEL_ROT | CompressedTransforms::CHANNEL_SCALE, constant.write().ptr());
+
+			PoolVector<float> ranges;
+			ranges.resize(ct.stride * 2);
+			{
+				PoolVector<float>::Write w = ranges.write();
+				for (int i = 0; i < ct.stride; i++) {
+					w[i * 2 + 0] = ct.offsets[i];
+					w[i * 2 + 1] = ct.steps[i];
+				}
+			}
+
+			PoolVector<uint8_t> data;
+			data.resize(ct.data.size() * 2);
+			{
+				PoolVector<uint8_t>::Write w = data.write();
+				for (int i = 0; i < ct.data.size(); i++) {
+					encode_uint16(ct.data[i], &w[i * 2]);
+				}
+			}
+
+			Dictionary d;
+			d["times"] = times;
+			d["transitions"] = transitions;
+			d["channels"] = ct.channels;
+			d["constant"] = constant;
+			d["ranges"] = ranges;
+			d["data"] = data;
+
+			r_ret = d;
+			return true;
+
+		} else if (what == "keys") {
 
 			if (track_get_type(track) == TYPE_TRANSFORM) {
 
@@ -622,7 +738,11 @@ void Animation::_get_property_list(List<PropertyInfo> *p_list) const {
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/loop_wrap", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/imported", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::BOOL, "tracks/" + itos(i) + "/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
-		p_list->push_back(PropertyInfo(Variant::ARRAY, "tracks/" + itos(i) + "/keys", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
+		if (tracks[i]->type == TYPE_TRANSFORM && static_cast<const TransformTrack *>(tracks[i])->compressed) {
+			p_list->push_back(PropertyInfo(Variant::DICTIONARY, "tracks/" + itos(i) + "/compressed", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
+		} else {
+			p_list->push_back(PropertyInfo(Variant::ARRAY, "tracks/" + itos(i) + "/keys", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL));
+		}
 	}
 }
 
@@ -684,6 +804,8 @@ void Animation::remove_track(int p_track) {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
 			_clear(tt->transforms);
+			tt->compressed = false;
+			tt->compressed_transforms = CompressedTransforms();
 
 		} break;
 		case TYPE_VALUE: {
@@ -849,14 +971,22 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc,
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, ERR_INVALID_PARAMETER);
-	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+
+	TransformKey key;
+	if (tt->compressed) {
+		ERR_FAIL_INDEX_V(p_key, tt->compressed_transforms.keys.size(), ERR_INVALID_PARAMETER);
+		key = _decode_transform_key(tt->compressed_transforms, p_key);
+	} else {
+		ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+		key = tt->transforms[p_key].value;
+	}
 
 	if (r_loc)
-		*r_loc = tt->transforms[p_key].value.loc;
+		*r_loc = key.loc;
 	if (r_rot)
-		*r_rot = tt->transforms[p_key].value.rot;
+		*r_rot = key.rot;
 	if (r_scale)
-		*r_scale = tt->transforms[p_key].value.scale;
+		*r_scale = key.scale;
 
 	return OK;
 }
@@ -868,6 +998,7 @@ int Animation::transform_track_insert_key(int p_track, float p_time, const Vecto
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM, -1);
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
+	_transform_track_decompress(tt);
 
 	TKey<TransformKey> tkey;
 	tkey.time = p_time;
@@ -896,6 +1027,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -949,6 +1081,15 @@ int Animation::track_find_key(int p_track, float p_time, bool p_exact) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				const Vector<Key> &keys = tt->compressed_transforms.keys;
+				int k = _find(keys, p_time);
+				if (k < 0 || k >= keys.size())
+					return -1;
+				if (keys[k].time != p_time && p_exact)
+					return -1;
+				return k;
+			}
 			int k = _find(tt->transforms, p_time);
 			if (k < 0 || k >= tt->transforms.size())
 				return -1;
@@ -1134,6 +1275,8 @@ int Animation::track_get_key_count(int p_track) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed)
+				return tt->compressed_transforms.keys.size();
 			return tt->transforms.size();
 		} break;
 		case TYPE_VALUE: {
@@ -1176,13 +1319,15 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 
 		case TYPE_TRANSFORM: {
 
-			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
+			Vector3 loc;
+			Quat rot;
+			Vector3 scale;
+			ERR_FAIL_COND_V(transform_track_get_key(p_track, p_key_idx, &loc, &rot, &scale) != OK, Variant());
 
 			Dictionary d;
-			d["location"] = tt->transforms[p_key_idx].value.loc;
-			d["rotation"] = tt->transforms[p_key_idx].value.rot;
-			d["scale"] = tt->transforms[p_key_idx].value.scale;
+			d["location"] = loc;
+			d["rotation"] = rot;
+			d["scale"] = scale;
 
 			return d;
 		} break;
@@ -1253,6 +1398,10 @@ float Animation::track_get_key_time(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.keys.size(), -1);
+				return tt->compressed_transforms.keys[p_key_idx].time;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].time;
 		} break;
@@ -1306,6 +1455,10 @@ float Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_transforms.keys.size(), -1);
+				return tt->compressed_transforms.keys[p_key_idx].transition;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].transition;
 		} break;
@@ -1350,6 +1503,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			Dictionary d = p_value;
 			if (d.has("location"))
@@ -1428,6 +1582,7 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 		case TYPE_TRANSFORM: {
 
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
 		} break;
@@ -1456,12 +1611,32 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, float p_tra
 }
 
 template <class K>
-int Animation::_find(const Vector<K> &p_keys, float p_time) const {
+int Animation::_find(const Vector<K> &p_keys, float p_time, int *r_hint) const {
 
 	int len = p_keys.size();
 	if (len == 0)
 		return -2;
 
+	if (r_hint) {
+		// Playback moves forward, so the key is most likely the last one found or the one after it.
+		const K *keys = p_keys.ptr();
+		for (int i = *r_hint; i <= *r_hint + 1; i++) {
+
+			if (i < -1 || i >= len)
+				continue;
+			if (i >= 0 && keys[i].time > p_time && Math::abs(p_time - keys[i].time) >= CMP_EPSILON)
+				continue; // key is after the time
+			if (i + 1 < len && (keys[i + 1].time <= p_time || Math::abs(p_time - keys[i + 1].time) < CMP_EPSILON))
+				continue; // next key is not after the time
+
+			*r_hint = i;
+			return i;
+		}
+
+		*r_hint = _find(p_keys, p_time);
+		return *r_hint;
+	}
+
 	int low = 0;
 	int high = len - 1;
 	int middle = 0;
@@ -1643,29 +1818,33 @@ float Animation::_cubic_interpolate(const float &p_pre_a, const float &p_a, cons
 	return _interpolate(p_a, p_b, p_c);
 }
 
-template <class T>
-T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
+template <class K>
+bool Animation::_find_interpolation(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, KeyInterpolation &r_interp, int *r_hint) const {
 
-	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+	int len;
+	if (p_keys.size() && p_keys[p_keys.size() - 1].time <= length) {
+		len = p_keys.size(); // no keys past the end, don't search
+	} else {
+		len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+	}
 
 	if (len <= 0) {
 		// (-1 or -2 returned originally) (plus one above)
 		// meaning no keys, or only key time is larger than length
-		if (p_ok)
-			*p_ok = false;
-		return T();
+		return false;
 	} else if (len == 1) { // one key found (0+1), return it
 
-		if (p_ok)
-			*p_ok = true;
-		return p_keys[0].value;
+		r_interp.idx = 0;
+		r_interp.next = 0;
+		r_interp.count = 1;
+		r_interp.c = 0;
+		return true;
 	}
 
-	int idx = _find(p_keys, p_time);
+	int idx = _find(p_keys, p_time, r_hint);
 
-	ERR_FAIL_COND_V(idx == -2, T());
+	ERR_FAIL_COND_V(idx == -2, false);
 
-	bool result = true;
 	int next = 0;
 	float c = 0;
 	// prepare for all cases of interpolation
@@ -1739,27 +1918,46 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 			if (loop)
 				idx = next = 0;
 			else
-				result = false;
+				return false;
 		}
 	}
 
+	float tr = p_keys[idx].transition;
+
+	if (tr == 0) {
+		// don't interpolate if not needed
+		next = idx;
+	} else if (tr != 1.0) {
+
+		c = Math::ease(c, tr);
+	}
+
+	r_interp.idx = idx;
+	r_interp.next = next;
+	r_interp.count = len;
+	r_interp.c = c;
+	return true;
+}
+
+template <class T>
+T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_hint) const {
+
+	KeyInterpolation ki;
+	bool result = _find_interpolation(p_keys, p_time, p_loop_wrap, ki, r_hint);
+
 	if (p_ok)
 		*p_ok = result;
 	if (!result)
 		return T();
 
-	float tr = p_keys[idx].transition;
+	int idx = ki.idx;
+	int next = ki.next;
 
-	if (tr == 0 || idx == next) {
+	if (idx == next) {
 		// don't interpolate if not needed
 		return p_keys[idx].value;
 	}
 
-	if (tr != 1.0) {
-
-		c = Math::ease(c, tr);
-	}
-
 	switch (p_interp) {
 
 		case INTERPOLATION_NEAREST: {
@@ -1768,17 +1966,17 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 		} break;
 		case INTERPOLATION_LINEAR: {
 
-			return _interpolate(p_keys[idx].value, p_keys[next].value, c);
+			return _interpolate(p_keys[idx].value, p_keys[next].value, ki.c);
 		} break;
 		case INTERPOLATION_CUBIC: {
 			int pre = idx - 1;
 			if (pre < 0)
 				pre = 0;
 			int post = next + 1;
-			if (post >= len)
+			if (post >= ki.count)
 				post = next;
 
-			return _cubic_interpolate(p_keys[pre].value, p_keys[idx].value, p_keys[next].value, p_keys[post].value, c);
+			return _cubic_interpolate(p_keys[pre].value, p_keys[idx].value, p_keys[next].value, p_keys[post].value, ki.c);
 
 		} break;
 		default: return p_keys[idx].value;
@@ -1787,7 +1985,305 @@ T Animation::_interpolate(const Vector<TKey<T> > &p_keys, float p_time, Interpol
 	// do a barrel roll
 }
 
-Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const {
+bool Animation::_is_transform_key_within_error(const TransformKey &p_a, const TransformKey &p_b, uint32_t p_channels, float p_allowed_linear_err, float p_allowed_angular_err) {
+
+	if ((p_channels & CompressedTransforms::CHANNEL_LOC) && p_a.loc.distance_to(p_b.loc) > p_allowed_linear_err)
+		return false;
+	if ((p_channels & CompressedTransforms::CHANNEL_ROT) && Math::acos(MIN(Math::abs(p_a.rot.dot(p_b.rot)), (real_t)1.0)) * 2.0 > p_allowed_angular_err)
+		return false;
+	if ((p_channels & CompressedTransforms::CHANNEL_SCALE) && p_a.scale.distance_to(p_b.scale) > p_allowed_linear_err)
+		return false;
+
+	return true;
+}
+
+int Animation::_get_transform_components(const TransformKey &p_key, uint32_t p_channels, float *r_components) {
+
+	int count = 0;
+	if (p_channels & CompressedTransforms::CHANNEL_LOC) {
+		r_components[count++] = p_key.loc.x;
+		r_components[count++] = p_key.loc.y;
+		r_components[count++] = p_key.loc.z;
+	}
+	if (p_channels & CompressedTransforms::CHANNEL_ROT) {
+		r_components[count++] = p_key.rot.x;
+		r_components[count++] = p_key.rot.y;
+		r_components[count++] = p_key.rot.z;
+		r_components[count++] = p_key.rot.w;
+	}
+	if (p_channels & CompressedTransforms::CHANNEL_SCALE) {
+		r_components[count++] = p_key.scale.x;
+		r_components[count++] = p_key.scale.y;
+		r_components[count++] = p_key.scale.z;
+	}
+	return count;
+}
+
+void Animation::_set_transform_components(TransformKey &r_key, uint32_t p_channels, const float *p_components) {
+
+	int count = 0;
+	if (p_channels & CompressedTransforms::CHANNEL_LOC) {
+		r_key.loc.x = p_components[count++];
+		r_key.loc.y = p_components[count++];
+		r_key.loc.z = p_components[count++];
+	}
+	if (p_channels & CompressedTransforms::CHANNEL_ROT) {
+		r_key.rot.x = p_components[count++];
+		r_key.rot.y = p_components[count++];
+		r_key.rot.z = p_components[count++];
+		r_key.rot.w = p_components[count++];
+	}
+	if (p_channels & CompressedTransforms::CHANNEL_SCALE) {
+		r_key.scale.x = p_components[count++];
+		r_key.scale.y = p_components[count++];
+		r_key.scale.z = p_components[count++];
+	}
+}
+
+// Largest error quantizing components within the given ranges can cause, half a step on each of them.
+void Animation::_get_quantization_error(uint32_t p_channels, const float *p_mins, const float *p_maxs, float &r_linear_err, float &r_angular_err) {
+
+	r_linear_err = 0;
+	r_angular_err = 0;
+
+	int c = 0;
+	for (int channel = CompressedTransforms::CHANNEL_LOC; channel <= CompressedTransforms::CHANNEL_SCALE; channel <<= 1) {
+
+		if (!(p_channels & channel))
+			continue;
+
+		int count = channel == CompressedTransforms::CHANNEL_ROT ? 4 : 3;
+		float sq = 0;
+		for (int i = 0; i < count; i++, c++) {
+			float half_step = (p_maxs[c] - p_mins[c]) / (65535.0 * 2.0);
+			sq += half_step * half_step;
+		}
+
+		if (channel == CompressedTransforms::CHANNEL_ROT) {
+			// The angle between two unit quaternions is about twice the distance between them.
+			r_angular_err = 2.0 * Math::sqrt(sq);
+		} else {
+			r_linear_err = MAX(r_linear_err, Math::sqrt(sq));
+		}
+	}
+}
+
+Animation::TransformKey Animation::_decode_transform_key(const CompressedTransforms &p_compressed, int p_key) const {
+
+	// A flat loop over the components, which compilers can vectorize.
+	const uint16_t *q = p_compressed.data.ptr() + p_key * p_compressed.stride;
+	float components[CompressedTransforms::MAX_COMPONENTS];
+	for (int i = 0; i < p_compressed.stride; i++) {
+		components[i] = p_compressed.offsets[i] + q[i] * p_compressed.steps[i];
+	}
+
+	TransformKey key = p_compressed.constant;
+	_set_transform_components(key, p_compressed.channels, components);
+	if (p_compressed.channels & CompressedTransforms::CHANNEL_ROT) {
+		key.rot.normalize();
+	}
+	return key;
+}
+
+bool Animation::_interpolate_compressed(const TransformTrack *p_track, float p_time, TransformKey &r_value, int *r_hint) const {
+
+	const CompressedTransforms &ct = p_track->compressed_transforms;
+
+	KeyInterpolation ki;
+	if (!_find_interpolation(ct.keys, p_time, p_track->loop_wrap, ki, r_hint))
+		return false;
+
+	if (ki.idx == ki.next || p_track->interpolation == INTERPOLATION_NEAREST) {
+		r_value = _decode_transform_key(ct, ki.idx);
+		return true;
+	}
+
+	TransformKey a = _decode_transform_key(ct, ki.idx);
+	TransformKey b = _decode_transform_key(ct, ki.next);
+
+	if (p_track->interpolation == INTERPOLATION_CUBIC) {
+		int pre = ki.idx - 1;
+		if (pre < 0)
+			pre = 0;
+		int post = ki.next + 1;
+		if (post >= ki.count)
+			post = ki.next;
+
+		r_value = _cubic_interpolate(_decode_transform_key(ct, pre), a, b, _decode_transform_key(ct, post), ki.c);
+	} else {
+		r_value = _interpolate(a, b, ki.c);
+	}
+
+	return true;
+}
+
+void Animation::_transform_track_compress(TransformTrack *p_track, float p_allowed_linear_err, float p_allowed_angular_err) {
+
+	_transform_track_decompress(p_track);
+
+	const Vector<TKey<TransformKey> > &keys = p_track->transforms;
+	int count = keys.size();
+
+	CompressedTransforms ct;
+
+	// Channels that barely change are stored once.
+	if (count) {
+		ct.constant = keys[0].value;
+		for (int i = 1; i < count; i++) {
+			const TransformKey &k = keys[i].value;
+			if (!_is_transform_key_within_error(k, ct.constant, CompressedTransforms::CHANNEL_LOC, p_allowed_linear_err, p_allowed_angular_err))
+				ct.channels |= CompressedTransforms::CHANNEL_LOC;
+			if (!_is_transform_key_within_error(k, ct.constant, CompressedTransforms::CHANNEL_ROT, p_allowed_linear_err, p_allowed_angular_err))
+				ct.channels |= CompressedTransforms::CHANNEL_ROT;
+			if (!_is_transform_key_within_error(k, ct.constant, CompressedTransforms::CHANNEL_SCALE, p_allowed_linear_err, p_allowed_angular_err))
+				ct.channels |= CompressedTransforms::CHANNEL_SCALE;
+		}
+	}
+
+	float components[CompressedTransforms::MAX_COMPONENTS];
+	float mins[CompressedTransforms::MAX_COMPONENTS];
+	float maxs[CompressedTransforms::MAX_COMPONENTS];
+	ct.stride = _get_transform_components(ct.constant, ct.channels, components);
+	for (int j = 0; j < ct.stride; j++) {
+		mins[j] = 1e20;
+		maxs[j] = -1e20;
+	}
+
+	// Quantizing adds its own error, so less is left for dropping keys. The kept keys
+	// span at most the range of all of them, which bounds the quantization error.
+	for (int i = 0; i < count; i++) {
+		_get_transform_components(keys[i].value, ct.channels, components);
+		for (int j = 0; j < ct.stride; j++) {
+			mins[j] = MIN(mins[j], components[j]);
+			maxs[j] = MAX(maxs[j], components[j]);
+		}
+	}
+
+	float quantization_linear_err;
+	float quantization_angular_err;
+	_get_quantization_error(ct.channels, mins, maxs, quantization_linear_err, quantization_angular_err);
+	float reduction_linear_err = MAX(p_allowed_linear_err - quantization_linear_err, 0);
+	float reduction_angular_err = MAX(p_allowed_angular_err - quantization_angular_err, 0);
+
+	// Drop the keys that interpolating between their neighbours reproduces within the allowed error.
+	// Only done for linear interpolation without easing, where a key only affects its neighbours.
+	bool reduce = p_track->interpolation == INTERPOLATION_LINEAR && count > 2;
+	for (int i = 0; i < count && reduce; i++) {
+		reduce = keys[i].transition == 1.0;
+	}
+
+	Vector<int> kept;
+	if (reduce) {
+		kept.push_back(0);
+		int last = 0;
+		for (int i = 2; i < count; i++) {
+
+			float delta = keys[i].time - keys[last].time;
+			for (int j = last + 1; j < i; j++) {
+
+				float c = delta > CMP_EPSILON ? (keys[j].time - keys[last].time) / delta : 0;
+				if (!_is_transform_key_within_error(_interpolate(keys[last].value, keys[i].value, c), keys[j].value, ct.channels, reduction_linear_err, reduction_angular_err)) {
+					last = i - 1;
+					kept.push_back(last);
+					break;
+				}
+			}
+		}
+		kept.push_back(count - 1);
+	} else {
+		kept.resize(count);
+		for (int i = 0; i < count; i++) {
+			kept.write[i] = i;
+		}
+	}
+
+	for (int j = 0; j < ct.stride; j++) {
+		mins[j] = 1e20;
+		maxs[j] = -1e20;
+	}
+
+	ct.keys.resize(kept.size());
+	for (int i = 0; i < kept.size(); i++) {
+
+		const TKey<TransformKey> &k = keys[kept[i]];
+		ct.keys.write[i].time = k.time;
+		ct.keys.write[i].transition = k.transition;
+
+		_get_transform_components(k.value, ct.channels, components);
+		for (int j = 0; j < ct.stride; j++) {
+			mins[j] = MIN(mins[j], components[j]);
+			maxs[j] = MAX(maxs[j], components[j]);
+		}
+	}
+
+	for (int j = 0; j < ct.stride; j++) {
+		ct.offsets[j] = mins[j];
+		ct.steps[j] = (maxs[j] - mins[j]) / 65535.0;
+	}
+
+	ct.data.resize(kept.size() * ct.stride);
+	uint16_t *w = ct.data.ptrw();
+	for (int i = 0; i < kept.size(); i++) {
+
+		_get_transform_components(keys[kept[i]].value, ct.channels, components);
+		for (int j = 0; j < ct.stride; j++) {
+			float q = ct.steps[j] > 0 ? Math::round((components[j] - ct.offsets[j]) / ct.steps[j]) : 0;
+			w[i * ct.stride + j] = (uint16_t)CLAMP(q, 0, 65535);
+		}
+	}
+
+	p_track->transforms.clear();
+	p_track->compressed_transforms = ct;
+	p_track->compressed = true;
+}
+
+void Animation::_transform_track_decompress(TransformTrack *p_track) {
+
+	if (!p_track->compressed)
+		return;
+
+	const CompressedTransforms &ct = p_track->compressed_transforms;
+
+	p_track->transforms.resize(ct.keys.size());
+	for (int i = 0; i < ct.keys.size(); i++) {
+
+		TKey<TransformKey> &k = p_track->transforms.write[i];
+		k.time = ct.keys[i].time;
+		k.transition = ct.keys[i].transition;
+		k.value = _decode_transform_key(ct, i);
+	}
+
+	p_track->compressed = false;
+	p_track->compressed_transforms = CompressedTransforms();
+}
+
+void Animation::transform_track_compress(int p_track, float p_allowed_linear_err, float p_allowed_angular_err) {
+
+	ERR_FAIL_INDEX(p_track, tracks.size());
+	ERR_FAIL_COND(tracks[p_track]->type != TYPE_TRANSFORM);
+
+	_transform_track_compress(static_cast<TransformTrack *>(tracks[p_track]), p_allowed_linear_err, p_allowed_angular_err);
+	emit_changed();
+}
+
+void Animation::transform_track_decompress(int p_track) {
+
+	ERR_FAIL_INDEX(p_track, tracks.size());
+	ERR_FAIL_COND(tracks[p_track]->type != TYPE_TRANSFORM);
+
+	_transform_track_decompress(static_cast<TransformTrack *>(tracks[p_track]));
+	emit_changed();
+}
+
+bool Animation::transform_track_is_compressed(int p_track) const {
+
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), false);
+	ERR_FAIL_COND_V(tracks[p_track]->type != TYPE_TRANSFORM, false);
+
+	return static_cast<const TransformTrack *>(tracks[p_track])->compressed;
+}
+
+Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_cursor) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
@@ -1797,7 +2293,12 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 
 	bool ok = false;
 
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
+	if (tt->compressed) {
+		ok = _interpolate_compressed(tt, p_time, tk, r_cursor);
+	} else {
+		tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok, r_cursor);
+	}
 
 	if (!ok)
 		return ERR_UNAVAILABLE;
@@ -1814,7 +2315,39 @@ Error Animation::transform_track_interpolate(int p_track, float p_time, Vector3
 	return OK;
 }
 
-Variant Animation::value_track_interpolate(int p_track, float p_time) const {
+void Animation::transform_tracks_interpolate(float p_time, const int *p_tracks, int p_track_count, TransformTrackSample *r_samples, int *r_cursors) const {
+
+	for (int k = 0; k < p_track_count; k++) {
+
+		int i = p_tracks[k];
+		ERR_CONTINUE(i < 0 || i >= tracks.size());
+
+		TransformTrackSample &sample = r_samples[i];
+		const Track *t = tracks[i];
+		if (t->type != TYPE_TRANSFORM || !t->enabled) {
+			sample.valid = false;
+			continue;
+		}
+
+		const TransformTrack *tt = static_cast<const TransformTrack *>(t);
+		int *cursor = r_cursors ? &r_cursors[i] : NULL;
+
+		TransformKey tk;
+		if (tt->compressed) {
+			sample.valid = _interpolate_compressed(tt, p_time, tk, cursor);
+		} else {
+			tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &sample.valid, cursor);
+		}
+
+		if (sample.valid) {
+			sample.loc = tk.loc;
+			sample.rot = tk.rot;
+			sample.scale = tk.scale;
+		}
+	}
+}
+
+Variant Animation::value_track_interpolate(int p_track, float p_time, int *r_cursor) const {
 
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), 0);
 	Track *t = tracks[p_track];
@@ -1823,7 +2356,7 @@ Variant Animation::value_track_interpolate(int p_track, float p_time) const {
 
 	bool ok = false;
 
-	Variant res = _interpolate(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok);
+	Variant res = _interpolate(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok, r_cursor);
 
 	if (ok) {
 
@@ -1989,8 +2522,13 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 				case TYPE_TRANSFORM: {
 
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					if (tt->compressed) {
+						_track_get_key_indices_in_range(tt->compressed_transforms.keys, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->compressed_transforms.keys, 0, to_time, p_indices);
+					} else {
+						_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					}
 
 				} break;
 				case TYPE_VALUE: {
@@ -2049,7 +2587,11 @@ void Animation::track_get_key_indices_in_range(int p_track, float p_time, float
 		case TYPE_TRANSFORM: {
 
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			if (tt->compressed) {
+				_track_get_key_indices_in_range(tt->compressed_transforms.keys, from_time, to_time, p_indices);
+			} else {
+				_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			}
 
 		} break;
 		case TYPE_VALUE: {
@@ -2684,6 +3226,9 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("track_get_interpolation_loop_wrap", "idx"), &Animation::track_get_interpolation_loop_wrap);
 
 	ClassDB::bind_method(D_METHOD("transform_track_interpolate", "idx", "time_sec"), &Animation::_transform_track_interpolate);
+	ClassDB::bind_method(D_METHOD("transform_track_compress", "idx", "allowed_linear_err", "allowed_angular_err"), &Animation::transform_track_compress, DEFVAL(0.001), DEFVAL(0.001));
+	ClassDB::bind_method(D_METHOD("transform_track_decompress", "idx"), &Animation::transform_track_decompress);
+	ClassDB::bind_method(D_METHOD("transform_track_is_compressed", "idx"), &Animation::transform_track_is_compressed);
 	ClassDB::bind_method(D_METHOD("value_track_set_update_mode", "idx", "mode"), &Animation::value_track_set_update_mode);
 	ClassDB::bind_method(D_METHOD("value_track_get_update_mode", "idx"), &Animation::value_track_get_update_mode);
 
@@ -2728,6 +3273,7 @@ void Animation::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track", "to_animation"), &Animation::copy_track);
+	ClassDB::bind_method(D_METHOD("compress", "allowed_linear_err", "allowed_angular_err"), &Animation::compress, DEFVAL(0.001), DEFVAL(0.001));
 
 	ADD_PROPERTY(PropertyInfo(Variant::REAL, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
@@ -2939,6 +3485,9 @@ void Animation::_transform_track_optimize(int p_idx, float p_allowed_linear_err,
 	ERR_FAIL_INDEX(p_idx, tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type != TYPE_TRANSFORM);
 	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_idx]);
+	if (tt->compressed)
+		return; // Keys were already reduced when compressing.
+
 	bool prev_erased = false;
 	TKey<TransformKey> first_erased;
 
@@ -2986,6 +3535,17 @@ void Animation::optimize(float p_allowed_linear_err, float p_allowed_angular_err
 	}
 }
 
+void Animation::compress(float p_allowed_linear_err, float p_allowed_angular_err) {
+
+	for (int i = 0; i < tracks.size(); i++) {
+
+		if (tracks[i]->type == TYPE_TRANSFORM)
+			_transform_track_compress(static_cast<TransformTrack *>(tracks[i]), p_allowed_linear_err, p_allowed_angular_err);
+	}
+
+	emit_changed();
+}
+
 Animation::Animation() {
 
 	step = 0.1;
@@ -41,6 +41,15 @@ class Animation : public Resource {
 	RES_BASE_EXTENSION("anim");
 
 public:
+	// Value of a transform track at some time, see transform_tracks_interpolate().
+	struct TransformTrackSample {
+
+		Vector3 loc;
+		Quat rot;
+		Vector3 scale;
+		bool valid; // False if the track isn't a transform track, or has no key at that time.
+	};
+
 	enum TrackType {
 		TYPE_VALUE, ///< Set a value in a property, can be interpolated.
 		TYPE_TRANSFORM, ///< Transform a node or a bone.
@@ -104,13 +113,44 @@ private:
 		Vector3 scale;
 	};
 
+	// Transform keys quantized to 16 bits per component, within the range each component spans in the track.
+	// Channels that stay within the allowed error of a single value store only that value.
+	struct CompressedTransforms {
+
+		enum {
+			CHANNEL_LOC = 1,
+			CHANNEL_ROT = 2,
+			CHANNEL_SCALE = 4,
+			MAX_COMPONENTS = 10
+		};
+
+		Vector<Key> keys; // Times and transitions.
+		Vector<uint16_t> data; // Components of the animated channels, one key after another.
+		uint32_t channels; // Animated ones.
+		int stride; // Components per key.
+		float offsets[MAX_COMPONENTS]; // Value of each component when quantized to 0.
+		float steps[MAX_COMPONENTS]; // Difference between two quantized values.
+		TransformKey constant; // Value of the channels that aren't animated.
+
+		CompressedTransforms() {
+			channels = 0;
+			stride = 0;
+		}
+	};
+
 	/* TRANSFORM TRACK */
 
 	struct TransformTrack : public Track {
 
 		Vector<TKey<TransformKey> > transforms;
 
-		TransformTrack() { type = TYPE_TRANSFORM; }
+		bool compressed; // Keys are in compressed_transforms instead.
+		CompressedTransforms compressed_transforms;
+
+		TransformTrack() {
+			type = TYPE_TRANSFORM;
+			compressed = false;
+		}
 	};
 
 	/* PROPERTY VALUE TRACK */
@@ -203,7 +243,19 @@ private:
 	int _insert(float p_time, T &p_keys, const V &p_value);
 
 	template <class K>
-	inline int _find(const Vector<K> &p_keys, float p_time) const;
+	inline int _find(const Vector<K> &p_keys, float p_time, int *r_hint = NULL) const;
+
+	// Keys to interpolate between at some time, and how far between them it is.
+	struct KeyInterpolation {
+
+		int idx;
+		int next;
+		int count; // Keys up to the length of the animation.
+		float c;
+	};
+
+	template <class K>
+	_FORCE_INLINE_ bool _find_interpolation(const Vector<K> &p_keys, float p_time, bool p_loop_wrap, KeyInterpolation &r_interp, int *r_hint) const;
 
 	_FORCE_INLINE_ Animation::TransformKey _interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, float p_c) const;
 
@@ -219,7 +271,7 @@ private:
 	_FORCE_INLINE_ float _cubic_interpolate(const float &p_pre_a, const float &p_a, const float &p_b, const float &p_post_b, float p_c) const;
 
 	template <class T>
-	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
+	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T> > &p_keys, float p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_hint = NULL) const;
 
 	template <class T>
 	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, float from_time, float to_time, List<int> *p_indices) const;
@@ -270,6 +322,15 @@ private:
 		return idxr;
 	}
 
+	static bool _is_transform_key_within_error(const TransformKey &p_a, const TransformKey &p_b, uint32_t p_channels, float p_allowed_linear_err, float p_allowed_angular_err);
+	static int _get_transform_components(const TransformKey &p_key, uint32_t p_channels, float *r_components);
+	static void _set_transform_components(TransformKey &r_key, uint32_t p_channels, const float *p_components);
+	static void _get_quantization_error(uint32_t p_channels, const float *p_mins, const float *p_maxs, float &r_linear_err, float &r_angular_err);
+	TransformKey _decode_transform_key(const CompressedTransforms &p_compressed, int p_key) const;
+	bool _interpolate_compressed(const TransformTrack *p_track, float p_time, TransformKey &r_value, int *r_hint) const;
+	void _transform_track_compress(TransformTrack *p_track, float p_allowed_linear_err, float p_allowed_angular_err);
+	void _transform_track_decompress(TransformTrack *p_track);
+
 	bool _transform_track_optimize_key(const TKey<TransformKey> &t0, const TKey<TransformKey> &t1, const TKey<TransformKey> &t2, float p_alowed_linear_err, float p_alowed_angular_err, float p_max_optimizable_angle, const Vector3 &p_norm);
 	void _transform_track_optimize(int p_idx, float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
 
@@ -343,9 +404,17 @@ public:
 	void track_set_interpolation_loop_wrap(int p_track, bool p_enable);
 	bool track_get_interpolation_loop_wrap(int p_track) const;
 
-	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale) const;
+	// The optional cursors keep the index of the last key found, so sampling successive
+	// times (as playback does) finds the keys without searching. Keep one per track.
+	Error transform_track_interpolate(int p_track, float p_time, Vector3 *r_loc, Quat *r_rot, Vector3 *r_scale, int *r_cursor = NULL) const;
+	// Samples the tracks listed in p_tracks. Samples and cursors are indexed by track, the others are left untouched.
+	void transform_tracks_interpolate(float p_time, const int *p_tracks, int p_track_count, TransformTrackSample *r_samples, int *r_cursors = NULL) const;
+
+	void transform_track_compress(int p_track, float p_allowed_linear_err = 0.001, float p_allowed_angular_err = 0.001);
+	void transform_track_decompress(int p_track);
+	bool transform_track_is_compressed(int p_track) const;
 
-	Variant value_track_interpolate(int p_track, float p_time) const;
+	Variant value_track_interpolate(int p_track, float p_time, int *r_cursor = NULL) const;
 	void value_track_get_key_indices(int p_track, float p_time, float p_delta, List<int> *p_indices) const;
 	void value_track_set_update_mode(int p_track, UpdateMode p_mode);
 	UpdateMode value_track_get_update_mode(int p_track) const;
@@ -370,6 +439,7 @@ public:
 	void clear();
 
 	void optimize(float p_allowed_linear_err = 0.05, float p_allowed_angular_err = 0.01, float p_max_optimizable_angle = Math_PI * 0.125);
+	void compress(float p_allowed_linear_err = 0.001, float p_allowed_angular_err = 0.001);
 
 	Animation();
 	~Animation();
@@ -51,19 +51,31 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 	// nodes where instancing failed (because something is missing)
 	List<Node *> stray_instances;
 
-#define NODE_FROM_ID(p_name, p_id)                   \
-	Node *p_name;                                    \
-	if (p_id & FLAG_ID_IS_PATH) {                    \
-		NodePath np = node_paths[p_id & FLAG_MASK];  \
-		p_name = ret_nodes[0]->get_node_or_null(np); \
-	} else {                                         \
-		ERR_FAIL_INDEX_V(p_id &FLAG_MASK, nc, NULL); \
-		p_name = ret_nodes[p_id & FLAG_MASK];        \
+#define NODE_FROM_ID(p_name, p_id)                                                             \
+	Node *p_name = NULL;                                                                       \
+	if (p_id & FLAG_ID_IS_PATH) {                                                              \
+		int pn = path_nodes[p_id & FLAG_MASK];                                                 \
+		if (pn >= 0 && ret_nodes[pn] && (pn == 0 || ret_nodes[0]->is_a_parent_of(ret_nodes[pn]))) \
+			p_name = ret_nodes[pn];                                                            \
+		else {                                                                                 \
+			NodePath np = node_paths[p_id & FLAG_MASK];                                        \
+			p_name = ret_nodes[0]->get_node_or_null(np);                                       \
+		}                                                                                      \
+	} else {                                                                                   \
+		ERR_FAIL_INDEX_V(p_id &FLAG_MASK, nc, NULL);                                           \
+		p_name = ret_nodes[p_id & FLAG_MASK];                                                  \
 	}
 
 	int nc = nodes.size();
 	ERR_FAIL_COND_V(nc == 0, NULL);
 
+	if (!atomic_load_acquire(&instance_plan_valid)) {
+		_build_instance_plan();
+	}
+
+	const InstancePlan::NodePlan *nplans = instance_plan.nodes.ptr();
+	const int *path_nodes = instance_plan.node_path_nodes.ptr();
+
 	const StringName *snames = NULL;
 	int sname_count = names.size();
 	if (sname_count)
@@ -79,6 +91,7 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 	const NodeData *nd = &nodes[0];
 
 	Node **ret_nodes = (Node **)alloca(sizeof(Node *) * nc);
+	zeromem(ret_nodes, sizeof(Node *) * nc);
 
 	bool gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.empty();
 
@@ -190,6 +203,14 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 			if (nprop_count) {
 
 				const NodeData::Property *nprops = &n.properties[0];
+				const InstancePlan::NodePlan &nplan = nplans[i];
+
+				// setters resolved by the plan are only valid for the exact class that was packed, and
+				// a script instance may override them, so anything else goes through Object::set()
+				const ClassDB::PropertySetGet *const *nsetgets = NULL;
+				if (p_edit_state == GEN_EDIT_STATE_DISABLED && nplan.property_setgets.size() && n.type != TYPE_INSTANCED && node->get_class_name() == snames[n.type]) {
+					nsetgets = nplan.property_setgets.ptr();
+				}
 
 				for (int j = 0; j < nprop_count; j++) {
 
@@ -197,7 +218,11 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 					ERR_FAIL_INDEX_V(nprops[j].name, sname_count, NULL);
 					ERR_FAIL_INDEX_V(nprops[j].value, prop_count, NULL);
 
-					if (snames[nprops[j].name] == CoreStringNames::get_singleton()->_script) {
+					if (nsetgets && nsetgets[j] && !node->get_script_instance() && props[nprops[j].value].get_type() != Variant::OBJECT) {
+						//fast path, value is passed as is so no copy is made
+						ClassDB::set_property_setget(node, nsetgets[j], props[nprops[j].value], &valid);
+
+					} else if (j == nplan.script_property) {
 						//work around to avoid old script variables from disappearing, should be the proper fix to:
 						//https://github.com/godotengine/godot/issues/2958
 
@@ -353,6 +378,321 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 	return ret_nodes[0];
 }
 
+// Brings an instance previously created by this state back to its packed
+// values, so it can be reused instead of instancing the scene again: stored
+// properties are reapplied, other stored properties go back to their class
+// defaults and script instances are recreated. Nodes added since instancing
+// must have been removed already. Returns false if the instance no longer
+// matches the packed node layout.
+bool SceneState::reset_instance(Node *p_root) const {
+
+	ERR_FAIL_NULL_V(p_root, false);
+
+	int nc = nodes.size();
+	ERR_FAIL_COND_V(nc == 0, false);
+
+	if (!atomic_load_acquire(&instance_plan_valid)) {
+		_build_instance_plan();
+	}
+	if (!atomic_load_acquire(&instance_plan.defaults_valid)) {
+		_build_instance_defaults();
+	}
+
+	const InstancePlan::NodePlan *nplans = instance_plan.nodes.ptr();
+	const StringName *snames = names.ptr();
+	int sname_count = names.size();
+	const Variant *props = variants.ptr();
+	int prop_count = variants.size();
+	const NodeData *nd = nodes.ptr();
+
+	Node **ret_nodes = (Node **)alloca(sizeof(Node *) * nc);
+
+	for (int i = 0; i < nc; i++) {
+
+		const NodeData &n = nd[i];
+		Node *node = NULL;
+
+		if (i == 0) {
+			node = p_root;
+		} else {
+
+			Node *parent = NULL;
+			if (n.parent & FLAG_ID_IS_PATH) {
+				int pn = instance_plan.node_path_nodes[n.parent & FLAG_MASK];
+				parent = pn >= 0 && pn < i ? ret_nodes[pn] : p_root->get_node_or_null(node_paths[n.parent & FLAG_MASK]);
+			} else {
+				ERR_FAIL_INDEX_V(n.parent, i, false);
+				parent = ret_nodes[n.parent];
+			}
+
+			ERR_FAIL_INDEX_V(n.name, sname_count, false);
+			if (!parent) {
+				return false;
+			}
+			node = parent->_get_child_by_name(snames[n.name]);
+			if (!node) {
+				return false;
+			}
+		}
+
+		ret_nodes[i] = node;
+
+		const InstancePlan::NodePlan &nplan = nplans[i];
+
+		Ref<PackedScene> sdata;
+		if (i == 0 && base_scene_idx >= 0) {
+			sdata = props[base_scene_idx];
+		} else if (n.instance >= 0 && !(n.instance & FLAG_INSTANCE_IS_PLACEHOLDER)) {
+			sdata = props[n.instance & FLAG_MASK];
+		}
+
+		if (sdata.is_valid()) {
+			//instanced from another scene, which resets it first like instance() creates it first
+			if (!sdata->get_state()->reset_instance(node)) {
+				return false;
+			}
+		} else if (_is_class_created(i)) {
+
+			if (node->get_class_name() != snames[n.type]) {
+				return false;
+			}
+
+			if (node->get_script_instance()) {
+				//recreate the script instance so member variables start over
+				RefPtr script = nplan.script_property >= 0 ? node->get_script() : RefPtr();
+				node->set_script(RefPtr());
+				if (!script.is_null()) {
+					node->set_script(script);
+					node->request_ready();
+				}
+			}
+
+			int ndefault_count = nplan.default_names.size();
+			const StringName *dnames = nplan.default_names.ptr();
+			const Variant *dvalues = nplan.default_values.ptr();
+
+			for (int j = 0; j < ndefault_count; j++) {
+
+				bool valid;
+				Variant value = node->get(dnames[j], &valid);
+				if (valid && value != dvalues[j]) {
+					node->set(dnames[j], dvalues[j]);
+				}
+			}
+		}
+
+		const ClassDB::PropertySetGet *const *nsetgets = NULL;
+		if (nplan.property_setgets.size() && node->get_class_name() == snames[n.type]) {
+			nsetgets = nplan.property_setgets.ptr();
+		}
+
+		int nprop_count = n.properties.size();
+		const NodeData::Property *nprops = n.properties.ptr();
+
+		for (int j = 0; j < nprop_count; j++) {
+
+			ERR_FAIL_INDEX_V(nprops[j].name, sname_count, false);
+			ERR_FAIL_INDEX_V(nprops[j].value, prop_count, false);
+
+			const Variant &value = props[nprops[j].value];
+
+			if (j == nplan.script_property) {
+				Ref<Script> script = value;
+				if (node->get_script() == script.get_ref_ptr()) {
+					continue; //already recreated above, or by the instanced scene
+				}
+				node->set_script(script.get_ref_ptr());
+				node->request_ready();
+				continue;
+			}
+
+			if (value.get_type() == Variant::OBJECT) {
+				Ref<Resource> res = value;
+				if (res.is_valid() && res->is_local_to_scene()) {
+					continue; //the instance owns a duplicate of this resource, keep it
+				}
+			}
+
+			if (nsetgets && nsetgets[j] && !node->get_script_instance()) {
+				ClassDB::set_property_setget(node, nsetgets[j], value);
+			} else {
+				node->set(snames[nprops[j].name], value);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool SceneState::_is_class_created(int p_idx) const {
+
+	const NodeData &n = nodes[p_idx];
+	return !(p_idx == 0 && base_scene_idx >= 0) && n.instance < 0 && n.type != TYPE_INSTANCED && n.type >= 0 && n.type < names.size();
+}
+
+void SceneState::_build_instance_defaults() const {
+
+	MutexLock lock(instance_plan_mutex);
+
+	if (instance_plan.defaults_valid) {
+		return;
+	}
+
+	int nc = nodes.size();
+	const NodeData *nd = nodes.ptr();
+	const StringName *snames = names.ptr();
+	int sname_count = names.size();
+
+	for (int i = 0; i < nc; i++) {
+
+		InstancePlan::NodePlan &nplan = instance_plan.nodes.write[i];
+		nplan.default_names.clear();
+		nplan.default_values.clear();
+
+		if (!_is_class_created(i)) {
+			continue;
+		}
+
+		const NodeData &n = nd[i];
+
+		// only properties registered in ClassDB, dynamic ones are left as they are
+		List<PropertyInfo> plist;
+		ClassDB::get_property_list(snames[n.type], &plist);
+
+		for (List<PropertyInfo>::Element *E = plist.front(); E; E = E->next()) {
+
+			if (!(E->get().usage & PROPERTY_USAGE_STORAGE)) {
+				continue;
+			}
+
+			StringName pname = E->get().name;
+			if (pname == CoreStringNames::get_singleton()->_script) {
+				continue;
+			}
+
+			bool stored = false;
+			for (int j = 0; j < n.properties.size(); j++) {
+				int sname = n.properties[j].name;
+				if (sname >= 0 && sname < sname_count && snames[sname] == pname) {
+					stored = true;
+					break;
+				}
+			}
+
+			if (!stored) {
+				nplan.default_names.push_back(pname);
+				nplan.default_values.push_back(ClassDB::class_get_default_property_value(snames[n.type], pname));
+			}
+		}
+	}
+
+	atomic_store_release(&instance_plan.defaults_valid, true);
+}
+
+void SceneState::_build_instance_plan() const {
+
+	MutexLock lock(instance_plan_mutex);
+
+	if (instance_plan_valid) {
+		return; //built by another thread while waiting
+	}
+
+	int nc = nodes.size();
+	const NodeData *nd = nodes.ptr();
+	const StringName *snames = names.ptr();
+	int sname_count = names.size();
+
+	instance_plan.nodes.resize(nc);
+
+	// paths of the nodes this state creates or finds by name, relative to the root,
+	// used to resolve node path ids without walking the tree
+	Vector<Vector<StringName> > node_names;
+	node_names.resize(nc);
+	Vector<bool> node_names_known;
+	node_names_known.resize(nc);
+	HashMap<NodePath, int> path_map;
+
+	for (int i = 0; i < nc; i++) {
+
+		const NodeData &n = nd[i];
+		InstancePlan::NodePlan &nplan = instance_plan.nodes.write[i];
+
+		nplan.script_property = -1;
+		nplan.property_setgets.clear();
+
+		bool class_created = _is_class_created(i);
+
+		if (class_created) {
+			nplan.property_setgets.resize(n.properties.size());
+		}
+
+		for (int j = 0; j < n.properties.size(); j++) {
+
+			int pname = n.properties[j].name;
+			if (pname < 0 || pname >= sname_count) {
+				if (class_created)
+					nplan.property_setgets.write[j] = NULL;
+				continue;
+			}
+
+			if (snames[pname] == CoreStringNames::get_singleton()->_script) {
+				nplan.script_property = j;
+				if (class_created)
+					nplan.property_setgets.write[j] = NULL;
+				continue;
+			}
+
+			if (class_created) {
+				const ClassDB::PropertySetGet *psg = ClassDB::get_property_setget(snames[n.type], snames[pname]);
+				nplan.property_setgets.write[j] = (psg && psg->setter && psg->_setptr) ? psg : NULL;
+			}
+		}
+
+		bool known = false;
+		if (i == 0) {
+			known = true;
+		} else if (n.name >= 0 && n.name < sname_count && n.parent >= 0) {
+
+			int pidx = n.parent & FLAG_MASK;
+			if (n.parent & FLAG_ID_IS_PATH) {
+				if (pidx < node_paths.size() && !node_paths[pidx].is_absolute() && node_paths[pidx].get_subname_count() == 0) {
+					Vector<StringName> pnames = node_paths[pidx].get_names();
+					if (pnames.size() == 1 && pnames[0] == StringName(".")) {
+						pnames.clear();
+					}
+					node_names.write[i] = pnames;
+					known = true;
+				}
+			} else if (pidx < i && node_names_known[pidx]) {
+				node_names.write[i] = node_names[pidx];
+				known = true;
+			}
+
+			if (known) {
+				node_names.write[i].push_back(snames[n.name]);
+			}
+		}
+
+		node_names_known.write[i] = known;
+		if (known) {
+			NodePath np = i == 0 ? NodePath(".") : NodePath(node_names[i], false);
+			if (!path_map.has(np)) {
+				path_map[np] = i;
+			}
+		}
+	}
+
+	instance_plan.node_path_nodes.resize(node_paths.size());
+	for (int i = 0; i < node_paths.size(); i++) {
+
+		const int *idx = path_map.getptr(node_paths[i]);
+		instance_plan.node_path_nodes.write[i] = idx ? *idx : -1;
+	}
+
+	instance_plan.defaults_valid = false;
+	atomic_store_release(&instance_plan_valid, true);
+}
+
 static int _nm_get_string(const String &p_string, Map<StringName, int> &name_map) {
 
 	if (name_map.has(p_string))
@@ -930,6 +1270,7 @@ void SceneState::clear() {
 	node_paths.clear();
 	editable_instances.clear();
 	base_scene_idx = -1;
+	_invalidate_instance_plan();
 }
 
 Ref<SceneState> SceneState::_get_base_scene_state() const {
@@ -1098,6 +1439,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 		ERR_FAIL();
 	}
 
+	_invalidate_instance_plan();
+
 	PoolVector<String> snames = p_dictionary["names"];
 	if (snames.size()) {
 
@@ -1531,6 +1874,7 @@ Vector<NodePath> SceneState::get_editable_instances() const {
 int SceneState::add_name(const StringName &p_name) {
 
 	names.push_back(p_name);
+	_invalidate_instance_plan();
 	return names.size() - 1;
 }
 
@@ -1553,6 +1897,7 @@ int SceneState::add_value(const Variant &p_value) {
 int SceneState::add_node_path(const NodePath &p_path) {
 
 	node_paths.push_back(p_path);
+	_invalidate_instance_plan();
 	return (node_paths.size() - 1) | FLAG_ID_IS_PATH;
 }
 int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int p_instance, int p_index) {
@@ -1566,6 +1911,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.index = p_index;
 
 	nodes.push_back(nd);
+	_invalidate_instance_plan();
 
 	return nodes.size() - 1;
 }
@@ -1579,6 +1925,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	prop.name = p_name;
 	prop.value = p_value;
 	nodes.write[p_node].properties.push_back(prop);
+	_invalidate_instance_plan();
 }
 void SceneState::add_node_group(int p_node, int p_group) {
 
@@ -1590,6 +1937,7 @@ void SceneState::set_base_scene(int p_idx) {
 
 	ERR_FAIL_INDEX(p_idx, variants.size());
 	base_scene_idx = p_idx;
+	_invalidate_instance_plan();
 }
 void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method, int p_flags, const Vector<int> &p_binds) {
 
@@ -1658,6 +2006,14 @@ SceneState::SceneState() {
 
 	base_scene_idx = -1;
 	last_modified_time = 0;
+	instance_plan_valid = false;
+	instance_plan.defaults_valid = false;
+	instance_plan_mutex = Mutex::create();
+}
+
+SceneState::~SceneState() {
+
+	memdelete(instance_plan_mutex);
 }
 
 ////////////////
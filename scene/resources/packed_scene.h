@@ -31,6 +31,7 @@
 #ifndef PACKED_SCENE_H
 #define PACKED_SCENE_H
 
+#include "core/os/mutex.h"
 #include "core/resource.h"
 #include "scene/main/node.h"
 
@@ -92,6 +93,36 @@ class SceneState : public Reference {
 
 	Vector<ConnectionData> connections;
 
+	// Lookups that only depend on the packed data, resolved once and reused
+	// by every instance() call until the state is modified.
+	struct InstancePlan {
+
+		struct NodePlan {
+
+			Vector<const ClassDB::PropertySetGet *> property_setgets; // NULL when the property needs Object::set()
+			int script_property; // index of the "script" property, -1 if none
+
+			// class defaults of the stored properties this state doesn't set, used by reset_instance()
+			Vector<StringName> default_names;
+			Vector<Variant> default_values;
+		};
+
+		Vector<NodePlan> nodes;
+		Vector<int> node_path_nodes; // node created by this state for each node path, -1 if it must be looked up
+		volatile bool defaults_valid;
+	};
+
+	// The valid flags are set with a release store once the plan is built, and
+	// checked with an acquire load, so a thread seeing them set also sees the plan.
+	mutable InstancePlan instance_plan;
+	mutable volatile bool instance_plan_valid;
+	Mutex *instance_plan_mutex;
+
+	void _build_instance_plan() const;
+	void _build_instance_defaults() const;
+	bool _is_class_created(int p_idx) const;
+	_FORCE_INLINE_ void _invalidate_instance_plan() { instance_plan_valid = false; }
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -143,6 +174,7 @@ public:
 
 	bool can_instance() const;
 	Node *instance(GenEditState p_edit_state) const;
+	bool reset_instance(Node *p_root) const;
 
 	//unbuild API
 
@@ -190,6 +222,7 @@ public:
 	uint64_t get_last_modified_time() const { return last_modified_time; }
 
 	SceneState();
+	~SceneState();
 };
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
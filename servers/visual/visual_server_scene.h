@@ -170,7 +170,7 @@ public:
 		AABB transformed_aabb;
 		AABB *custom_aabb; // <Zylann> would using aabb directly with a bool be better?
 		float extra_margin;
-		uint32_t object_ID;
+		ObjectID object_ID;
 
 		float lod_begin;
 		float lod_end;